@@ -7,7 +7,9 @@
 #include <stdint.h>
 #include <type_traits>
 #include <map>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
@@ -35,6 +37,84 @@ using VectorDouble = std::vector<double>;
 using VectorMapStringToFloat = std::vector<MapStringToFloat>;
 using VectorMapInt64ToFloat = std::vector<MapInt64ToFloat>;
 
+/**
+ * \brief Sequence of maps that all have the same keys, e.g. the per class
+ *        scores of a classifier for a batch of rows.
+ *
+ * \details The keys are stored once and may be shared between sequences, the values
+ *          are stored as a dense row major [size() x NumKeys()] matrix.
+ *          It represents the same ONNX type as std::vector<std::map<K, V>>, which values
+ *          of that type are created as. A kernel may produce it instead for an output only
+ *          the caller reads (see KernelDefBuilder::OutputValueType), so a std::map<K, V>
+ *          per row is only built when one is requested via MapAt() or ToMaps().
+ */
+template <typename K, typename V>
+class ColumnarMapSequence {
+ public:
+  using key_type = K;
+  using mapped_type = V;
+  // Element type of the sequence, which determines the registered ONNX type.
+  using value_type = std::map<K, V>;
+
+  ColumnarMapSequence() = default;
+
+  // Set the keys and resize the value matrix to num_rows rows.
+  void Reset(std::shared_ptr<const std::vector<K>> keys, size_t num_rows) {
+    ORT_ENFORCE(keys != nullptr, "keys must be provided");
+    keys_ = std::move(keys);
+    num_rows_ = num_rows;
+    values_.resize(num_rows_ * keys_->size());
+  }
+
+  size_t size() const { return num_rows_; }
+  bool empty() const { return num_rows_ == 0; }
+
+  size_t NumKeys() const { return keys_ == nullptr ? 0 : keys_->size(); }
+
+  const std::vector<K>& Keys() const {
+    static const std::vector<K> no_keys;
+    return keys_ == nullptr ? no_keys : *keys_;
+  }
+
+  const std::shared_ptr<const std::vector<K>>& SharedKeys() const { return keys_; }
+
+  const std::vector<V>& Values() const { return values_; }
+  std::vector<V>& MutableValues() { return values_; }
+
+  // Values of row i, in the order of Keys().
+  const V* Row(size_t i) const {
+    ORT_ENFORCE(i < num_rows_, "row ", i, " is out of range. Number of rows is ", num_rows_);
+    return values_.data() + i * NumKeys();
+  }
+
+  value_type MapAt(size_t i) const {
+    const V* row = Row(i);
+    const auto& keys = Keys();
+    value_type result;
+    for (size_t k = 0; k < keys.size(); ++k) {
+      result[keys[k]] = row[k];
+    }
+    return result;
+  }
+
+  std::vector<value_type> ToMaps() const {
+    std::vector<value_type> result;
+    result.reserve(num_rows_);
+    for (size_t i = 0; i < num_rows_; ++i) {
+      result.push_back(MapAt(i));
+    }
+    return result;
+  }
+
+ private:
+  std::shared_ptr<const std::vector<K>> keys_;
+  size_t num_rows_ = 0;
+  std::vector<V> values_;
+};
+
+using ColumnarMapStringToFloat = ColumnarMapSequence<std::string, float>;
+using ColumnarMapInt64ToFloat = ColumnarMapSequence<int64_t, float>;
+
 class DataTypeImpl;
 class TensorTypeBase;
 
@@ -394,6 +474,8 @@ class NonTensorTypeBase : public DataTypeImpl {
 
   ONNX_NAMESPACE::TypeProto& mutable_type_proto();
 
+  bool IsTensorCompatible(const ONNX_NAMESPACE::TypeProto& type_proto) const;
+
   bool IsMapCompatible(const ONNX_NAMESPACE::TypeProto& type_proto) const;
 
   bool IsSequenceCompatible(const ONNX_NAMESPACE::TypeProto& type_proto) const;
@@ -483,6 +565,33 @@ class SequenceType : public NonTensorType<CPPType> {
   }
 };
 
+/**
+ * \brief PackedTensorType. Use to register a representation of tensors
+ *  other than Tensor, such as PackedStringTensor.
+ *
+ *  \param CPPType - CPP type of the representation
+ *
+ *  \param ElemT - element type of the tensors it represents
+ *
+ * \details Usage: ORT_REGISTER_PACKED_TENSOR(C++Type, ElemType)
+ *          TypeFromProto keeps returning the Tensor type, the representation is
+ *          only created where a kernel asks for it, see KernelDefBuilder::InputValueType.
+ */
+template <typename CPPType, typename ElemT>
+class PackedTensorType : public NonTensorType<CPPType> {
+ public:
+  static MLDataType Type();
+
+  bool IsCompatible(const ONNX_NAMESPACE::TypeProto& type_proto) const override {
+    return this->IsTensorCompatible(type_proto);
+  }
+
+ private:
+  PackedTensorType() {
+    data_types_internal::TensorContainedTypeSetter<ElemT>::SetTensorElementType(this->mutable_type_proto());
+  }
+};
+
 /**
  * \brief OpaqueType
  *
@@ -579,6 +688,17 @@ class NonOnnxType : public DataTypeImpl {
     return SequenceType<TYPE>::Type();       \
   }
 
+#define ORT_REGISTER_PACKED_TENSOR(TYPE, ELEM_TYPE)              \
+  template <>                                                    \
+  MLDataType PackedTensorType<TYPE, ELEM_TYPE>::Type() {         \
+    static PackedTensorType<TYPE, ELEM_TYPE> packed_tensor_type; \
+    return &packed_tensor_type;                                  \
+  }                                                              \
+  template <>                                                    \
+  MLDataType DataTypeImpl::GetType<TYPE>() {                     \
+    return PackedTensorType<TYPE, ELEM_TYPE>::Type();            \
+  }
+
 #define ORT_REGISTER_NON_ONNX_TYPE(TYPE)     \
   template <>                                \
   MLDataType NonOnnxType<TYPE>::Type() {     \
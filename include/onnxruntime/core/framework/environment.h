@@ -9,6 +9,8 @@
 #include "core/common/status.h"
 
 namespace onnxruntime {
+class SharedInitializerStore;
+
 /**
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -30,6 +32,13 @@ class Environment {
   */
   static bool IsInitialized() { return is_initialized_; }
 
+  /**
+     Returns the store deduplicating the initializers of the sessions created with
+     SessionOptions::share_initializers, or nullptr if no runtime environment is alive.
+     Sessions hold the store as long as they use it.
+  */
+  static std::shared_ptr<SharedInitializerStore> GetSharedInitializerStore();
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
 
@@ -72,6 +72,20 @@ class KernelDef {
     return it->second;
   }
 
+  // Types input input_index may be fed as besides the type registered for its ONNX type.
+  const std::vector<MLDataType>& InputValueTypes(size_t input_index) const {
+    static const std::vector<MLDataType> no_types;
+    auto it = input_value_types_.find(input_index);
+    return it == input_value_types_.end() ? no_types : it->second;
+  }
+
+  // Types output output_index may be created as when only the caller reads it.
+  const std::vector<MLDataType>& OutputValueTypes(size_t output_index) const {
+    static const std::vector<MLDataType> no_types;
+    auto it = output_value_types_.find(output_index);
+    return it == output_value_types_.end() ? no_types : it->second;
+  }
+
   int ExecQueueId() const {
     return exec_queue_id_;
   }
@@ -112,6 +126,12 @@ class KernelDef {
   MemTypeMap input_memory_type_args_;
   MemTypeMap output_memory_type_args_;
 
+  // Alternative representations of inputs, see KernelDefBuilder::InputValueType
+  std::unordered_map<size_t, std::vector<MLDataType>> input_value_types_;
+
+  // Alternative representations of outputs, see KernelDefBuilder::OutputValueType
+  std::unordered_map<size_t, std::vector<MLDataType>> output_value_types_;
+
   // execution command queue id, 0 for default queue in execution provider
   int exec_queue_id_ = 0;
   // Default memory type for all inputs
@@ -211,6 +231,27 @@ class KernelDefBuilder {
     return *this;
   }
 
+  /**
+     Specify that input input_index may also be one of types that represents its ONNX type, when the
+     caller feeds a graph input as such and only kernels accepting it consume the input. The feed is
+     converted to the type registered for its ONNX type otherwise. The kernel must handle both.
+  */
+  KernelDefBuilder& InputValueType(int input_index, const std::vector<MLDataType>& types) {
+    kernel_def_->input_value_types_[input_index] = types;
+    return *this;
+  }
+
+  /**
+     Specify that output output_index is created as the one of types that represents its ONNX type,
+     when it is a graph output that no other node consumes. A non-tensor output is always created so,
+     a tensor output only when the caller provides the fetch as that type. It is created as the type
+     registered for its ONNX type otherwise, so the kernel must handle both.
+  */
+  KernelDefBuilder& OutputValueType(int output_index, const std::vector<MLDataType>& types) {
+    kernel_def_->output_value_types_[output_index] = types;
+    return *this;
+  }
+
   /**
      Specify that this kernel runs on which execution queue in the provider
   */
@@ -94,6 +94,13 @@ class OpKernelContext {
     return p_ml_value ? p_ml_value->GetMutable<T>() : nullptr;
   }
 
+  /**
+  Return the type of non-tensor output index, creating the output if it has not been yet.
+  Lets a kernel that declares another representation of the output (see KernelDefBuilder::OutputValueType)
+  find out which one to write. Returns nullptr if it is an unused optional output.
+  */
+  MLDataType NonTensorOutputType(int index);
+
   // In the case that memory allocation has not been done for an output tensor,
   // The memory allocation will be done on-the-fly with given tensor shape.
   // Return nullptr if the output is an unused optional output.
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "core/framework/tensor_shape.h"
+
+namespace onnxruntime {
+
+/*
+  A tensor of strings packed in one buffer: the bytes of all the strings one after another
+  and the offset at which each of them starts, as OrtGetStringTensorContent returns them.
+  It represents tensor(string) like a Tensor of std::string, without an allocation per element.
+  Kernels may accept or produce it besides the Tensor (see KernelDefBuilder::InputValueType and
+  KernelDefBuilder::OutputValueType), the session converts it for the others.
+*/
+class PackedStringTensor final {
+ public:
+  PackedStringTensor();
+
+  /**
+     Allocate the offsets of shape.Size() strings and total_length bytes in one buffer.
+     The caller fills the bytes and the offsets.
+  */
+  void Reset(const TensorShape& shape, size_t total_length, AllocatorPtr allocator);
+
+  /**
+     Use the total_length bytes and the shape.Size() offsets of the caller without copying them.
+     They must outlive this tensor.
+  */
+  void Reset(const TensorShape& shape, char* bytes, size_t total_length, size_t* offsets);
+
+  /**
+     Pack the strings of a Tensor of std::string in a buffer allocated from allocator.
+  */
+  void Assign(const Tensor& strings, AllocatorPtr allocator);
+
+  /**
+     Copy the strings into a Tensor of std::string of the same shape.
+  */
+  void CopyTo(Tensor& strings) const;
+
+  const TensorShape& Shape() const noexcept { return shape_; }
+
+  // Number of strings.
+  size_t Size() const noexcept { return size_; }
+
+  // Total length of the strings in bytes.
+  size_t TotalLength() const noexcept { return total_length_; }
+
+  const char* Bytes() const noexcept { return bytes_; }
+
+  char* MutableBytes() noexcept { return bytes_; }
+
+  // Size() offsets, in increasing order.
+  const size_t* Offsets() const noexcept { return offsets_; }
+
+  size_t* MutableOffsets() noexcept { return offsets_; }
+
+  const char* Data(size_t index) const { return bytes_ + offsets_[index]; }
+
+  size_t Length(size_t index) const {
+    return (index + 1 < size_ ? offsets_[index + 1] : total_length_) - offsets_[index];
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PackedStringTensor);
+
+  TensorShape shape_;
+  size_t size_;
+  // holds the offsets followed by the bytes, unless they are owned by the caller
+  BufferUniquePtr buffer_;
+  size_t* offsets_;
+  char* bytes_;
+  size_t total_length_;
+};
+
+}  // namespace onnxruntime
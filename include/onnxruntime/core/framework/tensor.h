@@ -171,6 +171,13 @@ class Tensor final {
     return shape_.Size() * dtype_->Size();
   }
 
+  /**
+     Returns true if the tensor releases its buffer when it is destroyed.
+  */
+  bool OwnsBuffer() const noexcept {
+    return buffer_deleter_ != nullptr;
+  }
+
   // More API methods.
  private:
   void Init(MLDataType p_type,
@@ -389,6 +389,11 @@ class Node {
   // validate and update the input arg count
   common::Status UpdateInputArgCount();
 
+  // The input and output defs, with the versions of their types and shapes, when the types and shapes of the
+  // outputs were last inferred. Empty if they have to be inferred again.
+  const std::vector<std::pair<const NodeArg*, int>>& InferredArgs() const noexcept { return inferred_args_; }
+  void SetInferredArgs(std::vector<std::pair<const NodeArg*, int>>&& args) { inferred_args_ = std::move(args); }
+
   // Node index. Default to impossible value rather than 0.
   NodeIndex index_ = std::numeric_limits<NodeIndex>::max();
 
@@ -432,6 +437,9 @@ class Node {
 
   // Graph instances for subgraphs that are owned by this Node
   std::vector<std::unique_ptr<Graph>> subgraphs_;
+
+  // Args the types and shapes of the outputs were last inferred from, see InferredArgs.
+  std::vector<std::pair<const NodeArg*, int>> inferred_args_;
 };
 
 /**
@@ -821,6 +829,16 @@ class Graph {
   // search this and up through any parent_graph_ instance for a NodeArg
   NodeArg* GetNodeArgIncludingParentGraphs(const std::string& node_arg_name);
 
+  // Whether the types and shapes of the outputs of node, inferred by a previous Resolve, are up to date
+  // as neither the node nor its input and output defs changed since.
+  bool IsTypeInferenceUpToDate(const Node& node) const;
+
+  // Save what the types and shapes of the outputs of node were inferred from.
+  void SaveTypeInferenceArgs(Node& node) const;
+
+  // Mark the NodeArg with the name of an initializer as changed.
+  void InitializerChanged(const std::string& name);
+
   // Initialize all the graph inputs, initializers and outputs
   common::Status InitInputsInitializersOutputs();
 
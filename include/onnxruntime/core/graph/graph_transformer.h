@@ -115,4 +115,23 @@ class TopDownRuleBasedTransformer : public RuleBasedGraphTransformer {
   common::Status Apply(Graph& graph, bool& modified) const override;
 };
 
+/**
+@class WorklistRuleBasedTransformer
+
+This is a rule-based Graph transformer that applies rules until none applies, without re-scanning the Graph.
+The nodes with rules registered for their op type are visited once in topological order. When a rule
+modifies the Graph, the node, its neighbors before and after the rewrite and the nodes the rule added are
+visited again, so rules enabled by a rewrite are applied in the same Apply call.
+A rule must report a modification only when it changed the Graph, and must keep the edges of the nodes
+it leaves in the Graph up to date (Graph::AddEdge/RemoveEdge), as they are used to find the neighbors.
+*/
+class WorklistRuleBasedTransformer : public RuleBasedGraphTransformer {
+ public:
+  WorklistRuleBasedTransformer(const std::string& name, const std::string& desc)
+      : RuleBasedGraphTransformer(name, desc) {}
+
+  // Applies the registered rules to the nodes of the worklist until it is empty.
+  common::Status Apply(Graph& graph, bool& modified) const override;
+};
+
 }  // namespace onnxruntime
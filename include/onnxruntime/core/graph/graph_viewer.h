@@ -97,6 +97,9 @@ class GraphViewer {
   */
   const NodeArg* GetNodeArg(const std::string& name) const;
 
+  /** Returns true if the Graph is a subgraph of a node in another Graph. */
+  bool IsSubgraph() const;
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphViewer);
 
@@ -91,5 +91,9 @@ class NodeArg {
 
   // Flag indicates whether <*this> node arg exists or not.
   bool exists_;
+
+  // Incremented when the type or shape changes, or the value of the initializer with this name, so that
+  // Graph::Resolve only infers the types and shapes of the nodes consuming it again after a change.
+  int version_ = 0;
 };
 }  // namespace onnxruntime
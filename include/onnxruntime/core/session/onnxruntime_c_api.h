@@ -177,15 +177,54 @@ ORT_API_STATUS(OrtInitializeWithCustomLogger, OrtLoggingFunction logging_functio
 // execution of OrtCreateSession, or does the OrtSession retain a handle to the file/directory
 // and continue to access throughout the OrtSession lifetime?
 //  What sort of access is needed to model_path : read or read/write?
-// TODO:  allow loading from an in-memory byte-array
 ORT_API_STATUS(OrtCreateSession, _In_ OrtEnv* env, _In_ const ORTCHAR_T* model_path,
                _In_ const OrtSessionOptions* options, _Out_ OrtSession** out);
 
+// Create a session from a model serialized in a buffer, e.g. a model decrypted in memory.
+// The model is parsed from the buffer directly, which is owned by the caller and only has to be valid during
+// the call. model_data_len must be less than 2GB.
+ORT_API_STATUS(OrtCreateSessionFromArray, _In_ OrtEnv* env, _In_ const void* model_data, size_t model_data_len,
+               _In_ const OrtSessionOptions* options, _Out_ OrtSession** out);
+
+/**
+ * Create a session serving the model of sess, sharing its weights and kernels. Only the memory used while running
+ * and the thread pools are specific to the new session, which makes it cheap to create, e.g. one per NUMA node.
+ * sess must only use the CPU execution provider. It may be released before the new session.
+ * \param options options of the new session, may be NULL. The execution providers and custom op libraries
+ *        it lists are ignored as those of sess are used.
+ * \param out Should be freed by `OrtReleaseSession` after use
+ */
+ORT_API_STATUS(OrtCloneSession, _In_ const OrtSession* sess, _In_opt_ const OrtSessionOptions* options,
+               _Out_ OrtSession** out);
+
 ORT_API_STATUS(OrtRun, _Inout_ OrtSession* sess,
                _In_ OrtRunOptions* run_options,
                _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
                _In_ const char* const* output_names, size_t output_names_len, _Out_ OrtValue** output);
 
+/**
+ * Called once a run queued by OrtRunAsync completed, on a thread owned by the session.
+ * \param user_data the value given to OrtRunAsync
+ * \param output the output values in the order of output_names, NULL if the run failed.
+ *        Each value should be freed by OrtReleaseValue. The array itself is only valid during the call.
+ * \param output_len number of values in output
+ * \param status NULL on success, otherwise it should be freed by OrtReleaseStatus
+ */
+typedef void(ORT_API_CALL* OrtRunAsyncCallback)(void* user_data, OrtValue** output, size_t output_len,
+                                                OrtStatus* status);
+
+/**
+ * Queue a run and return without waiting for it. The arguments are the same as OrtRun's.
+ * run_options may be NULL, otherwise it must stay valid until callback is called.
+ * The inputs are referenced by the queued run, the caller may release them once this function returned.
+ * Releasing the session waits for the queued runs, so callback must not release it.
+ */
+ORT_API_STATUS(OrtRunAsync, _Inout_ OrtSession* sess,
+               _In_opt_ OrtRunOptions* run_options,
+               _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+               _In_ const char* const* output_names, size_t output_names_len,
+               _In_ OrtRunAsyncCallback callback, _In_opt_ void* user_data);
+
 /**
  * \return A pointer of the newly created object. The pointer should be freed by OrtReleaseSessionOptions after use
  */
@@ -213,6 +252,34 @@ ORT_API(void, OrtDisableMemPattern, _In_ OrtSessionOptions* options);
 ORT_API(void, OrtEnableCpuMemArena, _In_ OrtSessionOptions* options);
 ORT_API(void, OrtDisableCpuMemArena, _In_ OrtSessionOptions* options);
 
+// Share the initializers (weights) on CPU with the other sessions enabling it: identical weights of different
+// models are only held once in the process. Disabled by default.
+ORT_API(void, OrtEnableInitializerSharing, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableInitializerSharing, _In_ OrtSessionOptions* options);
+
+// Evaluate the nodes with constant inputs once when initializing the session. Enabled by default.
+ORT_API(void, OrtEnableConstantFolding, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableConstantFolding, _In_ OrtSessionOptions* options);
+
+// Push the Transpose nodes through the ops not depending on the layout and remove the ones cancelling each
+// other when initializing the session. Enabled by default.
+ORT_API(void, OrtEnableTransposeOptimization, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableTransposeOptimization, _In_ OrtSessionOptions* options);
+
+// Merge the nodes computing the same values from the same inputs when initializing the session, before the
+// other graph transformers run. Enabled by default.
+ORT_API(void, OrtEnableCommonSubexpressionElimination, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableCommonSubexpressionElimination, _In_ OrtSessionOptions* options);
+
+// Apply the rewrite rules of onnxruntime, such as removing the Identity nodes, when initializing the session.
+// Enabled by default.
+ORT_API(void, OrtEnableRuleBasedOptimization, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableRuleBasedOptimization, _In_ OrtSessionOptions* options);
+
+// Cache the models optimized by the graph transformers in cache_dir. A session finding the optimized version of
+// its model there skips the transformers when initializing. An empty cache_dir disables the cache (default).
+ORT_API(void, OrtSetOptimizedModelCacheDir, _In_ OrtSessionOptions* options, _In_ const char* cache_dir);
+
 // < logger id to use for session output
 ORT_API(void, OrtSetSessionLogId, _In_ OrtSessionOptions* options, const char* logid);
 
@@ -318,6 +385,37 @@ ORT_API_STATUS(OrtGetStringTensorDataLength, _In_ const OrtValue* value, _Out_ s
 ORT_API_STATUS(OrtGetStringTensorContent, _In_ const OrtValue* value, _Out_ void* s, size_t s_len,
                _Out_ size_t* offsets, size_t offsets_len);
 
+/**
+ * Create a string tensor whose strings are packed in one buffer allocated from allocator, instead of
+ * one allocation per string. It can be fed to and fetched from OrtRun like a tensor created by
+ * OrtCreateTensorAsOrtValue with ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING.
+ * \param s s_len strings, null terminated, copied into the tensor. s_len must be the element count of shape.
+ * \param out Should be freed by calling OrtReleaseValue
+ */
+ORT_API_STATUS(OrtCreatePackedStringTensorAsOrtValue, _Inout_ OrtAllocator* allocator,
+               _In_ const size_t* shape, size_t shape_len, _In_ const char* const* s, size_t s_len,
+               _Out_ OrtValue** out);
+
+/**
+ * Create a packed string tensor with user's buffers, laid out as OrtGetStringTensorContent returns them.
+ * s and offsets are owned by caller. OrtReleaseValue won't release them.
+ * When it is given to OrtRun as an output, the strings are written to a buffer owned by the tensor instead.
+ * \param s string contents. Each string is NOT null-terminated.
+ * \param offsets offset of each string in s. offsets_len must be the element count of shape.
+ * \param out Should be freed by calling OrtReleaseValue
+ */
+ORT_API_STATUS(OrtCreatePackedStringTensorWithDataAsOrtValue, _In_ void* s, size_t s_len,
+               _In_ size_t* offsets, size_t offsets_len, _In_ const size_t* shape, size_t shape_len,
+               _Out_ OrtValue** out);
+
+/**
+ * Get the buffers of a packed string tensor without copying them.
+ * They are only valid until the backing OrtValue is free'd.
+ * \param value A tensor created from OrtCreatePackedStringTensor... function.
+ */
+ORT_API_STATUS(OrtGetPackedStringTensorContent, _In_ const OrtValue* value, _Out_ const void** s, _Out_ size_t* s_len,
+               _Out_ const size_t** offsets, _Out_ size_t* offsets_len);
+
 ORT_API_STATUS(OrtTensorProtoToOrtValue, _Inout_ OrtAllocator* allocator,
                _In_ const void* input, int input_len, _Out_ OrtValue** out);
 
@@ -118,6 +118,11 @@ class SessionOptionsWrapper {
     return ret;
   }
 #endif
+  OrtSession* OrtCreateSessionFromArray(_In_ const void* model_data, size_t model_data_len) {
+    OrtSession* ret;
+    ORT_THROW_ON_ERROR(::OrtCreateSessionFromArray(env_, model_data, model_data_len, value.get(), &ret));
+    return ret;
+  }
   void AppendCustomOpLibPath(_In_ const char* lib_path) {
     OrtAppendCustomOpLibPath(value.get(), lib_path);
   }
@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/attention.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/util/math.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    Attention,
+    1,
+    float,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    Attention<float>);
+
+// Replace each row of scores by its softmax.
+static void SoftmaxRows(float* scores, int rows, int columns) {
+  for (int row = 0; row < rows; ++row) {
+    float* x = scores + row * columns;
+    const float max = *std::max_element(x, x + columns);
+    float sum = 0;
+    for (int i = 0; i < columns; ++i) {
+      x[i] = std::exp(x[i] - max);
+      sum += x[i];
+    }
+    const float inv_sum = 1 / sum;
+    for (int i = 0; i < columns; ++i) {
+      x[i] *= inv_sum;
+    }
+  }
+}
+
+template <>
+Status Attention<float>::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* weight = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+  const Tensor* mask = context->Input<Tensor>(3);
+
+  const auto& dims = input->Shape().GetDims();
+  if (dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Attention: input must have 3 dimensions, got ",
+                           input->Shape());
+  }
+  const int batch_size = static_cast<int>(dims[0]);
+  const int sequence_length = static_cast<int>(dims[1]);
+  const int hidden_size = static_cast<int>(dims[2]);
+  if (hidden_size % num_heads_ != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Attention: the hidden size ", hidden_size,
+                           " is not a multiple of num_heads ", num_heads_);
+  }
+  if (weight->Shape() != TensorShape({hidden_size, 3 * hidden_size}) ||
+      bias->Shape() != TensorShape({3 * hidden_size})) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Attention: weight ", weight->Shape(), " and bias ",
+                           bias->Shape(), " do not match the hidden size ", hidden_size);
+  }
+  if (mask != nullptr && mask->Shape().Size() != static_cast<int64_t>(batch_size) * sequence_length) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Attention: mask ", mask->Shape(),
+                           " must have batch_size x sequence_length elements");
+  }
+
+  const int num_heads = static_cast<int>(num_heads_);
+  const int head_size = hidden_size / num_heads;
+  const int qkv_size = 3 * hidden_size;
+  const int num_tokens = batch_size * sequence_length;
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  // Q, K and V of each token side by side: the row of a token holds qkv_size values
+  BufferUniquePtr qkv_buffer(alloc->Alloc(sizeof(float) * num_tokens * qkv_size), BufferDeleter(alloc));
+  float* qkv = static_cast<float*>(qkv_buffer.get());
+  const float* bias_data = bias->template Data<float>();
+  for (int token = 0; token < num_tokens; ++token) {
+    std::copy(bias_data, bias_data + qkv_size, qkv + token * qkv_size);
+  }
+  math::Gemm<float, CPUMathUtil>(CblasNoTrans, CblasNoTrans, num_tokens, qkv_size, hidden_size, 1.f,
+                                 input->template Data<float>(), weight->template Data<float>(), 1.f, qkv,
+                                 &CPUMathUtil::Instance());
+
+  // the scores of each (batch, head) pair, computed in parallel
+  const int num_scores = sequence_length * sequence_length;
+  BufferUniquePtr scores_buffer(alloc->Alloc(sizeof(float) * batch_size * num_heads * num_scores),
+                                BufferDeleter(alloc));
+  float* scores_data = static_cast<float*>(scores_buffer.get());
+  const float* mask_data = mask != nullptr ? mask->template Data<float>() : nullptr;
+  float* output_data = context->Output(0, input->Shape())->template MutableData<float>();
+  const float scale = 1.f / std::sqrt(static_cast<float>(head_size));
+
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < batch_size * num_heads; ++i) {
+    const int batch = i / num_heads;
+    const int head = i % num_heads;
+    const float* q = qkv + batch * sequence_length * qkv_size + head * head_size;
+    const float* k = q + hidden_size;
+    const float* v = k + hidden_size;
+    float* scores = scores_data + i * num_scores;
+
+    // scores = Q * K^T / sqrt(head_size) + mask
+    math::GemmEx<float, CPUMathUtil>(CblasNoTrans, CblasTrans, sequence_length, sequence_length, head_size, scale,
+                                     q, qkv_size, k, qkv_size, 0.f, scores, sequence_length,
+                                     &CPUMathUtil::Instance());
+    if (mask_data != nullptr) {
+      const float* batch_mask = mask_data + batch * sequence_length;
+      for (int row = 0; row < sequence_length; ++row) {
+        float* row_scores = scores + row * sequence_length;
+        for (int column = 0; column < sequence_length; ++column) {
+          row_scores[column] += batch_mask[column];
+        }
+      }
+    }
+    SoftmaxRows(scores, sequence_length, sequence_length);
+
+    // the context of the head goes to its columns of the output
+    math::GemmEx<float, CPUMathUtil>(CblasNoTrans, CblasNoTrans, sequence_length, head_size, sequence_length, 1.f,
+                                     scores, sequence_length, v, qkv_size, 0.f,
+                                     output_data + batch * sequence_length * hidden_size + head * head_size,
+                                     hidden_size, &CPUMathUtil::Instance());
+  }
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
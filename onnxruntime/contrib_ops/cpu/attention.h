@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+/*
+Multi-head self attention in a single node: the query, key and value projections are one GEMM, and
+the scaled scores, their softmax and the context of each head are computed in a buffer of
+sequence_length x sequence_length instead of the full tensors of the unfused graph.
+*/
+template <typename T>
+class Attention final : public OpKernel {
+ public:
+  explicit Attention(const OpKernelInfo& info) : OpKernel(info) {
+    ORT_ENFORCE(info.GetAttr("num_heads", &num_heads_).IsOK() && num_heads_ > 0,
+                "Attention requires a positive num_heads attribute");
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t num_heads_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
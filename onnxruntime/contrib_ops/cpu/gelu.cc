@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/gelu.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    Gelu,
+    1,
+    float,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0),
+    Gelu<float>);
+
+template <typename T>
+Status Gelu<T>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const T* x_data = X->template Data<T>();
+  T* y_data = context->Output(0, X->Shape())->template MutableData<T>();
+  const int64_t size = X->Shape().Size();
+
+  // blocks of contiguous elements, large enough for the loops to be vectorized
+  static constexpr int64_t block_size = 4096;
+  const int64_t num_blocks = (size + block_size - 1) / block_size;
+  const T one_over_sqrt_2 = static_cast<T>(0.70710678118654752440);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+  for (int64_t block = 0; block < num_blocks; ++block) {
+    const int64_t begin = block * block_size;
+    const int64_t end = std::min(begin + block_size, size);
+    for (int64_t i = begin; i < end; ++i) {
+      const T x = x_data[i];
+      y_data[i] = static_cast<T>(0.5) * x * (1 + std::erf(x * one_over_sqrt_2));
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
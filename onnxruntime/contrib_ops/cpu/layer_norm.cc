@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/layer_norm.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    LayerNormalization,
+    1,
+    float,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    LayerNorm<float>);
+
+template <typename T>
+Status LayerNorm<T>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* scale = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+  const TensorShape& x_shape = X->Shape();
+  const int64_t axis = HandleNegativeAxis(axis_, x_shape.NumDimensions());
+  const int64_t num_rows = x_shape.SizeToDimension(axis);
+  const int64_t row_size = x_shape.SizeFromDimension(axis);
+  if (scale->Shape().Size() != row_size || bias->Shape().Size() != row_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "LayerNormalization: scale and B must have ", row_size,
+                           " elements, the size of the normalized dimensions of X ", x_shape);
+  }
+
+  const T* x_data = X->template Data<T>();
+  const T* scale_data = scale->template Data<T>();
+  const T* bias_data = bias->template Data<T>();
+  T* y_data = context->Output(0, x_shape)->template MutableData<T>();
+
+  // the mean and variance of a row are computed in a single pass over it
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+  for (int64_t row = 0; row < num_rows; ++row) {
+    const T* x = x_data + row * row_size;
+    T* y = y_data + row * row_size;
+
+    double sum = 0;
+    double sum_of_squares = 0;
+    for (int64_t i = 0; i < row_size; ++i) {
+      sum += x[i];
+      sum_of_squares += static_cast<double>(x[i]) * x[i];
+    }
+    const double mean = sum / row_size;
+    const double variance = std::max(sum_of_squares / row_size - mean * mean, 0.0);
+    const T inv_std_dev = static_cast<T>(1 / std::sqrt(variance + epsilon_));
+    const T shift = static_cast<T>(-mean) * inv_std_dev;
+
+    for (int64_t i = 0; i < row_size; ++i) {
+      y[i] = (x[i] * inv_std_dev + shift) * scale_data[i] + bias_data[i];
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
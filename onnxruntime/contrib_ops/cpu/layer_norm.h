@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+template <typename T>
+class LayerNorm final : public OpKernel {
+ public:
+  explicit LayerNorm(const OpKernelInfo& info) : OpKernel(info),
+                                                 axis_(info.GetAttrOrDefault<int64_t>("axis", -1)),
+                                                 epsilon_(info.GetAttrOrDefault<float>("epsilon", 1e-5f)) {
+    ORT_ENFORCE(epsilon_ >= 0, "epsilon must be non-negative");
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t axis_;
+  float epsilon_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
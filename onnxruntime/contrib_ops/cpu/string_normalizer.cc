@@ -4,14 +4,11 @@
 #include "string_normalizer.h"
 #include "onnx/defs/schema.h"
 #include "core/common/common.h"
+#include "core/common/utf8_util.h"
 #include "core/framework/tensor.h"
 
-#ifdef _MSC_VER
-#include <locale.h>
-#endif
-
-#include <codecvt>
-#include <locale>
+#include <cassert>
+#include <cstring>
 #include <functional>
 #include <unordered_set>
 
@@ -27,124 +24,258 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
     contrib::StringNormalizer);
 
 namespace string_normalizer {
-const std::string conv_error("Conversion Error");
-const std::wstring wconv_error(L"Conversion Error");
 
-// We need to specialize for MS as there is
-// a std::locale creation bug that affects different
-// environments in a different way
-#ifdef _MSC_VER
+// Case mapping is locale independent and table driven. It covers the simple (one to one)
+// Unicode mappings of Latin, Greek, Cyrillic, Armenian and fullwidth Latin letters.
+// Other code points, and characters whose full mapping expands (e.g. german eszett),
+// are left unchanged. None of the mappings below needs more UTF-8 bytes than its
+// source, which lets us change case in place.
+struct CaseRange {
+  char32_t upper_first;
+  char32_t upper_last;
+  // lower = upper + delta
+  int32_t delta;
+  // Upper and lower case letters alternate: upper_first, upper_first + 1 (lower), ...
+  bool alternating;
+};
+
+const CaseRange case_ranges[] = {
+    {0x0041, 0x005A, 0x20, false},
+    {0x00C0, 0x00D6, 0x20, false},
+    {0x00D8, 0x00DE, 0x20, false},
+    {0x0100, 0x012F, 1, true},
+    {0x0132, 0x0137, 1, true},
+    {0x0139, 0x0148, 1, true},
+    {0x014A, 0x0177, 1, true},
+    {0x0178, 0x0178, -0x79, false},
+    {0x0179, 0x017E, 1, true},
+    {0x0386, 0x0386, 0x26, false},
+    {0x0388, 0x038A, 0x25, false},
+    {0x038C, 0x038C, 0x40, false},
+    {0x038E, 0x038F, 0x3F, false},
+    {0x0391, 0x03A1, 0x20, false},
+    {0x03A3, 0x03AB, 0x20, false},
+    {0x0400, 0x040F, 0x50, false},
+    {0x0410, 0x042F, 0x20, false},
+    {0x0460, 0x0481, 1, true},
+    {0x048A, 0x04BF, 1, true},
+    {0x04C0, 0x04C0, 0x0F, false},
+    {0x04C1, 0x04CE, 1, true},
+    {0x04D0, 0x052F, 1, true},
+    {0x0531, 0x0556, 0x30, false},
+    {0x1E00, 0x1E95, 1, true},
+    {0x1EA0, 0x1EFF, 1, true},
+};
+
+// Mappings that only go one way
+struct CaseSingle {
+  char32_t from;
+  char32_t to;
+};
+
+const CaseSingle to_upper_singles[] = {
+    {0x00B5, 0x039C},  // micro sign
+    {0x0131, 0x0049},  // dotless i
+    {0x017F, 0x0053},  // long s
+    {0x03C2, 0x03A3},  // final sigma
+};
+
+const CaseSingle to_lower_singles[] = {
+    {0x0130, 0x0069},  // capital I with dot above
+};
+
+// Fullwidth Latin is the only mapped range above the flat tables
+const char32_t fullwidth_upper_first = 0xFF21;
+const char32_t fullwidth_upper_last = 0xFF3A;
+const char32_t fullwidth_delta = 0x20;
+
+size_t Utf8Length(char32_t cp) {
+  return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+}
 
-class Locale {
+class CaseTables {
  public:
-  explicit Locale(const std::string& name)
-      : loc_(nullptr) {
-    loc_ = _create_locale(LC_CTYPE, name.c_str());
-    if (loc_ == nullptr) {
-      ORT_THROW("Failed to construct locale with name:",
-                name, ":", ":Please, install necessary language-pack-XX and configure locales");
-    }
-  }
+  static constexpr char32_t kFlatLimit = 0x2000;
 
-  ~Locale() {
-    if (loc_ != nullptr) {
-      _free_locale(loc_);
-    }
+  static const CaseTables& Instance() {
+    static const CaseTables tables;
+    return tables;
   }
 
-  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Locale);
-
-  void ChangeCase(StringNormalizer::CaseAction caseaction,
-                  std::wstring& wstr) const {
-    assert(caseaction != StringNormalizer::NONE);
+  char32_t Map(StringNormalizer::CaseAction caseaction, char32_t cp) const {
+    if (cp < kFlatLimit) {
+      return (caseaction == StringNormalizer::LOWER) ? to_lower_[cp] : to_upper_[cp];
+    }
     if (caseaction == StringNormalizer::LOWER) {
-      std::transform(wstr.begin(), wstr.end(), wstr.begin(),
-                     [this](wchar_t ch) { return ::_towlower_l(ch, loc_); });
+      if (cp >= fullwidth_upper_first && cp <= fullwidth_upper_last) return cp + fullwidth_delta;
     } else {
-      std::transform(wstr.begin(), wstr.end(), wstr.begin(),
-                     [this](wchar_t ch) { return ::_towupper_l(ch, loc_); });
+      if (cp >= fullwidth_upper_first + fullwidth_delta && cp <= fullwidth_upper_last + fullwidth_delta) {
+        return cp - fullwidth_delta;
+      }
     }
+    return cp;
+  }
+
+  const uint16_t* Table(StringNormalizer::CaseAction caseaction) const {
+    return (caseaction == StringNormalizer::LOWER) ? to_lower_ : to_upper_;
   }
 
  private:
-  _locale_t loc_;
+  CaseTables() {
+    for (char32_t cp = 0; cp < kFlatLimit; ++cp) {
+      to_lower_[cp] = to_upper_[cp] = static_cast<uint16_t>(cp);
+    }
+    for (const auto& r : case_ranges) {
+      for (char32_t upper = r.upper_first; upper <= r.upper_last; upper += r.alternating ? 2 : 1) {
+        Set(to_lower_, upper, upper + r.delta);
+        Set(to_upper_, upper + r.delta, upper);
+      }
+    }
+    for (const auto& s : to_upper_singles) Set(to_upper_, s.from, s.to);
+    for (const auto& s : to_lower_singles) Set(to_lower_, s.from, s.to);
+  }
+
+  static void Set(uint16_t* table, char32_t from, char32_t to) {
+    ORT_ENFORCE(from < kFlatLimit && to < kFlatLimit && Utf8Length(to) <= Utf8Length(from),
+                "Invalid case mapping table entry");
+    table[from] = static_cast<uint16_t>(to);
+  }
+
+  uint16_t to_lower_[kFlatLimit];
+  uint16_t to_upper_[kFlatLimit];
 };
 
-const std::string default_locale("en-US");
+constexpr char32_t CaseTables::kFlatLimit;
+
+// Changes the case of eight ASCII characters packed in a word at once.
+// Every byte must be < 0x80 so the additions below never carry into the next byte.
+inline uint64_t ChangeCaseAscii8(StringNormalizer::CaseAction caseaction, uint64_t word) {
+  const uint64_t ones = 0x0101010101010101ULL;
+  // Bytes >= first get their high bit set by the first addition,
+  // bytes > last by the second one.
+  const uint64_t first = (caseaction == StringNormalizer::LOWER) ? 'A' : 'a';
+  const uint64_t last = (caseaction == StringNormalizer::LOWER) ? 'Z' : 'z';
+  const uint64_t ge_first = word + ones * (0x80 - first);
+  const uint64_t gt_last = word + ones * (0x80 - last - 1);
+  const uint64_t in_range = ge_first & ~gt_last & (ones * 0x80);
+  // 0x80 >> 2 == 0x20 which is the case bit of ASCII letters
+  return word ^ (in_range >> 2);
+}
 
-#else
-class Locale {
- public:
-  explicit Locale(const std::string& name) try : loc_(name) {
-  } catch (const std::runtime_error& e) {
-    ORT_THROW("Failed to construct locale with name:",
-              name, ":", e.what(), ":Please, install necessary language-pack-XX and configure locales");
+inline char32_t DecodeUtf8(const unsigned char* s, size_t bytes) {
+  switch (bytes) {
+    case 2:
+      return ((s[0] & 0x1Fu) << 6) | (s[1] & 0x3Fu);
+    case 3:
+      return ((s[0] & 0x0Fu) << 12) | ((s[1] & 0x3Fu) << 6) | (s[2] & 0x3Fu);
+    default:
+      return ((s[0] & 0x07u) << 18) | ((s[1] & 0x3Fu) << 12) | ((s[2] & 0x3Fu) << 6) | (s[3] & 0x3Fu);
   }
+}
 
-  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Locale);
+inline size_t EncodeUtf8(char32_t cp, char* out) {
+  if (cp < 0x80) {
+    out[0] = static_cast<char>(cp);
+    return 1;
+  }
+  if (cp < 0x800) {
+    out[0] = static_cast<char>(0xC0 | (cp >> 6));
+    out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 2;
+  }
+  if (cp < 0x10000) {
+    out[0] = static_cast<char>(0xE0 | (cp >> 12));
+    out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 3;
+  }
+  out[0] = static_cast<char>(0xF0 | (cp >> 18));
+  out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+  out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+  out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+  return 4;
+}
 
-  void ChangeCase(StringNormalizer::CaseAction caseaction,
-                  std::wstring& wstr) const {
-    assert(caseaction != StringNormalizer::NONE);
-    if (caseaction == StringNormalizer::LOWER) {
-      std::transform(wstr.begin(), wstr.end(), wstr.begin(),
-                     [this](wchar_t ch) { return std::tolower(ch, loc_); });
-    } else {
-      std::transform(wstr.begin(), wstr.end(), wstr.begin(),
-                     [this](wchar_t ch) { return std::toupper(ch, loc_); });
-    }
+// Changes the case of a UTF-8 string in place.
+// Returns false if the string is not valid UTF-8, the contents are unspecified in that case.
+bool ChangeCase(StringNormalizer::CaseAction caseaction, std::string& str) {
+  assert(caseaction != StringNormalizer::NONE);
+  const size_t len = str.size();
+  if (len == 0) {
+    return true;
   }
 
- private:
-  std::locale loc_;
-};
+  const CaseTables& tables = CaseTables::Instance();
+  const uint16_t* const ascii_table = tables.Table(caseaction);
+  char* const data = &str[0];
+  // Mapped characters never get longer so the write position never passes the read position
+  size_t w = 0;
+  size_t r = 0;
+  while (r < len) {
+    if (len - r >= sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, data + r, sizeof(word));
+      if ((word & 0x8080808080808080ULL) == 0) {
+        word = ChangeCaseAscii8(caseaction, word);
+        memcpy(data + w, &word, sizeof(word));
+        r += sizeof(word);
+        w += sizeof(word);
+        continue;
+      }
+    }
 
-const std::string default_locale("en_US.UTF-8");
+    const auto ch = static_cast<unsigned char>(data[r]);
+    if (ch < 0x80) {
+      data[w++] = static_cast<char>(ascii_table[ch]);
+      ++r;
+      continue;
+    }
 
-#endif
+    size_t bytes = 0;
+    size_t utf8_chars = 0;
+    const auto* src = reinterpret_cast<const unsigned char*>(data + r);
+    if (!utf8_util::utf8_bytes(ch, bytes) || bytes > len - r ||
+        !utf8_util::utf8_validate(src, bytes, utf8_chars)) {
+      return false;
+    }
+    const char32_t mapped = tables.Map(caseaction, DecodeUtf8(src, bytes));
+    w += EncodeUtf8(mapped, data + w);
+    r += bytes;
+  }
+  str.resize(w);
+  return true;
+}
 
-template <class ForwardIter>
-Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
-                      const Locale& loc,
-                      std::wstring_convert<std::codecvt_utf8<wchar_t>>& converter,
-                      size_t N, size_t C,
-                      StringNormalizer::CaseAction caseaction) {
+Tensor* AllocateOutput(OpKernelContext* ctx, size_t N, size_t C) {
   std::vector<int64_t> output_dims;
   if (N == 1) {
     output_dims.push_back(1);
   }
+  // Empty output case: this will create one empty string
+  output_dims.push_back(C == 0 ? 1 : static_cast<int64_t>(C));
+  TensorShape output_shape(output_dims);
+  return ctx->Output(0, output_shape);
+}
 
-  // Empty output case
+template <class ForwardIter>
+Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
+                      size_t N, size_t C,
+                      StringNormalizer::CaseAction caseaction) {
+  auto output_tensor = AllocateOutput(ctx, N, C);
   if (C == 0) {
-    output_dims.push_back(1);
-    TensorShape output_shape(output_dims);
-    // This will create one empty string
-    ctx->Output(0, output_shape);
     return Status::OK();
   }
 
-  output_dims.push_back(C);
-
-  TensorShape output_shape(output_dims);
-  auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->template MutableData<std::string>();
-
   size_t output_idx = 0;
   while (first != end) {
     auto& s = *first;
-    if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
-      std::wstring wstr = converter.from_bytes(s);
-      if (wstr == wconv_error) {
-        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                      "Input contains invalid utf8 chars at: " + static_cast<const std::string&>(s));
-      }
-      // In place transform
-      loc.ChangeCase(caseaction, wstr);
-      *(output_data + output_idx) = converter.to_bytes(wstr);
-    } else {
-      assert(caseaction == StringNormalizer::NONE);
-      // Simple copy or move if the iterator points to a non-const string
-      *(output_data + output_idx) = std::move(s);
+    std::string& output = *(output_data + output_idx);
+    // Simple copy or move if the iterator points to a non-const string
+    output = std::move(s);
+    if (caseaction != StringNormalizer::NONE && !ChangeCase(caseaction, output)) {
+      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                    "Input contains invalid utf8 chars at: " + static_cast<const std::string&>(s));
     }
     ++output_idx;
     ++first;
@@ -182,24 +313,19 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
     compare_caseaction_ = (casechangeaction_ == UPPER) ? UPPER : LOWER;
   }
 
-  locale_name_ = info.GetAttrOrDefault("locale", default_locale);
-  Locale locale(locale_name_);
-  std::wstring_convert<std::codecvt_utf8<wchar_t>> converter(conv_error, wconv_error);
+  // The optional locale attribute is accepted for compatibility only,
+  // case mapping does not depend on the locales installed on the machine.
 
   std::vector<std::string> swords = info.GetAttrsOrDefault<std::string>("stopwords");
-  for (const auto& sw : swords) {
+  std::unordered_set<std::string> unique_words;
+  for (auto& sw : swords) {
     ORT_ENFORCE(!sw.empty(), "Empty stopwords not allowed");
-    if (is_case_sensitive_) {
-      auto p = stopwords_.insert(sw);
-      ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
-    } else {
-      std::wstring wstr = converter.from_bytes(sw);
-      ORT_ENFORCE(wstr != wconv_error, "Stopword contains invalid utf8 chars");
-      locale.ChangeCase(compare_caseaction_, wstr);
-      auto p = wstopwords_.insert(wstr);
-      ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
+    if (!is_case_sensitive_) {
+      ORT_ENFORCE(ChangeCase(compare_caseaction_, sw), "Stopword contains invalid utf8 chars");
     }
+    ORT_ENFORCE(unique_words.insert(sw).second, "Duplicate stopwords not allowed");
   }
+  stopwords_ = PerfectHashIndex<std::string>(swords);
 }
 
 Status StringNormalizer::Compute(OpKernelContext* ctx) const {
@@ -229,71 +355,64 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
                   "Input dimensions are either[C > 0] or [1][C > 0] allowed");
   }
 
-  Status status;
-  Locale locale(locale_name_);
-  std::wstring_convert<std::codecvt_utf8<wchar_t>> converter(conv_error, wconv_error);
   auto const input_data = X->template Data<std::string>();
+  if (stopwords_.empty()) {
+    // Nothing to filter. Copy input to output and change case if needed
+    return CopyCaseAction(input_data, input_data + C, ctx, N, C, casechangeaction_);
+  }
+
   using StrRef = std::reference_wrapper<const std::string>;
+  auto first = input_data;
+  auto const last = input_data + C;
   if (is_case_sensitive_) {
-    if (!stopwords_.empty()) {
-      std::vector<StrRef> filtered_strings;
-      filtered_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
-        if (0 == stopwords_.count(s)) {
-          filtered_strings.push_back(std::cref(s));
-        }
-        ++first;
+    std::vector<StrRef> filtered_strings;
+    filtered_strings.reserve(C);
+    while (first != last) {
+      const std::string& s = *first;
+      if (!stopwords_.Contains(s)) {
+        filtered_strings.push_back(std::cref(s));
       }
-      status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale, converter,
-                              N, filtered_strings.size(), casechangeaction_);
-    } else {
-      // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, casechangeaction_);
+      ++first;
     }
-  } else {
-    if (!wstopwords_.empty()) {
-      // Filter input. When no case action is required
-      // we simply store original string references.
-      // Otherwise, we store converted strings.
-      std::vector<StrRef> filtered_orignal_strings;
-      std::vector<std::string> filtered_cased_strings;
-      filtered_orignal_strings.reserve(C);
-      filtered_cased_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
-        std::wstring wstr = converter.from_bytes(s);
-        if (wstr == wconv_error) {
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Input contains invalid utf8 chars at: " + s);
-        }
-        locale.ChangeCase(compare_caseaction_, wstr);
-        if (0 == wstopwords_.count(wstr)) {
-          if (casechangeaction_ == NONE) {
-            filtered_orignal_strings.push_back(std::cref(s));
-          } else {
-            filtered_cased_strings.push_back(converter.to_bytes(wstr));
-          }
-        }
-        ++first;
+    return CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx,
+                          N, filtered_strings.size(), casechangeaction_);
+  }
+
+  // Filter input. When no case action is required
+  // we simply store original string references.
+  // Otherwise, the compare case is also the output case so we keep the converted strings.
+  std::vector<StrRef> filtered_orignal_strings;
+  std::vector<std::string> filtered_cased_strings;
+  std::string compare_buffer;
+  while (first != last) {
+    const std::string& s = *first;
+    if (casechangeaction_ == NONE) {
+      compare_buffer.assign(s);
+      if (!ChangeCase(compare_caseaction_, compare_buffer)) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Input contains invalid utf8 chars at: " + s);
       }
-      if (casechangeaction_ == NONE) {
-        status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale, converter,
-                                N, filtered_orignal_strings.size(), NONE);
-      } else {
-        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale, converter,
-                                N, filtered_cased_strings.size(), NONE);
+      if (!stopwords_.Contains(compare_buffer)) {
+        filtered_orignal_strings.push_back(std::cref(s));
       }
     } else {
-      // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, casechangeaction_);
+      std::string cased(s);
+      if (!ChangeCase(compare_caseaction_, cased)) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Input contains invalid utf8 chars at: " + s);
+      }
+      if (!stopwords_.Contains(cased)) {
+        filtered_cased_strings.push_back(std::move(cased));
+      }
     }
+    ++first;
+  }
+  if (casechangeaction_ == NONE) {
+    return CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx,
+                          N, filtered_orignal_strings.size(), NONE);
   }
-  return status;
+  return CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx,
+                        N, filtered_cased_strings.size(), NONE);
 }
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -3,11 +3,10 @@
 
 #pragma once
 
+#include "core/common/perfect_hash.h"
 #include "core/framework/op_kernel.h"
 
-#include <locale>
 #include <string>
-#include <unordered_set>
 
 namespace onnxruntime {
 namespace contrib {
@@ -29,10 +28,8 @@ class StringNormalizer : public OpKernel {
   bool is_case_sensitive_;
   CaseAction casechangeaction_;
   CaseAction compare_caseaction_;  // used for case-insensitive compare
-  std::string locale_name_;
-  // Either if these are populated but not both
-  std::unordered_set<std::string> stopwords_;
-  std::unordered_set<std::wstring> wstopwords_;
+  // Stored already case-folded with compare_caseaction_ when !is_case_sensitive_
+  PerfectHashIndex<std::string> stopwords_;
 };
 
 }  // namespace contrib
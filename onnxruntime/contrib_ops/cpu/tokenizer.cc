@@ -4,6 +4,7 @@
 #include "tokenizer.h"
 #include "onnx/defs/schema.h"
 #include "core/common/common.h"
+#include "core/framework/packed_string_tensor.h"
 #include "core/framework/tensor.h"
 
 #include "core/common/utf8_util.h"
@@ -21,7 +22,9 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
     1,
     string,
     KernelDefBuilder()
-        .TypeConstraint("T", DataTypeImpl::GetTensorType<std::string>()),
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<std::string>())
+        .InputValueType(0, {DataTypeImpl::GetType<PackedStringTensor>()})
+        .OutputValueType(0, {DataTypeImpl::GetType<PackedStringTensor>()}),
     contrib::Tokenizer);
 
 namespace tokenizer_details {
@@ -241,83 +244,64 @@ Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
 Tokenizer ::~Tokenizer() {
 }
 
-Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
+Status Tokenizer::CharTokenize(OpKernelContext* ctx, const std::vector<StringRef>& input,
                                const std::vector<int64_t>& input_dims) const {
   // With char tokenzation we get as many tokens as the number of
   // utf8 characters in the string. So for every string we calculate its character(utf8) length
   // add padding and add start/end test separators if necessary
   size_t max_tokens = 0;
-  auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
+  for (const auto& s : input) {
     size_t tokens = 0;  // length in utf8 chars
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data_), s.size_,
                        tokens)) {
       return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
+                    "Input string contains invalid utf8 chars: " + std::string(s.data_, s.size_));
     }
     if (mark_) {
       tokens += 2;  // Start/end markers as separate tokens
     }
     max_tokens = std::max(max_tokens, tokens);
-    ++curr_input;
   }
 
   std::vector<int64_t> output_dims(input_dims);
   // Check if we have no output due to apparently empty strings input.
   if ((max_tokens - mark_ * 2) == 0) {
     output_dims.push_back(0);
-    TensorShape output_shape(output_dims);
-    ctx->Output(0, output_shape);
-    return Status::OK();
+    return WriteOutput(ctx, TensorShape(output_dims), {});
   }
 
   output_dims.push_back(max_tokens);
-  TensorShape output_shape(output_dims);
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
-  size_t output_index = 0;
-  curr_input = input_data;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
+  std::vector<StringRef> output;
+  output.reserve(input.size() * max_tokens);
+  for (const auto& s : input) {
     if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
+      output.push_back({&start_text, 1});
     }
     size_t tokens = 0;
-    const size_t str_len = s.size();
-    for (size_t token_idx = 0; token_idx < str_len;) {
+    for (size_t token_idx = 0; token_idx < s.size_;) {
       size_t tlen = 0;
-      bool result = utf8_bytes(static_cast<unsigned char>(s[token_idx]), tlen);
+      bool result = utf8_bytes(static_cast<unsigned char>(s.data_[token_idx]), tlen);
       assert(result);
       (void)result;
-      assert(token_idx + tlen <= str_len);
-      *(output_data + output_index) = s.substr(token_idx, tlen);
-      ++output_index;
+      assert(token_idx + tlen <= s.size_);
+      output.push_back({s.data_ + token_idx, tlen});
       token_idx += tlen;
       ++tokens;
     }
     if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
+      output.push_back({&end_text, 1});
     }
     // Padding strings
     assert(tokens + (mark_ * 2) <= max_tokens);
     const size_t pads = max_tokens - (mark_ * 2) - tokens;
     for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
+      output.push_back({pad_value_.data(), pad_value_.size()});
     }
-    ++curr_input;
   }
-  return Status::OK();
+  return WriteOutput(ctx, TensorShape(output_dims), output);
 }
 
-Status Tokenizer::SeparatorTokenize(OpKernelContext* ctx,
-                                    size_t N, size_t C,
+Status Tokenizer::SeparatorTokenize(OpKernelContext* ctx, const std::vector<StringRef>& input,
                                     const std::vector<int64_t>& input_dims) const {
   struct Match {
     int priority_;
@@ -333,20 +317,20 @@ Status Tokenizer::SeparatorTokenize(OpKernelContext* ctx,
 
   std::wstring_convert<std::codecvt_utf8<wchar_t>> converter(conv_error, wconv_error);
   // Scan all strings and attempt to find separators in them
-  // collect all the output tokens here
+  // collect all the output tokens here. Tokens are kept as byte ranges
+  // of the input strings so that they are written without intermediate copies.
   size_t max_tokens = 0;
-  std::vector<std::vector<std::wstring>> tokenized_strings;
-  tokenized_strings.reserve(N * C);
-  auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    std::wstring wstr = converter.from_bytes(s);
+  std::vector<StringRef> tokens;
+  // End of each input string's tokens in tokens
+  std::vector<size_t> row_ends;
+  row_ends.reserve(input.size());
+  // Byte offset in the utf8 input of each wchar_t of the converted string
+  std::vector<size_t> byte_offsets;
+  for (const auto& s : input) {
+    std::wstring wstr = converter.from_bytes(s.data_, s.data_ + s.size_);
     if (wstr == wconv_error) {
       return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Invalid utf8 chars in the input: " + s);
+                    "Invalid utf8 chars in the input: " + std::string(s.data_, s.size_));
     }
 
     std::set<Match> matches;
@@ -369,32 +353,46 @@ Status Tokenizer::SeparatorTokenize(OpKernelContext* ctx,
       --len_remaining;
     }
 
+    // Map character positions back to the utf8 input.
+    // The input is valid utf8 since the conversion above succeeded.
+    byte_offsets.clear();
+    for (size_t byte_idx = 0; byte_idx < s.size_;) {
+      size_t clen = 0;
+      bool result = utf8_bytes(static_cast<unsigned char>(s.data_[byte_idx]), clen);
+      assert(result);
+      (void)result;
+      byte_offsets.push_back(byte_idx);
+      // Characters outside of BMP are surrogate pairs with 2 byte wchar_t
+      if (clen == 4 && sizeof(wchar_t) == 2) {
+        byte_offsets.push_back(byte_idx);
+      }
+      byte_idx += clen;
+    }
+    assert(byte_offsets.size() == wstr.length());
+    byte_offsets.push_back(s.size_);
+
     // Tokenize
-    tokenized_strings.emplace_back();
-    auto& row_tokens = tokenized_strings.back();
-    row_tokens.reserve(matches.size() + 1);
-    ws = wstr.c_str();
+    const size_t row_begin = tokens.size();
     offset = 0;
     for (const auto& m : matches) {
       assert(m.offset_ >= offset);
       size_t sz = (m.offset_ - offset);
       if (sz > 0 && sz >= size_t(mincharnum_)) {
-        row_tokens.emplace_back(ws, sz);
+        tokens.push_back({s.data_ + byte_offsets[offset], byte_offsets[m.offset_] - byte_offsets[offset]});
       }
       offset = m.offset_ + m.size_;
-      ws = wstr.c_str() + offset;
     }
     assert(offset <= wstr.length());
     if (offset < wstr.length()) {
-      row_tokens.emplace_back(ws, wstr.length() - offset);
+      tokens.push_back({s.data_ + byte_offsets[offset], s.size_ - byte_offsets[offset]});
     }
+    row_ends.push_back(tokens.size());
 
-    size_t tokens = row_tokens.size();
+    size_t row_tokens = tokens.size() - row_begin;
     if (mark_) {
-      tokens += 2;  // Start/end markers as separate tokens
+      row_tokens += 2;  // Start/end markers as separate tokens
     }
-    max_tokens = std::max(max_tokens, tokens);
-    ++curr_input;
+    max_tokens = std::max(max_tokens, row_tokens);
   }
 
   std::vector<int64_t> output_dims(input_dims);
@@ -402,77 +400,104 @@ Status Tokenizer::SeparatorTokenize(OpKernelContext* ctx,
   // everything is a separator
   if ((max_tokens - mark_ * 2) == 0) {
     output_dims.push_back(0);
-    TensorShape output_shape(output_dims);
-    ctx->Output(0, output_shape);
-    return Status::OK();
+    return WriteOutput(ctx, TensorShape(output_dims), {});
   }
 
   output_dims.push_back(max_tokens);
-  TensorShape output_shape(output_dims);
-
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
-
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  size_t output_index = 0;
-  for (auto& row : tokenized_strings) {
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
+  std::vector<StringRef> output;
+  output.reserve(input.size() * max_tokens);
+  size_t row_begin = 0;
+  for (size_t row = 0; row < row_ends.size(); ++row) {
+    const size_t row_end = row_ends[row];
     if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
+      output.push_back({&start_text, 1});
     }
     // Output tokens for this row
-    for (auto& token : row) {
-      *(output_data + output_index) = converter.to_bytes(token);
-      ++output_index;
-    }
+    output.insert(output.end(), tokens.begin() + row_begin, tokens.begin() + row_end);
     if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
+      output.push_back({&end_text, 1});
     }
-    const size_t pads = max_tokens - (mark_ * 2) - row.size();
+    const size_t pads = max_tokens - (mark_ * 2) - (row_end - row_begin);
     for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
+      output.push_back({pad_value_.data(), pad_value_.size()});
     }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
+    assert(output.size() == (row + 1) * max_tokens);
+    row_begin = row_end;
+  }
+  return WriteOutput(ctx, TensorShape(output_dims), output);
+}
+
+Status Tokenizer::WriteOutput(OpKernelContext* ctx, const TensorShape& output_shape,
+                              const std::vector<StringRef>& output) const {
+  assert(output.size() == static_cast<size_t>(output_shape.Size()));
+  if (ctx->OutputType(0) == DataTypeImpl::GetType<PackedStringTensor>()) {
+    size_t total_length = 0;
+    for (const auto& s : output) {
+      total_length += s.size_;
+    }
+    // the allocator of the provider, which the output tensors are allocated from too
+    AllocatorPtr allocator;
+    ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
+    auto* Y = ctx->Output<PackedStringTensor>(0);
+    Y->Reset(output_shape, total_length, allocator);
+    auto* const offsets = Y->MutableOffsets();
+    auto* const bytes = Y->MutableBytes();
+    size_t offset = 0;
+    for (size_t i = 0; i < output.size(); ++i) {
+      offsets[i] = offset;
+      if (output[i].size_ > 0) {
+        memcpy(bytes + offset, output[i].data_, output[i].size_);
+      }
+      offset += output[i].size_;
+    }
+    return Status::OK();
+  }
+
+  auto output_tensor = ctx->Output(0, output_shape);
+  auto const output_data = output_tensor->template MutableData<std::string>();
+  for (size_t i = 0; i < output.size(); ++i) {
+    // assign() reuses the buffer of the pre-constructed output string
+    output_data[i].assign(output[i].data_, output[i].size_);
   }
   return Status::OK();
 }
 
 Status Tokenizer::Compute(OpKernelContext* ctx) const {
-  // Get input buffer ptr
-  auto X = ctx->Input<Tensor>(0);
-  if (X == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
-  if (X->DataType() != DataTypeImpl::GetType<std::string>()) {
-    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                  "tensor(string) expected as input");
+  // The input is either a tensor of std::string or packed in one buffer by the caller
+  std::vector<StringRef> input;
+  const TensorShape* input_shape = nullptr;
+  if (ctx->InputType(0) == DataTypeImpl::GetType<PackedStringTensor>()) {
+    const auto* X = ctx->Input<PackedStringTensor>(0);
+    input_shape = &X->Shape();
+    input.reserve(X->Size());
+    for (size_t i = 0, end = X->Size(); i < end; ++i) {
+      input.push_back({X->Data(i), X->Length(i)});
+    }
+  } else {
+    auto X = ctx->Input<Tensor>(0);
+    if (X == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
+    if (X->DataType() != DataTypeImpl::GetType<std::string>()) {
+      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                    "tensor(string) expected as input");
+    }
+    input_shape = &X->Shape();
+    input.reserve(static_cast<size_t>(input_shape->Size()));
+    for (const auto& s : X->DataAsSpan<std::string>()) {
+      input.push_back({s.data(), s.size()});
+    }
   }
 
-  auto& input_dims = X->Shape().GetDims();
-  size_t N = 0;
-  size_t C = 0;
+  auto& input_dims = input_shape->GetDims();
   if (input_dims.size() == 1) {
-    N = 1;
     if (input_dims[0] < 1) {
       return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                     "Invalid C dimension value");
     }
-    C = input_dims[0];
   } else if (input_dims.size() == 2) {
     if (input_dims[0] < 1 || input_dims[1] < 1) {
       return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                     "Invalid N and/or C dimension values");
     }
-    N = input_dims[0];
-    C = input_dims[1];
   } else {
     return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                   "Input dimensions are either [C] or [N][C] allowed");
@@ -480,9 +505,9 @@ Status Tokenizer::Compute(OpKernelContext* ctx) const {
 
   Status s;
   if (char_tokenezation_) {
-    s = CharTokenize(ctx, N, C, input_dims);
+    s = CharTokenize(ctx, input, input_dims);
   } else {
-    s = SeparatorTokenize(ctx, N, C, input_dims);
+    s = SeparatorTokenize(ctx, input, input_dims);
   }
   return s;
 }
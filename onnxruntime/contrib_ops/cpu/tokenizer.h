@@ -19,12 +19,22 @@ class Tokenizer final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  Status CharTokenize(OpKernelContext* context, size_t N, size_t C,
+  // A string as the bytes it is stored in: in the input, an attribute or a marker
+  struct StringRef {
+    const char* data_;
+    size_t size_;
+  };
+
+  Status CharTokenize(OpKernelContext* context, const std::vector<StringRef>& input,
                       const std::vector<int64_t>& input_dims) const;
 
-  Status SeparatorTokenize(OpKernelContext* context, size_t N, size_t C,
+  Status SeparatorTokenize(OpKernelContext* context, const std::vector<StringRef>& input,
                            const std::vector<int64_t>& input_dims) const;
 
+  // Write the output as a tensor of std::string, or packed in one buffer if the caller fetches it so
+  Status WriteOutput(OpKernelContext* context, const TensorShape& output_shape,
+                     const std::vector<StringRef>& output) const;
+
   bool mark_;
   std::string pad_value_;
   int64_t mincharnum_;
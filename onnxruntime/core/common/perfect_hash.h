@@ -0,0 +1,254 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace perfect_hash {
+
+// 64-bit finalizer from MurmurHash3. Spreads every input bit over the whole word.
+inline uint64_t Mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// FNV-1a over the bytes followed by Mix so that short keys still fill all 64 bits.
+inline uint64_t HashBytes(const char* data, size_t len) {
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < len; ++i) {
+    h ^= static_cast<unsigned char>(data[i]);
+    h *= 0x100000001b3ULL;
+  }
+  return Mix(h ^ len);
+}
+
+template <typename Key>
+struct Hash;
+
+template <>
+struct Hash<std::string> {
+  uint64_t operator()(const std::string& key) const { return HashBytes(key.data(), key.size()); }
+};
+
+template <>
+struct Hash<int64_t> {
+  uint64_t operator()(int64_t key) const { return Mix(static_cast<uint64_t>(key)); }
+};
+
+}  // namespace perfect_hash
+
+/**
+Immutable minimal perfect hash index over a fixed set of unique keys.
+
+Built once (typically in a kernel constructor) using the hash-and-displace scheme:
+keys are grouped into buckets by their 64-bit hash and every bucket gets a seed that
+maps all of its keys to distinct free slots. Singleton buckets store their slot directly.
+A lookup costs one key hash, one seeded remix, one comparison of precomputed hashes and,
+only if those match, one key comparison.
+
+Find returns the slot of a key in [0, size()) or npos. Slots are dense, so callers can
+keep values in a plain vector indexed by slot (see PerfectHashMap).
+*/
+template <typename Key, typename Hasher = perfect_hash::Hash<Key>>
+class PerfectHashIndex {
+ public:
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  PerfectHashIndex() = default;
+
+  // Keys must be unique. On return slot_of_input[i] holds the slot assigned to keys[i].
+  PerfectHashIndex(const std::vector<Key>& keys, std::vector<size_t>* slot_of_input = nullptr) {
+    Build(keys, slot_of_input);
+  }
+
+  size_t size() const { return keys_.size(); }
+  bool empty() const { return keys_.empty(); }
+
+  size_t Find(const Key& key) const {
+    if (keys_.empty()) return npos;
+    return FindHashed(key, hasher_(key));
+  }
+
+  // Lookup when the caller has already hashed the key with the same Hasher,
+  // e.g. when hashes of a whole batch were computed in a separate pass.
+  size_t FindHashed(const Key& key, uint64_t hash) const {
+    if (keys_.empty()) return npos;
+    const size_t slot = Slot(hash);
+    return (hashes_[slot] == hash && keys_[slot] == key) ? slot : npos;
+  }
+
+  bool Contains(const Key& key) const { return Find(key) != npos; }
+
+  const Key& KeyAt(size_t slot) const { return keys_[slot]; }
+
+  uint64_t Hash(const Key& key) const { return hasher_(key); }
+
+ private:
+  static constexpr uint32_t kDirect = 0x80000000U;
+  static constexpr uint32_t kMaxSeed = 1U << 20;
+
+  size_t Slot(uint64_t hash) const {
+    const uint32_t seed = seeds_[hash % seeds_.size()];
+    if (seed & kDirect) return seed & ~kDirect;
+    return SeededSlot(hash, seed, keys_.size());
+  }
+
+  static size_t SeededSlot(uint64_t hash, uint32_t seed, size_t n) {
+    return static_cast<size_t>(perfect_hash::Mix(hash + seed * 0x9e3779b97f4a7c15ULL) % n);
+  }
+
+  void Build(const std::vector<Key>& keys, std::vector<size_t>* slot_of_input) {
+    const size_t n = keys.size();
+    ORT_ENFORCE(n < kDirect, "Too many keys for PerfectHashIndex: ", n);
+    if (n == 0) {
+      if (slot_of_input) slot_of_input->clear();
+      return;
+    }
+
+    std::vector<uint64_t> key_hashes(n);
+    {
+      std::unordered_set<uint64_t> seen;
+      seen.reserve(n);
+      for (size_t i = 0; i < n; ++i) {
+        key_hashes[i] = hasher_(keys[i]);
+        // Equal keys have equal hashes, and two distinct keys sharing a full 64-bit hash
+        // could never be separated by any seed. Both are rejected here.
+        ORT_ENFORCE(seen.insert(key_hashes[i]).second, "PerfectHashIndex keys must be unique");
+      }
+    }
+
+    std::vector<size_t> assignment;
+    // Start with ~2 keys per bucket. Only if some bucket cannot be placed do we retry with more buckets.
+    for (size_t num_buckets = n / 2 + 1;; num_buckets *= 2) {
+      if (TryBuild(key_hashes, num_buckets, assignment)) break;
+      ORT_ENFORCE(num_buckets <= n * 4, "Failed to build PerfectHashIndex");
+    }
+
+    keys_.resize(n);
+    hashes_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      keys_[assignment[i]] = keys[i];
+      hashes_[assignment[i]] = key_hashes[i];
+    }
+    if (slot_of_input) slot_of_input->swap(assignment);
+  }
+
+  bool TryBuild(const std::vector<uint64_t>& key_hashes, size_t num_buckets, std::vector<size_t>& assignment) {
+    const size_t n = key_hashes.size();
+    std::vector<std::vector<size_t>> buckets(num_buckets);
+    for (size_t i = 0; i < n; ++i) {
+      buckets[key_hashes[i] % num_buckets].push_back(i);
+    }
+
+    // Place the largest buckets first while most slots are still free.
+    std::vector<size_t> order(num_buckets);
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(),
+                     [&buckets](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    seeds_.assign(num_buckets, 0);
+    assignment.assign(n, npos);
+    std::vector<bool> taken(n, false);
+    std::vector<size_t> slots;
+    size_t next_free = 0;
+
+    for (size_t b : order) {
+      const auto& bucket = buckets[b];
+      if (bucket.empty()) break;
+
+      if (bucket.size() == 1) {
+        while (taken[next_free]) ++next_free;
+        taken[next_free] = true;
+        seeds_[b] = kDirect | static_cast<uint32_t>(next_free);
+        assignment[bucket[0]] = next_free;
+        continue;
+      }
+
+      bool placed = false;
+      for (uint32_t seed = 0; seed < kMaxSeed && !placed; ++seed) {
+        slots.clear();
+        placed = true;
+        for (size_t k : bucket) {
+          const size_t slot = SeededSlot(key_hashes[k], seed, n);
+          if (taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+            placed = false;
+            break;
+          }
+          slots.push_back(slot);
+        }
+        if (placed) {
+          seeds_[b] = seed;
+          for (size_t j = 0; j < bucket.size(); ++j) {
+            taken[slots[j]] = true;
+            assignment[bucket[j]] = slots[j];
+          }
+        }
+      }
+      if (!placed) return false;
+    }
+    return true;
+  }
+
+  Hasher hasher_;
+  std::vector<uint32_t> seeds_;
+  std::vector<Key> keys_;
+  std::vector<uint64_t> hashes_;
+};
+
+template <typename Key, typename Hasher>
+constexpr size_t PerfectHashIndex<Key, Hasher>::npos;
+
+/**
+Immutable Key -> Value map on top of PerfectHashIndex. Values are stored densely by slot.
+*/
+template <typename Key, typename Value, typename Hasher = perfect_hash::Hash<Key>>
+class PerfectHashMap {
+ public:
+  PerfectHashMap() = default;
+
+  PerfectHashMap(const std::vector<Key>& keys, const std::vector<Value>& values) {
+    ORT_ENFORCE(keys.size() == values.size(), "PerfectHashMap keys and values must have the same size");
+    std::vector<size_t> slot_of_input;
+    index_ = PerfectHashIndex<Key, Hasher>(keys, &slot_of_input);
+    values_.resize(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+      values_[slot_of_input[i]] = values[i];
+    }
+  }
+
+  size_t size() const { return index_.size(); }
+  bool empty() const { return index_.empty(); }
+
+  // Returns nullptr if the key is not present.
+  const Value* Find(const Key& key) const {
+    const size_t slot = index_.Find(key);
+    return slot == index_.npos ? nullptr : &values_[slot];
+  }
+
+  const Value* FindHashed(const Key& key, uint64_t hash) const {
+    const size_t slot = index_.FindHashed(key, hash);
+    return slot == index_.npos ? nullptr : &values_[slot];
+  }
+
+  uint64_t Hash(const Key& key) const { return index_.Hash(key); }
+
+ private:
+  PerfectHashIndex<Key, Hasher> index_;
+  std::vector<Value> values_;
+};
+
+}  // namespace onnxruntime
@@ -161,11 +161,10 @@ class TaskThreadPool {
       // If pool is no longer running, break out of loop.
       if (!running_) break;
 
-      // Copy task locally and remove from the queue.  This is
-      // done within its own scope so that the task object is
-      // destructed immediately after running the task.  This is
-      // useful in the event that the function contains
-      // shared_ptr arguments bound via bind.
+      // Move the task out of the queue and run it without the lock. This is done within its own scope
+      // so that the task object is destructed right after running it, before the lock is recovered:
+      // the function may hold shared_ptr arguments bound via bind whose destruction takes other locks
+      // (e.g. a Python callback needing the GIL), which must not happen while holding mutex_.
       {
         auto task = std::move(tasks_.front());
         tasks_.pop();
@@ -185,17 +184,17 @@ class TaskThreadPool {
           // LOGS_DEFAULT(ERROR) << "Exception running TaskThreadPool task: " << ex.what();
           throw;
         }
+      }
 
-        // Update status of empty, maybe
-        // Need to recover the lock first
-        lock.lock();
+      // Update status of empty, maybe
+      // Need to recover the lock first
+      lock.lock();
 
-        // Increment count, indicating thread is available.
-        ++available_;
-        if (tasks_.empty() && available_ == total_) {
-          complete_ = true;
-          completed_.notify_one();
-        }
+      // Increment count, indicating thread is available.
+      ++available_;
+      if (tasks_.empty() && available_ == total_) {
+        complete_ = true;
+        completed_.notify_one();
       }
     }  // while running_
   }
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/framework/allocation_planner.h"
+#include <limits>
 #include <list>
 #include <unordered_map>
 #include <algorithm>
@@ -257,12 +258,17 @@ class PlannerImpl {
   /*! \brief Given a tensor-type, return the size of an element of the tensor.
   */
   size_t GetElementSize(const DataType& tensor_type) {
+    return GetElementType(tensor_type)->Size();
+  }
+
+  /*! \brief Given a tensor-type, return the type of an element of the tensor.
+  */
+  MLDataType GetElementType(const DataType& tensor_type) {
     const TypeProto& type_proto = ONNX_NAMESPACE::Utils::DataTypeUtils::ToTypeProto(tensor_type);
     MLDataType ml_data_type = DataTypeImpl::TypeFromProto(type_proto);
     const TensorTypeBase* tensor_type_base = ml_data_type->AsTensorType();
     ORT_ENFORCE(nullptr != tensor_type_base);
-    MLDataType elt_type = tensor_type_base->GetElementType();
-    return elt_type->Size();
+    return tensor_type_base->GetElementType();
   }
 
   bool SameSize(const TensorShapeProto& shape1, const DataType& ptype1,
@@ -292,30 +298,80 @@ class PlannerImpl {
     return SameSize(*p_shape1, arg1.Type(), *p_shape2, arg2.Type());
   }
 
-  // Find if freelist contains a buffer of the same size as output_arg
+  // SymbolicSize: the size in bytes of a tensor written as known_bytes * (product of symbols),
+  // e.g. a float tensor of shape [batch, seq, 768] has known_bytes 3072 and symbols {batch, seq}.
+  struct SymbolicSize {
+    int64_t known_bytes = 0;
+    std::vector<std::string> symbols;  // sorted, so that equal products compare equal
+    MLDataType element_type = nullptr;
+  };
+
+  static bool IsStringType(MLDataType element_type) {
+    return element_type == DataTypeImpl::GetType<std::string>();
+  }
+
+  // Returns false if some dimension is neither a known value nor a named parameter.
+  bool GetSymbolicSize(const TensorShapeProto& shape, const DataType& type, SymbolicSize& size) {
+    size.element_type = GetElementType(type);
+    size.known_bytes = static_cast<int64_t>(size.element_type->Size());
+    size.symbols.clear();
+    for (const auto& dim : shape.dim()) {
+      if (dim.has_dim_value()) {
+        auto value = dim.dim_value();
+        if (value < 0) return false;
+        if (value > 0 && size.known_bytes > std::numeric_limits<int64_t>::max() / value) return false;
+        size.known_bytes *= value;
+      } else if (dim.has_dim_param() && !dim.dim_param().empty()) {
+        size.symbols.push_back(dim.dim_param());
+      } else {
+        return false;
+      }
+    }
+    std::sort(size.symbols.begin(), size.symbols.end());
+    return true;
+  }
+
+  // Find if freelist contains a buffer large enough for output_arg.
+  // A buffer is large enough if, whatever values the symbolic dimensions take at run time, its size is
+  // at least the required size. That holds when both sizes are multiples of the same symbols and the
+  // known part of the buffer is no smaller. Among such buffers pick the smallest (best fit), preferring
+  // the most recently freed one among equals.
+  // A reused buffer is handed to the new tensor as is, without constructing or destroying elements, so
+  // string tensors only reuse the buffers of string tensors and vice versa.
   bool FindReusableTensor(const onnxruntime::NodeArg& output_arg, MLValueIndex* reusable_tensor) {
     auto p_required_buffer_shape = context_.GetShape(output_arg);
     if (nullptr == p_required_buffer_shape) return false;
-    auto required_buffer_type = output_arg.Type();
+    SymbolicSize required_size;
+    if (!GetSymbolicSize(*p_required_buffer_shape, output_arg.Type(), required_size)) return false;
     auto& required_allocator_info = AllocPlan(output_arg.Name()).location;
 
+    auto best_fit = freelist_.end();
+    SymbolicSize available_size;
+    int64_t best_fit_bytes = 0;
     for (auto it = freelist_.begin(); it != freelist_.end(); ++it) {
-      auto reusable = it->ml_value;
-      auto p_node_arg = ml_value_info_.at(reusable).p_def_site;
+      auto p_node_arg = ml_value_info_.at(it->ml_value).p_def_site;
       auto& available_allocator_info = AllocPlan(p_node_arg->Name()).location;
       if (!(available_allocator_info == required_allocator_info)) continue;
       auto p_available_buffer_shape = context_.GetShape(*p_node_arg);
-      if (nullptr != p_available_buffer_shape) {
-        auto available_buffer_type = p_node_arg->Type();
-        if (SameSize(*p_available_buffer_shape, available_buffer_type,
-                     *p_required_buffer_shape, required_buffer_type)) {
-          *reusable_tensor = reusable;
-          freelist_.erase(it);
-          return true;
-        }
+      if (nullptr == p_available_buffer_shape) continue;
+      if (!GetSymbolicSize(*p_available_buffer_shape, p_node_arg->Type(), available_size)) continue;
+      if (available_size.element_type != required_size.element_type &&
+          (IsStringType(available_size.element_type) || IsStringType(required_size.element_type)))
+        continue;
+      if (available_size.symbols != required_size.symbols ||
+          available_size.known_bytes < required_size.known_bytes)
+        continue;
+      if (best_fit == freelist_.end() || available_size.known_bytes < best_fit_bytes) {
+        best_fit = it;
+        best_fit_bytes = available_size.known_bytes;
+        if (best_fit_bytes == required_size.known_bytes) break;  // exact fit, cannot do better
       }
     }
-    return false;
+
+    if (best_fit == freelist_.end()) return false;
+    *reusable_tensor = best_fit->ml_value;
+    freelist_.erase(best_fit);
+    return true;
   }
 
   void Initialize(size_t num_graph_nodes, size_t num_ml_values) {
@@ -481,7 +537,9 @@ class PlannerImpl {
       auto& graph_outputs = graph_viewer_.GetOutputs();
       // determine allocation for outputs of pnode
       int output_arg_num = 0;
-      for (auto node_output : pnode->OutputDefs()) {
+      auto& output_defs = pnode->OutputDefs();
+      for (size_t output_index = 0; output_index < output_defs.size(); ++output_index) {
+        auto node_output = output_defs[output_index];
         if (!node_output->Exists()) continue;
         auto current = Index(node_output->Name());
         AllocPlan(current).value_type = utils::GetMLDataType(*node_output);
@@ -489,6 +547,9 @@ class PlannerImpl {
         if (std::find(graph_outputs.begin(), graph_outputs.end(), node_output) != graph_outputs.end()) {
           // node_output is graph's output, so we can't reuse intermedia buffer
           AllocPlan(current).alloc_kind = AllocKind::kAllocateOutput;
+          if (!IsConsumed(*pnode, output_index)) {
+            AllocPlan(current).value_type = GetCallerOnlyValueType(*pnode, output_index);
+          }
         } else if (IsNonTensor(*node_output)) {
           // we do not try sharing-optimization for non-tensors
           AllocPlan(current).alloc_kind = AllocKind::kAllocate;
@@ -565,6 +626,28 @@ class PlannerImpl {
       plan_.execution_plan[prev_dealloc_point].free_to_index = current - 1;
   }
 
+  static bool IsConsumed(const onnxruntime::Node& node, size_t output_index) {
+    for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+      if (static_cast<size_t>(it->GetSrcArgIndex()) == output_index) return true;
+    }
+    return false;
+  }
+
+  // Type to create an output of the main graph that no node consumes as. It is the representation the
+  // kernel asks for if any (see KernelDefBuilder::OutputValueType), the type of its ONNX type otherwise.
+  // Subgraph outputs are passed on to the node owning the subgraph, so they keep the type of their ONNX type.
+  MLDataType GetCallerOnlyValueType(const onnxruntime::Node& node, size_t output_index) {
+    auto node_output = node.OutputDefs()[output_index];
+    MLDataType type = utils::GetMLDataType(*node_output);
+    if (graph_viewer_.IsSubgraph() || !IsNonTensor(*node_output)) return type;
+    auto p_kernel_def = utils::GetKernelDef(kernel_registry_, node);
+    if (p_kernel_def == nullptr || node_output->TypeAsProto() == nullptr) return type;
+    for (auto value_type : p_kernel_def->OutputValueTypes(output_index)) {
+      if (value_type->IsCompatible(*node_output->TypeAsProto())) return value_type;
+    }
+    return type;
+  }
+
   bool IsNonTensor(const onnxruntime::NodeArg& nodearg) {
     // TODO: unclear why we should go through a string-representation of type
     auto ptype = nodearg.Type();
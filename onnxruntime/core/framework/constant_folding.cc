@@ -0,0 +1,278 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/constant_folding.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "core/common/profiler.h"
+#include "core/framework/kernel_registry_manager.h"
+#include "core/framework/sequential_executor.h"
+#include "core/framework/session_state.h"
+#include "core/framework/session_state_initializer.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/model.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+
+ConstantFolding::ConstantFolding(std::unique_ptr<IExecutionProvider> cpu_execution_provider)
+    : GraphTransformer("ConstantFolding", "Replace the nodes with constant inputs by initializers holding their outputs") {
+  ORT_ENFORCE(cpu_execution_provider != nullptr && cpu_execution_provider->Type() == kCpuExecutionProvider,
+              "ConstantFolding requires a CPU execution provider");
+  ORT_ENFORCE(execution_providers_.Add(kCpuExecutionProvider, std::move(cpu_execution_provider)).IsOK());
+}
+
+static bool CanFold(Node& node) {
+  // the outputs of these ops differ from one evaluation to the next
+  static const std::unordered_set<std::string> nondeterministic_ops{
+      "RandomNormal", "RandomNormalLike", "RandomUniform", "RandomUniformLike", "Multinomial"};
+
+  const auto& provider_type = node.GetExecutionProviderType();
+  return (node.Domain() == kOnnxDomain || node.Domain() == kOnnxDomainAlias) &&
+         (provider_type.empty() || provider_type == kCpuExecutionProvider) &&
+         node.MutableSubgraphs().empty() &&
+         nondeterministic_ops.count(node.OpType()) == 0;
+}
+
+static bool HasStaticShape(const NodeArg& arg) {
+  const TensorShapeProto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static TensorProto CreateShapeTensorProto(const std::string& name, const TensorShapeProto& shape) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(TensorProto_DataType_INT64);
+  tensor_proto.add_dims(shape.dim_size());
+  for (const auto& dim : shape.dim()) {
+    tensor_proto.add_int64_data(dim.dim_value());
+  }
+  return tensor_proto;
+}
+
+// The value of a Constant node as an initializer, or false if it's given otherwise than by the value attribute.
+static bool GetConstantValue(const Node& node, TensorProto& value) {
+  const auto& attributes = node.GetAttributes();
+  auto it = attributes.find("value");
+  if (it == attributes.cend() || !it->second.has_t()) {
+    return false;
+  }
+  value = it->second.t();
+  value.set_name(node.OutputDefs()[0]->Name());
+  return true;
+}
+
+static TensorProto CreateTensorProto(const std::string& name, const Tensor& tensor) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(utils::GetTensorProtoType(tensor));
+  for (auto dim : tensor.Shape().GetDims()) {
+    tensor_proto.add_dims(dim);
+  }
+  if (tensor.DataType() == DataTypeImpl::GetType<std::string>()) {
+    const std::string* data = tensor.Data<std::string>();
+    for (int64_t i = 0; i < tensor.Shape().Size(); ++i) {
+      tensor_proto.add_string_data(data[i]);
+    }
+  } else {
+    tensor_proto.set_raw_data(tensor.DataRaw(), tensor.Size());
+  }
+  return tensor_proto;
+}
+
+// Evaluate nodes, given in topological order, in a graph of their own and return the values of output_names.
+static Status EvaluateNodes(const Graph& graph,
+                            const std::vector<NodeIndex>& nodes,
+                            const std::vector<std::string>& output_names,
+                            const ExecutionProviders& execution_providers,
+                            std::vector<TensorProto>& values) {
+  Model model("ConstantFolding", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              graph.DomainToVersionMap());
+  Graph& evaluation_graph = model.MainGraph();
+
+  std::unordered_set<std::string> consumed_values;
+  for (NodeIndex index : nodes) {
+    const Node& node = *graph.GetNode(index);
+    evaluation_graph.AddNode(node).SetExecutionProviderType(kCpuExecutionProvider);
+    for (const NodeArg* input_def : node.InputDefs()) {
+      const TensorProto* initializer = nullptr;
+      if (input_def->Exists() && graph.GetInitializedTensor(input_def->Name(), initializer)) {
+        evaluation_graph.AddInitializedTensor(*initializer);
+      }
+      consumed_values.insert(input_def->Name());
+    }
+  }
+
+  // The buffer of a value consumed by another node may be reused once that node ran, so such a value
+  // is copied to an output of the evaluation graph.
+  std::vector<std::string> fetch_names;
+  for (const auto& name : output_names) {
+    if (consumed_values.count(name) == 0) {
+      fetch_names.push_back(name);
+      continue;
+    }
+
+    std::string copy_name = name + "_ConstantFolding";
+    while (evaluation_graph.GetNodeArg(copy_name) != nullptr) {
+      copy_name += "_";
+    }
+    NodeArg* value = evaluation_graph.GetNodeArg(name);
+    NodeArg& copy = evaluation_graph.GetOrCreateNodeArg(copy_name, value->TypeAsProto());
+    evaluation_graph.AddNode(copy_name, "Identity", "Copy of a folded value", {value}, {&copy})
+        .SetExecutionProviderType(kCpuExecutionProvider);
+    fetch_names.push_back(copy_name);
+  }
+  ORT_RETURN_IF_ERROR(evaluation_graph.Resolve());
+
+  std::map<OrtAllocatorInfo, BufferUniquePtr> weights_buffers;
+  profiling::Profiler profiler;
+  SessionState session_state{execution_providers};
+  session_state.SetProfiler(profiler);
+
+  KernelRegistryManager kernel_registry_manager;
+  kernel_registry_manager.RegisterKernels(execution_providers);
+  SessionStateInitializer session_initializer{evaluation_graph, session_state, execution_providers,
+                                              kernel_registry_manager};
+  ORT_RETURN_IF_ERROR(session_initializer.CreatePlan({}, true));
+  ORT_RETURN_IF_ERROR(session_initializer.InitializeAndSave(false, weights_buffers));
+
+  SequentialExecutor executor;
+  std::vector<MLValue> fetches;
+  ORT_RETURN_IF_ERROR(executor.Execute(session_state, {}, fetch_names, fetches, session_state.Logger()));
+
+  values.reserve(output_names.size());
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    values.push_back(CreateTensorProto(output_names[i], fetches[i].Get<Tensor>()));
+  }
+  return Status::OK();
+}
+
+Status ConstantFolding::Apply(onnxruntime::Graph& graph, bool& modified) const {
+  KernelRegistryManager kernel_registry_manager;
+  kernel_registry_manager.RegisterKernels(execution_providers_);
+  const auto kernel_registries = kernel_registry_manager.GetAllKernelRegistries();
+  auto has_kernel = [&kernel_registries](const Node& node) {
+    return std::any_of(kernel_registries.cbegin(), kernel_registries.cend(), [&node](const KernelRegistry* registry) {
+      return registry->TryFindKernel(node, kCpuExecutionProvider) != nullptr;
+    });
+  };
+
+  // the folded nodes in topological order, and the outputs of the ones to evaluate
+  std::vector<NodeIndex> folded_nodes;
+  std::vector<NodeIndex> evaluated_nodes;
+  std::unordered_set<std::string> evaluated_values;
+  std::unordered_set<std::string> constant_values;
+
+  // an initializer which is also a graph input may be overridden by a feed
+  std::unordered_set<std::string> graph_inputs;
+  for (const NodeArg* input : graph.GetInputsIncludingInitializers()) {
+    graph_inputs.insert(input->Name());
+  }
+
+  auto is_constant = [&graph, &evaluated_values, &graph_inputs](const NodeArg* arg) {
+    const TensorProto* initializer = nullptr;
+    return !arg->Exists() || evaluated_values.count(arg->Name()) != 0 ||
+           (graph_inputs.count(arg->Name()) == 0 && graph.GetInitializedTensor(arg->Name(), initializer));
+  };
+
+  GraphViewer graph_viewer(graph);
+  for (NodeIndex index : graph_viewer.GetNodesInTopologicalOrder()) {
+    Node& node = *graph.GetNode(index);
+    if (!CanFold(node) || graph.IsNodeOutputsInGraphOutputs(node)) {
+      continue;
+    }
+
+    // the Constant nodes added after the graph was loaded, which the loading replaces by initializers
+    TensorProto constant_value;
+    if (node.OpType() == "Constant" && GetConstantValue(node, constant_value)) {
+      constant_values.insert(constant_value.name());
+      graph.AddInitializedTensor(constant_value);
+      folded_nodes.push_back(index);
+      continue;
+    }
+
+    // the shape is known without evaluating the node
+    if (node.OpType() == "Shape" && HasStaticShape(*node.InputDefs()[0])) {
+      graph.AddInitializedTensor(CreateShapeTensorProto(node.OutputDefs()[0]->Name(), *node.InputDefs()[0]->Shape()));
+      folded_nodes.push_back(index);
+      continue;
+    }
+
+    const auto& input_defs = node.InputDefs();
+    const auto& output_defs = node.OutputDefs();
+    if (input_defs.size() == 0 || !std::all_of(input_defs.begin(), input_defs.end(), is_constant) ||
+        !std::all_of(output_defs.begin(), output_defs.end(), [](const NodeArg* arg) {
+          return !arg->Exists() || (arg->TypeAsProto() != nullptr && arg->TypeAsProto()->has_tensor_type());
+        }) ||
+        !has_kernel(node)) {
+      continue;
+    }
+
+    for (const NodeArg* output_def : output_defs) {
+      if (output_def->Exists()) {
+        evaluated_values.insert(output_def->Name());
+      }
+    }
+    evaluated_nodes.push_back(index);
+    folded_nodes.push_back(index);
+  }
+
+  if (folded_nodes.empty()) {
+    return Status::OK();
+  }
+
+  // only the evaluated values and the values of Constant nodes used by the remaining nodes become initializers
+  std::unordered_set<NodeIndex> folded_node_set(folded_nodes.cbegin(), folded_nodes.cend());
+  std::unordered_set<std::string> used_values;
+  std::unordered_set<std::string> used_constant_values;
+  auto add_used_value = [&](const NodeArg* def) {
+    if (evaluated_values.count(def->Name()) != 0) {
+      used_values.insert(def->Name());
+    } else if (constant_values.count(def->Name()) != 0) {
+      used_constant_values.insert(def->Name());
+    }
+  };
+  for (const auto& node : graph.Nodes()) {
+    if (folded_node_set.count(node.Index()) == 0) {
+      std::for_each(node.InputDefs().begin(), node.InputDefs().end(), add_used_value);
+      std::for_each(node.ImplicitInputDefs().cbegin(), node.ImplicitInputDefs().cend(), add_used_value);
+    }
+  }
+
+  if (!used_values.empty()) {
+    std::vector<std::string> output_names(used_values.cbegin(), used_values.cend());
+    std::vector<TensorProto> values;
+    ORT_RETURN_IF_ERROR(EvaluateNodes(graph, evaluated_nodes, output_names, execution_providers_, values));
+    for (const auto& value : values) {
+      graph.AddInitializedTensor(value);
+    }
+  }
+
+  for (const auto& name : constant_values) {
+    if (used_constant_values.count(name) == 0) {
+      graph.RemoveInitializedTensor(name);
+    }
+  }
+
+  // remove the consumers first
+  for (auto it = folded_nodes.crbegin(); it != folded_nodes.crend(); ++it) {
+    graph.RemoveNode(*it);
+  }
+
+  modified = true;
+  return graph.Resolve();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/graph_transformer.h"
+#include "core/framework/execution_providers.h"
+
+namespace onnxruntime {
+
+/**
+@class ConstantFolding
+
+Transformer that evaluates the nodes whose inputs are all initializers, or outputs of such nodes, once
+with the kernels of a CPU execution provider and replaces them by initializers holding their outputs.
+Constant nodes are replaced by initializers, and Shape nodes whose input has a static shape are folded
+as well, which lets the shape computations following them (Gather, Unsqueeze, Concat...) be folded too.
+Nodes of other domains than ONNX, nodes with subgraphs, nodes producing graph outputs and random
+generators are left as is, as well as nodes without a kernel in the provider.
+Initializers which are also listed in the graph inputs are not constant, as a feed may override them.
+*/
+class ConstantFolding : public onnxruntime::GraphTransformer {
+ public:
+  /**
+  @param cpu_execution_provider The CPUExecutionProvider to evaluate the nodes with.
+  */
+  explicit ConstantFolding(std::unique_ptr<IExecutionProvider> cpu_execution_provider);
+
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+
+ private:
+  ExecutionProviders execution_providers_;
+};
+
+}  // namespace onnxruntime
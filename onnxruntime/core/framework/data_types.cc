@@ -3,6 +3,7 @@
 
 #include "core/framework/data_types.h"
 #include "core/framework/tensor.h"
+#include "core/framework/packed_string_tensor.h"
 #include "core/graph/onnx_protobuf.h"
 
 #ifdef __GNUC__
@@ -387,6 +388,19 @@ const ONNX_NAMESPACE::TypeProto* NonTensorTypeBase::GetTypeProto() const {
   return impl_->GetProto();
 }
 
+bool NonTensorTypeBase::IsTensorCompatible(const ONNX_NAMESPACE::TypeProto& type_proto) const {
+  const auto* thisProto = impl_->GetProto();
+  if (&type_proto == thisProto) {
+    return true;
+  }
+  if (type_proto.value_case() != TypeProto::ValueCase::kTensorType) {
+    return false;
+  }
+  ORT_ENFORCE(thisProto->value_case() == TypeProto::ValueCase::kTensorType);
+  ORT_ENFORCE(thisProto->tensor_type().has_elem_type());
+  return data_types_internal::IsCompatible(thisProto->tensor_type(), type_proto.tensor_type());
+}
+
 bool NonTensorTypeBase::IsMapCompatible(const ONNX_NAMESPACE::TypeProto& type_proto) const {
   const auto* thisProto = impl_->GetProto();
   if (&type_proto == thisProto) {
@@ -460,6 +474,15 @@ ORT_REGISTER_SEQ(VectorDouble);
 ORT_REGISTER_SEQ(VectorMapStringToFloat);
 ORT_REGISTER_SEQ(VectorMapInt64ToFloat);
 
+// Same ONNX types as VectorMap*ToFloat, which TypeFromProto returns. Only created
+// for kernel outputs that the caller reads, see KernelDefBuilder::OutputValueType.
+ORT_REGISTER_SEQ(ColumnarMapStringToFloat);
+ORT_REGISTER_SEQ(ColumnarMapInt64ToFloat);
+
+// Same ONNX type as Tensor of std::string, which TypeFromProto returns. Only created
+// for the kernels and the callers asking for it, see KernelDefBuilder::InputValueType.
+ORT_REGISTER_PACKED_TENSOR(PackedStringTensor, std::string);
+
 // Used for Tensor Proto registrations
 #define REGISTER_TENSOR_PROTO(TYPE, reg_fn)                  \
   {                                                          \
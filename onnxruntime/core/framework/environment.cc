@@ -3,6 +3,7 @@
 
 #include "core/framework/environment.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/graph/constants.h"
 #include "core/graph/contrib_ops/contrib_defs.h"
 #include "core/graph/op.h"
@@ -17,6 +18,15 @@ std::once_flag schemaRegistrationOnceFlag;
 
 std::atomic<bool> Environment::is_initialized_{false};
 
+// held by the runtime environment and the sessions sharing their initializers
+static OrtMutex shared_initializer_store_mutex;
+static std::shared_ptr<SharedInitializerStore> shared_initializer_store;
+
+std::shared_ptr<SharedInitializerStore> Environment::GetSharedInitializerStore() {
+  std::lock_guard<OrtMutex> lock(shared_initializer_store_mutex);
+  return shared_initializer_store;
+}
+
 Status Environment::Create(std::unique_ptr<Environment>& environment) {
   environment = std::unique_ptr<Environment>(new Environment());
   auto status = environment->Initialize();
@@ -95,6 +105,11 @@ Internal copy node
 Internal copy node
 )DOC");
 
+    {
+      std::lock_guard<OrtMutex> lock(shared_initializer_store_mutex);
+      shared_initializer_store = std::make_shared<SharedInitializerStore>();
+    }
+
     is_initialized_ = true;
   } catch (std::exception& ex) {
     status = Status{ONNXRUNTIME, common::RUNTIME_EXCEPTION, std::string{"Exception caught: "} + ex.what()};
@@ -106,6 +121,10 @@ Internal copy node
 }
 
 Environment::~Environment() {
+  {
+    std::lock_guard<OrtMutex> lock(shared_initializer_store_mutex);
+    shared_initializer_store.reset();
+  }
   ::google::protobuf::ShutdownProtobufLibrary();
 }
 
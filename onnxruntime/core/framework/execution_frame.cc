@@ -3,6 +3,7 @@
 
 #include "core/framework/execution_frame.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "core/framework/mem_pattern_planner.h"
@@ -21,44 +22,124 @@ ExecutionFrame::ExecutionFrame(const std::unordered_map<std::string, MLValue>& f
     : session_state_(session_state), mem_patterns_(nullptr), planner_(nullptr) {
   auto* graph = session_state.GetGraphViewer();
   ORT_ENFORCE(graph);
-  Init(*graph, feeds, output_names, fetches);
+
+  auto& mlvalue_idx_map = session_state_.GetMLValueNameIdxMap();
+  std::vector<int> feed_mlvalue_idxs;
+  std::vector<MLValue> feed_values;
+  feed_mlvalue_idxs.reserve(feeds.size());
+  feed_values.reserve(feeds.size());
+  for (const auto& feed : feeds) {
+    int mlvalue_idx;
+    Status status = mlvalue_idx_map.GetIdx(feed.first, mlvalue_idx);
+    ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+    feed_mlvalue_idxs.push_back(mlvalue_idx);
+    // we are sharing the underline tensor/object for MLValue
+    feed_values.push_back(feed.second);
+  }
+
+  std::vector<int> fetch_mlvalue_idxs;
+  if (!fetches.empty()) {
+    // should've already verified this much before when Run() starts
+    ORT_ENFORCE(output_names.size() == fetches.size(),
+                "output_names vector size: " + std::to_string(output_names.size()) +
+                    " does not match that of fetches vector: " + std::to_string(fetches.size()));
+    fetch_mlvalue_idxs.reserve(output_names.size());
+    for (const auto& oname : output_names) {
+      int mlvalue_idx;
+      Status status = mlvalue_idx_map.GetIdx(oname, mlvalue_idx);
+      ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+      fetch_mlvalue_idxs.push_back(mlvalue_idx);
+    }
+  }
+
+  Init(*graph, feed_mlvalue_idxs, feed_values, fetch_mlvalue_idxs, fetches);
 
   // If the session enable memory pattern optimization
   // and we have execution plan generated, try to setup
   // memory pattern optimization.
   if (session_state.GetEnableMemoryPattern() &&
       session_state.GetExecutionPlan()) {
-    std::vector<TensorShape> input_shapes;
-    bool all_tensors = true;
-    for (const auto& feed : feeds) {
-      if (!(feed.second.IsTensor())) {
-        all_tensors = false;
-        break;
-      }
-      auto& tensor = feed.second.Get<Tensor>();
-      input_shapes.push_back(tensor.Shape());
-    }
     // if there is some traditional ml value type in inputs
     // disable the memory pattern optimization.
+    bool all_tensors = std::all_of(feeds.cbegin(), feeds.cend(), [](const std::pair<const std::string, MLValue>& feed) {
+      return feed.second.IsTensor();
+    });
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(input_shapes);
+      mem_patterns_ = session_state.GetMemoryPatternGroup(feeds);
       // if no existing patterns, generate one in this executionframe
       if (!mem_patterns_) {
         planner_ = std::make_unique<MLValuePatternPlanner>(*session_state.GetExecutionPlan());
       } else {
-        // pre-allocate the big chunk requested in memory pattern.
-        // all the internal kernel's input/output tensors will be allocated on these buffer.
-        for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
-          ORT_ENFORCE(buffers_.find(mem_patterns_->locations[i]) == buffers_.end());
-          AllocatorPtr alloc = GetAllocator(mem_patterns_->locations[i]);
-          void* buffer = mem_patterns_->patterns[i].PeakSize() > 0 ? alloc->Alloc(mem_patterns_->patterns[i].PeakSize()) : nullptr;
-          buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
-        }
+        AllocatePatternBuffers();
       }
     }
   }
 }
 
+ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs,
+                               const std::vector<MLValue>& feeds,
+                               const std::vector<int>& fetch_mlvalue_idxs,
+                               const std::vector<MLValue>& fetches,
+                               const ::onnxruntime::SessionState& session_state)
+    : session_state_(session_state), mem_patterns_(nullptr), planner_(nullptr) {
+  auto* graph = session_state.GetGraphViewer();
+  ORT_ENFORCE(graph);
+  ORT_ENFORCE(fetches.empty() || fetches.size() == fetch_mlvalue_idxs.size());
+  Init(*graph, feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches);
+
+  // there is no cache lookup here. the caller traces the first execution and switches to the
+  // generated pattern with UseGeneratedPatterns for the following ones.
+  if (session_state.GetEnableMemoryPattern() && session_state.GetExecutionPlan()) {
+    bool all_tensors = std::all_of(feeds.cbegin(), feeds.cend(), [](const MLValue& feed) { return feed.IsTensor(); });
+    if (all_tensors) {
+      planner_ = std::make_unique<MLValuePatternPlanner>(*session_state.GetExecutionPlan());
+    }
+  }
+}
+
+void ExecutionFrame::UpdateFeedsAndFetches(const std::vector<int>& feed_mlvalue_idxs,
+                                           const std::vector<MLValue>& feeds,
+                                           const std::vector<int>& fetch_mlvalue_idxs,
+                                           const std::vector<MLValue>& fetches) {
+  for (size_t i = 0, end = feed_mlvalue_idxs.size(); i < end; ++i) {
+    all_values_[feed_mlvalue_idxs[i]] = feeds[i];
+  }
+
+  // the previous outputs are owned by the caller now. unless a pre-allocated fetch is provided
+  // the kernels need to allocate new ones.
+  for (size_t i = 0, end = fetch_mlvalue_idxs.size(); i < end; ++i) {
+    all_values_[fetch_mlvalue_idxs[i]] = fetches.empty() ? MLValue() : fetches[i];
+  }
+}
+
+Status ExecutionFrame::UseGeneratedPatterns() {
+  auto mem_patterns = std::make_unique<MemoryPatternGroup>();
+  ORT_RETURN_IF_ERROR(GeneratePatterns(mem_patterns.get()));
+  planner_.reset();
+  mem_patterns_ = std::move(mem_patterns);
+  AllocatePatternBuffers();
+  return Status::OK();
+}
+
+void ExecutionFrame::TracePatterns() {
+  mem_patterns_.reset();
+  buffers_.clear();
+  if (session_state_.GetExecutionPlan()) {
+    planner_ = std::make_unique<MLValuePatternPlanner>(*session_state_.GetExecutionPlan());
+  }
+}
+
+void ExecutionFrame::AllocatePatternBuffers() {
+  // pre-allocate the big chunk requested in memory pattern.
+  // all the internal kernel's input/output tensors will be allocated on these buffer.
+  for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
+    ORT_ENFORCE(buffers_.find(mem_patterns_->locations[i]) == buffers_.end());
+    AllocatorPtr alloc = GetAllocator(mem_patterns_->locations[i]);
+    void* buffer = mem_patterns_->patterns[i].PeakSize() > 0 ? alloc->Alloc(mem_patterns_->patterns[i].PeakSize()) : nullptr;
+    buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
+  }
+}
+
 ExecutionFrame::~ExecutionFrame() = default;
 
 Status ExecutionFrame::AllocateMLValueTensorSelfOwnBuffer(int mlvalue_index,
@@ -113,14 +194,15 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(int mlvalue_inde
       if (block) {
         auto it = buffers_.find(location);
         // if the block is not correct, log message then fall back to default behavior
-        if (it != buffers_.end() && block->size_ == size) {
+        // a pattern traced with larger inputs has blocks at least as large as needed
+        if (it != buffers_.end() && size <= block->size_) {
           void* buffer = it->second.get();
           auto status = AllocateTensorWithPreAllocateBufferHelper(
               p_mlvalue, static_cast<void*>(static_cast<char*>(buffer) + block->offset_),
               element_type, location, shape);
           return status;
         }
-        if (block->size_ != size) {
+        if (block->size_ < size) {
           LOGS_DEFAULT(WARNING) << "For mlvalue with index: " << mlvalue_index << ", block in memory pattern size is: "
                                 << block->size_ << " but the actually size is: " << size << ", fall back to default allocation behavior";
         } else if (it == buffers_.end()) {
@@ -309,8 +391,9 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(int mlvalue_index,
 }
 
 void ExecutionFrame::Init(const onnxruntime::GraphViewer& graph,
-                          const std::unordered_map<std::string, MLValue>& feeds,
-                          const std::vector<std::string>& output_names,
+                          const std::vector<int>& feed_mlvalue_idxs,
+                          const std::vector<MLValue>& feeds,
+                          const std::vector<int>& fetch_mlvalue_idxs,
                           const std::vector<MLValue>& fetches) {
   // 1. resize the node_offsets and all_value_ vector
   // We need to use the max index rather than number of nodes as we use Node.Index()
@@ -329,30 +412,17 @@ void ExecutionFrame::Init(const onnxruntime::GraphViewer& graph,
   }
 
   // 3. handle feed in values
-  for (const auto& feed : feeds) {
-    int mlvalue_idx;
-    Status status = mlvalue_idx_map.GetIdx(feed.first, mlvalue_idx);
-    ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+  for (size_t i = 0, end = feed_mlvalue_idxs.size(); i < end; ++i) {
     // we are sharing the underline tensor/object for MLValue
-    all_values_[mlvalue_idx] = feed.second;
+    all_values_[feed_mlvalue_idxs[i]] = feeds[i];
   }
 
   // 4. Handle non-empty output vector
   if (!fetches.empty()) {
-    // should've already verified this much before when Run() starts
-    ORT_ENFORCE(output_names.size() == fetches.size(),
-                        "output_names vector size: " + std::to_string(output_names.size()) +
-                            " does not match that of fetches vector: " + std::to_string(fetches.size()));
-
     // setup output_indices_, we dont' want to generate mem plan on output tensors.
-    output_indices_.reserve(output_names.size());
-    auto idx = 0;
-    for (const auto& oname : output_names) {
-      int mlvalue_idx;
-      Status status = mlvalue_idx_map.GetIdx(oname, mlvalue_idx);
-      ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
-      all_values_[mlvalue_idx] = fetches.at(idx++);
-      output_indices_.push_back(mlvalue_idx);
+    output_indices_ = fetch_mlvalue_idxs;
+    for (size_t i = 0, end = fetch_mlvalue_idxs.size(); i < end; ++i) {
+      all_values_[fetch_mlvalue_idxs[i]] = fetches[i];
     }
   }
 
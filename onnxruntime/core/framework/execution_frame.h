@@ -43,8 +43,30 @@ class ExecutionFrame {
                  const std::vector<MLValue>& fetches,
                  const SessionState& session_state);
 
+  // Feeds and fetches bound by MLValue index, e.g. by a caller executing the same graph repeatedly.
+  // fetches may be empty, or hold a (possibly unallocated) MLValue per entry of fetch_mlvalue_idxs.
+  ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs,
+                 const std::vector<MLValue>& feeds,
+                 const std::vector<int>& fetch_mlvalue_idxs,
+                 const std::vector<MLValue>& fetches,
+                 const SessionState& session_state);
+
   ~ExecutionFrame();
 
+  // Prepare the frame for another execution of the graph with new feeds and fetches.
+  // The indices must be the ones the frame was created with.
+  void UpdateFeedsAndFetches(const std::vector<int>& feed_mlvalue_idxs,
+                             const std::vector<MLValue>& feeds,
+                             const std::vector<int>& fetch_mlvalue_idxs,
+                             const std::vector<MLValue>& fetches);
+
+  // Generate the memory pattern traced by the last execution and use it for the following ones,
+  // which then share one pre-allocated buffer per location.
+  Status UseGeneratedPatterns();
+
+  // Drop the memory pattern in use, if any, and trace the next execution instead.
+  void TracePatterns();
+
   Status AllocateMLValueTensorSelfOwnBuffer(int mlvalue_index,
                                             MLDataType element_type,
                                             const OrtAllocatorInfo& location,
@@ -138,10 +160,13 @@ class ExecutionFrame {
                                                   bool create_fence);
 
   void Init(const onnxruntime::GraphViewer& graph,
-            const std::unordered_map<std::string, MLValue>& feeds,
-            const std::vector<std::string>& output_names,
+            const std::vector<int>& feed_mlvalue_idxs,
+            const std::vector<MLValue>& feeds,
+            const std::vector<int>& fetch_mlvalue_idxs,
             const std::vector<MLValue>& fetches);
 
+  void AllocatePatternBuffers();
+
   void SetupNodeArg(const onnxruntime::NodeArg* arg);
 
   Status AllocateTensorWithPreAllocateBufferHelper(MLValue* p_mlvalue,
@@ -179,7 +204,7 @@ class ExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
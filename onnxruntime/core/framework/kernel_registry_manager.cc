@@ -13,13 +13,18 @@ Status KernelRegistryManager::CreateKernel(const onnxruntime::Node& node,
                                            const IExecutionProvider& execution_provider,
                                            const SessionState& session_state,
                                            /*out*/ std::unique_ptr<OpKernel>& op_kernel) const {
-  std::lock_guard<OrtMutex> lock(lock_);
-  if (kernel_registries_.empty()) {
+  // the kernels of a session are created in parallel, so the lock isn't held while constructing them
+  std::list<std::shared_ptr<KernelRegistry>> kernel_registries;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    kernel_registries = kernel_registries_;
+  }
+  if (kernel_registries.empty()) {
     return Status(ONNXRUNTIME, FAIL, "Kernel not found.");
   }
 
   Status status;
-  for (auto& registry : kernel_registries_) {
+  for (auto& registry : kernel_registries) {
     status = registry->CreateKernel(node, execution_provider, session_state, op_kernel);
     if (status.IsOK()) {
       return status;
@@ -31,8 +36,14 @@ Status KernelRegistryManager::CreateKernel(const onnxruntime::Node& node,
 
 void KernelRegistryManager::RegisterKernels(const ExecutionProviders& execution_providers,
                                             KernelRegistryPriority priority) {
-  for (auto& provider : execution_providers)
-    RegisterKernelRegistry(provider->GetKernelRegistry(), priority);
+  for (auto& provider : execution_providers) {
+    auto kernel_registry = provider->GetKernelRegistry();
+    RegisterKernelRegistry(kernel_registry, priority);
+    if (kernel_registry != nullptr) {
+      std::lock_guard<OrtMutex> lock(lock_);
+      execution_provider_registries_.insert(kernel_registry.get());
+    }
+  }
 }
 
 void KernelRegistryManager::RegisterKernelRegistry(std::shared_ptr<KernelRegistry> kernel_registry,
@@ -67,4 +78,15 @@ Status KernelRegistryManager::SearchKernelRegistry(const onnxruntime::Node& node
   return Status(ONNXRUNTIME, FAIL, "Failed to find kernel for " + node.OpType());
 }
 
+bool KernelRegistryManager::IsExecutionProviderKernel(const onnxruntime::Node& node) const {
+  std::lock_guard<OrtMutex> lock(lock_);
+  // the first registry having a kernel for the node is the one CreateKernel creates it from
+  for (auto& registry : kernel_registries_) {
+    if (registry->TryFindKernel(node, node.GetExecutionProviderType()) != nullptr) {
+      return execution_provider_registries_.count(registry.get()) != 0;
+    }
+  }
+  return false;
+}
+
 }  // namespace onnxruntime
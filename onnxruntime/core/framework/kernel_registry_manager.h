@@ -5,6 +5,7 @@
 #include <memory>
 #include <vector>
 #include <list>
+#include <unordered_set>
 #include "core/common/status.h"
 #include "core/platform/ort_mutex.h"
 #include "core/graph/graph_viewer.h"
@@ -44,6 +45,10 @@ class KernelRegistryManager {
   Status SearchKernelRegistry(const onnxruntime::Node& node,
                               /*out*/ const KernelCreateInfo** kernel_create_info) const;
 
+  // Whether the kernel of node is created from the registry of an execution provider registered by
+  // RegisterKernels, rather than from a custom registry whose kernels may not be safe to construct concurrently.
+  bool IsExecutionProviderKernel(const onnxruntime::Node& node) const;
+
   // Get all kernel registries. There are no nullptr entries.
   std::vector<const KernelRegistry*> GetAllKernelRegistries() const {
     std::vector<const KernelRegistry*> result;
@@ -58,6 +63,8 @@ class KernelRegistryManager {
 
   // This list stores all kernel registries shared across sessions, including common ones and customized ones.
   std::list<std::shared_ptr<KernelRegistry>> kernel_registries_;
+  // The registries of kernel_registries_ that belong to execution providers.
+  std::unordered_set<const KernelRegistry*> execution_provider_registries_;
   mutable OrtMutex lock_;
 };
 }  // namespace onnxruntime
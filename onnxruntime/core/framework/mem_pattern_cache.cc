@@ -0,0 +1,129 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+
+static size_t TotalPeakSize(const MemoryPatternGroup& group) {
+  size_t bytes = 0;
+  for (const auto& pattern : group.patterns) {
+    bytes += pattern.PeakSize();
+  }
+  return bytes;
+}
+
+// Whether every dimension of shapes is no larger than the corresponding one of traced.
+// Both must have the same key, hence the same inputs and ranks.
+static bool Covers(const MemoryPatternCache::InputShapes& traced, const MemoryPatternCache::InputShapes& shapes) {
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    const auto& dims = shapes[i].second;
+    const auto& traced_dims = traced[i].second;
+    for (size_t j = 0; j < dims.size(); ++j) {
+      if (dims[j] > traced_dims[j]) return false;
+    }
+  }
+  return true;
+}
+
+void MemoryPatternCache::SetOptions(const MemoryPatternCacheOptions& options) {
+  ORT_ENFORCE(std::is_sorted(options.dim_buckets.begin(), options.dim_buckets.end()),
+              "Memory pattern dimension buckets must be sorted");
+  std::lock_guard<OrtMutex> lock(mutex_);
+  options_ = options;
+  EvictIfNeeded();
+}
+
+void MemoryPatternCache::SetDynamicDims(std::unordered_map<std::string, std::vector<bool>> dynamic_dims) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  dynamic_dims_ = std::move(dynamic_dims);
+  // existing keys were computed with the previous dimensions
+  entries_.clear();
+  lru_.clear();
+  total_bytes_ = 0;
+}
+
+std::vector<int64_t> MemoryPatternCache::BucketShape(const std::string& input_name,
+                                                     const std::vector<int64_t>& dims) const {
+  std::vector<int64_t> bucketed(dims);
+  if (options_.dim_buckets.empty()) return bucketed;
+
+  auto it = dynamic_dims_.find(input_name);
+  if (it == dynamic_dims_.end() || it->second.size() != dims.size()) return bucketed;
+
+  for (size_t i = 0; i < dims.size(); ++i) {
+    if (!it->second[i]) continue;
+    auto bucket = std::lower_bound(options_.dim_buckets.begin(), options_.dim_buckets.end(), dims[i]);
+    if (bucket != options_.dim_buckets.end()) bucketed[i] = *bucket;
+  }
+  return bucketed;
+}
+
+MemoryPatternCache::InputShapes MemoryPatternCache::MakeKey(const InputShapes& shapes) const {
+  InputShapes key;
+  key.reserve(shapes.size());
+  for (const auto& input : shapes) {
+    key.emplace_back(input.first, BucketShape(input.first, input.second));
+  }
+  return key;
+}
+
+std::shared_ptr<const MemoryPatternGroup> MemoryPatternCache::Get(const InputShapes& shapes) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(MakeKey(shapes));
+  if (it == entries_.end() || !Covers(it->second.traced_shapes, shapes))
+    return nullptr;
+
+  lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+  return it->second.patterns;
+}
+
+void MemoryPatternCache::Put(const InputShapes& shapes, std::unique_ptr<MemoryPatternGroup> patterns) {
+  const size_t bytes = TotalPeakSize(*patterns);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (options_.max_bytes != 0 && bytes > options_.max_bytes)
+    return;
+
+  auto key = MakeKey(shapes);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    // another run may have traced the same or larger shapes meanwhile
+    if (Covers(it->second.traced_shapes, shapes))
+      return;
+    total_bytes_ -= it->second.bytes;
+    lru_.erase(it->second.lru_position);
+    entries_.erase(it);
+  }
+
+  it = entries_.emplace(std::move(key), Entry()).first;
+  Entry& entry = it->second;
+  entry.traced_shapes = shapes;
+  entry.patterns = std::move(patterns);
+  entry.bytes = bytes;
+  lru_.push_front(&it->first);
+  entry.lru_position = lru_.begin();
+  total_bytes_ += bytes;
+
+  EvictIfNeeded();
+}
+
+size_t MemoryPatternCache::Size() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return entries_.size();
+}
+
+void MemoryPatternCache::EvictIfNeeded() {
+  // Patterns still in use by running frames stay alive through their shared_ptr.
+  while (!lru_.empty() &&
+         ((options_.max_entries != 0 && entries_.size() > options_.max_entries) ||
+          (options_.max_bytes != 0 && total_bytes_ > options_.max_bytes))) {
+    auto it = entries_.find(*lru_.back());
+    total_bytes_ -= it->second.bytes;
+    lru_.pop_back();
+    entries_.erase(it);
+  }
+}
+}  // namespace onnxruntime
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/mem_pattern.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+struct MemoryPatternCacheOptions {
+  // Dynamic dimensions of the graph inputs (those without a fixed value in the model) are rounded
+  // up to the smallest bucket not below them, so that one pattern serves every length in a bucket.
+  // Must be sorted ascending. Dimensions above the last bucket are kept exact.
+  // Empty means no bucketing, i.e. a pattern is only used for exactly the shapes it was traced with.
+  std::vector<int64_t> dim_buckets;
+
+  // Maximum number of cached patterns. Least recently used patterns are evicted first. 0 means unbounded.
+  // The default keeps the cache bounded for models fed with many distinct shapes when no buckets are set.
+  size_t max_entries = 64;
+
+  // Maximum sum of the peak sizes in bytes of all cached patterns, i.e. of the memory that runs using them
+  // pre-allocate. Patterns above this limit on their own are not cached at all. 0 means unbounded.
+  // A pattern only holds the offsets of its blocks, so by default only max_entries bounds the cache,
+  // which avoids tracing every run of models whose peak size exceeds a fixed limit.
+  size_t max_bytes = 0;
+};
+
+/**
+Bounded cache of memory patterns keyed by bucketed input shapes.
+
+A pattern records the offsets of the blocks used during a traced run. It can serve any run whose
+inputs are no larger than the inputs it was traced with, as every block is then large enough.
+Get only returns such patterns; for a larger run in the same bucket the caller traces again and Put
+replaces the entry, so that each bucket converges to its largest shapes. WarmUp at the bucket
+boundaries therefore makes a pattern serve its whole bucket from the first run on.
+
+Thread-safe.
+*/
+class MemoryPatternCache {
+ public:
+  // Input shapes of a run, sorted by input name.
+  using InputShapes = std::vector<std::pair<std::string, std::vector<int64_t>>>;
+
+  MemoryPatternCache() = default;
+
+  void SetOptions(const MemoryPatternCacheOptions& options);
+
+  // dynamic_dims maps a graph input name to the dimensions of that input that may vary between runs.
+  // Inputs not listed are never bucketed.
+  void SetDynamicDims(std::unordered_map<std::string, std::vector<bool>> dynamic_dims);
+
+  // Rounds the dynamic dimensions of the given input up to their bucket.
+  std::vector<int64_t> BucketShape(const std::string& input_name, const std::vector<int64_t>& dims) const;
+
+  // Returns nullptr if there is no pattern covering shapes.
+  std::shared_ptr<const MemoryPatternGroup> Get(const InputShapes& shapes);
+
+  void Put(const InputShapes& shapes, std::unique_ptr<MemoryPatternGroup> patterns);
+
+  size_t Size() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCache);
+
+  InputShapes MakeKey(const InputShapes& shapes) const;
+  void EvictIfNeeded();
+
+  struct Entry {
+    // shapes of the run the pattern was traced with
+    InputShapes traced_shapes;
+    std::shared_ptr<const MemoryPatternGroup> patterns;
+    size_t bytes = 0;
+    // position in lru_
+    std::list<const InputShapes*>::iterator lru_position;
+  };
+
+  MemoryPatternCacheOptions options_;
+  std::unordered_map<std::string, std::vector<bool>> dynamic_dims_;
+
+  mutable OrtMutex mutex_;
+  std::map<InputShapes, Entry> entries_;
+  // keys of entries_, most recently used first
+  std::list<const InputShapes*> lru_;
+  size_t total_bytes_ = 0;
+};
+}  // namespace onnxruntime
@@ -68,6 +68,15 @@ MLDataType OpKernelContext::OutputType(int index) const {
   return p_ml_value ? p_ml_value->Type() : nullptr;
 }
 
+MLDataType OpKernelContext::NonTensorOutputType(int index) {
+  if (index < 0 || index >= OutputCount())
+    return nullptr;
+
+  MLValue* p_ml_value = nullptr;
+  ORT_ENFORCE(GetOrCreateOutputMLValue(index, p_ml_value).IsOK());
+  return p_ml_value ? p_ml_value->Type() : nullptr;
+}
+
 Fence_t OpKernelContext::InputFence(int index) const {
   if (index >= InputCount())
     return nullptr;
@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/packed_string_tensor.h"
+
+#include <cstring>
+
+namespace onnxruntime {
+
+PackedStringTensor::PackedStringTensor()
+    : shape_(std::vector<int64_t>{0}), size_(0), offsets_(nullptr), bytes_(nullptr), total_length_(0) {
+}
+
+void PackedStringTensor::Reset(const TensorShape& shape, size_t total_length, AllocatorPtr allocator) {
+  ORT_ENFORCE(shape.Size() >= 0, "shape.Size() must >=0");
+  ORT_ENFORCE(allocator != nullptr);
+  const auto num_strings = static_cast<size_t>(shape.Size());
+
+  size_t offsets_size = 0;
+  if (!IAllocator::CalcMemSizeForArray(num_strings, sizeof(size_t), &offsets_size) ||
+      offsets_size + total_length < offsets_size) {
+    ORT_THROW("size overflow");
+  }
+  BufferUniquePtr buffer;
+  if (offsets_size + total_length > 0) {
+    buffer = BufferUniquePtr(allocator->Alloc(offsets_size + total_length), BufferDeleter(allocator));
+    ORT_ENFORCE(buffer != nullptr, "Failed to allocate ", offsets_size + total_length, " bytes");
+  }
+
+  shape_ = shape;
+  size_ = num_strings;
+  buffer_ = std::move(buffer);
+  offsets_ = static_cast<size_t*>(buffer_.get());
+  bytes_ = static_cast<char*>(buffer_.get()) + offsets_size;
+  total_length_ = total_length;
+}
+
+void PackedStringTensor::Reset(const TensorShape& shape, char* bytes, size_t total_length, size_t* offsets) {
+  ORT_ENFORCE(shape.Size() >= 0, "shape.Size() must >=0");
+  ORT_ENFORCE(offsets != nullptr || shape.Size() == 0);
+  shape_ = shape;
+  size_ = static_cast<size_t>(shape.Size());
+  buffer_.reset();
+  offsets_ = offsets;
+  bytes_ = bytes;
+  total_length_ = total_length;
+}
+
+void PackedStringTensor::Assign(const Tensor& strings, AllocatorPtr allocator) {
+  const auto* src = strings.Data<std::string>();
+  const auto num_strings = static_cast<size_t>(strings.Shape().Size());
+  size_t total_length = 0;
+  for (size_t i = 0; i < num_strings; ++i) {
+    total_length += src[i].size();
+  }
+
+  Reset(strings.Shape(), total_length, std::move(allocator));
+  size_t offset = 0;
+  for (size_t i = 0; i < num_strings; ++i) {
+    offsets_[i] = offset;
+    if (!src[i].empty()) {
+      memcpy(bytes_ + offset, src[i].data(), src[i].size());
+    }
+    offset += src[i].size();
+  }
+}
+
+void PackedStringTensor::CopyTo(Tensor& strings) const {
+  ORT_ENFORCE(strings.Shape() == shape_, "Shape mismatch. ", strings.Shape(), "!=", shape_);
+  auto* dst = strings.MutableData<std::string>();
+  for (size_t i = 0, end = Size(); i < end; ++i) {
+    dst[i].assign(Data(i), Length(i));
+  }
+}
+
+}  // namespace onnxruntime
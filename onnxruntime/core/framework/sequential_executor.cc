@@ -15,9 +15,8 @@
 
 namespace onnxruntime {
 
-static Status FetchOutput(const MLValueNameIdxMap& name_idx_map,
-                          ExecutionFrame& frame,
-                          const std::vector<std::string>& output_names,
+static Status FetchOutput(ExecutionFrame& frame,
+                          const std::vector<int>& fetch_mlvalue_idxs,
                           std::vector<MLValue>& fetches,
                           const logging::Logger& logger);
 
@@ -33,8 +32,6 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
                                    const logging::Logger& logger) {
   bool f_profiler_enabled = session_state.Profiler().FEnabled();
   TimePoint tp;
-  TimePoint sync_time_begin;
-  TimePoint kernel_begin_time;
 
   if (f_profiler_enabled) {
     tp = session_state.Profiler().StartTime();
@@ -42,6 +39,38 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
 
   ExecutionFrame frame{feeds, output_names, fetches, session_state};
 
+  std::vector<int> fetch_mlvalue_idxs;
+  fetch_mlvalue_idxs.reserve(output_names.size());
+  for (const auto& oname : output_names) {
+    int mlvalue_idx;
+    ORT_RETURN_IF_ERROR(session_state.GetMLValueNameIdxMap().GetIdx(oname, mlvalue_idx));
+    fetch_mlvalue_idxs.push_back(mlvalue_idx);
+  }
+
+  ORT_RETURN_IF_ERROR(Execute(session_state, frame, fetch_mlvalue_idxs, fetches, logger));
+
+  if (frame.HasPlan()) {
+    auto mem_patterns = std::make_unique<MemoryPatternGroup>();
+    ORT_RETURN_IF_ERROR(frame.GeneratePatterns(mem_patterns.get()));
+    ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
+  }
+
+  if (f_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SequentialExecutor::Execute", tp);
+  }
+
+  return Status::OK();
+}
+
+Status SequentialExecutor::Execute(const SessionState& session_state,
+                                   ExecutionFrame& frame,
+                                   const std::vector<int>& fetch_mlvalue_idxs,
+                                   std::vector<MLValue>& fetches,
+                                   const logging::Logger& logger) {
+  bool f_profiler_enabled = session_state.Profiler().FEnabled();
+  TimePoint sync_time_begin;
+  TimePoint kernel_begin_time;
+
   LOGS(logger, INFO) << "Begin execution";
   const SequentialExecutionPlan& seq_exec_plan = *session_state.GetExecutionPlan();
   const auto& exec_plan_vec = seq_exec_plan.execution_plan;
@@ -161,54 +190,26 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
   }
 
   VLOGS(logger, 1) << "Fetching output.";
-  ORT_RETURN_IF_ERROR(FetchOutput(session_state.GetMLValueNameIdxMap(), frame, output_names, fetches, logger));
-
-  if (frame.HasPlan()) {
-    std::vector<TensorShape> input_shapes;
-    bool all_tensors = true;
-    for (const auto& feed : feeds) {
-      if (!(feed.second.IsTensor())) {
-        all_tensors = false;
-        break;
-      }
-      auto& tensor = feed.second.Get<Tensor>();
-      input_shapes.push_back(tensor.Shape());
-    }
-
-    if (all_tensors) {
-      auto mem_patterns = std::make_unique<MemoryPatternGroup>();
-      ORT_RETURN_IF_ERROR(frame.GeneratePatterns(mem_patterns.get()));
-      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns)));
-    }
-  }
-
-  if (f_profiler_enabled) {
-    session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SequentialExecutor::Execute", tp);
-  }
-
-  return Status::OK();
+  return FetchOutput(frame, fetch_mlvalue_idxs, fetches, logger);
 }
 
-static Status FetchOutput(const MLValueNameIdxMap& name_idx_map,
-                          ExecutionFrame& frame,
-                          const std::vector<std::string>& output_names,
+static Status FetchOutput(ExecutionFrame& frame,
+                          const std::vector<int>& fetch_mlvalue_idxs,
                           std::vector<MLValue>& fetches,
                           const logging::Logger& logger) {
   if (fetches.empty()) {
-    fetches.resize(output_names.size());
+    fetches.resize(fetch_mlvalue_idxs.size());
   } else {
     // this should've been checked before already
-    ORT_ENFORCE(output_names.size() == fetches.size(),
-                "output_names vector size: " + std::to_string(output_names.size()) +
+    ORT_ENFORCE(fetch_mlvalue_idxs.size() == fetches.size(),
+                "fetch_mlvalue_idxs vector size: " + std::to_string(fetch_mlvalue_idxs.size()) +
                     " does not match that of fetches vector: " + std::to_string(fetches.size()));
   }
 
   auto idx = 0;
 
-  for (const auto& oname : output_names) {
-    VLOGS(logger, 1) << "Attempting to fetch output with name: " << oname;
-    int mlvalue_index;
-    ORT_RETURN_IF_ERROR(name_idx_map.GetIdx(oname, mlvalue_index));
+  for (auto mlvalue_index : fetch_mlvalue_idxs) {
+    VLOGS(logger, 1) << "Attempting to fetch output with index: " << mlvalue_index;
     const MLValue& output_mlvalue = frame.GetMLValue(mlvalue_index);
     VLOGS(logger, 1) << "Copying fetched MLValue to output vector";
     fetches[idx++] = output_mlvalue;
@@ -14,6 +14,8 @@
 #include "core/graph/graph_viewer.h"
 
 namespace onnxruntime {
+class ExecutionFrame;
+
 class SequentialExecutor : public IExecutor {
  public:
   SequentialExecutor(const bool& terminate_flag = false) : terminate_flag_{terminate_flag} {}
@@ -24,6 +26,15 @@ class SequentialExecutor : public IExecutor {
                          std::vector<MLValue>& fetches,
                          const logging::Logger& logger) override;
 
+  // Execute the graph with a frame set up by the caller, which may be reused across executions.
+  // fetch_mlvalue_idxs are the MLValue indices of the values to return in fetches.
+  // The memory pattern traced by the frame, if any, is left to the caller.
+  common::Status Execute(const SessionState& session_state,
+                         ExecutionFrame& frame,
+                         const std::vector<int>& fetch_mlvalue_idxs,
+                         std::vector<MLValue>& fetches,
+                         const logging::Logger& logger);
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SequentialExecutor);
   const bool& terminate_flag_;
@@ -3,6 +3,7 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "core/common/logging/logging.h"
@@ -12,16 +13,31 @@
 using namespace ::onnxruntime::common;
 namespace onnxruntime {
 
+void SessionState::SetSourceState(const SessionState& source) {
+  ORT_ENFORCE(graph_viewer_ == nullptr && session_kernels_.empty() && initialized_tensors_.empty(),
+              "SetSourceState must be called on a SessionState which was not initialized.");
+  // share with the original instance rather than building a chain
+  source_state_ = source.source_state_ != nullptr ? source.source_state_ : &source;
+  export_fused_dll_ = source.export_fused_dll_;
+}
+
 void SessionState::SetGraphViewer(std::unique_ptr<onnxruntime::GraphViewer> graph_viewer) {
   ORT_ENFORCE(nullptr != graph_viewer);
   graph_viewer_ = std::move(graph_viewer);
 }
 
 const onnxruntime::GraphViewer* SessionState::GetGraphViewer() const {
+  if (source_state_ != nullptr) {
+    return source_state_->GetGraphViewer();
+  }
   return graph_viewer_.get();
 }
 
 const OpKernel* SessionState::GetKernel(onnxruntime::NodeIndex node_id) const {
+  if (source_state_ != nullptr) {
+    return source_state_->GetKernel(node_id);
+  }
+
   if (session_kernels_.count(node_id) == 0) {
     return nullptr;
   }
@@ -39,6 +55,9 @@ void SessionState::SetExecutionPlan(std::unique_ptr<SequentialExecutionPlan> p_s
 }
 
 const SequentialExecutionPlan* SessionState::GetExecutionPlan() const {
+  if (source_state_ != nullptr) {
+    return source_state_->GetExecutionPlan();
+  }
   return p_seq_exec_plan_.get();
 }
 
@@ -48,6 +67,9 @@ void SessionState::AddInitializedTensor(int mlvalue_index, const MLValue& mlvalu
 }
 
 const std::unordered_map<int, MLValue>& SessionState::GetInitializedTensors() const {
+  if (source_state_ != nullptr) {
+    return source_state_->GetInitializedTensors();
+  }
   return initialized_tensors_;
 }
 
@@ -70,38 +92,46 @@ void SessionState::SetProfiler(profiling::Profiler& profiler) {
   return *profiler_;
 }
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<TensorShape>& shapes) {
-  int64_t key = 0;
-  for (auto& shape : shapes) {
-    for (auto dim : shape.GetDims())
-      key ^= dim;
+// Returns false if some feed is not a tensor, in which case memory patterns are not used.
+static bool GetInputShapes(const NameMLValMap& feeds, MemoryPatternCache::InputShapes& shapes) {
+  shapes.clear();
+  shapes.reserve(feeds.size());
+  for (const auto& feed : feeds) {
+    if (!feed.second.IsTensor())
+      return false;
+    shapes.emplace_back(feed.first, feed.second.Get<Tensor>().Shape().GetDims());
   }
-  return key;
+  std::sort(shapes.begin(), shapes.end());
+  return true;
 }
 
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const {
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end())
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(const NameMLValMap& feeds) const {
+  MemoryPatternCache::InputShapes shapes;
+  if (!GetInputShapes(feeds, shapes))
     return nullptr;
 
-  return it->second.get();
+  return mem_patterns_.Get(shapes);
 }
 
-Status SessionState::UpdateMemoryPatternGroupCache(const std::vector<TensorShape>& input_shape,
+Status SessionState::UpdateMemoryPatternGroupCache(const NameMLValMap& feeds,
                                                    std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shape);
-
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
-  }
+  MemoryPatternCache::InputShapes shapes;
+  if (GetInputShapes(feeds, shapes))
+    mem_patterns_.Put(shapes, std::move(mem_patterns));
 
   return Status::OK();
 }
 
+void SessionState::SetMemoryPatternCacheOptions(const MemoryPatternCacheOptions& options,
+                                                std::unordered_map<std::string, std::vector<bool>> dynamic_dims) {
+  mem_patterns_.SetOptions(options);
+  mem_patterns_.SetDynamicDims(std::move(dynamic_dims));
+}
+
+TensorShape SessionState::GetMemoryPatternBucketShape(const std::string& input_name, const TensorShape& shape) const {
+  return TensorShape(mem_patterns_.BucketShape(input_name, shape.GetDims()));
+}
+
 void SessionState::SetEnableMemoryPattern(bool flag) {
   enable_mem_pattern_ = flag;
 }
@@ -155,6 +185,9 @@ common::Status SessionState::AddInputNameToNodeInfoMapping(const std::string& in
 }
 
 common::Status SessionState::GetInputNodeInfo(const std::string& input_name, std::vector<NodeInfo>& node_info_vec) const {
+  if (source_state_ != nullptr) {
+    return source_state_->GetInputNodeInfo(input_name, node_info_vec);
+  }
   if (!input_names_to_nodeinfo_mapping_.count(input_name)) {
     return Status(ONNXRUNTIME, FAIL, "Failed to find input name in the mapping: " + input_name);
   }
@@ -163,6 +196,9 @@ common::Status SessionState::GetInputNodeInfo(const std::string& input_name, std
 }
 
 const SessionState::NameNodeInfoMapType& SessionState::GetInputNodeInfoMap() const {
+  if (source_state_ != nullptr) {
+    return source_state_->GetInputNodeInfoMap();
+  }
   return input_names_to_nodeinfo_mapping_;
 }
 
@@ -171,6 +207,9 @@ void SessionState::AddOutputNameToNodeInfoMapping(const std::string& output_name
 }
 
 const SessionState::NameNodeInfoMapType& SessionState::GetOutputNodeInfoMap() const {
+  if (source_state_ != nullptr) {
+    return source_state_->GetOutputNodeInfoMap();
+  }
   return output_names_to_nodeinfo_mapping_;
 }
 
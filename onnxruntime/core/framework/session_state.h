@@ -14,8 +14,10 @@
 #include "core/common/profiler.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_providers.h"
+#include "core/framework/framework_common.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/mlvalue_name_idx_map.h"
 #include "core/graph/graph_viewer.h"
@@ -45,6 +47,14 @@ class SessionState {
       : execution_providers_{execution_providers} {
   }
 
+  /**
+  Share the graph, kernels, initialized tensors and execution plan of source, which must outlive this instance,
+  instead of creating them. The execution providers (and therefore the memory allocated during execution),
+  thread pool, logger, profiler, memory pattern cache and subgraph SessionState instances remain specific
+  to this instance.
+  */
+  void SetSourceState(const SessionState& source);
+
   // Graph viewer.
   void SetGraphViewer(std::unique_ptr<onnxruntime::GraphViewer> graph_viewer);
   const onnxruntime::GraphViewer* GetGraphViewer() const;
@@ -58,7 +68,9 @@ class SessionState {
 
   const ExecutionProviders& GetExecutionProviders() const noexcept { return execution_providers_; }
 
-  const MLValueNameIdxMap& GetMLValueNameIdxMap() const noexcept { return mlvalue_name_idx_map_; }
+  const MLValueNameIdxMap& GetMLValueNameIdxMap() const noexcept {
+    return source_state_ != nullptr ? source_state_->GetMLValueNameIdxMap() : mlvalue_name_idx_map_;
+  }
   MLValueNameIdxMap& GetMLValueNameIdxMap() noexcept { return mlvalue_name_idx_map_; }
 
   // initialized tensors
@@ -101,17 +113,31 @@ class SessionState {
   profiling::Profiler& Profiler() const;
 
   /**
-  Get cached memory pattern based on input shapes
+  Get cached memory pattern based on input shapes.
+  Returns nullptr if there is no pattern for shapes like these or if some input is not a tensor.
+  The pattern stays valid as long as the returned pointer is held, even if it is evicted meanwhile.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const;
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(const NameMLValMap& feeds) const;
 
   /**
   Set generated memory pattern with a given input shapes. 
   Const as it's an internal cache update only.
   */
-  Status UpdateMemoryPatternGroupCache(const std::vector<TensorShape>& input_shape,
+  Status UpdateMemoryPatternGroupCache(const NameMLValMap& feeds,
                                        std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
 
+  /**
+  Configure bucketing and bounds of the memory pattern cache.
+  @param dynamic_dims maps a graph input name to the dimensions of that input that may vary between runs.
+  */
+  void SetMemoryPatternCacheOptions(const MemoryPatternCacheOptions& options,
+                                    std::unordered_map<std::string, std::vector<bool>> dynamic_dims);
+
+  /**
+  Get the shape a graph input is rounded up to by the memory pattern cache.
+  */
+  TensorShape GetMemoryPatternBucketShape(const std::string& input_name, const TensorShape& shape) const;
+
   /**
   Set enable memory pattern flag
   */
@@ -163,7 +189,9 @@ class SessionState {
 
   bool ExportDll() const { return export_fused_dll_; }
   void SetExportDllFlag(bool flag) { export_fused_dll_ = flag; }
-  const FuncManager* GetFuncMgr() const { return &fused_funcs_mgr_; }
+  const FuncManager* GetFuncMgr() const {
+    return source_state_ != nullptr ? source_state_->GetFuncMgr() : &fused_funcs_mgr_;
+  }
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionState);
@@ -174,6 +202,9 @@ class SessionState {
   std::unique_ptr<onnxruntime::GraphViewer> graph_viewer_;
 
   const ExecutionProviders& execution_providers_;  // owned by InferenceSession
+
+  // SessionState providing the graph, kernels, initialized tensors and plan if set by SetSourceState.
+  const SessionState* source_state_ = nullptr;
   MLValueNameIdxMap mlvalue_name_idx_map_;
 
   // initialized tensorset
@@ -185,10 +216,8 @@ class SessionState {
 
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_ = true;
-  // lock for the mem_patterns_
-  mutable OrtMutex mem_patterns_lock_;
   // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
+  mutable MemoryPatternCache mem_patterns_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
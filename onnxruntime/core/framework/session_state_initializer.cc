@@ -3,11 +3,17 @@
 
 #include "core/framework/session_state_initializer.h"
 
+#include <atomic>
 #include <functional>
+#include <future>
 #include <limits>
+#include <thread>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
+#ifndef USE_EIGEN_THREADPOOL
+#include "core/common/task_thread_pool.h"
+#endif
 
 #include "core/graph/graph_viewer.h"
 #include "core/graph/graph_transformer.h"
@@ -20,6 +26,7 @@
 #include "core/framework/mlvalue_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/framework/tensorutils.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/transformer_memcpy.h"
@@ -35,6 +42,7 @@ using SaveTensorFunc = std::function<void(int idx, const onnxruntime::MLValue&)>
 
 static common::Status SaveInitializedTensors(const onnxruntime::Graph& graph,
                                              bool enable_memory_pattern,
+                                             const SessionState& session_state,
                                              const SequentialExecutionPlan& execution_plan,
                                              const ExecutionProviders& exec_providers,
                                              const MLValueNameIdxMap& mlvalue_name_idx_map,
@@ -42,6 +50,17 @@ static common::Status SaveInitializedTensors(const onnxruntime::Graph& graph,
                                              const SaveTensorFunc& save_tensor_func,
                                              const logging::Logger& logger);
 
+static common::Status SaveInitializedTensorsWithSharedStore(
+    const onnxruntime::Graph& graph,
+    const SessionState& session_state,
+    const SequentialExecutionPlan& execution_plan,
+    const ExecutionProviders& exec_providers,
+    const MLValueNameIdxMap& mlvalue_name_idx_map,
+    SharedInitializerStore& store,
+    std::vector<std::shared_ptr<const Tensor>>& shared_tensors,
+    const SaveTensorFunc& save_tensor_func,
+    const logging::Logger& logger);
+
 static common::Status SaveKernels(const ExecutionProviders& execution_providers,
                                   SessionState& session_state,
                                   const KernelRegistryManager& custom_registry_manager,
@@ -118,9 +137,15 @@ common::Status SessionStateInitializer::InitializeAndSave(bool enable_memory_pat
     session_state_.AddInitializedTensor(idx, value);
   };
 
-  ORT_RETURN_IF_ERROR(SaveInitializedTensors(graph_, enable_memory_pattern, exec_plan,
-                                             execution_providers_, mlvalue_name_idx_map, weights_buffers,
-                                             add_initialized_tensor, logger_));
+  if (shared_initializer_store_ != nullptr) {
+    ORT_RETURN_IF_ERROR(SaveInitializedTensorsWithSharedStore(graph_, session_state_, exec_plan, execution_providers_,
+                                                              mlvalue_name_idx_map, *shared_initializer_store_,
+                                                              *shared_tensors_, add_initialized_tensor, logger_));
+  } else {
+    ORT_RETURN_IF_ERROR(SaveInitializedTensors(graph_, enable_memory_pattern, session_state_, exec_plan,
+                                               execution_providers_, mlvalue_name_idx_map, weights_buffers,
+                                               add_initialized_tensor, logger_));
+  }
 
   graph_.CleanAllInitializedTensors();  // remove weights from the graph now to save memory
 
@@ -185,6 +210,61 @@ common::Status SaveMLValueNameIndexMapping(const onnxruntime::Graph& graph,
   return Status::OK();
 }
 
+static bool IsCpuLocation(const OrtAllocatorInfo& alloc_info) {
+  return strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput;
+}
+
+// Call func for the indexes in [0, n) as tasks of the session thread pool, or in order when the session has none.
+// The first failure is returned once all the tasks are done.
+static common::Status RunInParallel(const SessionState& session_state, size_t n,
+                                    const std::function<common::Status(size_t)>& func) {
+  auto* thread_pool = session_state.GetThreadPool();
+  if (thread_pool == nullptr || n < 2) {
+    for (size_t i = 0; i < n; ++i) {
+      ORT_RETURN_IF_ERROR(func(i));
+    }
+    return Status::OK();
+  }
+
+  std::vector<Status> statuses(n);
+  auto run = [&func, &statuses](size_t i) {
+    try {
+      statuses[i] = func(i);
+    } catch (const std::exception& ex) {
+      statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+    }
+  };
+
+#ifdef USE_EIGEN_THREADPOOL
+  std::atomic<size_t> done(0);
+  for (size_t i = 0; i < n; ++i) {
+    thread_pool->Schedule([&run, i, &done]() {
+      run(i);
+      ++done;
+    });
+  }
+  while (done != n) {
+    std::this_thread::yield();
+  }
+#else
+  std::vector<std::future<void>> task_results;
+  task_results.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    std::packaged_task<void()> task{std::bind(run, i)};
+    task_results.emplace_back(task.get_future());
+    thread_pool->RunTask(std::move(task));
+  }
+  for (auto& future : task_results) {
+    future.get();
+  }
+#endif
+
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  return Status::OK();
+}
+
 common::Status DeserializeTensorProto(const ONNX_NAMESPACE::TensorProto& tensor_proto,
                                       const OrtAllocatorInfo& alloc_info,
                                       const ExecutionProviders& exec_providers,
@@ -194,7 +274,7 @@ common::Status DeserializeTensorProto(const ONNX_NAMESPACE::TensorProto& tensor_
     return Status(common::ONNXRUNTIME, common::FAIL, "Failed to get allocator for alloc_info: " + alloc_info.ToString());
   }
 
-  if (strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput) {
+  if (IsCpuLocation(alloc_info)) {
     // deserialize directly to CPU tensor
     return utils::TensorProtoToMLValue(tensor_proto, alloc_ptr, preallocated, preallocated_size, mlvalue);
   }
@@ -233,6 +313,54 @@ common::Status DeserializeTensorProto(const ONNX_NAMESPACE::TensorProto& tensor_
   return common::Status::OK();
 }
 
+// An initializer to deserialize, in the preallocated buffer if any
+struct TensorToDeserialize {
+  const std::string* name;
+  int mlvalue_index;
+  const ONNX_NAMESPACE::TensorProto* tensor_proto;
+  const OrtAllocatorInfo* location;
+  void* preallocated;
+  size_t preallocated_size;
+};
+
+// Deserialize the tensors and save them in order. The CPU ones are deserialized in parallel, the others one
+// by one as they are copied to their device by the provider.
+static common::Status DeserializeAndSaveTensors(const std::vector<TensorToDeserialize>& tensors,
+                                                const SessionState& session_state,
+                                                const ExecutionProviders& exec_providers,
+                                                const SaveTensorFunc& save_tensor_func,
+                                                const logging::Logger& logger) {
+  std::vector<MLValue> mlvalues(tensors.size());
+  auto deserialize = [&tensors, &exec_providers, &mlvalues](size_t i) {
+    const TensorToDeserialize& tensor = tensors[i];
+    Status st = DeserializeTensorProto(*tensor.tensor_proto, *tensor.location, exec_providers, mlvalues[i],
+                                       tensor.preallocated, tensor.preallocated_size);
+    if (!st.IsOK()) {
+      std::ostringstream oss;
+      oss << "Deserialize tensor " << *tensor.name << " failed." << st.ErrorMessage();
+      return Status(st.Category(), st.Code(), oss.str());
+    }
+    return Status::OK();
+  };
+
+  std::vector<size_t> cpu_tensors;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    if (IsCpuLocation(*tensors[i].location)) {
+      cpu_tensors.push_back(i);
+    } else {
+      ORT_RETURN_IF_ERROR(deserialize(i));
+    }
+  }
+  ORT_RETURN_IF_ERROR(RunInParallel(session_state, cpu_tensors.size(),
+                                    [&deserialize, &cpu_tensors](size_t i) { return deserialize(cpu_tensors[i]); }));
+
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    save_tensor_func(tensors[i].mlvalue_index, mlvalues[i]);
+    VLOGS(logger, 1) << "Added weight with name : " << *tensors[i].name << " with index: " << tensors[i].mlvalue_index;
+  }
+  return Status::OK();
+}
+
 static common::Status PlanTensor(MLValuePatternPlanner& planner, const MLValueNameIdxMap& mlvalue_name_idx_map, const std::string& name, const ONNX_NAMESPACE::TensorProto& tensor_proto) {
   int mlvalue_index;
   ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(name, mlvalue_index));
@@ -244,6 +372,7 @@ static common::Status PlanTensor(MLValuePatternPlanner& planner, const MLValueNa
 }
 
 common::Status SaveInitializedTensorsWithMemPattern(const Graph& graph,
+                                                    const SessionState& session_state,
                                                     const SequentialExecutionPlan& execution_plan,
                                                     const ExecutionProviders& exec_providers,
                                                     const MLValueNameIdxMap& mlvalue_name_idx_map,
@@ -281,6 +410,8 @@ common::Status SaveInitializedTensorsWithMemPattern(const Graph& graph,
   }
 
   //3. create weight tensors based on weights buffer
+  std::vector<TensorToDeserialize> tensors;
+  tensors.reserve(initialized_tensor_set.size());
   for (const auto& entry : initialized_tensor_set) {
     const std::string& name = entry.first;
     int mlvalue_index;
@@ -296,7 +427,6 @@ common::Status SaveInitializedTensorsWithMemPattern(const Graph& graph,
     if (pattern == nullptr)
       return Status(common::ONNXRUNTIME, common::FAIL, "mem pattern not found");
     auto block = pattern->GetBlock(mlvalue_index);
-    MLValue mlvalue;
     // if block is not found, means this mlvalue is not traced
     // fall back to allocate separate buffer.
 
@@ -304,29 +434,21 @@ common::Status SaveInitializedTensorsWithMemPattern(const Graph& graph,
     if (it->second == nullptr) {
       block = nullptr;
     }
-    Status st;
     if (!block) {
-      st = DeserializeTensorProto(tensor_proto, location, exec_providers, mlvalue, nullptr, 0);
+      tensors.push_back({&name, mlvalue_index, &tensor_proto, &location, nullptr, 0});
     } else {
-      st = DeserializeTensorProto(tensor_proto, location, exec_providers, mlvalue,
-                                  (uint8_t*)it->second.get() + block->offset_, block->size_);
-    }
-    if (!st.IsOK()) {
-      std::ostringstream oss;
-      oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
-      return Status(st.Category(), st.Code(), oss.str());
+      tensors.push_back({&name, mlvalue_index, &tensor_proto, &location,
+                         (uint8_t*)it->second.get() + block->offset_, block->size_});
     }
-
-    save_tensor_func(mlvalue_index, mlvalue);
-
-    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << mlvalue_index;
   }
+  ORT_RETURN_IF_ERROR(DeserializeAndSaveTensors(tensors, session_state, exec_providers, save_tensor_func, logger));
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
   return common::Status::OK();
 }
 
 common::Status SaveInitializedTensorsWithSeperateBuffer(const onnxruntime::Graph& graph,
+                                                        const SessionState& session_state,
                                                         const SequentialExecutionPlan& execution_plan,
                                                         const ExecutionProviders& exec_providers,
                                                         const MLValueNameIdxMap& mlvalue_name_idx_map,
@@ -337,17 +459,17 @@ common::Status SaveInitializedTensorsWithSeperateBuffer(const onnxruntime::Graph
   ORT_ENFORCE(mlvalue_name_idx_map.MaxIdx() > 0, "MLValue indexes should have been populated.");
 
   const onnxruntime::InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
+  std::vector<TensorToDeserialize> tensors;
+  tensors.reserve(initialized_tensor_set.size());
   for (const auto& entry : initialized_tensor_set) {
     const std::string& name = entry.first;
     int mlvalue_index;
     ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(name, mlvalue_index));
     VLOGS(logger, 1) << "About to add weight with name: " << name << " and index: " << mlvalue_index;
     auto& location = execution_plan.allocation_plan[mlvalue_index].location;
-    MLValue mlvalue;
-    ORT_RETURN_IF_ERROR(DeserializeTensorProto(*(entry.second), location, exec_providers, mlvalue, nullptr, 0));
-    save_tensor_func(mlvalue_index, mlvalue);
-    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << mlvalue_index;
+    tensors.push_back({&name, mlvalue_index, entry.second, &location, nullptr, 0});
   }
+  ORT_RETURN_IF_ERROR(DeserializeAndSaveTensors(tensors, session_state, exec_providers, save_tensor_func, logger));
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
   return common::Status::OK();
@@ -355,6 +477,7 @@ common::Status SaveInitializedTensorsWithSeperateBuffer(const onnxruntime::Graph
 
 common::Status SaveInitializedTensors(const onnxruntime::Graph& graph,
                                       bool enable_memory_pattern,
+                                      const SessionState& session_state,
                                       const SequentialExecutionPlan& execution_plan,
                                       const ExecutionProviders& exec_providers,
                                       const MLValueNameIdxMap& mlvalue_name_idx_map,
@@ -365,13 +488,78 @@ common::Status SaveInitializedTensors(const onnxruntime::Graph& graph,
   // go with mem pattern approach, which will allocate a big chunk for all
   // the weights.
   if (enable_memory_pattern) {
-    return SaveInitializedTensorsWithMemPattern(graph, execution_plan, exec_providers,
+    return SaveInitializedTensorsWithMemPattern(graph, session_state, execution_plan, exec_providers,
                                                 mlvalue_name_idx_map, weights_buffers, save_tensor_func, logger);
   }
-  return SaveInitializedTensorsWithSeperateBuffer(graph, execution_plan, exec_providers,
+  return SaveInitializedTensorsWithSeperateBuffer(graph, session_state, execution_plan, exec_providers,
                                                   mlvalue_name_idx_map, save_tensor_func, logger);
 }
 
+common::Status SaveInitializedTensorsWithSharedStore(const onnxruntime::Graph& graph,
+                                                    const SessionState& session_state,
+                                                    const SequentialExecutionPlan& execution_plan,
+                                                    const ExecutionProviders& exec_providers,
+                                                    const MLValueNameIdxMap& mlvalue_name_idx_map,
+                                                    SharedInitializerStore& store,
+                                                    std::vector<std::shared_ptr<const Tensor>>& shared_tensors,
+                                                    const SaveTensorFunc& save_tensor_func,
+                                                    const logging::Logger& logger) {
+  LOGS(logger, INFO) << "Saving initialized tensors with the shared initializer store.";
+
+  ORT_ENFORCE(mlvalue_name_idx_map.MaxIdx() > 0, "MLValue indexes should have been populated.");
+
+  // the shared tensors outlive the session that added them, so they don't use its arena
+  AllocatorPtr shared_alloc = std::make_shared<CPUAllocator>();
+
+  std::vector<TensorToDeserialize> shareable_tensors;
+  std::vector<TensorToDeserialize> other_tensors;
+  const onnxruntime::InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
+  for (const auto& entry : initialized_tensor_set) {
+    const std::string& name = entry.first;
+    int mlvalue_index;
+    ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(name, mlvalue_index));
+    const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
+    auto& location = execution_plan.allocation_plan[mlvalue_index].location;
+
+    if (strcmp(location.name, CPU) == 0 &&
+        tensor_proto.data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+      shareable_tensors.push_back({&name, mlvalue_index, &tensor_proto, &location, nullptr, 0});
+    } else {
+      other_tensors.push_back({&name, mlvalue_index, &tensor_proto, &location, nullptr, 0});
+    }
+  }
+
+  // the tensors are deserialized in parallel, then looked up in the store in order
+  std::vector<std::unique_ptr<Tensor>> p_tensors(shareable_tensors.size());
+  ORT_RETURN_IF_ERROR(RunInParallel(session_state, shareable_tensors.size(),
+                                    [&shareable_tensors, &p_tensors, &shared_alloc](size_t i) {
+                                      return utils::GetTensorFromTensorProto(*shareable_tensors[i].tensor_proto,
+                                                                             &p_tensors[i], shared_alloc);
+                                    }));
+
+  for (size_t i = 0; i < shareable_tensors.size(); ++i) {
+    const TensorToDeserialize& tensor = shareable_tensors[i];
+    std::shared_ptr<const Tensor> shared = store.GetOrAdd(std::move(p_tensors[i]));
+    // the session holds the shared tensor through shared_tensors, its MLValue doesn't own the buffer
+    auto p_view = std::make_unique<Tensor>(shared->DataType(), shared->Shape(),
+                                           const_cast<void*>(shared->DataRaw()), *tensor.location);
+    MLValue mlvalue;
+    mlvalue.Init(p_view.release(),
+                 DataTypeImpl::GetType<Tensor>(),
+                 DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    shared_tensors.push_back(std::move(shared));
+
+    save_tensor_func(tensor.mlvalue_index, mlvalue);
+    VLOGS(logger, 1) << "Added weight with name : " << *tensor.name << " with index: " << tensor.mlvalue_index;
+  }
+
+  ORT_RETURN_IF_ERROR(DeserializeAndSaveTensors(other_tensors, session_state, exec_providers, save_tensor_func,
+                                                logger));
+
+  LOGS(logger, INFO) << "Done saving initialized tensors";
+  return common::Status::OK();
+}
+
 static common::Status CreateOpKernelInternal(const onnxruntime::Node& node,
                                              const IExecutionProvider& exec_provider,
                                              const SessionState& session_state,
@@ -412,11 +600,35 @@ common::Status SaveKernels(const ExecutionProviders& execution_providers,
                            const logging::Logger& logger) {
   LOGS(logger, INFO) << "Saving kernels.";
 
+  std::vector<const Node*> nodes;
   for (auto& node : session_state.GetGraphViewer()->Nodes()) {
-    // construct and save the kernels
-    std::unique_ptr<OpKernel> op_kernel;
-    ORT_RETURN_IF_ERROR(CreateOpKernel(node, execution_providers, session_state, custom_registry_manager, op_kernel, logger));
-    session_state.AddKernel(node.Index(), std::move(op_kernel));
+    nodes.push_back(&node);
+  }
+
+  // construct the kernels, the CPU ones in parallel. the kernels of other providers may set up device state
+  // bound to the thread creating them, and the kernels of custom registries (e.g. the custom ops loaded from a
+  // library) may not be safe to construct concurrently, so they are constructed one by one.
+  std::vector<std::unique_ptr<OpKernel>> op_kernels(nodes.size());
+  auto create_kernel = [&](size_t i) {
+    return CreateOpKernel(*nodes[i], execution_providers, session_state, custom_registry_manager, op_kernels[i],
+                          logger);
+  };
+
+  std::vector<size_t> cpu_nodes;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (nodes[i]->GetExecutionProviderType() == kCpuExecutionProvider &&
+        custom_registry_manager.IsExecutionProviderKernel(*nodes[i])) {
+      cpu_nodes.push_back(i);
+    } else {
+      ORT_RETURN_IF_ERROR(create_kernel(i));
+    }
+  }
+  ORT_RETURN_IF_ERROR(RunInParallel(session_state, cpu_nodes.size(),
+                                    [&create_kernel, &cpu_nodes](size_t i) { return create_kernel(cpu_nodes[i]); }));
+
+  // save the kernels
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    session_state.AddKernel(nodes[i]->Index(), std::move(op_kernels[i]));
   }
 
   LOGS(logger, INFO) << "Done saving kernels.";
@@ -3,6 +3,8 @@
 
 #pragma once
 #include <map>
+#include <memory>
+#include <vector>
 
 #include "core/framework/allocator.h"
 #include "core/framework/tensor.h"
@@ -15,6 +17,7 @@ class InsertCastTransformer;
 class KernelRegistryManager;
 class NodeArg;
 class SessionState;
+class SharedInitializerStore;
 
 namespace logging {
 class Logger;
@@ -31,6 +34,15 @@ class SessionStateInitializer {
   common::Status CreatePlan(const std::vector<NodeArg*>& outer_scope_node_args,
                             bool enable_sequential_execution);
 
+  // Deduplicate the CPU initialized tensors with those of other sessions through store.
+  // The shared tensors used are added to shared_tensors, which must outlive the SessionState.
+  // Initialized tensors are then allocated separately rather than using a memory pattern.
+  void SetSharedInitializerStore(SharedInitializerStore* store,
+                                 std::vector<std::shared_ptr<const Tensor>>* shared_tensors) {
+    shared_initializer_store_ = store;
+    shared_tensors_ = shared_tensors;
+  }
+
   // initialize tensors, and save. save kernels and input/output node mappings
   // @param enable_memory_pattern
   common::Status InitializeAndSave(bool enable_memory_pattern,
@@ -44,5 +56,8 @@ class SessionStateInitializer {
   const ExecutionProviders& execution_providers_;
   KernelRegistryManager& kernel_registry_manager_;
   const logging::Logger& logger_;
+
+  SharedInitializerStore* shared_initializer_store_ = nullptr;
+  std::vector<std::shared_ptr<const Tensor>>* shared_tensors_ = nullptr;
 };
 }  // namespace onnxruntime
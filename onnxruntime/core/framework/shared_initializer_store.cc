@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_store.h"
+
+#include <cstring>
+
+namespace onnxruntime {
+
+bool SharedInitializerStore::CanShare(const Tensor& tensor) {
+  return strcmp(tensor.Location().name, CPU) == 0 && tensor.DataType() != DataTypeImpl::GetType<std::string>();
+}
+
+// FNV-1a over the element type, the dimensions and the content
+size_t SharedInitializerStore::Hash(const Tensor& tensor) {
+  uint64_t hash = 14695981039346656037ULL;
+  auto add_bytes = [&hash](const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash ^= bytes[i];
+      hash *= 1099511628211ULL;
+    }
+  };
+
+  MLDataType type = tensor.DataType();
+  add_bytes(&type, sizeof(type));
+  const auto& dims = tensor.Shape().GetDims();
+  add_bytes(dims.data(), dims.size() * sizeof(int64_t));
+  add_bytes(tensor.DataRaw(), tensor.Size());
+  return static_cast<size_t>(hash);
+}
+
+static bool HaveSameContent(const Tensor& a, const Tensor& b) {
+  return a.DataType() == b.DataType() && a.Shape() == b.Shape() &&
+         (a.Size() == 0 || memcmp(a.DataRaw(), b.DataRaw(), a.Size()) == 0);
+}
+
+std::shared_ptr<const Tensor> SharedInitializerStore::GetOrAdd(std::unique_ptr<Tensor> tensor) {
+  ORT_ENFORCE(tensor != nullptr && CanShare(*tensor), "Only CPU tensors of fixed size types can be shared.");
+  const size_t hash = Hash(*tensor);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto range = tensors_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    std::shared_ptr<const Tensor> existing = it->second.lock();
+    if (existing != nullptr && HaveSameContent(*existing, *tensor)) {
+      return existing;
+    }
+  }
+
+  // the number of entries stays proportional to the number of tensors held
+  if (++num_added_since_cleanup_ > tensors_.size() / 2) {
+    RemoveExpired();
+  }
+
+  std::shared_ptr<const Tensor> shared{tensor.release()};
+  tensors_.emplace(hash, shared);
+  return shared;
+}
+
+size_t SharedInitializerStore::Size() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  size_t size = 0;
+  for (const auto& entry : tensors_) {
+    if (!entry.second.expired()) {
+      ++size;
+    }
+  }
+  return size;
+}
+
+void SharedInitializerStore::RemoveExpired() {
+  for (auto it = tensors_.begin(); it != tensors_.end();) {
+    if (it->second.expired()) {
+      it = tensors_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  num_added_since_cleanup_ = 0;
+}
+
+}  // namespace onnxruntime
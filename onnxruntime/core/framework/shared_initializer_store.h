@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/tensor.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+   Deduplicates identical initialized tensors (weights) across sessions, e.g. between fine-tuned
+   variants of a model sharing most of their weights.
+   Tensors are looked up by a hash of their type, shape and content, and compared in full on a match.
+   A tensor stays in the store while a session holds it, the store itself only keeps weak references.
+   Only CPU tensors of fixed size types can be shared.
+   This class is thread safe.
+*/
+class SharedInitializerStore {
+ public:
+  SharedInitializerStore() = default;
+
+  /**
+     Whether tensor can be added to the store.
+  */
+  static bool CanShare(const Tensor& tensor);
+
+  /**
+     Return the tensor of the store with the same type, shape and content as tensor if there is one,
+     otherwise add tensor to the store and return it.
+     @param tensor a tensor which CanShare, owning its buffer.
+     @return the shared tensor, which remains in the store as long as this pointer or a copy of it is held.
+  */
+  std::shared_ptr<const Tensor> GetOrAdd(std::unique_ptr<Tensor> tensor);
+
+  /**
+     Number of distinct tensors currently held by sessions.
+  */
+  size_t Size() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedInitializerStore);
+
+  static size_t Hash(const Tensor& tensor);
+
+  // Drop the entries of the tensors no session holds anymore.
+  void RemoveExpired();  // REQUIRES(mutex_)
+
+  mutable OrtMutex mutex_;
+  std::unordered_multimap<size_t, std::weak_ptr<const Tensor>> tensors_;  // GUARDED_BY(mutex_)
+  size_t num_added_since_cleanup_ = 0;                                   // GUARDED_BY(mutex_)
+};
+}  // namespace onnxruntime
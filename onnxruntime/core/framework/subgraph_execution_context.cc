@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/subgraph_execution_context.h"
+
+#include "core/framework/session_state.h"
+#include "core/framework/utils.h"
+
+namespace onnxruntime {
+
+SubgraphExecutionContext::SubgraphExecutionContext(const SessionState& session_state,
+                                                   const std::vector<std::string>& feed_names,
+                                                   const std::vector<std::string>& output_names,
+                                                   const bool& terminate_flag,
+                                                   const logging::Logger& logger)
+    : session_state_{session_state},
+      feed_names_{feed_names},
+      output_names_{output_names},
+      terminate_flag_{terminate_flag},
+      logger_{logger},
+      executor_{terminate_flag} {
+  for (const auto& provider : session_state_.GetExecutionProviders()) {
+    if (provider->Type() != onnxruntime::kCpuExecutionProvider) {
+      copy_across_devices_ = true;
+      break;
+    }
+  }
+
+  if (copy_across_devices_)
+    return;
+
+  const auto& mlvalue_idx_map = session_state_.GetMLValueNameIdxMap();
+
+  feed_mlvalue_idxs_.reserve(feed_names_.size());
+  for (const auto& name : feed_names_) {
+    int mlvalue_idx;
+    Status status = mlvalue_idx_map.GetIdx(name, mlvalue_idx);
+    ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+    feed_mlvalue_idxs_.push_back(mlvalue_idx);
+  }
+
+  fetch_mlvalue_idxs_.reserve(output_names_.size());
+  for (const auto& name : output_names_) {
+    int mlvalue_idx;
+    Status status = mlvalue_idx_map.GetIdx(name, mlvalue_idx);
+    ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+    fetch_mlvalue_idxs_.push_back(mlvalue_idx);
+  }
+}
+
+Status SubgraphExecutionContext::Execute(const std::vector<MLValue>& feeds, std::vector<MLValue>& fetches) {
+  ORT_ENFORCE(feeds.size() == feed_names_.size(), "Expected ", feed_names_.size(), " feeds. Got ", feeds.size());
+
+  if (copy_across_devices_) {
+    NameMLValMap feed_map;
+    feed_map.reserve(feeds.size());
+    for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+      feed_map[feed_names_[i]] = feeds[i];
+    }
+
+    return utils::ExecuteGraph(session_state_, feed_map, output_names_, fetches, /*sequential_execution*/ true,
+                               terminate_flag_, logger_);
+  }
+
+  // always pass one fetch per output so the frame knows which values must not be part of the memory pattern
+  if (fetches.empty()) {
+    fetches.resize(output_names_.size());
+  }
+
+  if (!frame_) {
+    frame_ = std::make_unique<ExecutionFrame>(feed_mlvalue_idxs_, feeds, fetch_mlvalue_idxs_, fetches, session_state_);
+    use_mem_patterns_ = frame_->HasPlan();
+  } else {
+    frame_->UpdateFeedsAndFetches(feed_mlvalue_idxs_, feeds, fetch_mlvalue_idxs_, fetches);
+
+    // blocks of the current pattern may be too small for larger feeds
+    if (use_mem_patterns_ && !frame_->HasPlan() && !FeedsCoveredByTracedShapes(feeds)) {
+      frame_->TracePatterns();
+    }
+  }
+
+  ORT_RETURN_IF_ERROR(executor_.Execute(session_state_, *frame_, fetch_mlvalue_idxs_, fetches, logger_));
+
+  if (frame_->HasPlan()) {
+    SaveTracedShapes(feeds);
+    ORT_RETURN_IF_ERROR(frame_->UseGeneratedPatterns());
+  }
+
+  return Status::OK();
+}
+
+bool SubgraphExecutionContext::FeedsCoveredByTracedShapes(const std::vector<MLValue>& feeds) const {
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    const auto& dims = feeds[i].Get<Tensor>().Shape().GetDims();
+    const auto& traced_dims = traced_shapes_[i];
+    if (dims.size() != traced_dims.size())
+      return false;
+
+    for (size_t j = 0; j < dims.size(); ++j) {
+      if (dims[j] > traced_dims[j])
+        return false;
+    }
+  }
+
+  return true;
+}
+
+void SubgraphExecutionContext::SaveTracedShapes(const std::vector<MLValue>& feeds) {
+  traced_shapes_.resize(feeds.size());
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    traced_shapes_[i] = feeds[i].Get<Tensor>().Shape().GetDims();
+  }
+}
+}  // namespace onnxruntime
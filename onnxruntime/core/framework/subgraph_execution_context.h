@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/common/status.h"
+#include "core/framework/execution_frame.h"
+#include "core/framework/ml_value.h"
+#include "core/framework/sequential_executor.h"
+
+namespace onnxruntime {
+class SessionState;
+
+/**
+Executes the same (sub)graph repeatedly, e.g. once per iteration of a Loop or Scan node.
+
+Feeds and outputs are resolved to MLValue indices once, and a single ExecutionFrame is kept across
+executions and re-bound to the new feeds and fetches each time. The memory pattern traced by the
+first execution is then used by the following ones, so intermediate tensors are placed in one
+pre-allocated buffer per location. If the feeds of an execution are larger than the ones the pattern
+was traced with, that execution traces a new one.
+
+When the session has execution providers other than the CPU one, the feeds and fetches may have to
+be copied across devices and every execution goes through utils::ExecuteGraph instead.
+*/
+class SubgraphExecutionContext {
+ public:
+  SubgraphExecutionContext(const SessionState& session_state,
+                           const std::vector<std::string>& feed_names,
+                           const std::vector<std::string>& output_names,
+                           const bool& terminate_flag,
+                           const logging::Logger& logger);
+
+  // feeds must be in the order of feed_names.
+  // fetches is either empty or has one entry per output, which may be pre-allocated.
+  common::Status Execute(const std::vector<MLValue>& feeds, std::vector<MLValue>& fetches);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SubgraphExecutionContext);
+
+  bool FeedsCoveredByTracedShapes(const std::vector<MLValue>& feeds) const;
+  void SaveTracedShapes(const std::vector<MLValue>& feeds);
+
+  const SessionState& session_state_;
+  const std::vector<std::string> feed_names_;
+  const std::vector<std::string> output_names_;
+  const bool& terminate_flag_;
+  const logging::Logger& logger_;
+
+  bool copy_across_devices_ = false;
+  std::vector<int> feed_mlvalue_idxs_;
+  std::vector<int> fetch_mlvalue_idxs_;
+
+  SequentialExecutor executor_;
+  std::unique_ptr<ExecutionFrame> frame_;
+
+  // whether frame_ uses memory patterns at all, and the feed shapes the current pattern was traced with
+  bool use_mem_patterns_ = false;
+  std::vector<std::vector<int64_t>> traced_shapes_;
+};
+}  // namespace onnxruntime
@@ -5,6 +5,7 @@
 #include "core/framework/tensor_shape.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/onnxruntime_typeinfo.h"
+#include "core/framework/packed_string_tensor.h"
 
 #include <assert.h>
 #include <stdexcept>
@@ -13,6 +14,7 @@
 using onnxruntime::BFloat16;
 using onnxruntime::DataTypeImpl;
 using onnxruntime::MLFloat16;
+using onnxruntime::PackedStringTensor;
 using onnxruntime::Tensor;
 
 struct OrtTensorTypeAndShapeInfo {
@@ -137,6 +139,10 @@ ORT_API_STATUS_IMPL(OrtGetTensorShapeAndType, _In_ const OrtValue* value,
                     _Out_ OrtTensorTypeAndShapeInfo** out) {
   API_IMPL_BEGIN
   auto v = reinterpret_cast<const ::onnxruntime::MLValue*>(value);
+  if (v->Type() == DataTypeImpl::GetType<PackedStringTensor>()) {
+    const PackedStringTensor& strings = v->Get<PackedStringTensor>();
+    return GetTensorShapeAndType(&strings.Shape(), DataTypeImpl::GetType<std::string>(), out);
+  }
   const onnxruntime::Tensor& tensor = v->Get<onnxruntime::Tensor>();
   return GetTensorShapeAndType(&tensor.Shape(), tensor.DataType(), out);
   API_IMPL_END
@@ -177,5 +183,9 @@ ORT_API_STATUS_IMPL(OrtGetTypeInfo, _In_ const OrtValue* value, struct OrtTypeIn
     const onnxruntime::TensorShape& shape = tensor.Shape();
     return OrtTypeInfo::FromDataTypeImpl(type, &shape, tensor.DataType(), out);
   }
+  if (type == DataTypeImpl::GetType<PackedStringTensor>()) {
+    const PackedStringTensor& strings = v->Get<PackedStringTensor>();
+    return OrtTypeInfo::FromDataTypeImpl(type, &strings.Shape(), DataTypeImpl::GetType<std::string>(), out);
+  }
   return OrtTypeInfo::FromDataTypeImpl(type, nullptr, nullptr, out);
 }
@@ -0,0 +1,277 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/attention_fusion.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/graph/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// The projection Transpose(Reshape(Add(MatMul(input, weight), bias), shape), perm) of the query, key or value.
+struct Projection {
+  const NodeArg* input = nullptr;
+  const TensorProto* weight = nullptr;
+  const TensorProto* bias = nullptr;
+  int64_t num_heads = 0;
+  int64_t head_size = 0;
+  std::vector<NodeIndex> nodes;
+};
+
+bool GetPermutation(const Node& transpose, std::vector<int64_t>& perm) {
+  const auto& attributes = transpose.GetAttributes();
+  auto perm_attr = attributes.find("perm");
+  if (perm_attr == attributes.cend()) {
+    return false;
+  }
+  perm.assign(perm_attr->second.ints().cbegin(), perm_attr->second.ints().cend());
+  return true;
+}
+
+bool GetInt64Values(const Graph& graph, const NodeArg& arg, std::vector<int64_t>& values) {
+  const TensorProto* tensor_proto = nullptr;
+  if (!graph.GetInitializedTensor(arg.Name(), tensor_proto) || tensor_proto->data_type() != TensorProto_DataType_INT64 ||
+      tensor_proto->dims_size() != 1) {
+    return false;
+  }
+  if (tensor_proto->has_raw_data()) {
+    values.resize(tensor_proto->raw_data().size() / sizeof(int64_t));
+    memcpy(values.data(), tensor_proto->raw_data().data(), values.size() * sizeof(int64_t));
+  } else {
+    values.assign(tensor_proto->int64_data().cbegin(), tensor_proto->int64_data().cend());
+  }
+  return static_cast<int64_t>(values.size()) == tensor_proto->dims(0);
+}
+
+bool IsFloatInitializer(const Graph& graph, const NodeArg& arg, const std::vector<int64_t>& dims,
+                        const TensorProto*& tensor_proto) {
+  return graph.GetInitializedTensor(arg.Name(), tensor_proto) &&
+         tensor_proto->data_type() == TensorProto_DataType_FLOAT &&
+         std::vector<int64_t>(tensor_proto->dims().cbegin(), tensor_proto->dims().cend()) == dims;
+}
+
+bool MatchProjection(const Graph& graph, const Node* transpose, const std::vector<int64_t>& expected_perm,
+                     Projection& projection) {
+  std::vector<int64_t> perm;
+  if (transpose == nullptr || !utils::IsOnnxOp(*transpose, "Transpose") || !GetPermutation(*transpose, perm) ||
+      perm != expected_perm) {
+    return false;
+  }
+
+  // (batch, sequence, num_heads, head_size)
+  const Node* reshape = utils::GetInputNode(*transpose, 0);
+  std::vector<int64_t> shape;
+  if (reshape == nullptr || !utils::IsOnnxOp(*reshape, "Reshape") || reshape->InputDefs().size() != 2 ||
+      !GetInt64Values(graph, *reshape->InputDefs()[1], shape) || shape.size() != 4 || shape[2] <= 0 ||
+      shape[3] <= 0) {
+    return false;
+  }
+  const int64_t hidden_size = shape[2] * shape[3];
+
+  const Node* add = utils::GetInputNode(*reshape, 0);
+  if (add == nullptr || !utils::IsOnnxOp(*add, "Add")) {
+    return false;
+  }
+  const Node* matmul = nullptr;
+  const NodeArg* bias = nullptr;
+  for (int i = 0; i < 2 && matmul == nullptr; ++i) {
+    const Node* producer = utils::GetInputNode(*add, i);
+    if (producer != nullptr && utils::IsOnnxOp(*producer, "MatMul")) {
+      matmul = producer;
+      bias = add->InputDefs()[1 - i];
+    }
+  }
+  if (matmul == nullptr ||
+      !IsFloatInitializer(graph, *matmul->InputDefs()[1], {hidden_size, hidden_size}, projection.weight) ||
+      !IsFloatInitializer(graph, *bias, {hidden_size}, projection.bias)) {
+    return false;
+  }
+
+  projection.input = matmul->InputDefs()[0];
+  projection.num_heads = shape[2];
+  projection.head_size = shape[3];
+  projection.nodes = {matmul->Index(), add->Index(), reshape->Index(), transpose->Index()};
+  return true;
+}
+
+// The MatMul(Q, K^T) scaled by 1 / sqrt(head_size), if node computes it.
+const Node* GetScaledMatMul(const Graph& graph, const Node& node, float scale) {
+  const auto& inputs = node.InputDefs();
+  const NodeArg* unscaled = nullptr;
+  float value = 0.f;
+  if (utils::IsOnnxOp(node, "Div") && utils::GetScalarInitializerValue(graph, *inputs[1], value) &&
+      std::abs(1 / value - scale) <= 1e-4f * scale) {
+    unscaled = inputs[0];
+  } else if (utils::IsOnnxOp(node, "Mul") && inputs.size() == 2) {
+    for (int i = 0; i < 2 && unscaled == nullptr; ++i) {
+      if (utils::GetScalarInitializerValue(graph, *inputs[1 - i], value) && std::abs(value - scale) <= 1e-4f * scale) {
+        unscaled = inputs[i];
+      }
+    }
+  }
+  const Node* matmul = unscaled != nullptr ? utils::GetInputNode(node, inputs[0] == unscaled ? 0 : 1) : nullptr;
+  return matmul != nullptr && utils::IsOnnxOp(*matmul, "MatMul") ? matmul : nullptr;
+}
+
+bool IsSameDimension(const TensorShapeProto_Dimension& dim, const TensorShapeProto_Dimension& other) {
+  return (dim.has_dim_value() && other.has_dim_value() && dim.dim_value() == other.dim_value()) ||
+         (dim.has_dim_param() && other.has_dim_param() && dim.dim_param() == other.dim_param());
+}
+
+// Whether mask is a float tensor of shape (batch, 1, 1, sequence) for an input of shape (batch, sequence, hidden).
+bool IsMask(const NodeArg& mask, const NodeArg& input) {
+  const TensorShapeProto* shape = mask.Shape();
+  const TensorShapeProto* input_shape = input.Shape();
+  return mask.TypeAsProto() != nullptr &&
+         mask.TypeAsProto()->tensor_type().elem_type() == TensorProto_DataType_FLOAT &&
+         shape != nullptr && shape->dim_size() == 4 && input_shape != nullptr && input_shape->dim_size() == 3 &&
+         IsSameDimension(shape->dim(0), input_shape->dim(0)) &&
+         shape->dim(1).has_dim_value() && shape->dim(1).dim_value() == 1 &&
+         shape->dim(2).has_dim_value() && shape->dim(2).dim_value() == 1 &&
+         IsSameDimension(shape->dim(3), input_shape->dim(1));
+}
+
+// Add the initializer concatenating the rows of the query, key and value weights, or their biases.
+NodeArg& AddConcatenatedInitializer(Graph& graph, const std::string& name,
+                                    const Projection& q, const Projection& k, const Projection& v, bool is_bias) {
+  const int64_t hidden_size = q.num_heads * q.head_size;
+  const int64_t rows = is_bias ? 1 : hidden_size;
+  Initializer concatenated{TensorProto_DataType_FLOAT, graph.GenerateNodeArgName(name),
+                           is_bias ? std::vector<int64_t>{3 * hidden_size}
+                                   : std::vector<int64_t>{hidden_size, 3 * hidden_size}};
+  float* data = concatenated.data<float>();
+  int64_t offset = 0;
+  for (const Projection* projection : {&q, &k, &v}) {
+    Initializer values{is_bias ? projection->bias : projection->weight};
+    const float* source = values.data<float>();
+    for (int64_t row = 0; row < rows; ++row) {
+      std::copy(source + row * hidden_size, source + (row + 1) * hidden_size, data + row * 3 * hidden_size + offset);
+    }
+    offset += hidden_size;
+  }
+
+  TensorProto tensor_proto;
+  concatenated.ToProto(&tensor_proto);
+  graph.AddInitializedTensor(tensor_proto);
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  return graph.GetOrCreateNodeArg(tensor_proto.name(), &type);
+}
+}  // namespace
+
+Status AttentionFusion::Apply(Graph& graph, bool& modified) const {
+  GraphViewer graph_viewer(graph);
+  const std::vector<NodeIndex> order = graph_viewer.GetNodesInTopologicalOrder();
+
+  bool fused = false;
+  for (NodeIndex index : order) {
+    const Node* softmax = graph.GetNode(index);
+    if (softmax == nullptr || !utils::IsOnnxOp(*softmax, "Softmax")) {
+      continue;
+    }
+    const auto& attributes = softmax->GetAttributes();
+    auto axis = attributes.find("axis");
+    if (axis == attributes.cend() || (axis->second.i() != 3 && axis->second.i() != -1)) {
+      continue;
+    }
+
+    // the scores, with the mask added
+    const Node* scores = utils::GetInputNode(*softmax, 0);
+    const Node* mask_add = nullptr;
+    const NodeArg* mask = nullptr;
+    if (scores != nullptr && utils::IsOnnxOp(*scores, "Add")) {
+      mask_add = scores;
+      scores = nullptr;
+      for (int i = 0; i < 2 && scores == nullptr; ++i) {
+        const Node* producer = utils::GetInputNode(*mask_add, i);
+        if (producer != nullptr && (utils::IsOnnxOp(*producer, "Div") || utils::IsOnnxOp(*producer, "Mul"))) {
+          scores = producer;
+          mask = mask_add->InputDefs()[1 - i];
+        }
+      }
+    }
+    if (scores == nullptr) {
+      continue;
+    }
+
+    // the context of the heads, reshaped to (batch, sequence, hidden)
+    const Node* context = utils::GetOnlyConsumer(*softmax);
+    if (context == nullptr || !utils::IsOnnxOp(*context, "MatMul") || context->InputDefs()[0] != softmax->OutputDefs()[0]) {
+      continue;
+    }
+    Projection v;
+    if (!MatchProjection(graph, utils::GetInputNode(*context, 1), {0, 2, 1, 3}, v)) {
+      continue;
+    }
+    const int64_t hidden_size = v.num_heads * v.head_size;
+    const Node* context_transpose = utils::GetOnlyConsumer(*context);
+    std::vector<int64_t> perm;
+    if (context_transpose == nullptr || !utils::IsOnnxOp(*context_transpose, "Transpose") ||
+        !GetPermutation(*context_transpose, perm) || perm != std::vector<int64_t>{0, 2, 1, 3}) {
+      continue;
+    }
+    const Node* output_reshape = utils::GetOnlyConsumer(*context_transpose);
+    std::vector<int64_t> output_shape;
+    if (output_reshape == nullptr || !utils::IsOnnxOp(*output_reshape, "Reshape") ||
+        output_reshape->InputDefs().size() != 2 ||
+        !GetInt64Values(graph, *output_reshape->InputDefs()[1], output_shape) || output_shape.size() != 3 ||
+        output_shape[2] != hidden_size) {
+      continue;
+    }
+
+    const float scale = static_cast<float>(1 / std::sqrt(static_cast<double>(v.head_size)));
+    const Node* qk = GetScaledMatMul(graph, *scores, scale);
+    Projection q;
+    Projection k;
+    if (qk == nullptr ||
+        !MatchProjection(graph, utils::GetInputNode(*qk, 0), {0, 2, 1, 3}, q) ||
+        !MatchProjection(graph, utils::GetInputNode(*qk, 1), {0, 2, 3, 1}, k) ||
+        q.input != v.input || k.input != v.input ||
+        q.num_heads != v.num_heads || k.num_heads != v.num_heads ||
+        q.head_size != v.head_size || k.head_size != v.head_size) {
+      continue;
+    }
+    const TensorShapeProto* input_shape = v.input->Shape();
+    if (input_shape == nullptr || input_shape->dim_size() != 3 || (mask != nullptr && !IsMask(*mask, *v.input))) {
+      continue;
+    }
+
+    std::vector<NodeIndex> nodes;
+    for (const Projection* projection : {&q, &k, &v}) {
+      nodes.insert(nodes.end(), projection->nodes.cbegin(), projection->nodes.cend());
+    }
+    nodes.insert(nodes.end(), {qk->Index(), scores->Index()});
+    if (mask_add != nullptr) {
+      nodes.push_back(mask_add->Index());
+    }
+    nodes.insert(nodes.end(), {softmax->Index(), context->Index(), context_transpose->Index(), output_reshape->Index()});
+    if (!utils::CanFuseNodes(graph, nodes)) {
+      continue;
+    }
+
+    std::vector<NodeArg*> inputs{graph.GetNodeArg(v.input->Name()),
+                                 &AddConcatenatedInitializer(graph, "attention_weight", q, k, v, false),
+                                 &AddConcatenatedInitializer(graph, "attention_bias", q, k, v, true)};
+    if (mask != nullptr) {
+      inputs.push_back(graph.GetNodeArg(mask->Name()));
+    }
+    Node& attention = utils::FuseNodes(graph, nodes, "Attention", "fused multi-head attention", inputs, nullptr,
+                                       kMSDomain);
+    attention.AddAttribute("num_heads", v.num_heads);
+    fused = true;
+  }
+
+  if (fused) {
+    modified = true;
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+  return Status::OK();
+}
+}  // namespace onnxruntime
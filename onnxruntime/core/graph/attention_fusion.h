@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class AttentionFusion
+
+Fuses the multi-head self attention of BERT models into an Attention contrib node:
+the query, key and value projections Add(MatMul(X, W), b) reshaped to (batch, sequence, num_heads, head_size)
+and transposed, the scores MatMul(Q, K^T) scaled by 1 / sqrt(head_size) with an optional mask added,
+their Softmax, and the context MatMul(scores, V) transposed and reshaped back to (batch, sequence, hidden).
+The three projection weights and biases are concatenated into new initializers.
+*/
+class AttentionFusion : public onnxruntime::GraphTransformer {
+ public:
+  AttentionFusion() noexcept : onnxruntime::GraphTransformer("AttentionFusion", "Fusing multi-head attention") {}
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/common_subexpression_elimination.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+
+static bool CanMerge(Node& node) {
+  // the outputs of these ops differ from one evaluation to the next
+  static const std::unordered_set<std::string> nondeterministic_ops{
+      "RandomNormal", "RandomNormalLike", "RandomUniform", "RandomUniformLike", "Multinomial"};
+
+  // the ops of custom domains may have side effects
+  const auto& domain = node.Domain();
+  return (domain == kOnnxDomain || domain == kOnnxDomainAlias || domain == kMLDomain || domain == kMSDomain) &&
+         node.MutableSubgraphs().empty() &&
+         node.ControlInputs().empty() &&
+         nondeterministic_ops.count(node.OpType()) == 0;
+}
+
+static void AppendToKey(std::string& key, const std::string& value) {
+  // prefixed by its length so that the concatenation of different values can't collide
+  key += std::to_string(value.size());
+  key += ':';
+  key += value;
+}
+
+// The nodes with the same key compute the same outputs: the inputs are compared by name, as a value has
+// a single producer, and the attributes by their serialization.
+static std::string GetKey(const Node& node) {
+  std::string key;
+  AppendToKey(key, node.Domain());
+  AppendToKey(key, node.OpType());
+  AppendToKey(key, node.GetExecutionProviderType());
+
+  key += std::to_string(node.InputDefs().size()) + "i";
+  for (const NodeArg* input_def : node.InputDefs()) {
+    AppendToKey(key, input_def->Name());
+  }
+
+  // the outputs used by the consumers of a duplicate must be computed by the node kept
+  key += std::to_string(node.OutputDefs().size()) + "o";
+  for (const NodeArg* output_def : node.OutputDefs()) {
+    key += output_def->Exists() ? '1' : '0';
+  }
+
+  const std::map<std::string, AttributeProto> attributes(node.GetAttributes().cbegin(), node.GetAttributes().cend());
+  key += std::to_string(attributes.size()) + "a";
+  for (const auto& attribute : attributes) {
+    AppendToKey(key, attribute.second.SerializeAsString());
+  }
+  return key;
+}
+
+Status CommonSubexpressionElimination::Apply(onnxruntime::Graph& graph, bool& modified) const {
+  // the nodes kept, by key. the consumers of a duplicate are rewired before being visited, so their key
+  // refers to the values of the nodes kept.
+  std::unordered_map<std::string, NodeIndex> kept_nodes;
+  bool merged = false;
+
+  GraphViewer graph_viewer(graph);
+  for (NodeIndex index : graph_viewer.GetNodesInTopologicalOrder()) {
+    Node& node = *graph.GetNode(index);
+    if (!CanMerge(node)) {
+      continue;
+    }
+
+    auto kept = kept_nodes.emplace(GetKey(node), index);
+    if (kept.second) {
+      continue;
+    }
+
+    // the output names of a duplicate producing graph outputs, or used by a subgraph, must be kept
+    if (graph.IsNodeOutputsInGraphOutputs(node)) {
+      continue;
+    }
+    std::vector<Node::EdgeEnd> output_edges(node.OutputEdgesBegin(), node.OutputEdgesEnd());
+    if (std::any_of(output_edges.cbegin(), output_edges.cend(), [](const Node::EdgeEnd& edge) {
+          return edge.GetDstArgIndex() >= static_cast<int>(edge.GetNode().InputDefs().size());
+        })) {
+      continue;
+    }
+
+    Node& kept_node = *graph.GetNode(kept.first->second);
+    std::map<const NodeArg*, NodeArg*> replacement_defs;
+    for (size_t i = 0; i < node.OutputDefs().size(); ++i) {
+      replacement_defs[node.OutputDefs()[i]] = kept_node.MutableOutputDefs()[i];
+    }
+
+    for (const auto& edge : output_edges) {
+      const NodeIndex consumer_index = edge.GetNode().Index();
+      graph.RemoveEdge(index, consumer_index, edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+      graph.GetNode(consumer_index)->ReplaceDefs(replacement_defs);
+      graph.AddEdge(kept_node.Index(), consumer_index, edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+    }
+    graph.RemoveNode(index);
+    merged = true;
+  }
+
+  if (!merged) {
+    return Status::OK();
+  }
+
+  modified = true;
+  return graph.Resolve();
+}
+
+}  // namespace onnxruntime
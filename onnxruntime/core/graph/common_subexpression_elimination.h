@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class CommonSubexpressionElimination
+
+Merges the nodes computing the same values: nodes of the same op type and domain, with the same attributes
+and the same inputs. The consumers of the duplicated node are rewired to the outputs of the node kept, which
+makes their own duplicates visible in the same pass (e.g. identical Shape/Gather chains).
+Random generators, nodes of custom domains and nodes with subgraphs are left as is, as well as duplicates
+producing graph outputs or consumed by subgraphs, whose output names must be kept.
+*/
+class CommonSubexpressionElimination : public onnxruntime::GraphTransformer {
+ public:
+  CommonSubexpressionElimination() noexcept
+      : onnxruntime::GraphTransformer("CommonSubexpressionElimination",
+                                      "Merge the nodes computing the same values from the same inputs") {}
+
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+};
+
+}  // namespace onnxruntime
@@ -847,7 +847,7 @@ The bounding box coordinates corresponding to the selected indices can then be o
           OPTIONAL)
       .Attr(
           "locale",
-          "Environment dependent string that denotes the locale according to which output strings needs to be upper/lowercased. Default en_US",
+          "Accepted for compatibility and ignored. Case changes use locale independent simple Unicode case mappings of Latin, Greek, Cyrillic and Armenian letters.",
           AttributeProto::STRING,
           OPTIONAL)
       .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
@@ -1012,6 +1012,69 @@ Example 4:
   the value of the sampled locations are computed directly
   through bilinear interpolation.)DOC");
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(LayerNormalization)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .Attr(
+          "axis",
+          "The first normalization dimension: the normalization is done over the dimensions from axis "
+          "to the last one. Negative values count from the back. Default is -1.",
+          AttributeProto::INT,
+          static_cast<int64_t>(-1))
+      .Attr(
+          "epsilon",
+          "The epsilon value to use to avoid division by zero. Default is 1e-5.",
+          AttributeProto::FLOAT,
+          1e-5f)
+      .Input(0, "X", "Input data tensor.", "T")
+      .Input(1, "scale", "Scale tensor, of the shape of the normalized dimensions of X.", "T")
+      .Input(2, "B", "Bias tensor, of the shape of the normalized dimensions of X.", "T")
+      .Output(0, "Y", "Output data tensor, of the shape of X.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput)
+      .SetDoc(R"DOC(Layer normalization: Y = scale * (X - mean) / sqrt(variance + epsilon) + B, with the
+mean and variance computed over the dimensions from axis to the last one. It is what the graph
+transformer LayerNormFusion replaces the ReduceMean, Sub, Pow, Sqrt and Div nodes computing it by.)DOC");
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Gelu)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .Input(0, "X", "Input data tensor.", "T")
+      .Output(0, "Y", "Output data tensor, of the shape of X.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput)
+      .SetDoc(R"DOC(Gaussian Error Linear Unit: Y = 0.5 * X * (1 + erf(X / sqrt(2))), applied elementwise.)DOC");
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Attention)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .Attr(
+          "num_heads",
+          "Number of attention heads. The hidden size must be a multiple of it.",
+          AttributeProto::INT)
+      .Input(0, "input", "3D input tensor of shape (batch_size, sequence_length, hidden_size).", "T")
+      .Input(1, "weight", "2D weight tensor of shape (hidden_size, 3 * hidden_size), the query, key and value "
+                          "projections concatenated along the second dimension.", "T")
+      .Input(2, "bias", "1D bias tensor of shape (3 * hidden_size), the query, key and value biases.", "T")
+      .Input(3, "mask", "Optional mask added to the attention scores, of shape (batch_size, sequence_length) "
+                        "or (batch_size, 1, 1, sequence_length): 0 for the positions attended to and a large "
+                        "negative value for the masked ones.", "T", OpSchema::Optional)
+      .Output(0, "output", "3D output tensor of shape (batch_size, sequence_length, hidden_size).", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput)
+      .SetDoc(R"DOC(Multi-head self attention of the BERT model. The query, key and value are projected from
+the input, and the context softmax(Q * K^T / sqrt(head_size) + mask) * V of each head is computed and
+concatenated to the output.)DOC");
+
 #ifdef MICROSOFT_INTERNAL
   // register internal ops
   RegisterInternalSchemas();
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/gelu_fusion.h"
+
+#include <cmath>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// Whether the binary node has an input, other than input, holding a value close to value.
+bool HasScalarInput(const Graph& graph, const Node& node, const NodeArg& input, float value) {
+  const NodeArg* other = utils::GetOtherInput(node, input);
+  float other_value = 0.f;
+  return other != nullptr && utils::GetScalarInitializerValue(graph, *other, other_value) &&
+         std::abs(other_value - value) <= 1e-4f * std::abs(value);
+}
+
+// The input X of the node computing X / sqrt(2), or X * (1 / sqrt(2)).
+const NodeArg* GetScaledInput(const Graph& graph, const Node& node) {
+  const auto& inputs = node.InputDefs();
+  if (utils::IsOnnxOp(node, "Div") && HasScalarInput(graph, node, *inputs[0], static_cast<float>(std::sqrt(2.0)))) {
+    return inputs[0];
+  }
+  if (utils::IsOnnxOp(node, "Mul")) {
+    for (const NodeArg* input : inputs) {
+      if (HasScalarInput(graph, node, *input, static_cast<float>(1 / std::sqrt(2.0)))) {
+        return input;
+      }
+    }
+  }
+  return nullptr;
+}
+}  // namespace
+
+Status GeluFusion::Apply(Graph& graph, bool& modified) const {
+  GraphViewer graph_viewer(graph);
+  const std::vector<NodeIndex> order = graph_viewer.GetNodesInTopologicalOrder();
+
+  bool fused = false;
+  for (NodeIndex index : order) {
+    const Node* erf = graph.GetNode(index);
+    if (erf == nullptr || !utils::IsOnnxOp(*erf, "Erf")) {
+      continue;
+    }
+    const Node* div = utils::GetInputNode(*erf, 0);
+    const NodeArg* x = div != nullptr && div->GetOutputEdgesCount() == 1 ? GetScaledInput(graph, *div) : nullptr;
+    if (x == nullptr) {
+      continue;
+    }
+
+    const Node* add = utils::GetOnlyConsumer(*erf);
+    if (add == nullptr || !utils::IsOnnxOp(*add, "Add") || !HasScalarInput(graph, *add, *erf->OutputDefs()[0], 1.f)) {
+      continue;
+    }
+    const Node* mul = utils::GetOnlyConsumer(*add);
+    const NodeArg* other = mul != nullptr && utils::IsOnnxOp(*mul, "Mul")
+                               ? utils::GetOtherInput(*mul, *add->OutputDefs()[0])
+                               : nullptr;
+    if (other == nullptr) {
+      continue;
+    }
+
+    // the factor 0.5 applies either to the product or to X
+    std::vector<NodeIndex> nodes;
+    if (other == x) {
+      const Node* half = utils::GetOnlyConsumer(*mul);
+      if (half == nullptr || !utils::IsOnnxOp(*half, "Mul") || !HasScalarInput(graph, *half, *mul->OutputDefs()[0], 0.5f)) {
+        continue;
+      }
+      nodes = {div->Index(), erf->Index(), add->Index(), mul->Index(), half->Index()};
+    } else {
+      const Node* half = utils::GetInputNode(*mul, mul->InputDefs()[0] == other ? 0 : 1);
+      if (half == nullptr || !utils::IsOnnxOp(*half, "Mul") || utils::GetOtherInput(*half, *x) == nullptr ||
+          !HasScalarInput(graph, *half, *x, 0.5f)) {
+        continue;
+      }
+      nodes = {half->Index(), div->Index(), erf->Index(), add->Index(), mul->Index()};
+    }
+    if (!utils::CanFuseNodes(graph, nodes)) {
+      continue;
+    }
+
+    utils::FuseNodes(graph, nodes, "Gelu", "fused Gelu", {graph.GetNodeArg(x->Name())}, nullptr, kMSDomain);
+    fused = true;
+  }
+
+  if (fused) {
+    modified = true;
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+  return Status::OK();
+}
+}  // namespace onnxruntime
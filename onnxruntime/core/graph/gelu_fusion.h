@@ -0,0 +1,22 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class GeluFusion
+
+Fuses the nodes computing 0.5 * X * (1 + Erf(X / sqrt(2))), with the division possibly written as a
+multiplication by 1 / sqrt(2) and the factor 0.5 applied to X or to the product, into a Gelu contrib node.
+*/
+class GeluFusion : public onnxruntime::GraphTransformer {
+ public:
+  GeluFusion() noexcept : onnxruntime::GraphTransformer("GeluFusion", "Fusing Gelu") {}
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+};
+
+}  // namespace onnxruntime
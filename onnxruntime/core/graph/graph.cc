@@ -45,6 +45,22 @@ static Status MergeShapeInfo(const std::string& output_name,
   return Status::OK();
 }
 
+static bool ShapesEqual(const TensorShapeProto& lhs, const TensorShapeProto& rhs) {
+  if (lhs.dim_size() != rhs.dim_size()) {
+    return false;
+  }
+  for (int i = 0; i < lhs.dim_size(); ++i) {
+    const auto& lhs_dim = lhs.dim(i);
+    const auto& rhs_dim = rhs.dim(i);
+    if (lhs_dim.value_case() != rhs_dim.value_case() ||
+        (lhs_dim.has_dim_value() && lhs_dim.dim_value() != rhs_dim.dim_value()) ||
+        (lhs_dim.has_dim_param() && lhs_dim.dim_param() != rhs_dim.dim_param())) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static bool GraphLoadedFromModelFile(const GraphProto* graph_proto) {
   return graph_proto && (graph_proto->input_size() != 0 ||
                          graph_proto->output_size() != 0 ||
@@ -112,13 +128,20 @@ void NodeArg::SetShape(const TensorShapeProto& shape) {
     return;
   }
 
+  const TensorShapeProto* existing_shape = Shape();
+  if (existing_shape != nullptr && ShapesEqual(*existing_shape, shape)) {
+    return;
+  }
+
   const auto type_case = node_arg_info_.type().value_case();
   switch (type_case) {
     case TypeProto::kTensorType:
       *(node_arg_info_.mutable_type()->mutable_tensor_type()->mutable_shape()) = shape;
+      ++version_;
       break;
     case TypeProto::kSparseTensorType:
       *(node_arg_info_.mutable_type()->mutable_sparse_tensor_type()->mutable_shape()) = shape;
+      ++version_;
       break;
     case TypeProto::kSequenceType:
     case TypeProto::kMapType:
@@ -133,6 +156,7 @@ common::Status NodeArg::UpdateTypeAndShape(const ONNX_NAMESPACE::TypeProto& inpu
   if (!node_arg_info_.has_type()) {
     *node_arg_info_.mutable_type() = input_type;
     type_ = DataTypeUtils::ToType(node_arg_info_.type());
+    ++version_;
     return Status::OK();
   }
 
@@ -158,9 +182,14 @@ common::Status NodeArg::UpdateTypeAndShape(const ONNX_NAMESPACE::TypeProto& inpu
       if (input_tensor_type.has_shape()) {
         auto& current_tensor_type = *current_type.mutable_tensor_type();
         if (current_tensor_type.has_shape()) {
+          const TensorShapeProto current_shape = current_tensor_type.shape();
           ORT_RETURN_IF_ERROR(MergeShapeInfo(Name(), input_tensor_type, current_tensor_type));
+          if (!ShapesEqual(current_shape, current_tensor_type.shape())) {
+            ++version_;
+          }
         } else {
           current_tensor_type = input_tensor_type;
+          ++version_;
         }
       }
 
@@ -183,6 +212,7 @@ common::Status NodeArg::UpdateTypeAndShape(const ONNX_NAMESPACE::TypeProto& inpu
           // mergeInShapeInfo(input_tensor_type, current_tensor_type);
         } else {
           current_tensor_type = input_tensor_type;
+          ++version_;
         }
       }
     } break;
@@ -212,11 +242,13 @@ void NodeArg::SetType(DataType p_type) {
 
   type_ = p_type;
   *(node_arg_info_.mutable_type()) = DataTypeUtils::ToTypeProto(p_type);
+  ++version_;
 }
 
 void NodeArg::SetType(const TypeProto& type_proto) {
   type_ = DataTypeUtils::ToType(type_proto);
   *(node_arg_info_.mutable_type()) = type_proto;
+  ++version_;
 }
 
 bool NodeArg::Exists() const noexcept {
@@ -409,6 +441,7 @@ void Node::CreateSubgraph(const std::string& attr_name) {
 void Node::AddAttribute(const std::string& attr_name, const AttributeProto& value) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inferred_args_.clear();
   attributes_[attr_name] = value;
 }
 
@@ -416,6 +449,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
     graph_->SetGraphProtoSyncNeeded();                                       \
+    inferred_args_.clear();                                                  \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
     a.set_type(enumType);                                                    \
@@ -427,6 +461,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
     graph_->SetGraphProtoSyncNeeded();                                       \
+    inferred_args_.clear();                                                  \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
     a.set_type(enumType);                                                    \
@@ -439,6 +474,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
                           const std::vector<type>& values) { \
     graph_->SetGraphResolveNeeded();                         \
     graph_->SetGraphProtoSyncNeeded();                       \
+    inferred_args_.clear();                                  \
     AttributeProto a;                                        \
     a.set_name(attr_name);                                   \
     a.set_type(enumType);                                    \
@@ -451,6 +487,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
 void Node::AddAttribute(const std::string& attr_name, const GraphProto& value) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inferred_args_.clear();
   AttributeProto a;
   a.set_name(attr_name);
   a.set_type(AttributeProto_AttributeType::AttributeProto_AttributeType_GRAPH);
@@ -473,6 +510,7 @@ ADD_LIST_ATTR_IMPL(GraphProto, AttributeProto_AttributeType::AttributeProto_Attr
 bool Node::ClearAttribute(const std::string& attr_name) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inferred_args_.clear();
   return attributes_.erase(attr_name) > 0;
 }
 
@@ -627,21 +665,24 @@ Graph::Graph(GraphProto* graph_proto,
         *tensor = node.attribute(0).t();
         *(tensor->mutable_name()) = node.output(0);
 
-        // we remove the node and add it as an initializer, but still need it to appear in the
-        // graph inputs to make the ONNX checker happy. add a new input due to that.
-        auto graph_inputs = graph_proto_->mutable_input();
+        // we remove the node and add it as an initializer. Before IR version 4 the ONNX checker requires
+        // every initializer to appear in the graph inputs, so add a new input for it. From IR version 4 on
+        // it's not added, as a graph input would let a feed override the value of the Constant node.
+        if (ir_version_ < 4) {
+          auto graph_inputs = graph_proto_->mutable_input();
 
-        ValueInfoProto* value_info = graph_inputs->Add();
-        value_info->set_name(node.output(0));
-        value_info->set_doc_string("Input to represent replaced Constant node");
+          ValueInfoProto* value_info = graph_inputs->Add();
+          value_info->set_name(node.output(0));
+          value_info->set_doc_string("Input to represent replaced Constant node");
 
-        TypeProto t;
-        t.mutable_tensor_type()->set_elem_type(tensor->data_type());
-        auto shape = t.mutable_tensor_type()->mutable_shape();
-        for (auto dim : tensor->dims())
-          shape->add_dim()->set_dim_value(dim);
+          TypeProto t;
+          t.mutable_tensor_type()->set_elem_type(tensor->data_type());
+          auto shape = t.mutable_tensor_type()->mutable_shape();
+          for (auto dim : tensor->dims())
+            shape->add_dim()->set_dim_value(dim);
 
-        (*value_info->mutable_type()) = t;
+          (*value_info->mutable_type()) = t;
+        }
       }
     }
 
@@ -1628,6 +1669,14 @@ Status Graph::VerifyNodeAndOpMatch() {
     // Node verification.
     auto& node = *GetNode(node_index);
 
+    // nodes left unchanged by the edits since the last Resolve, with unchanged inputs, were verified already
+    if (node.Op() != nullptr && IsTypeInferenceUpToDate(node)) {
+      for (const NodeArg* output_def : node.OutputDefs()) {
+        lsc.output_names.insert(output_def->Name());
+      }
+      continue;
+    }
+
     NodeProto node_proto;
     node.ToProto(node_proto);
     auto& node_name = node.Name();
@@ -1698,6 +1747,7 @@ Status Graph::VerifyNodeAndOpMatch() {
     }
 
     NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op)));
+    SaveTypeInferenceArgs(node);
 
     // Accumulate output names of the iterated Node
     for (auto& output_name : node_proto.output()) {
@@ -1708,6 +1758,49 @@ Status Graph::VerifyNodeAndOpMatch() {
   return Status::OK();
 }
 
+bool Graph::IsTypeInferenceUpToDate(const Node& node) const {
+  const auto& inferred_args = node.InferredArgs();
+  const auto& input_defs = node.InputDefs();
+  const auto& output_defs = node.OutputDefs();
+  if (inferred_args.empty() || inferred_args.size() != input_defs.size() + output_defs.size()) {
+    return false;
+  }
+
+  size_t i = 0;
+  for (const auto* defs : {&input_defs, &output_defs}) {
+    for (const NodeArg* def : *defs) {
+      if (inferred_args[i].first != def || inferred_args[i].second != def->version_) {
+        return false;
+      }
+      ++i;
+    }
+  }
+  return true;
+}
+
+void Graph::SaveTypeInferenceArgs(Node& node) const {
+  // the inferencing of a node with subgraphs depends on the subgraphs and the outer scope values they consume
+  std::vector<std::pair<const NodeArg*, int>> inferred_args;
+  if (node.MutableSubgraphs().empty()) {
+    inferred_args.reserve(node.InputDefs().size() + node.OutputDefs().size());
+    for (const NodeArg* def : node.InputDefs()) {
+      inferred_args.emplace_back(def, def->version_);
+    }
+    for (const NodeArg* def : node.OutputDefs()) {
+      inferred_args.emplace_back(def, def->version_);
+    }
+  }
+  node.SetInferredArgs(std::move(inferred_args));
+}
+
+void Graph::InitializerChanged(const std::string& name) {
+  // the shapes inferred for the consumers may depend on the value
+  NodeArg* node_arg = GetNodeArg(name);
+  if (node_arg != nullptr) {
+    ++node_arg->version_;
+  }
+}
+
 void Graph::FindAllSubgraphs(std::vector<Graph*>& subgraphs) {
   for (auto& node : Nodes()) {
     for (auto& subgraph : node.MutableSubgraphs()) {
@@ -1886,6 +1979,7 @@ void Graph::AddInitializedTensor(const TensorProto& tensor) {
   const gsl::not_null<TensorProto*> tensor_added{graph_proto_->add_initializer()};
   *(tensor_added) = tensor;
   name_to_initial_tensor_[tensor.name()] = tensor_added;
+  InitializerChanged(tensor.name());
 
   if (!GraphLoadedFromModelFile(graph_proto_)) {
     // make sure there is a NodeArg for the initializer as SetGraphInputsOutputs will add it to the graph inputs
@@ -1906,6 +2000,7 @@ void Graph::RemoveInitializedTensor(const std::string& tensor_name) {
   auto iter = name_to_initial_tensor_.find(tensor_name);
   if (name_to_initial_tensor_.end() != iter) {
     name_to_initial_tensor_.erase(tensor_name);
+    InitializerChanged(tensor_name);
     SetGraphProtoSyncNeeded();
     SetGraphResolveNeeded();
   }
@@ -1922,6 +2017,9 @@ bool Graph::GetInitializedTensor(const std::string& tensor_name, const TensorPro
 }
 
 void Graph::CleanAllInitializedTensors() noexcept {
+  for (const auto& initializer : name_to_initial_tensor_) {
+    InitializerChanged(initializer.first);
+  }
   name_to_initial_tensor_.clear();
   removed_initializer_indexes_.clear();
 
@@ -3,12 +3,14 @@
 
 #include "core/graph/graph_transformer.h"
 
+#include <deque>
+
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
 
 Status RuleBasedGraphTransformer::Register(const std::string& op_type, std::unique_ptr<RewriteRule> rule) {
-  if (HasRules(op_type)) {
+  if (!HasRules(op_type)) {
     op_to_rules_[op_type] = std::vector<std::unique_ptr<RewriteRule>>();
   }
 
@@ -24,7 +26,8 @@ Status TopDownRuleBasedTransformer::Apply(Graph& graph, bool& modified) const {
   for (NodeIndex i : order) {
     auto node = graph.GetNode(i);
     if (!node) {
-      return Status(ONNXRUNTIME, INVALID_ARGUMENT);
+      // removed by a rule applied to a node before it
+      continue;
     }
 
     // Get the rules that should be fired for this node.
@@ -45,4 +48,89 @@ Status TopDownRuleBasedTransformer::Apply(Graph& graph, bool& modified) const {
   return Status::OK();
 }
 
+Status WorklistRuleBasedTransformer::Apply(Graph& graph, bool& modified) const {
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+
+  std::deque<NodeIndex> worklist;
+  std::vector<bool> in_worklist;
+  auto enqueue = [this, &graph, &worklist, &in_worklist](NodeIndex index) {
+    const Node* node = graph.GetNode(index);
+    if (node == nullptr || !HasRules(node->OpType())) {
+      return;
+    }
+    if (in_worklist.size() <= index) {
+      in_worklist.resize(graph.MaxNodeIndex(), false);
+    }
+    if (!in_worklist[index]) {
+      in_worklist[index] = true;
+      worklist.push_back(index);
+    }
+  };
+  auto enqueue_neighbors = [&enqueue](const Node& node) {
+    for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+      enqueue(it->GetNode().Index());
+    }
+    for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+      enqueue(it->GetNode().Index());
+    }
+  };
+
+  GraphViewer graph_viewer(graph);
+  for (NodeIndex index : graph_viewer.GetNodesInTopologicalOrder()) {
+    enqueue(index);
+  }
+
+  std::vector<NodeIndex> neighbors;
+  while (!worklist.empty()) {
+    const NodeIndex index = worklist.front();
+    worklist.pop_front();
+    in_worklist[index] = false;
+    if (graph.GetNode(index) == nullptr) {
+      // removed by a rule applied to a neighbor after it was queued
+      continue;
+    }
+
+    for (const auto& rule : *GetRewriteRules(graph.GetNode(index)->OpType())) {
+      Node* node = graph.GetNode(index);
+      neighbors.clear();
+      for (auto it = node->InputEdgesBegin(); it != node->InputEdgesEnd(); ++it) {
+        neighbors.push_back(it->GetNode().Index());
+      }
+      for (auto it = node->OutputEdgesBegin(); it != node->OutputEdgesEnd(); ++it) {
+        neighbors.push_back(it->GetNode().Index());
+      }
+      const NodeIndex first_new_index = graph.MaxNodeIndex();
+
+      bool rule_modified = false;
+      ORT_RETURN_IF_ERROR(rule->CheckConditionAndApply(graph, *node, rule_modified));
+      if (!rule_modified) {
+        continue;
+      }
+
+      // only the nodes around the rewrite may be matched by a rule now
+      modified = true;
+      for (NodeIndex neighbor : neighbors) {
+        enqueue(neighbor);
+      }
+      for (NodeIndex new_index = first_new_index; new_index < static_cast<NodeIndex>(graph.MaxNodeIndex()); ++new_index) {
+        if (graph.GetNode(new_index) != nullptr) {
+          enqueue(new_index);
+          enqueue_neighbors(*graph.GetNode(new_index));
+        }
+      }
+      if (graph.GetNode(index) != nullptr) {
+        enqueue(index);
+        enqueue_neighbors(*graph.GetNode(index));
+      }
+      // the other rules are tried when the node is visited again
+      break;
+    }
+  }
+
+  if (modified) {
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -6,6 +6,12 @@
 #include "core/graph/graph_transformer.h"
 
 namespace onnxruntime {
+
+enum class GraphTransformerPriority {
+  HighPriority,  // applied before the transformers registered so far
+  LowPriority    // applied after the transformers registered so far
+};
+
 // Manages a list of graph transformers. It is initialized with a list of graph
 // transformers. Each inference session can further register additional ones.
 class GraphTransformerManager {
@@ -15,11 +21,25 @@ class GraphTransformerManager {
   }
 
   // Register a graph transformer.
-  common::Status Register(std::unique_ptr<GraphTransformer> transformer) {
-    transformers_.push_back(std::move(transformer));
+  common::Status Register(std::unique_ptr<GraphTransformer> transformer,
+                          GraphTransformerPriority priority = GraphTransformerPriority::LowPriority) {
+    if (priority == GraphTransformerPriority::HighPriority) {
+      transformers_.insert(transformers_.begin(), std::move(transformer));
+    } else {
+      transformers_.push_back(std::move(transformer));
+    }
     return common::Status::OK();
   }
 
+  // Get the names of the graph transformers registered, in the order they are applied.
+  std::vector<std::string> GetTransformerNames() const {
+    std::vector<std::string> names;
+    for (const auto& transformer : transformers_) {
+      names.push_back(transformer->Name());
+    }
+    return names;
+  }
+
   // Apply the list of graph transformers registered on the specified graph
   // up to the given number of steps.
   common::Status ApplyAll(Graph& graph) const;
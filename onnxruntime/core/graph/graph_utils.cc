@@ -1,6 +1,11 @@
 
 #include "core/graph/graph_utils.h"
 
+#include <algorithm>
+#include <tuple>
+
+#include "core/graph/initializer.h"
+
 namespace onnxruntime {
 
 namespace utils {
@@ -69,5 +74,112 @@ Status ForAllSubgraphs(const Graph& graph, std::function<Status(const Graph&)> f
   return status;
 }
 
+bool IsOnnxOp(const Node& node, const std::string& op_type) {
+  return node.OpType() == op_type && (node.Domain() == kOnnxDomain || node.Domain() == kOnnxDomainAlias);
+}
+
+const Node* GetInputNode(const Node& node, int input_index) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == input_index) {
+      return &it->GetNode();
+    }
+  }
+  return nullptr;
+}
+
+const Node* GetOnlyConsumer(const Node& node) {
+  if (node.GetOutputEdgesCount() == 0) {
+    return nullptr;
+  }
+  const Node* consumer = &node.OutputEdgesBegin()->GetNode();
+  for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+    if (it->GetNode().Index() != consumer->Index()) {
+      return nullptr;
+    }
+  }
+  return consumer;
+}
+
+const NodeArg* GetOtherInput(const Node& node, const NodeArg& input) {
+  const auto& input_defs = node.InputDefs();
+  if (input_defs.size() != 2) {
+    return nullptr;
+  }
+  if (input_defs[0] == &input) {
+    return input_defs[1];
+  }
+  return input_defs[1] == &input ? input_defs[0] : nullptr;
+}
+
+bool GetScalarInitializerValue(const Graph& graph, const NodeArg& arg, float& value) {
+  const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
+  if (!graph.GetInitializedTensor(arg.Name(), tensor_proto) ||
+      tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT ||
+      std::any_of(tensor_proto->dims().cbegin(), tensor_proto->dims().cend(), [](int64_t dim) { return dim != 1; })) {
+    return false;
+  }
+  Initializer initializer{tensor_proto};
+  value = *initializer.data<float>();
+  return true;
+}
+
+bool CanFuseNodes(const Graph& graph, const std::vector<NodeIndex>& nodes) {
+  for (size_t i = 0; i + 1 < nodes.size(); ++i) {
+    const Node& node = *graph.GetNode(nodes[i]);
+    if (graph.IsNodeOutputsInGraphOutputs(node)) {
+      return false;
+    }
+    for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+      if (std::find(nodes.cbegin(), nodes.cend(), it->GetNode().Index()) == nodes.cend()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+Node& FuseNodes(Graph& graph, const std::vector<NodeIndex>& nodes,
+                const std::string& op_type, const std::string& description,
+                const std::vector<NodeArg*>& inputs, const NodeAttributes* attributes, const std::string& domain) {
+  // the producers of the inputs, and the consumers of the outputs, of the fused nodes
+  std::vector<std::tuple<NodeIndex, int, const NodeArg*>> producers;
+  for (NodeIndex index : nodes) {
+    const Node& node = *graph.GetNode(index);
+    for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+      if (std::find(nodes.cbegin(), nodes.cend(), it->GetNode().Index()) == nodes.cend()) {
+        producers.emplace_back(it->GetNode().Index(), it->GetSrcArgIndex(),
+                               it->GetNode().OutputDefs()[it->GetSrcArgIndex()]);
+      }
+    }
+  }
+  Node& last_node = *graph.GetNode(nodes.back());
+  std::vector<NodeArg*> outputs = last_node.MutableOutputDefs();
+  std::vector<Node::EdgeEnd> consumers(last_node.OutputEdgesBegin(), last_node.OutputEdgesEnd());
+
+  for (const auto& consumer : consumers) {
+    graph.RemoveEdge(last_node.Index(), consumer.GetNode().Index(), consumer.GetSrcArgIndex(),
+                     consumer.GetDstArgIndex());
+  }
+  for (auto it = nodes.crbegin(); it != nodes.crend(); ++it) {
+    graph.RemoveNode(*it);
+  }
+
+  Node& fused_node = graph.AddNode(graph.GenerateNodeName(op_type), op_type, description, inputs, outputs,
+                                   attributes, domain);
+  for (int i = 0; i < static_cast<int>(inputs.size()); ++i) {
+    auto producer = std::find_if(producers.cbegin(), producers.cend(), [&inputs, i](const auto& entry) {
+      return std::get<2>(entry) == inputs[i];
+    });
+    if (producer != producers.cend()) {
+      graph.AddEdge(std::get<0>(*producer), fused_node.Index(), std::get<1>(*producer), i);
+    }
+  }
+  for (const auto& consumer : consumers) {
+    graph.AddEdge(fused_node.Index(), consumer.GetNode().Index(), consumer.GetSrcArgIndex(),
+                  consumer.GetDstArgIndex());
+  }
+  return fused_node;
+}
+
 }  // namespace utils
 }  // namespace onnxruntime
@@ -17,5 +17,30 @@ bool IsSupportedOptypeVersionAndDomain(const Node& node,
 Status ForAllMutableSubgraphs(Graph& main_graph, std::function<Status(Graph&)> func);
 Status ForAllSubgraphs(Graph& main_graph, std::function<Status(Graph&)> func);
 
+// Whether node is an ONNX domain op_type node, whatever its version.
+bool IsOnnxOp(const Node& node, const std::string& op_type);
+
+// The node producing the input input_index of node, or nullptr if it is a graph input or an initializer.
+const Node* GetInputNode(const Node& node, int input_index);
+
+// The node consuming all the outputs of node, or nullptr if they are not used by a single node.
+const Node* GetOnlyConsumer(const Node& node);
+
+// The input of the binary node which is not input, or nullptr if input is not one of its inputs.
+const NodeArg* GetOtherInput(const Node& node, const NodeArg& input);
+
+// Get the value of arg if it is a float initializer holding a single value.
+bool GetScalarInitializerValue(const Graph& graph, const NodeArg& arg, float& value);
+
+// Whether nodes, given in topological order, can be replaced by a single node computing the outputs of the
+// last one: the outputs of the others are neither graph outputs nor used outside of nodes.
+bool CanFuseNodes(const Graph& graph, const std::vector<NodeIndex>& nodes);
+
+// Replace nodes, given in topological order, by a new node with inputs and the outputs of the last one,
+// keeping the edges of the graph up to date.
+Node& FuseNodes(Graph& graph, const std::vector<NodeIndex>& nodes,
+                const std::string& op_type, const std::string& description,
+                const std::vector<NodeArg*>& inputs, const NodeAttributes* attributes, const std::string& domain);
+
 }  // namespace utils
 }  // namespace onnxruntime
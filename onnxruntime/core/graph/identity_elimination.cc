@@ -10,23 +10,43 @@
 namespace onnxruntime {
 
 Status EliminateIdentity::Apply(Graph& graph_editor, Node& node, bool& modified) {
+  // The output name of an Identity producing a graph output must be kept.
+  if (graph_editor.IsNodeOutputsInGraphOutputs(node)) {
+    return Status::OK();
+  }
+
+  // A subgraph refers to its implicit inputs by name, which would change.
+  std::vector<Node::EdgeEnd> output_edges(node.OutputEdgesBegin(), node.OutputEdgesEnd());
+  for (const auto& edge : output_edges) {
+    if (edge.GetDstArgIndex() >= static_cast<int>(edge.GetNode().InputDefs().size())) {
+      return Status::OK();
+    }
+  }
+
+  const Node* producer = nullptr;
+  int producer_output_index = 0;
+  for (auto it = node.InputEdgesBegin(), end = node.InputEdgesEnd(); it != end; ++it) {
+    producer = &it->GetNode();
+    producer_output_index = it->GetSrcArgIndex();
+  }
+
   std::map<const NodeArg*, NodeArg*> replacement_defs;
-  auto id_input = node.InputDefs()[0];
-  auto id_output = node.OutputDefs()[0];
-  replacement_defs[id_output] = const_cast<NodeArg*>(id_input);
-
-  // Replace (input) defs of the nodes following the Identity with the input to the Identity.
-  for (auto it = node.OutputNodesBegin(), end = node.OutputNodesEnd(); it != end; ++it) {
-    // TODO: Fix the Node API so this operation is supported without resorting to const_cast.
-    const_cast<Node*>(&*it)->ReplaceDefs(replacement_defs);
-    modified = true;
+  replacement_defs[node.OutputDefs()[0]] = node.MutableInputDefs()[0];
+
+  // Replace (input) defs of the nodes following the Identity with the input to the Identity, and connect them
+  // to the producer of that input so the edges stay valid for the rules applied next.
+  for (const auto& edge : output_edges) {
+    const NodeIndex consumer_index = edge.GetNode().Index();
+    graph_editor.RemoveEdge(node.Index(), consumer_index, edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+    graph_editor.GetNode(consumer_index)->ReplaceDefs(replacement_defs);
+    if (producer != nullptr) {
+      graph_editor.AddEdge(producer->Index(), consumer_index, producer_output_index, edge.GetDstArgIndex());
+    }
   }
 
   // Remove the Identity node.
   graph_editor.RemoveNode(node.Index());
-
-  // TODO: Make sure resolve is not required here.
-  //ORT_RETURN_IF_ERROR(graph_editor->Resolve());
+  modified = true;
 
   return Status::OK();
 }
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/layer_norm_fusion.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// Whether the ReduceMean node averages over the last dimension, keeping it.
+bool ReducesLastDimension(const Node& reduce_mean) {
+  const auto& attributes = reduce_mean.GetAttributes();
+  auto keepdims = attributes.find("keepdims");
+  auto axes = attributes.find("axes");
+  if ((keepdims != attributes.cend() && keepdims->second.i() == 0) ||
+      axes == attributes.cend() || axes->second.ints_size() != 1) {
+    return false;
+  }
+  const TensorShapeProto* shape = reduce_mean.InputDefs()[0]->Shape();
+  return axes->second.ints(0) == -1 || (shape != nullptr && axes->second.ints(0) == shape->dim_size() - 1);
+}
+
+// Whether arg is a 1D initializer of the size of the last dimension of x.
+bool IsLastDimensionVector(const Graph& graph, const NodeArg* arg, const NodeArg& x) {
+  const TensorProto* tensor_proto = nullptr;
+  const TensorShapeProto* x_shape = x.Shape();
+  if (arg == nullptr || !graph.GetInitializedTensor(arg->Name(), tensor_proto) || tensor_proto->dims_size() != 1 ||
+      x_shape == nullptr || x_shape->dim_size() == 0) {
+    return false;
+  }
+  const auto& last_dim = x_shape->dim(x_shape->dim_size() - 1);
+  return last_dim.has_dim_value() && last_dim.dim_value() == tensor_proto->dims(0);
+}
+}  // namespace
+
+Status LayerNormFusion::Apply(Graph& graph, bool& modified) const {
+  GraphViewer graph_viewer(graph);
+  const std::vector<NodeIndex> order = graph_viewer.GetNodesInTopologicalOrder();
+
+  bool fused = false;
+  for (NodeIndex index : order) {
+    Node* mean = graph.GetNode(index);
+    if (mean == nullptr || !utils::IsOnnxOp(*mean, "ReduceMean") || !ReducesLastDimension(*mean)) {
+      continue;
+    }
+    NodeArg* x = mean->MutableInputDefs()[0];
+
+    // the deviation from the mean is both squared and divided by the standard deviation
+    const Node* sub = utils::GetOnlyConsumer(*mean);
+    if (sub == nullptr || !utils::IsOnnxOp(*sub, "Sub") || sub->InputDefs()[0] != x ||
+        sub->InputDefs()[1] != mean->OutputDefs()[0] || sub->GetOutputEdgesCount() != 2) {
+      continue;
+    }
+    const Node* pow = nullptr;
+    const Node* div = nullptr;
+    for (auto it = sub->OutputEdgesBegin(); it != sub->OutputEdgesEnd(); ++it) {
+      const Node& consumer = it->GetNode();
+      if (it->GetDstArgIndex() == 0 && utils::IsOnnxOp(consumer, "Pow")) {
+        pow = &consumer;
+      } else if (it->GetDstArgIndex() == 0 && utils::IsOnnxOp(consumer, "Div")) {
+        div = &consumer;
+      }
+    }
+    float exponent = 0.f;
+    if (pow == nullptr || div == nullptr ||
+        !utils::GetScalarInitializerValue(graph, *pow->InputDefs()[1], exponent) || exponent != 2.f) {
+      continue;
+    }
+
+    const Node* variance = utils::GetOnlyConsumer(*pow);
+    if (variance == nullptr || !utils::IsOnnxOp(*variance, "ReduceMean") || !ReducesLastDimension(*variance)) {
+      continue;
+    }
+    const Node* add_epsilon = utils::GetOnlyConsumer(*variance);
+    const NodeArg* epsilon_arg = nullptr;
+    float epsilon = 0.f;
+    if (add_epsilon == nullptr || !utils::IsOnnxOp(*add_epsilon, "Add") ||
+        (epsilon_arg = utils::GetOtherInput(*add_epsilon, *variance->OutputDefs()[0])) == nullptr ||
+        !utils::GetScalarInitializerValue(graph, *epsilon_arg, epsilon)) {
+      continue;
+    }
+    const Node* sqrt = utils::GetOnlyConsumer(*add_epsilon);
+    if (sqrt == nullptr || !utils::IsOnnxOp(*sqrt, "Sqrt") || utils::GetOnlyConsumer(*sqrt) != div ||
+        div->InputDefs()[1] != sqrt->OutputDefs()[0]) {
+      continue;
+    }
+
+    // the normalized value is scaled and shifted
+    const Node* mul = utils::GetOnlyConsumer(*div);
+    if (mul == nullptr || !utils::IsOnnxOp(*mul, "Mul")) {
+      continue;
+    }
+    const NodeArg* scale = utils::GetOtherInput(*mul, *div->OutputDefs()[0]);
+    const Node* add = utils::GetOnlyConsumer(*mul);
+    if (add == nullptr || !utils::IsOnnxOp(*add, "Add")) {
+      continue;
+    }
+    const NodeArg* bias = utils::GetOtherInput(*add, *mul->OutputDefs()[0]);
+    if (!IsLastDimensionVector(graph, scale, *x) || !IsLastDimensionVector(graph, bias, *x)) {
+      continue;
+    }
+
+    const std::vector<NodeIndex> nodes{mean->Index(), sub->Index(), pow->Index(), variance->Index(),
+                                       add_epsilon->Index(), sqrt->Index(), div->Index(), mul->Index(),
+                                       add->Index()};
+    if (!utils::CanFuseNodes(graph, nodes)) {
+      continue;
+    }
+    Node& layer_norm = utils::FuseNodes(graph, nodes, "LayerNormalization", "fused layer normalization",
+                                        {x, graph.GetNodeArg(scale->Name()), graph.GetNodeArg(bias->Name())},
+                                        nullptr, kMSDomain);
+    layer_norm.AddAttribute("axis", static_cast<int64_t>(-1));
+    layer_norm.AddAttribute("epsilon", epsilon);
+    fused = true;
+  }
+
+  if (fused) {
+    modified = true;
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+  return Status::OK();
+}
+}  // namespace onnxruntime
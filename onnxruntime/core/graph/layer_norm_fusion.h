@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class LayerNormFusion
+
+Fuses the nodes computing a layer normalization over the last dimension,
+Add(Mul(Div(Sub(X, ReduceMean(X)), Sqrt(Add(ReduceMean(Pow(Sub(...), 2)), epsilon))), scale), B),
+into a LayerNormalization contrib node.
+*/
+class LayerNormFusion : public onnxruntime::GraphTransformer {
+ public:
+  LayerNormFusion() noexcept : onnxruntime::GraphTransformer("LayerNormFusion", "Fusing layer normalization") {}
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+};
+
+}  // namespace onnxruntime
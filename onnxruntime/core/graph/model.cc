@@ -326,18 +326,21 @@ Status Model::Save(Model& model, const std::string& file_path) {
   return SaveModel(model, file_path);
 }
 
-Status Model::LoadFromBytes(int count, void* p_bytes, /*out*/ std::shared_ptr<Model>& p_model, const IOnnxRuntimeOpSchemaRegistryList* local_registries) {
-  std::unique_ptr<ModelProto> modelProto = std::make_unique<ModelProto>();
-  const bool result = modelProto->ParseFromArray(p_bytes, count);
-  if (!result) {
-    return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
+Status Model::LoadFromBytes(int count, const void* p_bytes, /*out*/ std::shared_ptr<Model>& p_model, const IOnnxRuntimeOpSchemaRegistryList* local_registries) {
+  if (p_bytes == nullptr || count < 0) {
+    return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid model buffer.");
   }
 
-  p_model = std::make_shared<Model>(std::move(modelProto), local_registries);
+  ::google::protobuf::io::CodedInputStream coded_input(static_cast<const uint8_t*>(p_bytes), count);
+  // Allows protobuf library versions < 3.2.0 to parse messages greater than 64MB.
+  coded_input.SetTotalBytesLimit(INT_MAX, INT_MAX);
 
-  ORT_RETURN_IF_ERROR(p_model->MainGraph().Resolve(true));
+  std::unique_ptr<ModelProto> model_proto = std::make_unique<ModelProto>();
+  if (!model_proto->ParseFromCodedStream(&coded_input) || !coded_input.ConsumedEntireMessage()) {
+    return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
+  }
 
-  return Status::OK();
+  return Load(std::move(model_proto), p_model, local_registries);
 }
 
 using ::google::protobuf::io::CodedInputStream;
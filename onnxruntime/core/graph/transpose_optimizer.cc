@@ -0,0 +1,552 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/transpose_optimizer.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_set>
+
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+
+using Permutation = std::vector<int64_t>;
+
+// How an op depends on the layout of its inputs.
+enum class LayoutKind {
+  kUnary,      // elementwise op of a single input
+  kBroadcast,  // elementwise op of inputs broadcast together
+  kConcat,
+  kSplit,
+  kPad,
+  kReduce,
+  kOther  // the op depends on the layout
+};
+
+static bool IsOnnxNode(const Node& node) {
+  return node.Domain() == kOnnxDomain || node.Domain() == kOnnxDomainAlias;
+}
+
+static LayoutKind GetLayoutKind(const Node& node) {
+  static const std::unordered_set<std::string> unary_ops{
+      "Abs", "Cast", "Ceil", "Clip", "Elu", "Erf", "Exp", "Floor", "HardSigmoid", "Identity", "IsNaN",
+      "LeakyRelu", "Log", "Neg", "Not", "Reciprocal", "Relu", "Selu", "Sigmoid", "Sign", "Softplus",
+      "Softsign", "Sqrt", "Tanh", "ThresholdedRelu"};
+  static const std::unordered_set<std::string> broadcast_ops{
+      "Add", "And", "Div", "Equal", "Greater", "Less", "Max", "Mean", "Min", "Mul", "Or", "Pow", "PRelu",
+      "Sub", "Sum", "Where", "Xor"};
+  static const std::unordered_set<std::string> reduce_ops{
+      "ReduceL1", "ReduceL2", "ReduceLogSum", "ReduceLogSumExp", "ReduceMax", "ReduceMean", "ReduceMin",
+      "ReduceProd", "ReduceSum", "ReduceSumSquare"};
+
+  const auto& op_type = node.OpType();
+  if (!IsOnnxNode(node)) {
+    return LayoutKind::kOther;
+  }
+  if (unary_ops.count(op_type) != 0) {
+    return LayoutKind::kUnary;
+  }
+  if (broadcast_ops.count(op_type) != 0) {
+    return LayoutKind::kBroadcast;
+  }
+  if (reduce_ops.count(op_type) != 0) {
+    return LayoutKind::kReduce;
+  }
+  if (op_type == "Concat") {
+    return LayoutKind::kConcat;
+  }
+  if (op_type == "Split") {
+    return LayoutKind::kSplit;
+  }
+  if (op_type == "Pad") {
+    return LayoutKind::kPad;
+  }
+  return LayoutKind::kOther;
+}
+
+static bool GetPermutation(const Node& transpose, Permutation& perm) {
+  const auto& attributes = transpose.GetAttributes();
+  auto perm_attr = attributes.find("perm");
+  if (perm_attr != attributes.cend()) {
+    perm.assign(perm_attr->second.ints().cbegin(), perm_attr->second.ints().cend());
+  } else {
+    // the dimensions are reversed by default
+    const TensorShapeProto* shape = transpose.InputDefs()[0]->Shape();
+    if (shape == nullptr) {
+      return false;
+    }
+    perm.resize(shape->dim_size());
+    std::iota(perm.rbegin(), perm.rend(), 0);
+  }
+
+  Permutation sorted_perm(perm);
+  std::sort(sorted_perm.begin(), sorted_perm.end());
+  for (size_t i = 0; i < sorted_perm.size(); ++i) {
+    if (sorted_perm[i] != static_cast<int64_t>(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool IsTranspose(const Node* node, Permutation& perm) {
+  return node != nullptr && node->OpType() == "Transpose" && IsOnnxNode(*node) && GetPermutation(*node, perm);
+}
+
+static Permutation InvertPermutation(const Permutation& perm) {
+  Permutation inverse(perm.size());
+  for (size_t i = 0; i < perm.size(); ++i) {
+    inverse[perm[i]] = i;
+  }
+  return inverse;
+}
+
+static bool IsIdentityPermutation(const Permutation& perm) {
+  for (size_t i = 0; i < perm.size(); ++i) {
+    if (perm[i] != static_cast<int64_t>(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Get the node producing the input input_index of node, and the index of that output, if there is one.
+static const Node* GetInputProducer(const Node& node, int input_index, int& output_index) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == input_index) {
+      output_index = it->GetSrcArgIndex();
+      return &it->GetNode();
+    }
+  }
+  return nullptr;
+}
+
+// Get the nodes consuming the output output_index of node, with the index of the input they consume it as.
+static std::vector<std::pair<NodeIndex, int>> GetConsumers(const Node& node, int output_index) {
+  std::vector<std::pair<NodeIndex, int>> consumers;
+  for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+    if (it->GetSrcArgIndex() == output_index) {
+      consumers.emplace_back(it->GetNode().Index(), it->GetDstArgIndex());
+    }
+  }
+  return consumers;
+}
+
+static bool IsGraphOutput(const Graph& graph, const NodeArg* arg) {
+  const auto& outputs = graph.GetOutputs();
+  return std::find(outputs.cbegin(), outputs.cend(), arg) != outputs.cend();
+}
+
+// Whether the consumers of the output output_index of node can be made to consume another value:
+// it is neither a graph output nor used by a subgraph.
+static bool CanReplaceOutput(const Graph& graph, const Node& node, int output_index) {
+  if (IsGraphOutput(graph, node.OutputDefs()[output_index])) {
+    return false;
+  }
+  for (const auto& consumer : GetConsumers(node, output_index)) {
+    if (consumer.second >= static_cast<int>(graph.GetNode(consumer.first)->InputDefs().size())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool IsConsumedOnlyBy(const Graph& graph, const Node& producer, int output_index, const Node& node) {
+  if (IsGraphOutput(graph, producer.OutputDefs()[output_index])) {
+    return false;
+  }
+  for (auto it = producer.OutputEdgesBegin(); it != producer.OutputEdgesEnd(); ++it) {
+    if (it->GetSrcArgIndex() == output_index && it->GetNode().Index() != node.Index()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Make the input input_index of node arg, which is the output producer_output_index of producer if not null,
+// keeping the edges of the graph up to date.
+static void ReplaceInput(Graph& graph, Node& node, int input_index,
+                         NodeArg& arg, const Node* producer, int producer_output_index) {
+  int output_index = 0;
+  const Node* current_producer = GetInputProducer(node, input_index, output_index);
+  if (current_producer != nullptr) {
+    graph.RemoveEdge(current_producer->Index(), node.Index(), output_index, input_index);
+  }
+  node.MutableInputDefs()[input_index] = &arg;
+  if (producer != nullptr) {
+    graph.AddEdge(producer->Index(), node.Index(), producer_output_index, input_index);
+  }
+}
+
+static NodeArg& CreateNodeArgLike(Graph& graph, const NodeArg& arg) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(arg.TypeAsProto()->tensor_type().elem_type());
+  return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(arg.Name()), &type);
+}
+
+// Remove a Transpose doing nothing, or merge it with the Transpose producing its input.
+static bool RemoveOrMergeTranspose(Graph& graph, Node& transpose) {
+  Permutation perm;
+  if (!IsTranspose(&transpose, perm)) {
+    return false;
+  }
+
+  int producer_output_index = 0;
+  const Node* producer = GetInputProducer(transpose, 0, producer_output_index);
+  Permutation inner_perm;
+  Node* inner_transpose = nullptr;
+  if (IsTranspose(producer, inner_perm) && inner_perm.size() == perm.size()) {
+    inner_transpose = graph.GetNode(producer->Index());
+    Permutation merged_perm(perm.size());
+    for (size_t i = 0; i < perm.size(); ++i) {
+      merged_perm[i] = inner_perm[perm[i]];
+    }
+    perm = merged_perm;
+  }
+
+  // the value transpose is equivalent to once merged with its input Transpose, if any
+  Node* input_producer = inner_transpose;
+  int input_output_index = 0;
+  NodeArg* input = transpose.MutableInputDefs()[0];
+  if (inner_transpose != nullptr) {
+    input = inner_transpose->MutableInputDefs()[0];
+    const Node* producer_of_inner = GetInputProducer(*inner_transpose, 0, input_output_index);
+    input_producer = producer_of_inner != nullptr ? graph.GetNode(producer_of_inner->Index()) : nullptr;
+  } else {
+    input_producer = producer != nullptr ? graph.GetNode(producer->Index()) : nullptr;
+    input_output_index = producer_output_index;
+  }
+
+  if (IsIdentityPermutation(perm) && CanReplaceOutput(graph, transpose, 0)) {
+    for (const auto& consumer : GetConsumers(transpose, 0)) {
+      ReplaceInput(graph, *graph.GetNode(consumer.first), consumer.second, *input, input_producer, input_output_index);
+    }
+    graph.RemoveNode(transpose.Index());
+  } else if (IsIdentityPermutation(perm) && input_producer != nullptr &&
+             IsConsumedOnlyBy(graph, *input_producer, input_output_index,
+                              inner_transpose != nullptr ? *inner_transpose : transpose) &&
+             (inner_transpose == nullptr || IsConsumedOnlyBy(graph, *inner_transpose, 0, transpose))) {
+    // the output is a graph output, make the producer of the input output it directly
+    NodeArg& output = *transpose.MutableOutputDefs()[0];
+    const auto consumers = GetConsumers(transpose, 0);
+    for (const auto& consumer : consumers) {
+      graph.RemoveEdge(transpose.Index(), consumer.first, 0, consumer.second);
+    }
+    graph.RemoveNode(transpose.Index());
+    if (inner_transpose != nullptr) {
+      graph.RemoveNode(inner_transpose->Index());
+    }
+    input_producer->MutableOutputDefs()[input_output_index] = &output;
+    for (const auto& consumer : consumers) {
+      graph.AddEdge(input_producer->Index(), consumer.first, input_output_index, consumer.second);
+    }
+    return true;
+  } else if (inner_transpose != nullptr && IsConsumedOnlyBy(graph, *inner_transpose, 0, transpose)) {
+    ReplaceInput(graph, transpose, 0, *input, input_producer, input_output_index);
+    transpose.AddAttribute("perm", perm);
+  } else {
+    return false;
+  }
+
+  if (inner_transpose != nullptr && inner_transpose->GetOutputEdgesCount() == 0 &&
+      !IsGraphOutput(graph, inner_transpose->OutputDefs()[0])) {
+    graph.RemoveNode(inner_transpose->Index());
+  }
+  return true;
+}
+
+static bool NormalizeAxis(int64_t& axis, size_t rank) {
+  if (axis < 0) {
+    axis += static_cast<int64_t>(rank);
+  }
+  return axis >= 0 && axis < static_cast<int64_t>(rank);
+}
+
+// Compute the attributes of node applying to its inputs before they were transposed with perm, and the
+// permutation to apply to its outputs. Returns false if node cannot be applied to them.
+static bool GetUntransposedAttributes(const Node& node, LayoutKind kind, const Permutation& perm,
+                                      std::vector<std::pair<std::string, std::vector<int64_t>>>& list_attributes,
+                                      std::vector<std::pair<std::string, int64_t>>& int_attributes,
+                                      Permutation& output_perm) {
+  const size_t rank = perm.size();
+  const auto& attributes = node.GetAttributes();
+  output_perm = perm;
+
+  switch (kind) {
+    case LayoutKind::kConcat:
+    case LayoutKind::kSplit: {
+      auto axis_attr = attributes.find("axis");
+      if (axis_attr == attributes.cend() && kind == LayoutKind::kConcat) {
+        return false;
+      }
+      int64_t axis = axis_attr != attributes.cend() ? axis_attr->second.i() : 0;
+      if (!NormalizeAxis(axis, rank)) {
+        return false;
+      }
+      int_attributes.emplace_back("axis", perm[axis]);
+      return true;
+    }
+    case LayoutKind::kPad: {
+      auto pads_attr = attributes.find("pads");
+      if (pads_attr == attributes.cend() || pads_attr->second.ints_size() != static_cast<int>(2 * rank)) {
+        return false;
+      }
+      std::vector<int64_t> pads(2 * rank);
+      for (size_t i = 0; i < rank; ++i) {
+        pads[perm[i]] = pads_attr->second.ints(static_cast<int>(i));
+        pads[rank + perm[i]] = pads_attr->second.ints(static_cast<int>(rank + i));
+      }
+      list_attributes.emplace_back("pads", pads);
+      return true;
+    }
+    case LayoutKind::kReduce: {
+      // all the dimensions are reduced by default
+      std::vector<int64_t> axes(rank);
+      std::iota(axes.begin(), axes.end(), 0);
+      auto axes_attr = attributes.find("axes");
+      if (axes_attr != attributes.cend()) {
+        axes.assign(axes_attr->second.ints().cbegin(), axes_attr->second.ints().cend());
+      }
+      std::vector<bool> is_reduced(rank, false);
+      for (auto& axis : axes) {
+        if (!NormalizeAxis(axis, rank)) {
+          return false;
+        }
+        axis = perm[axis];
+        is_reduced[axis] = true;
+      }
+      list_attributes.emplace_back("axes", axes);
+
+      auto keepdims_attr = attributes.find("keepdims");
+      if (keepdims_attr != attributes.cend() && keepdims_attr->second.i() == 0) {
+        // the reduced dimensions are dropped, permute the remaining ones
+        std::vector<int64_t> output_position(rank, 0);
+        int64_t position = 0;
+        for (size_t i = 0; i < rank; ++i) {
+          if (!is_reduced[i]) {
+            output_position[i] = position++;
+          }
+        }
+        output_perm.clear();
+        for (size_t i = 0; i < rank; ++i) {
+          if (!is_reduced[perm[i]]) {
+            output_perm.push_back(output_position[perm[i]]);
+          }
+        }
+      }
+      return true;
+    }
+    default:
+      return true;
+  }
+}
+
+// Whether a Transpose with perm added after the output output_index of node would go away.
+static bool WouldCancel(const Graph& graph, const Node& node, int output_index, const Permutation& perm) {
+  const auto consumers = GetConsumers(node, output_index);
+  if (consumers.empty() || IsGraphOutput(graph, node.OutputDefs()[output_index])) {
+    return false;
+  }
+  const Permutation inverse = InvertPermutation(perm);
+  for (const auto& consumer : consumers) {
+    Permutation consumer_perm;
+    if (!IsTranspose(graph.GetNode(consumer.first), consumer_perm) ||
+        (consumers.size() > 1 && consumer_perm != inverse)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Make input_index of node, a constant, the transpose of its value with perm, broadcast to the rank of perm.
+static void TransposeConstantInput(Graph& graph, Node& node, int input_index, const Permutation& perm) {
+  const size_t rank = perm.size();
+  NodeArg* value = node.MutableInputDefs()[input_index];
+  const TensorProto* initializer = nullptr;
+  graph.GetInitializedTensor(value->Name(), initializer);
+
+  Node* unsqueeze = nullptr;
+  if (static_cast<size_t>(initializer->dims_size()) < rank) {
+    std::vector<int64_t> axes(rank - initializer->dims_size());
+    std::iota(axes.begin(), axes.end(), 0);
+    NodeArg& unsqueezed = CreateNodeArgLike(graph, *value);
+    unsqueeze = &graph.AddNode(graph.GenerateNodeName("Unsqueeze"), "Unsqueeze",
+                               "Broadcast a constant to the rank of a Transpose", {value}, {&unsqueezed});
+    unsqueeze->AddAttribute("axes", axes);
+    value = &unsqueezed;
+  }
+
+  NodeArg& transposed = CreateNodeArgLike(graph, *value);
+  Node& transpose = graph.AddNode(graph.GenerateNodeName("Transpose"), "Transpose",
+                                  "Transpose a constant with the Transpose pushed through its consumer",
+                                  {value}, {&transposed});
+  transpose.AddAttribute("perm", perm);
+  if (unsqueeze != nullptr) {
+    graph.AddEdge(unsqueeze->Index(), transpose.Index(), 0, 0);
+  }
+  ReplaceInput(graph, node, input_index, transposed, &transpose, 0);
+}
+
+// Make the output output_index of node the input of a new Transpose with perm, which produces the original value.
+static void AddTransposeAfter(Graph& graph, Node& node, int output_index, const Permutation& perm) {
+  NodeArg& output = *node.MutableOutputDefs()[output_index];
+  const auto consumers = GetConsumers(node, output_index);
+  for (const auto& consumer : consumers) {
+    graph.RemoveEdge(node.Index(), consumer.first, output_index, consumer.second);
+  }
+
+  NodeArg& untransposed_output = CreateNodeArgLike(graph, output);
+  node.MutableOutputDefs()[output_index] = &untransposed_output;
+  Node& transpose = graph.AddNode(graph.GenerateNodeName("Transpose"), "Transpose",
+                                  "Transpose pushed through " + node.OpType(), {&untransposed_output}, {&output});
+  transpose.AddAttribute("perm", perm);
+
+  graph.AddEdge(node.Index(), transpose.Index(), output_index, 0);
+  for (const auto& consumer : consumers) {
+    graph.AddEdge(transpose.Index(), consumer.first, 0, consumer.second);
+  }
+}
+
+// Apply node to the inputs of the Transposes producing its inputs, and transpose its outputs instead.
+static bool PushTransposeThrough(Graph& graph, Node& node) {
+  const LayoutKind kind = GetLayoutKind(node);
+  if (kind == LayoutKind::kOther || (kind == LayoutKind::kPad && node.InputDefs().size() > 1)) {
+    return false;
+  }
+  const bool all_inputs = kind == LayoutKind::kBroadcast || kind == LayoutKind::kConcat;
+  const int num_inputs = all_inputs ? static_cast<int>(node.InputDefs().size()) : 1;
+
+  Permutation perm;
+  std::vector<int> transposed_inputs;
+  std::vector<NodeIndex> transposes;
+  std::vector<int> constant_inputs;
+  bool transposes_runtime_value = false;
+  for (int i = 0; i < num_inputs; ++i) {
+    int output_index = 0;
+    const Node* producer = GetInputProducer(node, i, output_index);
+    Permutation input_perm;
+    if (IsTranspose(producer, input_perm) && IsConsumedOnlyBy(graph, *producer, output_index, node)) {
+      if (!transposed_inputs.empty() && input_perm != perm) {
+        return false;
+      }
+      perm = input_perm;
+      transposed_inputs.push_back(i);
+      if (std::find(transposes.cbegin(), transposes.cend(), producer->Index()) == transposes.cend()) {
+        transposes.push_back(producer->Index());
+      }
+      // Transposes of initializers are left to constant folding
+      const TensorProto* initializer = nullptr;
+      transposes_runtime_value |= !graph.GetInitializedTensor(producer->InputDefs()[0]->Name(), initializer);
+      continue;
+    }
+
+    const TensorProto* initializer = nullptr;
+    if (!all_inputs || !graph.GetInitializedTensor(node.InputDefs()[i]->Name(), initializer)) {
+      return false;
+    }
+    constant_inputs.push_back(i);
+  }
+  if (transposed_inputs.empty() || !transposes_runtime_value) {
+    return false;
+  }
+
+  // constants broadcast as a single value are left as is
+  const size_t rank = perm.size();
+  std::vector<int> transposed_constant_inputs;
+  for (int i : constant_inputs) {
+    const TensorProto* initializer = nullptr;
+    graph.GetInitializedTensor(node.InputDefs()[i]->Name(), initializer);
+    const bool is_single_value = std::all_of(initializer->dims().cbegin(), initializer->dims().cend(),
+                                             [](int64_t dim) { return dim == 1; });
+    if (static_cast<size_t>(initializer->dims_size()) > rank ||
+        (kind == LayoutKind::kConcat && static_cast<size_t>(initializer->dims_size()) != rank)) {
+      return false;
+    }
+    if (!is_single_value || kind == LayoutKind::kConcat) {
+      transposed_constant_inputs.push_back(i);
+    }
+  }
+
+  std::vector<std::pair<std::string, std::vector<int64_t>>> list_attributes;
+  std::vector<std::pair<std::string, int64_t>> int_attributes;
+  Permutation output_perm;
+  if (!GetUntransposedAttributes(node, kind, perm, list_attributes, int_attributes, output_perm)) {
+    return false;
+  }
+
+  // do not add more Transposes than are removed
+  const bool transposes_output = !IsIdentityPermutation(output_perm);
+  size_t num_added = 0;
+  for (int i = 0; transposes_output && i < static_cast<int>(node.OutputDefs().size()); ++i) {
+    if (node.OutputDefs()[i]->Exists() && !WouldCancel(graph, node, i, output_perm)) {
+      ++num_added;
+    }
+  }
+  if (num_added > transposes.size()) {
+    return false;
+  }
+
+  for (int i : transposed_inputs) {
+    int output_index = 0;
+    Node& transpose = *graph.GetNode(GetInputProducer(node, i, output_index)->Index());
+    const Node* input_producer = GetInputProducer(transpose, 0, output_index);
+    ReplaceInput(graph, node, i, *transpose.MutableInputDefs()[0],
+                 input_producer != nullptr ? graph.GetNode(input_producer->Index()) : nullptr, output_index);
+  }
+  for (NodeIndex index : transposes) {
+    graph.RemoveNode(index);
+  }
+
+  const Permutation inverse_perm = InvertPermutation(perm);
+  for (int i : transposed_constant_inputs) {
+    TransposeConstantInput(graph, node, i, inverse_perm);
+  }
+
+  for (const auto& attribute : list_attributes) {
+    node.AddAttribute(attribute.first, attribute.second);
+  }
+  for (const auto& attribute : int_attributes) {
+    node.AddAttribute(attribute.first, attribute.second);
+  }
+
+  for (int i = 0; transposes_output && i < static_cast<int>(node.OutputDefs().size()); ++i) {
+    if (node.OutputDefs()[i]->Exists()) {
+      AddTransposeAfter(graph, node, i, output_perm);
+    }
+  }
+  return true;
+}
+
+Status TransposeOptimizer::Apply(onnxruntime::Graph& graph, bool& modified) const {
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+
+  // The Transposes added after a node are visited with its consumers, so a pass pushes them down as far as
+  // they go. Another pass handles the Transposes it left next to each other.
+  bool pass_modified = true;
+  while (pass_modified) {
+    pass_modified = false;
+    GraphViewer graph_viewer(graph);
+    const std::vector<NodeIndex> order = graph_viewer.GetNodesInTopologicalOrder();
+    for (NodeIndex index : order) {
+      Node* node = graph.GetNode(index);
+      if (node == nullptr) {
+        continue;  // removed during this pass
+      }
+      if (RemoveOrMergeTranspose(graph, *node) || PushTransposeThrough(graph, *node)) {
+        pass_modified = true;
+      }
+    }
+
+    if (pass_modified) {
+      modified = true;
+      ORT_RETURN_IF_ERROR(graph.Resolve());
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
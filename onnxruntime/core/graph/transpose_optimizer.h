@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class TransposeOptimizer
+
+Removes the Transpose nodes models converted from another layout (e.g. NHWC to NCHW) are full of.
+Transposes are pushed down through the ops which do not depend on the layout (elementwise ops, activations,
+Concat, Split, Pad and reductions, whose axes are permuted accordingly) when this does not add Transposes.
+Transposes which meet are merged into one, or cancel each other when their permutations are inverse.
+The constant inputs of the ops Transposes are pushed through get a Transpose (and an Unsqueeze if they are
+broadcast from a lower rank), left to the ConstantFolding transformer.
+*/
+class TransposeOptimizer : public onnxruntime::GraphTransformer {
+ public:
+  TransposeOptimizer() noexcept
+      : onnxruntime::GraphTransformer("TransposeOptimizer", "Push Transpose nodes down and cancel inverse ones") {}
+
+  Status Apply(onnxruntime::Graph& graph, bool& modified) const override;
+};
+
+}  // namespace onnxruntime
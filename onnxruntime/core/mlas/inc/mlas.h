@@ -94,6 +94,39 @@ MlasSgemm(
     size_t ldc
     );
 
+//
+// Single precision matrix/matrix multiply routine with post-processing of the
+// output matrix: each tile of C is updated as Activation(C + Bias + Residual)
+// once computed, while it is still in the cache.
+//
+
+struct MLAS_SGEMM_POSTPROCESS {
+    const float* ColumnBias;                // optional vector of N elements added to each row
+    const float* RowBias;                   // optional vector of M elements added to each column
+    const float* Residual;                  // optional M x N matrix added to C
+    size_t ldr;                             // first dimension of the residual matrix
+    const MLAS_ACTIVATION* Activation;      // optional activation applied last
+};
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess
+    );
+
 //
 // Convolution routines.
 //
@@ -438,3 +438,222 @@ Return Value:
         }
     }
 }
+
+template<MLAS_ACTIVATION_KIND ActivationKind>
+void
+MlasSgemmPostProcessKernel(
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    float* C,
+    size_t ldc,
+    size_t RowIndex,
+    size_t ColumnIndex,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine steps over a tile of a SGEMM output matrix, adds the optional
+    bias vectors and residual matrix and invokes the templated activation
+    function.
+
+Arguments:
+
+    PostProcess - Supplies the post-processing parameters.
+
+    C - Supplies the address of the tile of the output matrix.
+
+    ldc - Supplies the first dimension of the output matrix.
+
+    RowIndex - Supplies the index of the first row of the tile.
+
+    ColumnIndex - Supplies the index of the first column of the tile.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_ACTIVATION_FUNCTION<ActivationKind> ActivationFunction(PostProcess->Activation);
+
+    const float* ColumnBias = PostProcess->ColumnBias;
+    const float* RowBias = PostProcess->RowBias;
+    const float* Residual = PostProcess->Residual;
+    const size_t ldr = PostProcess->ldr;
+
+    if (ColumnBias != nullptr) {
+        ColumnBias += ColumnIndex;
+    }
+
+    if (RowBias != nullptr) {
+        RowBias += RowIndex;
+    }
+
+    if (Residual != nullptr) {
+        Residual += RowIndex * ldr + ColumnIndex;
+    }
+
+    //
+    // Step through each row of the tile.
+    //
+
+    while (CountM-- > 0) {
+
+        float* c = C;
+        const float* bias = ColumnBias;
+        const float* residual = Residual;
+        size_t n = CountN;
+
+        float RowBiasValue = (RowBias != nullptr) ? *RowBias++ : 0.0f;
+        MLAS_FLOAT32X4 RowBiasBroadcast = MlasBroadcastFloat32x4(RowBiasValue);
+
+        while (n >= 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasAddFloat32x4(MlasLoadFloat32x4(c), RowBiasBroadcast);
+
+            if (bias != nullptr) {
+                Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(bias));
+                bias += 4;
+            }
+
+            if (residual != nullptr) {
+                Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(residual));
+                residual += 4;
+            }
+
+            MlasStoreFloat32x4(c, ActivationFunction.Activate(Vector));
+            c += 4;
+            n -= 4;
+        }
+
+        while (n > 0) {
+
+            float Scalar = *c + RowBiasValue;
+
+            if (bias != nullptr) {
+                Scalar += *bias++;
+            }
+
+            if (residual != nullptr) {
+                Scalar += *residual++;
+            }
+
+            *c++ = ActivationFunction.Activate(Scalar);
+            n -= 1;
+        }
+
+        C += ldc;
+
+        if (Residual != nullptr) {
+            Residual += ldr;
+        }
+    }
+}
+
+void
+MlasSgemmPostProcess(
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    float* C,
+    size_t ldc,
+    size_t RowIndex,
+    size_t ColumnIndex,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the post-processing of a SGEMM operation to a tile of
+    the output matrix, once the tile has been computed.
+
+Arguments:
+
+    PostProcess - Supplies the post-processing parameters.
+
+    C - Supplies the address of the tile of the output matrix.
+
+    ldc - Supplies the first dimension of the output matrix.
+
+    RowIndex - Supplies the index of the first row of the tile.
+
+    ColumnIndex - Supplies the index of the first column of the tile.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const bool HasAddition = PostProcess->ColumnBias != nullptr ||
+        PostProcess->RowBias != nullptr || PostProcess->Residual != nullptr;
+
+    MLAS_ACTIVATION_KIND ActivationKind = (PostProcess->Activation != nullptr) ?
+        PostProcess->Activation->ActivationKind : MlasIdentityActivation;
+
+    switch (ActivationKind) {
+
+        case MlasIdentityActivation:
+        {
+            if (HasAddition) {
+                MlasSgemmPostProcessKernel<MlasIdentityActivation>(PostProcess, C, ldc,
+                    RowIndex, ColumnIndex, CountM, CountN);
+            }
+            break;
+        }
+
+        case MlasReluActivation:
+        {
+            MlasSgemmPostProcessKernel<MlasReluActivation>(PostProcess, C, ldc,
+                RowIndex, ColumnIndex, CountM, CountN);
+            break;
+        }
+
+        case MlasLeakyReluActivation:
+        {
+            MlasSgemmPostProcessKernel<MlasLeakyReluActivation>(PostProcess, C, ldc,
+                RowIndex, ColumnIndex, CountM, CountN);
+            break;
+        }
+
+        case MlasTanhActivation:
+        {
+            if (HasAddition) {
+                MlasSgemmPostProcessKernel<MlasIdentityActivation>(PostProcess, C, ldc,
+                    RowIndex, ColumnIndex, CountM, CountN);
+            }
+
+            while (CountM-- > 0) {
+                MlasComputeTanh(C, C, CountN);
+                C += ldc;
+            }
+
+            break;
+        }
+
+        case MlasLogisticActivation:
+        {
+            if (HasAddition) {
+                MlasSgemmPostProcessKernel<MlasIdentityActivation>(PostProcess, C, ldc,
+                    RowIndex, ColumnIndex, CountM, CountN);
+            }
+
+            while (CountM-- > 0) {
+                MlasComputeLogistic(C, C, CountN);
+                C += ldc;
+            }
+
+            break;
+        }
+    }
+}
@@ -552,6 +552,13 @@ Return Value:
         }
     }
 
+    //
+    // The bias and activation are applied by the GEMM operation to the last
+    // slice along the K dimension.
+    //
+
+    MLAS_SGEMM_POSTPROCESS PostProcess = { nullptr, Bias, nullptr, 0, Parameters->Activation };
+
     //
     // Step through each slice of the input tensor along the N dimension.
     //
@@ -592,17 +599,10 @@ Return Value:
 
             MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountN,
                 CountK, 1.0f, Filter + k, K, ColumnBuffer, CountN, beta,
-                SegmentOutput, OutputSize);
+                SegmentOutput, OutputSize, (k + CountK == K) ? &PostProcess : nullptr);
 
             beta = 1.0f;
         }
-
-        //
-        // Apply the activation with optional bias.
-        //
-
-        MlasActivation(Parameters->Activation, SegmentOutput, Bias, FilterCount,
-            SegmentOutput, CountN, OutputSize);
     }
 }
 
@@ -713,26 +713,22 @@ Return Value:
         const float* filter = WorkBlock->Filter + group * FilterGroupSize;
         float* output = WorkBlock->Output + bg * OutputGroupSize;
 
-        //
-        // Invoke the non-threaded GEMM directly with the input tensor.
-        //
-
-        MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
-            OutputSize, K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, 0.0f,
-            output, OutputSize);
-
-        //
-        // Apply the activation with optional bias.
-        //
-
         const float* bias = WorkBlock->Bias;
 
         if (bias != nullptr) {
             bias += group * FilterCount;
         }
 
-        MlasActivation(Parameters->Activation, output, bias, FilterCount, output,
-            OutputSize, OutputSize);
+        //
+        // Invoke the non-threaded GEMM directly with the input tensor, which
+        // applies the activation with optional bias.
+        //
+
+        MLAS_SGEMM_POSTPROCESS PostProcess = { nullptr, bias, nullptr, 0, Parameters->Activation };
+
+        MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
+            OutputSize, K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, 0.0f,
+            output, OutputSize, &PostProcess);
     }
 }
 
@@ -947,19 +943,15 @@ Return Value:
                 case MlasConvAlgorithmGemmDirect:
                 {
                     //
-                    // Invoke the threaded GEMM directly with the input tensor.
+                    // Invoke the threaded GEMM directly with the input tensor,
+                    // which applies the activation with optional bias.
                     //
 
+                    MLAS_SGEMM_POSTPROCESS PostProcess = { nullptr, bias, nullptr, 0, Parameters->Activation };
+
                     MlasSgemm(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
                         OutputSize, K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb, 0.0f,
-                        Output, OutputSize);
-
-                    //
-                    // Apply the activation with optional bias.
-                    //
-
-                    MlasActivation(Parameters->Activation, Output, bias, FilterCount, Output,
-                        OutputSize, OutputSize);
+                        Output, OutputSize, &PostProcess);
 
                     break;
                 }
@@ -977,15 +969,10 @@ Return Value:
                         MlasConvVol2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
                     }
 
-                    MlasSgemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f, filter,
-                        K, WorkingBuffer, OutputSize, 0.0f, Output, OutputSize);
-
-                    //
-                    // Apply the activation with optional bias.
-                    //
+                    MLAS_SGEMM_POSTPROCESS PostProcess = { nullptr, bias, nullptr, 0, Parameters->Activation };
 
-                    MlasActivation(Parameters->Activation, Output, bias, FilterCount, Output,
-                        OutputSize, OutputSize);
+                    MlasSgemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f, filter,
+                        K, WorkingBuffer, OutputSize, 0.0f, Output, OutputSize, &PostProcess);
 
                     break;
                 }
@@ -249,7 +249,23 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess
+    );
+
+//
+// Post-processing of a tile of a SGEMM output matrix.
+//
+
+void
+MlasSgemmPostProcess(
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    float* C,
+    size_t ldc,
+    size_t RowIndex,
+    size_t ColumnIndex,
+    size_t CountM,
+    size_t CountN
     );
 
 //
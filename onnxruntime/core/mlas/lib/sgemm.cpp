@@ -40,12 +40,14 @@ struct MLAS_SGEMM_WORK_BLOCK {
     size_t ldc;
     float alpha;
     float beta;
+    bool HasPostProcess;
     struct SEGMENT {
         size_t M;
         size_t N;
         const float* A;
         const float* B;
         float* C;
+        MLAS_SGEMM_POSTPROCESS PostProcess;
     } Segments[MLAS_MAXIMUM_THREAD_COUNT];
 };
 
@@ -786,7 +788,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess
     )
 /*++
 
@@ -824,6 +827,10 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    PostProcess - Supplies the optional post-processing applied to each tile
+        of matrix C once computed. The bias and residual pointers are relative
+        to the first element of matrix C.
+
 Return Value:
 
     None.
@@ -833,6 +840,29 @@ Return Value:
     float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
     MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
 
+    //
+    // Handle the special case of an empty product. The output matrix is only
+    // multiplied by beta before being post-processed.
+    //
+
+    if (K == 0) {
+
+        for (size_t m = 0; m < M; m++) {
+
+            float* c = C + m * ldc;
+
+            for (size_t n = 0; n < N; n++) {
+                c[n] = (beta == 0.0f) ? 0.0f : c[n] * beta;
+            }
+        }
+
+        if (PostProcess != nullptr) {
+            MlasSgemmPostProcess(PostProcess, C, ldc, 0, 0, M, N);
+        }
+
+        return;
+    }
+
     //
     // Handle the special case of a small M. The data from matrix B is not
     // referenced multiple times, so using a local packed buffer is a wasted
@@ -852,7 +882,13 @@ Return Value:
         }
 
         if (SgemmKernelM1Routine != nullptr) {
+
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+
+            if (PostProcess != nullptr) {
+                MlasSgemmPostProcess(PostProcess, C, ldc, 0, 0, 1, N);
+            }
+
             return;
         }
 
@@ -937,6 +973,13 @@ Return Value:
 
             bool UseKernelZeroRoutine = (k == 0 && beta == 0.0f);
 
+            //
+            // The rows of matrix C are complete once the last slice along the
+            // K dimension is added, so they are post-processed right away.
+            //
+
+            const MLAS_SGEMM_POSTPROCESS* TilePostProcess = (k + CountK == K) ? PostProcess : nullptr;
+
 #if defined(MLAS_TARGET_AMD64_IX86)
             PMLAS_SGEMM_KERNEL_ROUTINE SgemmKernelRoutine =
                 UseKernelZeroRoutine ? MlasPlatform.KernelZeroRoutine : MlasPlatform.KernelAddRoutine;
@@ -950,6 +993,7 @@ Return Value:
 
             size_t RowsRemaining = M;
             size_t RowsHandled;
+            size_t RowIndex = 0;
 
             if (TransA == CblasNoTrans) {
 
@@ -971,9 +1015,14 @@ Return Value:
                     }
 #endif
 
+                    if (TilePostProcess != nullptr) {
+                        MlasSgemmPostProcess(TilePostProcess, c, ldc, RowIndex, n, RowsHandled, CountN);
+                    }
+
                     c += ldc * RowsHandled;
                     a += lda * RowsHandled;
 
+                    RowIndex += RowsHandled;
                     RowsRemaining -= RowsHandled;
 
                 } while (RowsRemaining > 0);
@@ -1018,9 +1067,14 @@ Return Value:
                         }
 #endif
 
+                        if (TilePostProcess != nullptr) {
+                            MlasSgemmPostProcess(TilePostProcess, c, ldc, RowIndex, n, RowsHandled, CountN);
+                        }
+
                         c += ldc * RowsHandled;
                         pa += CountK * RowsHandled;
 
+                        RowIndex += RowsHandled;
                         RowsTransposed -= RowsHandled;
 
                     } while (RowsTransposed > 0);
@@ -1031,6 +1085,52 @@ Return Value:
     }
 }
 
+void
+MlasSgemmOffsetPostProcess(
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    size_t RowIndex,
+    size_t ColumnIndex,
+    MLAS_SGEMM_POSTPROCESS* SegmentPostProcess
+    )
+/*++
+
+Routine Description:
+
+    This routine builds the post-processing parameters of a segment of a SGEMM
+    operation starting at the supplied row and column of matrix C.
+
+Arguments:
+
+    PostProcess - Supplies the post-processing parameters of the operation.
+
+    RowIndex - Supplies the index of the first row of the segment.
+
+    ColumnIndex - Supplies the index of the first column of the segment.
+
+    SegmentPostProcess - Receives the post-processing parameters of the
+        segment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    *SegmentPostProcess = *PostProcess;
+
+    if (PostProcess->ColumnBias != nullptr) {
+        SegmentPostProcess->ColumnBias += ColumnIndex;
+    }
+
+    if (PostProcess->RowBias != nullptr) {
+        SegmentPostProcess->RowBias += RowIndex;
+    }
+
+    if (PostProcess->Residual != nullptr) {
+        SegmentPostProcess->Residual += RowIndex * PostProcess->ldr + ColumnIndex;
+    }
+}
+
 void
 MlasSgemmOperationThreaded(
     void* Context,
@@ -1062,7 +1162,7 @@ Return Value:
     MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
         Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
         Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
-        WorkBlock->ldc);
+        WorkBlock->ldc, WorkBlock->HasPostProcess ? &Segment->PostProcess : nullptr);
 }
 
 inline
@@ -1080,7 +1180,8 @@ MlasSgemmTryMultithread(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess
     )
 /*++
 
@@ -1118,6 +1219,8 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    PostProcess - Supplies the optional post-processing of matrix C.
+
 Return Value:
 
     Returns true if the operation was completed across multiple threads, else
@@ -1166,6 +1269,7 @@ Return Value:
     WorkBlock.ldc = ldc;
     WorkBlock.alpha = alpha;
     WorkBlock.beta = beta;
+    WorkBlock.HasPostProcess = (PostProcess != nullptr);
 
     //
     // Segment the operation across multiple threads.
@@ -1200,6 +1304,10 @@ Return Value:
             WorkBlock.Segments[Index].B = B + n * pldb;
             WorkBlock.Segments[Index].C = C + n;
 
+            if (PostProcess != nullptr) {
+                MlasSgemmOffsetPostProcess(PostProcess, 0, n, &WorkBlock.Segments[Index].PostProcess);
+            }
+
             Index++;
         }
 
@@ -1227,6 +1335,10 @@ Return Value:
             WorkBlock.Segments[Index].B = B;
             WorkBlock.Segments[Index].C = C + m * ldc;
 
+            if (PostProcess != nullptr) {
+                MlasSgemmOffsetPostProcess(PostProcess, m, 0, &WorkBlock.Segments[Index].PostProcess);
+            }
+
             Index++;
         }
     }
@@ -1254,6 +1366,7 @@ Return Value:
     MLAS_UNREFERENCED_PARAMETER(beta);
     MLAS_UNREFERENCED_PARAMETER(C);
     MLAS_UNREFERENCED_PARAMETER(ldc);
+    MLAS_UNREFERENCED_PARAMETER(PostProcess);
 
     return false;
 
@@ -1318,6 +1431,75 @@ Return Value:
 
     None.
 
+--*/
+{
+    MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, nullptr);
+}
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) followed by the post-processing of the output matrix.
+    Each tile of matrix C is post-processed once computed, while it is still
+    in the cache, which saves a pass over matrix C.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scaler beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    PostProcess - Supplies the optional post-processing of matrix C: the bias
+        vectors and the residual matrix are added to alpha * A * B + beta * C
+        before the activation is applied.
+
+Return Value:
+
+    None.
+
 --*/
 {
     //
@@ -1325,7 +1507,7 @@ Return Value:
     // single thread based on the GEMM parameters and system configuration.
     //
 
-    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc)) {
-        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, PostProcess)) {
+        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, PostProcess);
     }
 }
@@ -15,6 +15,7 @@
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/sequential_executor.h"
 #include "core/framework/session_state.h"
+#include "core/framework/subgraph_execution_context.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/providers/cpu/tensor/utils.h"
@@ -99,8 +100,9 @@ class LoopImpl {
   Status Execute();
 
  private:
-  NameMLValMap CreateInitialFeeds();
-  void UpdateFeeds(const std::vector<MLValue>& last_output, NameMLValMap& next_input);
+  // feeds are in the order of feed_names_
+  std::vector<MLValue> CreateInitialFeeds();
+  void UpdateFeeds(const std::vector<MLValue>& last_output, std::vector<MLValue>& next_input);
 
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<MLValue>& per_iteration_output, int output_index);
@@ -124,6 +126,9 @@ class LoopImpl {
   std::vector<std::string> subgraph_input_names_;
   std::vector<std::string> subgraph_output_names_;
 
+  // subgraph inputs followed by the implicit inputs
+  std::vector<std::string> feed_names_;
+
   // collection of MLValue outputs from each loop iteration for the loop outputs.
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<MLValue>> loop_output_tensors_;
@@ -213,6 +218,12 @@ Status LoopImpl::Initialize() {
     subgraph_input_names_.push_back(subgraph_inputs[i]->Name());
   }
 
+  feed_names_ = subgraph_input_names_;
+  feed_names_.reserve(num_subgraph_inputs_ + implicit_inputs_.size());
+  for (auto& entry : implicit_inputs_) {
+    feed_names_.push_back(entry.first);
+  }
+
   subgraph_output_names_.reserve(num_subgraph_outputs);
   loop_output_tensors_.resize(num_outputs_ - num_loop_carried_vars_);
 
@@ -226,36 +237,37 @@ Status LoopImpl::Initialize() {
   return status;
 }
 
-NameMLValMap LoopImpl::CreateInitialFeeds() {
-  NameMLValMap feeds;
+std::vector<MLValue> LoopImpl::CreateInitialFeeds() {
+  std::vector<MLValue> feeds;
 
-  feeds.reserve(num_subgraph_inputs_ + implicit_inputs_.size());
+  feeds.reserve(feed_names_.size());
 
-  feeds[subgraph_input_names_[0]] = iter_num_mlvalue_;
-  feeds[subgraph_input_names_[1]] = condition_mlvalue_;
+  feeds.push_back(iter_num_mlvalue_);
+  feeds.push_back(condition_mlvalue_);
 
   // populate loop carried var inputs which conveniently start at slot 2 in both the Loop and subgraph inputs
   for (int i = 2; i < num_subgraph_inputs_; ++i) {
-    feeds[subgraph_input_names_[i]] = *context_.GetInputMLValue(i);
+    feeds.push_back(*context_.GetInputMLValue(i));
   }
 
   // pass in implicit inputs as feeds.
-  for (auto& entry : implicit_inputs_) {
-    ORT_ENFORCE(entry.second, "All implicit inputs should have MLValue instances by now. ",
-                entry.first, " did not.");
-    feeds[entry.first] = *entry.second;
+  for (size_t i = num_subgraph_inputs_, end = feed_names_.size(); i < end; ++i) {
+    const MLValue* implicit_input = implicit_inputs_.at(feed_names_[i]);
+    ORT_ENFORCE(implicit_input, "All implicit inputs should have MLValue instances by now. ",
+                feed_names_[i], " did not.");
+    feeds.push_back(*implicit_input);
   }
 
   return feeds;
 }
 
-void LoopImpl::UpdateFeeds(const std::vector<MLValue>& last_output, NameMLValMap& next_input) {
+void LoopImpl::UpdateFeeds(const std::vector<MLValue>& last_output, std::vector<MLValue>& next_input) {
   // last_output: cond, loop vars..., loop output...
-  // next_input: iter_num, cond, loop_vars. iter_num is re-used
+  // next_input: iter_num, cond, loop_vars, implicit inputs. iter_num and the implicit inputs are re-used
 
   // simple copy for cond and loop carried vars.
   for (int i = 1; i < num_subgraph_inputs_; ++i) {
-    next_input[subgraph_input_names_[i]] = last_output[i - 1];  // skip iter_num in input
+    next_input[i] = last_output[i - 1];  // skip iter_num in input
   }
 
   // save loop outputs as we have to concatenate at the end
@@ -305,9 +317,12 @@ Status LoopImpl::ConcatenateLoopOutput(std::vector<MLValue>& per_iteration_outpu
 Status LoopImpl::Execute() {
   auto status = Status::OK();
 
-  NameMLValMap feeds{CreateInitialFeeds()};
+  std::vector<MLValue> feeds{CreateInitialFeeds()};
   std::vector<MLValue> fetches;
 
+  SubgraphExecutionContext subgraph_context{session_state_, feed_names_, subgraph_output_names_,
+                                            context_.GetTerminateFlag(), context_.Logger()};
+
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
@@ -316,8 +331,7 @@ Status LoopImpl::Execute() {
       fetches.clear();
     }
 
-    status = utils::ExecuteGraph(session_state_, feeds, subgraph_output_names_, fetches, /*sequential_execution*/ true,
-                                 context_.GetTerminateFlag(), context_.Logger());
+    status = subgraph_context.Execute(feeds, fetches);
     ORT_RETURN_IF_ERROR(status);
 
     condition_mlvalue_ = fetches[0];
@@ -352,7 +366,7 @@ Status LoopImpl::Execute() {
     // no iterations.
     // copy input loop carried vars to output.
     for (int i = 0; i < num_loop_carried_vars_; ++i) {
-      copy_tensor_from_mlvalue_to_output(feeds[subgraph_input_names_[i + 2]], i);  // skip iter# and cond
+      copy_tensor_from_mlvalue_to_output(feeds[i + 2], i);  // skip iter# and cond
     }
 
     // create empty outputs for loop outputs
@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
@@ -47,6 +48,10 @@ class Gemm : public OpKernel {
       return Status::OK();
     T_Y* y_data = Y->template MutableData<T_Y>();
 
+    // the bias, the activation or both are applied by MLAS to each tile of Y as it's computed
+    if (TryComputeWithPostProcess(*X, *W, *B, M, N, K, y_data))
+      return Status::OK();
+
     //bias
     // Todo: we might should move this part into math::gemm to let eigen
     // have better chance to further optimize it.
@@ -114,6 +119,76 @@ class Gemm : public OpKernel {
   }
 
  private:
+  template <typename T>
+  bool TryComputeWithPostProcess(const Tensor&, const Tensor&, const Tensor&, int64_t, int64_t, int64_t, T*) const {
+    return false;
+  }
+
+  // Computes Y in a single MLAS pass when the bias can be added and the activation applied while post-processing
+  // the GEMM output, i.e. when the bias isn't scaled nor broadcast from a scalar. Returns false otherwise.
+  bool TryComputeWithPostProcess(const Tensor& X, const Tensor& W, const Tensor& B,
+                                 int64_t M, int64_t N, int64_t K, float* y_data) const {
+    if (!std::is_same<T_X, float>::value || !std::is_same<T_W, float>::value || !std::is_same<T_B, float>::value)
+      return false;
+
+    MLAS_ACTIVATION activation;
+    if (activation_.empty()) {
+      activation.ActivationKind = MlasIdentityActivation;
+    } else if (activation_ == "Relu") {
+      activation.ActivationKind = MlasReluActivation;
+    } else if (activation_ == "LeakyRelu") {
+      activation.ActivationKind = MlasLeakyReluActivation;
+      activation.alpha = leaky_relu_alpha_;
+    } else if (activation_ == "Tanh") {
+      activation.ActivationKind = MlasTanhActivation;
+    } else if (activation_ == "Sigmoid") {
+      activation.ActivationKind = MlasLogisticActivation;
+    } else {
+      return false;
+    }
+
+    MLAS_SGEMM_POSTPROCESS post_process = {nullptr, nullptr, nullptr, 0, &activation};
+    if (beta_ != 0) {
+      if (beta_ != 1)
+        return false;
+
+      auto& b_shape = B.Shape();
+      const float* b_data = B.template Data<float>();
+      // B is (N,) or (1, N)
+      if ((b_shape.NumDimensions() == 1 && b_shape[0] == N) ||
+          (b_shape.NumDimensions() == 2 && b_shape[0] == 1 && b_shape[1] == N)) {
+        post_process.ColumnBias = b_data;
+      }
+      // B is (M, 1)
+      else if (b_shape.NumDimensions() == 2 && b_shape[0] == M && b_shape[1] == 1) {
+        post_process.RowBias = b_data;
+      }
+      // B is (M, N)
+      else if (b_shape.NumDimensions() == 2 && b_shape[0] == M && b_shape[1] == N) {
+        post_process.Residual = b_data;
+        post_process.ldr = static_cast<size_t>(N);
+      } else {
+        return false;
+      }
+    }
+
+    MlasSgemm(trans_A_,
+              trans_B_,
+              static_cast<size_t>(M),
+              static_cast<size_t>(N),
+              static_cast<size_t>(K),
+              alpha_,
+              X.template Data<float>(),
+              static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+              W.template Data<float>(),
+              static_cast<size_t>(trans_B_ == CblasNoTrans ? N : K),
+              0.0f,
+              y_data,
+              static_cast<size_t>(N),
+              &post_process);
+    return true;
+  }
+
   CBLAS_TRANSPOSE trans_A_;
   CBLAS_TRANSPOSE trans_B_;
   float alpha_;
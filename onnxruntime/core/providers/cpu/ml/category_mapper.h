@@ -22,27 +22,17 @@ class CategoryMapper final : public OpKernel {
     ORT_ENFORCE(info.GetAttr<std::string>("default_string", &default_string_).IsOK());
     ORT_ENFORCE(info.GetAttr<int64_t>("default_int64", &default_int_).IsOK());
 
-    auto num_entries = string_categories.size();
+    ORT_ENFORCE(string_categories.size() == int_categories.size());
 
-    ORT_ENFORCE(num_entries == int_categories.size());
-
-    string_to_int_map_.reserve(num_entries);
-    int_to_string_map_.reserve(num_entries);
-
-    for (size_t i = 0; i < num_entries; ++i) {
-      const std::string& str = string_categories[i];
-      int64_t index = int_categories[i];
-
-      string_to_int_map_[str] = index;
-      int_to_string_map_[index] = str;
-    }
+    string_to_int_map_ = MakeLookupTable(string_categories, int_categories);
+    int_to_string_map_ = MakeLookupTable(int_categories, string_categories);
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
-  std::unordered_map<int64_t, std::string> int_to_string_map_;
+  PerfectHashMap<std::string, int64_t> string_to_int_map_;
+  PerfectHashMap<int64_t, std::string> int_to_string_map_;
 
   std::string default_string_;
   int64_t default_int_;
@@ -4,7 +4,9 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include "core/common/common.h"
+#include "core/common/perfect_hash.h"
 #include "core/framework/op_kernel.h"
 
 namespace onnxruntime {
@@ -13,27 +15,62 @@ template <typename AttrType, typename TargetType>
 class DictVectorizerOp final : public OpKernel {
  public:
   DictVectorizerOp(const OpKernelInfo& info) : OpKernel(info) {
+    std::vector<AttrType> vocabulary;
     //In some stupid models, the vocabulary could have duplicated elements.
     //We must support that, otherwise some tests will be break.
-    ORT_ENFORCE(info.GetAttrs(std::is_same<AttrType, std::string>::value ? "string_vocabulary" : "int64_vocabulary", vocabulary_).IsOK());
+    ORT_ENFORCE(info.GetAttrs(std::is_same<AttrType, std::string>::value ? "string_vocabulary" : "int64_vocabulary", vocabulary).IsOK());
+    output_size_ = vocabulary.size();
+
+    // Index the unique words and keep the output positions of every word in CSR form
+    // so that Compute only visits the entries of the (usually small) input map.
+    std::unordered_map<AttrType, std::vector<size_t>> positions;
+    std::vector<AttrType> words;
+    for (size_t i = 0; i < vocabulary.size(); ++i) {
+      auto& word_positions = positions[vocabulary[i]];
+      if (word_positions.empty()) {
+        words.push_back(vocabulary[i]);
+      }
+      word_positions.push_back(i);
+    }
+    std::vector<size_t> slots;
+    vocabulary_ = PerfectHashIndex<AttrType>(words, &slots);
+    std::vector<const std::vector<size_t>*> by_slot(words.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+      by_slot[slots[i]] = &positions[words[i]];
+    }
+    position_offsets_.reserve(words.size() + 1);
+    position_offsets_.push_back(0);
+    positions_.reserve(vocabulary.size());
+    for (const auto* word_positions : by_slot) {
+      positions_.insert(positions_.end(), word_positions->begin(), word_positions->end());
+      position_offsets_.push_back(positions_.size());
+    }
   }
+
   common::Status Compute(OpKernelContext* ctx) const override {
     auto map = ctx->Input<std::map<AttrType, TargetType> >(0);
-    auto Y = ctx->Output(0, TensorShape({1, static_cast<int64_t>(vocabulary_.size())}));
+    auto Y = ctx->Output(0, TensorShape({1, static_cast<int64_t>(output_size_)}));
     auto* y_data = Y->template MutableData<TargetType>();
-    for (size_t i = 0, end = vocabulary_.size(); i < end; ++i) {
-      auto index = map->find(vocabulary_[i]);
-      if (index != map->end()) {
-        *y_data++ = index->second;
-      } else {
-        //Any keys not present in the input dictionary, will be zero in the output array
-        *y_data++ = TargetType();
+    //Any keys not present in the input dictionary, will be zero in the output array
+    std::fill(y_data, y_data + output_size_, TargetType());
+    for (const auto& entry : *map) {
+      const size_t slot = vocabulary_.Find(entry.first);
+      if (slot == vocabulary_.npos) {
+        continue;
+      }
+      for (size_t p = position_offsets_[slot], end = position_offsets_[slot + 1]; p < end; ++p) {
+        y_data[positions_[p]] = entry.second;
       }
     }
     return Status::OK();
   }
 
-  std::vector<AttrType> vocabulary_;
+ private:
+  size_t output_size_;
+  PerfectHashIndex<AttrType> vocabulary_;
+  // Output positions of the word in slot s are positions_[position_offsets_[s], position_offsets_[s + 1])
+  std::vector<size_t> position_offsets_;
+  std::vector<size_t> positions_;
 };
 
 }  // namespace ml
@@ -20,24 +20,18 @@ class LabelEncoder final : public OpKernel {
     ORT_ENFORCE(info.GetAttr<std::string>("default_string", &default_string_).IsOK());
     ORT_ENFORCE(info.GetAttr<int64_t>("default_int64", &default_int_).IsOK());
 
-    auto num_entries = string_classes.size();
-
-    string_to_int_map_.reserve(num_entries);
-    int_to_string_map_.reserve(num_entries);
-
-    for (size_t i = 0; i < num_entries; ++i) {
-      const std::string& str = string_classes[i];
-
-      string_to_int_map_[str] = i;
-      int_to_string_map_[i] = str;
-    }
+    std::vector<int64_t> indices(string_classes.size());
+    std::iota(indices.begin(), indices.end(), int64_t{0});
+    string_to_int_map_ = MakeLookupTable(string_classes, indices);
+    // int64 keys are the class indices so that direction is a plain array lookup
+    classes_ = std::move(string_classes);
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
-  std::unordered_map<int64_t, std::string> int_to_string_map_;
+  PerfectHashMap<std::string, int64_t> string_to_int_map_;
+  std::vector<std::string> classes_;
 
   std::string default_string_;
   int64_t default_int_;
@@ -63,6 +63,12 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
 
   int64_t stride = shape.NumDimensions() == 1 ? shape[0] : shape[1];
   int64_t N = shape.NumDimensions() == 1 ? 1 : shape[0];
+  if (static_cast<int64_t>(coefficients_.size()) != class_count_ * stride) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input has " + std::to_string(stride) + " features but the coefficients expect " +
+                      std::to_string(class_count_ == 0 ? 0 : coefficients_.size() / class_count_));
+  }
+
   Tensor* Y = ctx->Output(0, TensorShape({N}));
 
   int64_t output_classes = class_count_;
@@ -72,37 +78,43 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
     add_second_class = true;
   }
   Tensor* Z = ctx->Output(1, TensorShape({N, output_classes}));
+  if (N == 0 || class_count_ == 0) {
+    return Status::OK();
+  }
 
-  int64_t zindex = 0;
-  const auto* x_data = X->template Data<T>();
-
-  size_t class_count = static_cast<size_t>(class_count_);
-  std::vector<float> scores;
-  scores.reserve(class_count);
-  for (int64_t i = 0; i < N; i++)  //for each point
-  {
-    scores.clear();
-    size_t current_weight_0 = i * stride;
-    int maxclass = -1;
+  std::vector<float> x_buffer;
+  const float* x_data = AsFloatMatrix(X->template Data<T>(), N, stride, stride, x_buffer);
+
+  // Raw scores of the whole batch, [N x class_count], from a single GEMM.
+  // They go straight to Z unless the binary case writes a second score per row.
+  std::vector<float> score_buffer;
+  float* scores;
+  if (add_second_class) {
+    score_buffer.resize(N * class_count_);
+    scores = score_buffer.data();
+  } else {
+    scores = Z->template MutableData<float>();
+  }
+  EigenArrayMap<float>(scores, class_count_, N).colwise() =
+      ConstEigenVectorArrayMap<float>(intercepts_.data(), class_count_);
+  math::Gemm<float, CPUMathUtil>(CblasNoTrans, CblasTrans, N, class_count_, stride, 1.f,
+                                 x_data, coefficients_.data(), 1.f, scores, &CPUMathUtil::Instance());
+
+  //write top class, every point is independent
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < N; i++) {
+    const float* point_scores = scores + i * class_count_;
+    int64_t maxclass = -1;
     float maxweight = 0.f;
-    for (int j = 0; j < class_count; j++)  //for each class
-    {
-      size_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight += static_cast<float>(x_data[current_weight_0 + k] * coefficients_[current_coeff_0 + k]);
-      }
-      if (intercepts_.size() == class_count) {
-        weight += intercepts_[j];
-      }
-      scores.push_back(weight);
-      if (weight > maxweight || maxclass == -1) {
-        maxweight = weight;
+    for (int64_t j = 0; j < class_count_; j++) {
+      if (point_scores[j] > maxweight || maxclass == -1) {
+        maxweight = point_scores[j];
         maxclass = j;
       }
     }
-    //write top class
+
     if (intercepts_.size() == 1)  //binary
     {
       if (using_strings_) {
@@ -135,16 +147,24 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
         Y->template MutableData<int64_t>()[i] = classlabels_ints_[maxclass];
       }
     }
-    //write float values
-    if (add_second_class && maxweight > 0) {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 0);
-    } else if (add_second_class) {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 1);
-    } else {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, -1);
+  }
+
+  //write float values
+  if (add_second_class && post_transform_ != POST_EVAL_TRANSFORM::PROBIT) {
+    // same as write_scores for a single score: the opposite score goes in the first slot
+    float* z_data = Z->template MutableData<float>();
+    for (int64_t i = 0; i < N; i++) {
+      z_data[2 * i] = 1.f - scores[i];
+      z_data[2 * i + 1] = scores[i];
     }
-    zindex += scores.size();
-  }  //for each point
+  } else if (add_second_class) {
+    // write_scores only writes the transformed score, one per point
+    float* z_data = Z->template MutableData<float>();
+    std::copy(scores, scores + N, z_data);
+    batched_post_transform(z_data, N, 1, post_transform_);
+  } else {
+    batched_post_transform(scores, N, class_count_, post_transform_);
+  }
   return Status::OK();
 }
 
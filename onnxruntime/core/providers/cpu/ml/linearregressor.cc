@@ -31,30 +31,26 @@ Status LinearRegressor<float>::Compute(OpKernelContext* ctx) const {
   int64_t stride = X->Shape().NumDimensions() == 1 ? X->Shape()[0] : X->Shape()[1];
   int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
   Tensor* Y = ctx->Output(0, TensorShape({N, targets_}));
-  const auto* Xdata = X->template Data<float>();
-  int64_t yindex = 0;
+  if (static_cast<int64_t>(coefficients_.size()) != targets_ * stride) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input has " + std::to_string(stride) + " features but the coefficients expect " +
+                      std::to_string(targets_ == 0 ? 0 : coefficients_.size() / targets_));
+  }
+  if (N == 0 || targets_ == 0) {
+    return Status::OK();
+  }
 
+  // Scores of the whole batch from a single GEMM, straight into Y [N x targets]
+  float* scores = Y->template MutableData<float>();
   bool useIntercepts = intercepts_.size() == static_cast<size_t>(targets_) ? true : false;
-  for (int64_t i = 0; i < N; i++)  //for each point
-  {
-    std::vector<float> scores;
-    int64_t current_weight_0 = i * stride;
-    for (int j = 0; j < targets_; j++)  //for each target
-    {
-      int64_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight = weight + Xdata[current_weight_0 + k] * coefficients_[current_coeff_0 + k];
-      }
-      if (useIntercepts) {
-        weight = weight + intercepts_[j];
-      }
-      scores.push_back(weight);
-    }
-    ::onnxruntime::ml::write_scores(scores, post_transform_, yindex, Y, -1);
-    yindex += scores.size();
+  if (useIntercepts) {
+    EigenArrayMap<float>(scores, targets_, N).colwise() = ConstEigenVectorArrayMap<float>(intercepts_.data(), targets_);
   }
+  math::Gemm<float, CPUMathUtil>(CblasNoTrans, CblasTrans, N, targets_, stride, 1.f,
+                                 X->template Data<float>(), coefficients_.data(), useIntercepts ? 1.f : 0.f, scores,
+                                 &CPUMathUtil::Instance());
+
+  batched_post_transform(scores, N, targets_, post_transform_);
   return Status::OK();
 }
 
@@ -3,6 +3,7 @@
 
 #pragma once
 #include "core/common/common.h"
+#include "core/common/perfect_hash.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
 
@@ -236,48 +237,119 @@ static inline float sigmoid_probability(float score, float proba, float probb) {
 
 static const float ml_sqrt2 = 1.41421356f;
 
-static inline void compute_softmax(std::vector<float>& values) {
-  std::vector<float> newscores;
+static inline void compute_softmax(float* values, int64_t count) {
   // compute exp with negative number to be numerically stable
   float v_max = -std::numeric_limits<float>::max();
-  for (float value : values) {
-    if (value > v_max)
-      v_max = value;
+  for (int64_t k = 0; k < count; k++) {
+    if (values[k] > v_max)
+      v_max = values[k];
   }
   float this_sum = 0.f;
-  for (float value : values) {
-    float val2 = std::exp(value - v_max);
-    this_sum += val2;
-    newscores.push_back(val2);
+  for (int64_t k = 0; k < count; k++) {
+    values[k] = std::exp(values[k] - v_max);
+    this_sum += values[k];
   }
-  for (int64_t k = 0; k < static_cast<int64_t>(values.size()); k++) {
-    values[k] = newscores[k] / this_sum;
+  for (int64_t k = 0; k < count; k++) {
+    values[k] /= this_sum;
   }
 }
 
+static inline void compute_softmax(std::vector<float>& values) {
+  compute_softmax(values.data(), static_cast<int64_t>(values.size()));
+}
+
 //this function skips zero values (since exp(0) is non zero)
-static inline void compute_softmax_zero(std::vector<float>& values) {
-  std::vector<float> newscores;
+static inline void compute_softmax_zero(float* values, int64_t count) {
   // compute exp with negative number to be numerically stable
   float v_max = -std::numeric_limits<float>::max();
-  for (float value : values) {
-    if (value > v_max)
-      v_max = value;
+  for (int64_t k = 0; k < count; k++) {
+    if (values[k] > v_max)
+      v_max = values[k];
   }
   float exp_neg_v_max = std::exp(-v_max);
   float this_sum = 0.f;
-  for (float value : values) {
+  for (int64_t k = 0; k < count; k++) {
+    float value = values[k];
     if (value > 0.0000001f || value < -0.0000001f) {
-      float val2 = std::exp(value - v_max);
-      this_sum += val2;
-      newscores.push_back(val2);
+      values[k] = std::exp(value - v_max);
+      this_sum += values[k];
     } else {
-      newscores.push_back(value * exp_neg_v_max);
+      values[k] = value * exp_neg_v_max;
+    }
+  }
+  for (int64_t k = 0; k < count; k++) {
+    values[k] /= this_sum;
+  }
+}
+
+static inline void compute_softmax_zero(std::vector<float>& values) {
+  compute_softmax_zero(values.data(), static_cast<int64_t>(values.size()));
+}
+
+// Applies post_transform in place to every row of the row major [num_rows x row_size] matrix scores.
+// Same results as write_scores without additional scores, i.e. LOGISTIC and the softmaxes for rows of
+// at least 2 scores and PROBIT for single scores, but without any allocation.
+// Blocks of rows are transformed in parallel, each by vectorized passes where possible.
+static inline void batched_post_transform(float* scores, int64_t num_rows, int64_t row_size,
+                                          POST_EVAL_TRANSFORM post_transform) {
+  if (row_size == 1 && post_transform != POST_EVAL_TRANSFORM::PROBIT) return;
+  if (row_size >= 2 && (post_transform == POST_EVAL_TRANSFORM::NONE || post_transform == POST_EVAL_TRANSFORM::PROBIT))
+    return;
+
+  constexpr int64_t block_size = 256;
+  const int64_t num_blocks = (num_rows + block_size - 1) / block_size;
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+  for (int64_t b = 0; b < num_blocks; ++b) {
+    const int64_t begin = b * block_size;
+    const int64_t rows = std::min(block_size, num_rows - begin);
+    float* block = scores + begin * row_size;
+    // rows are the columns of the column major Eigen view
+    EigenArrayMap<float> values(block, row_size, rows);
+
+    switch (post_transform) {
+      case POST_EVAL_TRANSFORM::PROBIT:
+        for (int64_t i = 0; i < rows; ++i) {
+          block[i] = ml_sqrt2 * ml_inv_erf(2 * block[i] - 1);
+        }
+        break;
+      case POST_EVAL_TRANSFORM::LOGISTIC:
+        // 1 / (1 + exp(-x)) == (tanh(x / 2) + 1) / 2, which does not overflow for large |x|
+        values = (values * 0.5f).tanh() * 0.5f + 0.5f;
+        break;
+      case POST_EVAL_TRANSFORM::SOFTMAX:
+        for (int64_t i = 0; i < rows; ++i) {
+          auto row = values.col(i);
+          row = (row - row.maxCoeff()).exp();
+          row /= row.sum();
+        }
+        break;
+      case POST_EVAL_TRANSFORM::SOFTMAX_ZERO:
+        for (int64_t i = 0; i < rows; ++i) {
+          compute_softmax_zero(block + i * row_size, row_size);
+        }
+        break;
+      default:
+        break;
     }
   }
-  for (int64_t k = 0; k < static_cast<int64_t>(values.size()); k++) {
-    values[k] = newscores[k] / this_sum;
+}
+
+// Returns the first feature_count columns of x [n x stride] as a contiguous float matrix,
+// converting into buffer only when x cannot be used as is.
+template <typename T>
+const float* AsFloatMatrix(const T* x, int64_t n, int64_t stride, int64_t feature_count,
+                           std::vector<float>& buffer) {
+  if (std::is_same<T, float>::value && stride == feature_count) {
+    return reinterpret_cast<const float*>(x);
+  }
+  buffer.resize(n * feature_count);
+  for (int64_t i = 0; i < n; ++i) {
+    std::transform(x + i * stride, x + i * stride + feature_count, buffer.begin() + i * feature_count,
+                   [](T v) { return static_cast<float>(v); });
   }
+  return buffer.data();
 }
 
 static inline void write_scores(std::vector<float>& scores, POST_EVAL_TRANSFORM post_transform, int64_t write_index, Tensor* Z, int add_second_class) {
@@ -324,5 +396,53 @@ static inline void write_scores(std::vector<float>& scores, POST_EVAL_TRANSFORM
   }
 }
 
+// Builds an immutable lookup table from parallel key/value attributes.
+// Attributes may repeat a key, the last occurrence wins as it did with unordered_map assignment.
+template <typename Key, typename Value>
+PerfectHashMap<Key, Value> MakeLookupTable(const std::vector<Key>& keys, const std::vector<Value>& values) {
+  ORT_ENFORCE(keys.size() == values.size());
+  std::unordered_map<Key, size_t> position;
+  position.reserve(keys.size());
+  std::vector<Key> unique_keys;
+  std::vector<Value> unique_values;
+  unique_keys.reserve(keys.size());
+  unique_values.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto p = position.insert({keys[i], unique_keys.size()});
+    if (p.second) {
+      unique_keys.push_back(keys[i]);
+      unique_values.push_back(values[i]);
+    } else {
+      unique_values[p.first->second] = values[i];
+    }
+  }
+  return PerfectHashMap<Key, Value>(unique_keys, unique_values);
+}
+
+// Maps every input through table, writing default_value for keys that are not present.
+// Hashes are computed a block at a time in a separate loop so that the hashing of
+// independent keys is not serialized behind the table probes, and blocks run in parallel.
+template <typename Key, typename Value>
+void BatchLookup(const PerfectHashMap<Key, Value>& table, const Key* input, Value* output, int64_t count,
+                 const Value& default_value) {
+  constexpr int64_t block_size = 64;
+  const int64_t num_blocks = (count + block_size - 1) / block_size;
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+  for (int64_t b = 0; b < num_blocks; ++b) {
+    uint64_t hashes[block_size];
+    const int64_t begin = b * block_size;
+    const int64_t end = std::min(begin + block_size, count);
+    for (int64_t i = begin; i < end; ++i) {
+      hashes[i - begin] = table.Hash(input[i]);
+    }
+    for (int64_t i = begin; i < end; ++i) {
+      const Value* value = table.FindHashed(input[i], hashes[i - begin]);
+      output[i] = value == nullptr ? default_value : *value;
+    }
+  }
+}
+
 }  // namespace ml
 }  // namespace onnxruntime
@@ -73,6 +73,26 @@ SVMClassifier<T>::SVMClassifier(const OpKernelInfo& info)
       break;
     }
   }
+
+  if (mode_ == SVM_TYPE::SVM_SVC) {
+    // Decision (i, j) sums the kernels of the support vectors of class i weighted by the
+    // coefficients of row j - 1, and those of class j weighted by row i.
+    const int64_t num_pairs = class_count_ * (class_count_ - 1) / 2;
+    pair_coefficients_.assign(num_pairs * vector_count_, 0.f);
+    int64_t pair = 0;
+    for (int64_t i = 0; i < class_count_; i++) {
+      for (int64_t j = i + 1; j < class_count_; j++) {
+        float* pair_row = pair_coefficients_.data() + pair * vector_count_;
+        for (int64_t m = 0; m < vectors_per_class_[i]; m++) {
+          pair_row[starting_vector_[i] + m] = coefficients_[vector_count_ * (j - 1) + starting_vector_[i] + m];
+        }
+        for (int64_t m = 0; m < vectors_per_class_[j]; m++) {
+          pair_row[starting_vector_[j] + m] = coefficients_[vector_count_ * i + starting_vector_[j] + m];
+        }
+        pair++;
+      }
+    }
+  }
 }
 
 template <typename T>
@@ -92,67 +112,78 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
     dims = {static_cast<int64_t>(N), static_cast<int64_t>(class_count_)};
   Z = ctx->Output(1, TensorShape(dims));
 
-  const auto* x_data = X->template Data<T>();
-  int64_t zindex = 0;
-
-  for (int64_t n = 0; n < N; n++)  //for each example
-  {
-    int64_t current_weight_0 = n * stride;
-    int64_t maxclass = -1;
-    double maxweight = 0.f;
-    std::vector<float> decisions;
-    std::vector<float> scores;
-    std::vector<float> kernels;
-    std::vector<int64_t> votes;
+  std::vector<float> x_buffer;
+  const float* x_data = AsFloatMatrix(X->template Data<T>(), N, stride, feature_count_, x_buffer);
 
-    if (mode_ == SVM_TYPE::SVM_SVC) {
-      for (int64_t j = 0; j < vector_count_; j++) {
-        float val = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j, feature_count_, get_kernel_type());
-        kernels.push_back(val);
+  // Raw scores of the whole batch, [N x num_scores]
+  int64_t num_scores;
+  std::vector<float> batch_scores;
+  if (mode_ == SVM_TYPE::SVM_SVC) {
+    num_scores = class_count_ * (class_count_ - 1) / 2;
+    batch_scores.resize(N * num_scores);
+    if (num_scores > 0) {
+      // the kernels are computed for a chunk of rows at a time
+      const int64_t chunk_rows = kernel_batch_rows(N, vector_count_);
+      std::vector<float> kernels(chunk_rows * vector_count_);
+      for (int64_t n = 0; n < N; n += chunk_rows) {
+        const int64_t rows = std::min(chunk_rows, N - n);
+        batched_kernel_dot(x_data + n * feature_count_, rows, support_vectors_.data(), vector_count_,
+                           feature_count_, get_kernel_type(), kernels.data());
+        math::Gemm<float, CPUMathUtil>(CblasNoTrans, CblasTrans, rows, num_scores, vector_count_, 1.f,
+                                       kernels.data(), pair_coefficients_.data(), 0.f,
+                                       batch_scores.data() + n * num_scores, &CPUMathUtil::Instance());
       }
-      for (int64_t j = 0; j < class_count_; j++) {
-        votes.push_back(0);
-      }
-      int evals = 0;
-      for (int64_t i = 0; i < class_count_; i++) {        //for each class
-        for (int64_t j = i + 1; j < class_count_; j++) {  //for each class
-          float sum = 0;
-          int64_t start_index_i = starting_vector_[i];  // *feature_count_;
-          int64_t start_index_j = starting_vector_[j];  // *feature_count_;
-
-          int64_t class_i_support_count = vectors_per_class_[i];
-          int64_t class_j_support_count = vectors_per_class_[j];
-
-          int64_t pos1 = (vector_count_) * (j - 1);
-          int64_t pos2 = (vector_count_) * (i);
-          for (int64_t m = 0; m < class_i_support_count; m++) {
-            float val1 = coefficients_[pos1 + start_index_i + m];
-            float val2 = kernels[start_index_i + m];
-            sum += val1 * val2;
-          }
-          for (int64_t m = 0; m < class_j_support_count; m++) {
-            float val1 = coefficients_[pos2 + start_index_j + m];
-            float val2 = kernels[start_index_j + m];
-            sum += val1 * val2;
-          }
+      EigenArrayMap<float>(batch_scores.data(), num_scores, N).colwise() +=
+          ConstEigenVectorArrayMap<float>(rho_.data(), num_scores);
+    }
+  } else {  //liblinear
+    num_scores = class_count_;
+    batch_scores.resize(N * num_scores);
+    batched_kernel_dot(x_data, N, coefficients_.data(), class_count_, feature_count_, get_kernel_type(),
+                       batch_scores.data());
+    EigenArrayMap<float>(batch_scores.data(), num_scores, N) += rho_[0];
+  }
 
-          sum += rho_[evals];
-          scores.push_back(sum);
-          if (sum > 0) {
+  // One-vs-one voting, every example is independent
+  std::vector<int64_t> vote_winners;
+  if (mode_ == SVM_TYPE::SVM_SVC) {
+    vote_winners.resize(N);
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+    for (int64_t n = 0; n < N; n++) {
+      const float* decisions = batch_scores.data() + n * num_scores;
+      std::vector<int64_t> votes(class_count_, 0);
+      int64_t evals = 0;
+      for (int64_t i = 0; i < class_count_; i++) {
+        for (int64_t j = i + 1; j < class_count_; j++) {
+          if (decisions[evals++] > 0) {
             votes[i]++;
           } else {
             votes[j]++;
           }
-          evals++;  //index into rho
         }
       }
-    } else if (mode_ == SVM_TYPE::SVM_LINEAR) {     //liblinear
-      for (int64_t j = 0; j < class_count_; j++) {  //for each class
-        float val = kernel_dot(x_data, current_weight_0, coefficients_, feature_count_ * j, feature_count_, get_kernel_type());
-        val += rho_[0];
-        scores.push_back(val);
+      int64_t maxclass = -1;
+      int64_t maxvotes = 0;
+      for (int64_t k = 0; k < class_count_; k++) {
+        if (votes[k] > maxvotes) {
+          maxvotes = votes[k];
+          maxclass = k;
+        }
       }
+      vote_winners[n] = maxclass;
     }
+  }
+
+  int64_t zindex = 0;
+  for (int64_t n = 0; n < N; n++)  //for each example
+  {
+    int64_t maxclass = -1;
+    double maxweight = 0.f;
+    const float* row_scores = batch_scores.data() + n * num_scores;
+    std::vector<float> scores(row_scores, row_scores + num_scores);
+
     if (proba_.size() > 0 && mode_ == SVM_TYPE::SVM_SVC) {
       //compute probabilities from the scores
       std::vector<float> estimates;
@@ -181,14 +212,8 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
         scores[k] = estimates[k];
       }
     }
-    int64_t maxvotes = 0;
-    if (votes.size() > 0) {
-      for (int64_t k = 0; k < static_cast<int64_t>(votes.size()); k++) {
-        if (votes[k] > maxvotes) {
-          maxvotes = votes[k];
-          maxclass = k;
-        }
-      }
+    if (mode_ == SVM_TYPE::SVM_SVC) {
+      maxclass = vote_winners[n];
     } else {
       for (int64_t k = 0; k < static_cast<int64_t>(scores.size()); k++) {
         if (scores[k] > maxweight) {
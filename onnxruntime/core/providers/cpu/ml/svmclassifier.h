@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "ml_common.h"
 
@@ -29,32 +30,35 @@ class SVMCommon {
   void set_kernel_type(KERNEL new_kernel_type) { kernel_type_ = new_kernel_type; }
   KERNEL get_kernel_type() const { return kernel_type_; }
 
-  float kernel_dot(const T* A, int64_t a, const std::vector<float>& B, int64_t b, int64_t len, KERNEL k) const {
-    float sum = 0.f;
+  // Number of rows of a batch whose kernels against m support vectors are computed at once,
+  // so that the kernel matrix of a large batch is never allocated as a whole.
+  static int64_t kernel_batch_rows(int64_t n, int64_t m) {
+    const int64_t max_kernel_elements = 1 << 20;
+    return std::max<int64_t>(1, std::min<int64_t>(n, max_kernel_elements / std::max<int64_t>(m, 1)));
+  }
+
+  // Computes the kernel between every row of A [n x feature_count]
+  // and every row of B [m x feature_count] into out [n x m].
+  // All dot products come from a single GEMM and the kernel function is then applied
+  // to the whole matrix in one vectorized pass.
+  void batched_kernel_dot(const float* A, int64_t n, const float* B, int64_t m, int64_t feature_count,
+                          KERNEL k, float* out) const {
+    math::Gemm<float, CPUMathUtil>(CblasNoTrans, CblasTrans, n, m, feature_count, 1.f, A, B, 0.f, out,
+                                   &CPUMathUtil::Instance());
+    // out is row major [n x m] which Eigen sees as column major [m x n]
+    EigenArrayMap<float> kernels(out, m, n);
     if (k == KERNEL::POLY) {
-      for (int64_t i = 0; i < len; i++) {
-        sum += B[b + i] * static_cast<float>(A[a + i]);
-      }
-      sum = gamma_ * sum + coef0_;
-      sum = std::pow(sum, degree_);
+      kernels = (kernels * gamma_ + coef0_).pow(degree_);
     } else if (k == KERNEL::SIGMOID) {
-      for (int64_t i = 0; i < len; i++) {
-        sum += B[b + i] * static_cast<float>(A[a + i]);
-      }
-      sum = gamma_ * sum + coef0_;
-      sum = std::tanh(sum);
+      kernels = (kernels * gamma_ + coef0_).tanh();
     } else if (k == KERNEL::RBF) {
-      for (int64_t i = 0; i < len; i++) {
-        float val = static_cast<float>(A[a + i]) - B[b + i];
-        sum += (val * val);
-      }
-      sum = std::exp(-gamma_ * sum);
-    } else if (k == KERNEL::LINEAR) {
-      for (int64_t i = 0; i < len; i++) {
-        sum += B[b + i] * static_cast<float>(A[a + i]);
-      }
+      // |a - b|^2 = |a|^2 + |b|^2 - 2 * a.b
+      Eigen::ArrayXf a_norms = ConstEigenMatrixMapRowMajor<float>(A, n, feature_count).rowwise().squaredNorm().array();
+      Eigen::ArrayXf b_norms = ConstEigenMatrixMapRowMajor<float>(B, m, feature_count).rowwise().squaredNorm().array();
+      kernels = ((kernels * -2.f).colwise() + b_norms).rowwise() + a_norms.transpose();
+      // Rounding can make the distance of (nearly) equal vectors slightly negative
+      kernels = (kernels.max(0.f) * -gamma_).exp();
     }
-    return sum;
   }
 
  private:
@@ -66,7 +70,8 @@ class SVMCommon {
 
 template <typename T>
 class SVMClassifier final : public OpKernel, private SVMCommon<T> {
-  using SVMCommon<T>::kernel_dot;
+  using SVMCommon<T>::batched_kernel_dot;
+  using SVMCommon<T>::kernel_batch_rows;
   using SVMCommon<T>::set_kernel_type;
   using SVMCommon<T>::get_kernel_type;
 
@@ -87,6 +92,9 @@ class SVMClassifier final : public OpKernel, private SVMCommon<T> {
   std::vector<float> probb_;
   std::vector<float> coefficients_;
   std::vector<float> support_vectors_;
+  // One-vs-one coefficients laid out as a [class pairs x vector_count_] matrix so that
+  // the decision values of a batch are a single GEMM with the kernel matrix
+  std::vector<float> pair_coefficients_;
   std::vector<int64_t> classlabels_ints_;
   std::vector<std::string> classlabels_strings_;
   POST_EVAL_TRANSFORM post_transform_;
@@ -44,32 +44,30 @@ Status SVMRegressor<T>::Compute(OpKernelContext* ctx) const {
   int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
 
   Tensor* Y = ctx->Output(0, TensorShape({N, 1}));  // this op outputs for one target only
-  const auto* x_data = X->template Data<T>();
+  std::vector<float> x_buffer;
+  const float* x_data = AsFloatMatrix(X->template Data<T>(), N, stride, feature_count_, x_buffer);
+  float* y_data = Y->template MutableData<float>();
 
-  for (int64_t n = 0; n < N; n++) {  //for each example
-    int64_t current_weight_0 = n * stride;
-    std::vector<float> scores;
-
-    float sum = 0.f;
-    if (mode_ == SVM_TYPE::SVM_SVC) {
-      for (int64_t j = 0; j < vector_count_; j++) {
-        float val1 = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j, feature_count_, get_kernel_type());
-        float val2 = coefficients_[j];
-        float val3 = val1 * val2;
-        sum += val3;
-      }
-      sum += rho_[0];
-    } else if (mode_ == SVM_TYPE::SVM_LINEAR) {  //liblinear
-      sum = kernel_dot(x_data, current_weight_0, coefficients_, 0, feature_count_, get_kernel_type());
-      sum += rho_[0];
-    }
-    if (one_class_ && sum > 0) {
-      Y->template MutableData<float>()[n] = 1.f;
-    } else if (one_class_) {
-      Y->template MutableData<float>()[n] = -1.f;
-    } else {
-      Y->template MutableData<float>()[n] = sum;
+  if (mode_ == SVM_TYPE::SVM_SVC) {
+    // Kernels of a chunk of rows [rows x vector_count_] at a time weighted by the coefficients
+    const int64_t chunk_rows = kernel_batch_rows(N, vector_count_);
+    std::vector<float> kernels(chunk_rows * vector_count_);
+    for (int64_t n = 0; n < N; n += chunk_rows) {
+      const int64_t rows = std::min(chunk_rows, N - n);
+      batched_kernel_dot(x_data + n * feature_count_, rows, support_vectors_.data(), vector_count_, feature_count_,
+                         get_kernel_type(), kernels.data());
+      EigenVectorMap<float>(y_data + n, rows) =
+          ConstEigenMatrixMapRowMajor<float>(kernels.data(), rows, vector_count_) *
+          ConstEigenVectorMap<float>(coefficients_.data(), vector_count_);
     }
+  } else if (mode_ == SVM_TYPE::SVM_LINEAR) {  //liblinear
+    batched_kernel_dot(x_data, N, coefficients_.data(), 1, feature_count_, get_kernel_type(), y_data);
+  }
+
+  auto sums = EigenVectorArrayMap<float>(y_data, N);
+  sums += rho_[0];
+  if (one_class_) {
+    sums = (sums > 0.f).select(Eigen::ArrayXf::Constant(N, 1.f), Eigen::ArrayXf::Constant(N, -1.f));
   }
 
   return Status::OK();
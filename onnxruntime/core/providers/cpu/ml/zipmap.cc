@@ -31,17 +31,59 @@ namespace ml {
 ONNX_CPU_OPERATOR_ML_KERNEL(
     ZipMap,
     1,
-    KernelDefBuilder().TypeConstraint("T", {DataTypeImpl::GetType<std::vector<std::map<std::string, float>>>(),
-                                            DataTypeImpl::GetType<std::vector<std::map<std::int64_t, float>>>()}),
+    KernelDefBuilder()
+        .TypeConstraint("T", {DataTypeImpl::GetType<std::vector<std::map<std::string, float>>>(),
+                              DataTypeImpl::GetType<std::vector<std::map<std::int64_t, float>>>()})
+        .OutputValueType(0, {DataTypeImpl::GetType<ColumnarMapStringToFloat>(),
+                             DataTypeImpl::GetType<ColumnarMapInt64ToFloat>()}),
     ZipMapOp);
 
 ZipMapOp::ZipMapOp(const OpKernelInfo& info)
     : OpKernel(info),
-      classlabels_int64s_(info.GetAttrsOrDefault<int64_t>("classlabels_int64s")),
-      classlabels_strings_(info.GetAttrsOrDefault<std::string>("classlabels_strings")) {
-  ORT_ENFORCE(classlabels_strings_.empty() ^ classlabels_int64s_.empty(),
+      classlabels_int64s_(std::make_shared<const std::vector<int64_t>>(info.GetAttrsOrDefault<int64_t>("classlabels_int64s"))),
+      classlabels_strings_(std::make_shared<const std::vector<std::string>>(info.GetAttrsOrDefault<std::string>("classlabels_strings"))) {
+  ORT_ENFORCE(classlabels_strings_->empty() ^ classlabels_int64s_->empty(),
               "Must provide classlabels_strings or classlabels_int64s but not both.");
-  using_strings_ = !classlabels_strings_.empty();
+  using_strings_ = !classlabels_strings_->empty();
+}
+
+template <typename TKey>
+common::Status ZipMapOp::ComputeImpl(OpKernelContext* context, const float* x_data, int64_t batch_size,
+                                     int64_t features_per_batch,
+                                     const std::shared_ptr<const std::vector<TKey>>& classlabels) const {
+  if (features_per_batch != static_cast<int64_t>(classlabels->size())) {
+    return Status(ONNXRUNTIME,
+                  INVALID_ARGUMENT,
+                  "Input features_per_batch[" + std::to_string(features_per_batch) +
+                      "] != number of classlabels[" + std::to_string(classlabels->size()) + "]");
+  }
+
+  // Only the caller reads the output: the rows share the labels and the scores are kept as they
+  // are laid out in X. A map per row is only built if the caller asks for one.
+  if (context->NonTensorOutputType(0) == DataTypeImpl::GetType<ColumnarMapSequence<TKey, float>>()) {
+    auto* y_data = context->Output<ColumnarMapSequence<TKey, float>>(0);
+    y_data->Reset(classlabels, static_cast<size_t>(batch_size));
+    auto& values = y_data->MutableValues();
+    if (!values.empty()) {
+      memcpy(values.data(), x_data, values.size() * sizeof(float));
+    }
+    return common::Status::OK();
+  }
+
+  auto* y_data = context->Output<std::vector<std::map<TKey, float>>>(0);
+  if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
+
+  y_data->resize(batch_size);
+  int64_t current_weight_0 = 0;
+  for (int n = 0; n < batch_size; n++) {
+    std::map<TKey, float> map1;
+    for (int j = 0; j < features_per_batch; j++) {
+      map1[(*classlabels)[j]] = x_data[current_weight_0 + j];
+    }
+    current_weight_0 += features_per_batch;
+    (*y_data)[n] = std::move(map1);
+  }
+  return common::Status::OK();
 }
 
 common::Status ZipMapOp::Compute(OpKernelContext* context) const {
@@ -69,48 +111,9 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
   const float* x_data = X.template Data<float>();
 
   if (using_strings_) {
-    if (features_per_batch != static_cast<int64_t>(classlabels_strings_.size())) {
-      return Status(ONNXRUNTIME,
-                    INVALID_ARGUMENT,
-                    "Input features_per_batch[" + std::to_string(features_per_batch) +
-                        "] != number of classlabels[" + std::to_string(classlabels_strings_.size()) + "]");
-    }
-    auto* y_data = context->Output<std::vector<std::map<std::string, float>>>(0);
-    if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
-
-    //auto* y_data = Y->template MutableData<std::vector<std::map<std::string, float>>>();
-    y_data->resize(batch_size);
-    int64_t current_weight_0 = 0;
-    for (int n = 0; n < batch_size; n++) {
-      std::map<std::string, float> map1;
-      for (int j = 0; j < features_per_batch; j++) {
-        map1[classlabels_strings_[j]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map1);
-    }
-  } else {
-    if (features_per_batch != static_cast<int64_t>(classlabels_int64s_.size())) {
-      return Status(ONNXRUNTIME,
-                    INVALID_ARGUMENT,
-                    "Input features_per_batch[" + std::to_string(features_per_batch) +
-                        "] != number of classlabels[" + std::to_string(classlabels_int64s_.size()) + "]");
-    }
-    auto* y_data = context->Output<std::vector<std::map<std::int64_t, float>>>(0);
-    if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
-    //auto* y_data = Y->template MutableData<std::vector<std::map<int64_t, float>>>();
-    y_data->resize(batch_size);
-    int64_t current_weight_0 = 0;
-    for (int n = 0; n < batch_size; n++) {
-      std::map<int64_t, float> map2;
-      for (int j = 0; j < features_per_batch; j++) {
-        map2[classlabels_int64s_[j]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map2);
-    }
+    return ComputeImpl(context, x_data, batch_size, features_per_batch, classlabels_strings_);
   }
-  return common::Status::OK();
+  return ComputeImpl(context, x_data, batch_size, features_per_batch, classlabels_int64s_);
 }
 }  // namespace ml
 }  // namespace onnxruntime
@@ -13,9 +13,15 @@ class ZipMapOp final : public OpKernel {
   common::Status Compute(OpKernelContext* context) const override;
 
  private:
+  template <typename TKey>
+  common::Status ComputeImpl(OpKernelContext* context, const float* x_data, int64_t batch_size,
+                             int64_t features_per_batch,
+                             const std::shared_ptr<const std::vector<TKey>>& classlabels) const;
+
   bool using_strings_;
-  std::vector<int64_t> classlabels_int64s_;
-  std::vector<std::string> classlabels_strings_;
+  // shared with every output so the labels are not copied per run
+  std::shared_ptr<const std::vector<int64_t>> classlabels_int64s_;
+  std::shared_ptr<const std::vector<std::string>> classlabels_strings_;
 };
 
 }  // namespace ml
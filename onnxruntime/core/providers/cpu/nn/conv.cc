@@ -48,23 +48,23 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
 
   const size_t kernel_rank = kernel_shape.size();
 
-  if (kernel_rank == 2 || kernel_rank == 3) {
-    MLAS_ACTIVATION Activation;
-    if (activation_.empty()) {
-        Activation.ActivationKind = MlasIdentityActivation;
-    } else if (activation_ == "Relu") {
-        Activation.ActivationKind = MlasReluActivation;
-    } else if (activation_ == "LeakyRelu") {
-        Activation.ActivationKind = MlasLeakyReluActivation;
-        Activation.alpha = alpha_;
-    } else if (activation_ == "Tanh") {
-        Activation.ActivationKind = MlasTanhActivation;
-    } else if (activation_ == "Sigmoid") {
-        Activation.ActivationKind = MlasLogisticActivation;
-    } else {
-      ORT_NOT_IMPLEMENTED("Not implemented fused activation: ", activation_);
-    }
+  MLAS_ACTIVATION Activation;
+  if (activation_.empty()) {
+    Activation.ActivationKind = MlasIdentityActivation;
+  } else if (activation_ == "Relu") {
+    Activation.ActivationKind = MlasReluActivation;
+  } else if (activation_ == "LeakyRelu") {
+    Activation.ActivationKind = MlasLeakyReluActivation;
+    Activation.alpha = alpha_;
+  } else if (activation_ == "Tanh") {
+    Activation.ActivationKind = MlasTanhActivation;
+  } else if (activation_ == "Sigmoid") {
+    Activation.ActivationKind = MlasLogisticActivation;
+  } else {
+    ORT_NOT_IMPLEMENTED("Not implemented fused activation: ", activation_);
+  }
 
+  if (kernel_rank == 2 || kernel_rank == 3) {
     MLAS_CONV_PARAMETERS Parameters;
     size_t WorkingBufferSize;
     MlasConvPrepare(&Parameters,
@@ -125,28 +125,29 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
             static_cast<int>(kernel_shape.size()),
             col_buffer_data,
             &CPUMathUtil::Instance());
-        math::Gemm<float, CPUMathUtil>(
-            CblasNoTrans,
-            CblasNoTrans,
-            M / group_,
-            output_image_size,
-            kernel_dim,
-            1,
-            W->template Data<float>() + group_id * W_offset,
-            col_buffer_data,
+        // the bias of each output channel and the activation are applied as the GEMM output is computed
+        MLAS_SGEMM_POSTPROCESS PostProcess = {
+            nullptr,
+            B != nullptr ? B->template Data<float>() + group_id * (M / group_) : nullptr,
+            nullptr,
             0,
-            Ydata + group_id * Y_offset,
-            &CPUMathUtil::Instance());
+            &Activation};
+        MlasSgemm(CblasNoTrans,
+                  CblasNoTrans,
+                  static_cast<size_t>(M / group_),
+                  static_cast<size_t>(output_image_size),
+                  static_cast<size_t>(kernel_dim),
+                  1.0f,
+                  W->template Data<float>() + group_id * W_offset,
+                  static_cast<size_t>(kernel_dim),
+                  col_buffer_data,
+                  static_cast<size_t>(output_image_size),
+                  0.0f,
+                  Ydata + group_id * Y_offset,
+                  static_cast<size_t>(output_image_size),
+                  &PostProcess);
       }
 
-      if (B != nullptr) {
-        auto Ymatrix = EigenMatrixMap<float>(Ydata, output_image_size, M);
-        auto Bvec = ConstEigenVectorMap<float>(B->template Data<float>(), M);
-        Ymatrix.rowwise() += Bvec.transpose();
-      }
-
-      FuseActivation(activation_, Ydata, Y_offset * group_, alpha_);
-
       Xdata += X_offset * group_;
       Ydata += Y_offset * group_;
     }
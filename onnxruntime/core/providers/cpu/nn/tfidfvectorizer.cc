@@ -4,12 +4,11 @@
 #include "tfidfvectorizer.h"
 #include "onnx/defs/schema.h"
 #include "core/common/common.h"
+#include "core/common/perfect_hash.h"
 #include "core/framework/tensor.h"
 
-#include <functional>
-#include <unordered_set>
-#include <ostream>
-#include <iterator>
+#include <limits>
+#include <unordered_map>
 
 namespace onnxruntime {
 
@@ -42,147 +41,91 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
 
 namespace ngram_details {
 
-class NgramEntryBase {
-  size_t id_;  // Id in the pool
- protected:
-  NgramEntryBase(size_t id) : id_(id) {}
-  ~NgramEntryBase() = default;
-
+// N-grams are stored as sequences of dense token ids. Input items are translated to
+// token ids once per Compute, so probing the index never touches strings.
+// The hash of a n-gram is built incrementally, item by item, which lets us probe
+// every n-gram length of a window in a single pass.
+class NgramIndex {
  public:
-  size_t Id() const { return id_; }
-};
-
-template <class T>
-class NgramEntry;
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
 
-template <>
-class NgramEntry<int64_t> : public NgramEntryBase {
-  std::vector<int64_t> items_;
-  size_t hash_ = 0;
-
-  void RunningHash(int64_t v) {
-    std::hash<int64_t> hf{};
-    hash_ ^= hf(v) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
+  static uint64_t Extend(uint64_t hash, int32_t token_id) {
+    return (hash + static_cast<uint64_t>(token_id) + 1) * 0x9e3779b97f4a7c15ULL;
   }
 
- public:
-  template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntryBase(id) {
-    while (first != last) {
-      RunningHash(*first);
-      items_.push_back(*first);
-      ++first;
+  // Must be called with the total number of n-grams before any Insert
+  void Reserve(size_t ngrams) {
+    size_t capacity = 16;
+    while (capacity < ngrams * 2) {
+      capacity *= 2;
     }
-    assert(!items_.empty());
-  }
-  // For sampling
-  explicit NgramEntry() : NgramEntryBase(0) {}
-  void AddItem(int64_t v) {
-    items_.push_back(v);
-    RunningHash(v);
+    table_.assign(capacity, Entry());
+    mask_ = capacity - 1;
   }
-  void DebugPrint() const {
-    std::copy(items_.cbegin(), items_.cend(), std::ostream_iterator<int64_t>(std::cout, ","));
-    std::cout << std::endl;
-  }
-  void Clear() {
-    items_.clear();
-    hash_ = 0;
-  }
-  bool operator==(const NgramEntry& o) const {
-    return items_ == o.items_;
-  }
-  size_t Hash() const {
-    return hash_;
-  }
-};
 
-template <>
-class NgramEntry<int32_t> : public NgramEntry<int64_t> {
- public:
-  template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntry<int64_t>(id, first, last) {}
-  explicit NgramEntry() = default;
-};
-
-template <>
-class NgramEntry<std::string> : public NgramEntryBase {
- private:
-  std::vector<std::reference_wrapper<const std::string>> items_;
-  size_t hash_ = 0;
-
-  void RunningHash(const std::string& s) {
-    std::hash<std::string> hf{};
-    hash_ ^= hf(s) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
+  // Returns false if the n-gram is already present
+  bool Insert(const int32_t* token_ids, size_t length, size_t ngram_id) {
+    uint64_t hash = 0;
+    for (size_t i = 0; i < length; ++i) {
+      hash = Extend(hash, token_ids[i]);
+    }
+    if (Find(hash, token_ids, length, 1) != npos) {
+      return false;
+    }
+    size_t slot = Slot(hash);
+    while (table_[slot].length_ != 0) {
+      slot = (slot + 1) & mask_;
+    }
+    table_[slot] = {hash, items_.size(), length, ngram_id};
+    items_.insert(items_.end(), token_ids, token_ids + length);
+    return true;
   }
 
- public:
-  template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntryBase(id) {
-    while (first != last) {
-      RunningHash(*first);
-      items_.push_back(std::cref(*first));
-      ++first;
+  // token_ids are the n-gram items, stride elements apart. Returns the n-gram id or npos.
+  size_t Find(uint64_t hash, const int32_t* token_ids, size_t length, size_t stride) const {
+    for (size_t slot = Slot(hash); table_[slot].length_ != 0; slot = (slot + 1) & mask_) {
+      const Entry& e = table_[slot];
+      if (e.hash_ == hash && e.length_ == length && Equal(&items_[e.items_offset_], token_ids, length, stride)) {
+        return e.ngram_id_;
+      }
     }
-    assert(!items_.empty());
-  }
-  explicit NgramEntry() : NgramEntryBase(0) {}
-  void AddItem(const std::string& s) {
-    items_.push_back(std::cref(s));
-    RunningHash(s);
-  }
-  void DebugPrint() const {
-    std::copy(items_.cbegin(), items_.cend(), std::ostream_iterator<std::string>(std::cout, ","));
-    std::cout << std::endl;
+    return npos;
   }
-  void Clear() {
-    items_.clear();
-    hash_ = 0;
+
+ private:
+  struct Entry {
+    uint64_t hash_ = 0;
+    size_t items_offset_ = 0;
+    size_t length_ = 0;  // 0 marks an empty slot
+    size_t ngram_id_ = 0;
+  };
+
+  size_t Slot(uint64_t hash) const {
+    return static_cast<size_t>(perfect_hash::Mix(hash)) & mask_;
   }
 
-  bool operator==(const NgramEntry& o) const {
-    if (items_.size() == o.items_.size()) {
-      return std::equal(items_.cbegin(), items_.cend(),
-                        o.items_.cbegin(), o.items_.cend(),
-                        std::equal_to<std::string>());
+  static bool Equal(const int32_t* pool, const int32_t* token_ids, size_t length, size_t stride) {
+    for (size_t i = 0; i < length; ++i, token_ids += stride) {
+      if (pool[i] != *token_ids) {
+        return false;
+      }
     }
-    return false;
-  }
-  size_t Hash() const {
-    return hash_;
+    return true;
   }
+
+  std::vector<Entry> table_;
+  size_t mask_ = 0;
+  // Token ids of all n-grams, back to back
+  std::vector<int32_t> items_;
 };
 
-using IntegerPoolSet = std::unordered_set<NgramEntry<int64_t>>;
-// Does not own strings, contains references to them. This helps
-// to search by string references that point to the current input.
-using StringPoolSet = std::unordered_set<NgramEntry<std::string>>;
-
-template <typename ForwardIter, typename Cont>
-inline void Emplace(ForwardIter first, size_t ngrams, size_t ngram_size, size_t& ngram_id, Cont& c) {
-  for (; ngrams > 0; --ngrams) {
-    c.emplace(ngram_id, first, first + ngram_size);
-    first += ngram_size;
-    ++ngram_id;
-  }
-}
+constexpr size_t NgramIndex::npos;
 
 }  // namespace ngram_details
 }  // namespace onnxruntime
 
 using namespace onnxruntime::ngram_details;
 
-namespace std {
-template <typename T>
-struct hash<NgramEntry<T>> {
-  typedef NgramEntry<T> argument_type;
-  typedef size_t result_type;
-  result_type operator()(const argument_type& a) const {
-    return a.Hash();
-  }
-};
-}  // namespace std
-
 namespace onnxruntime {
 
 // The weighting criteria.
@@ -219,12 +162,11 @@ struct TfIdfVectorizer::Impl {
   std::vector<int64_t> ngram_indexes_;
   std::vector<float> weights_;
 
-  std::vector<std::string> pool_strings_;
-  // This set contains references to pool_string_ entries
-  // of pool_strings attribute
-  StringPoolSet str_set_;
-  // This set contains pool_int64s entries
-  IntegerPoolSet int64_set_;
+  // Dense token ids for the distinct items of the loaded n-grams.
+  // Only one of them is populated depending on the pool type.
+  PerfectHashIndex<std::string> str_tokens_;
+  PerfectHashIndex<int64_t> int64_tokens_;
+  NgramIndex ngrams_;
   size_t output_size_ = 0;
 
   Impl() = default;
@@ -232,11 +174,19 @@ struct TfIdfVectorizer::Impl {
   Impl(const Impl&) = delete;
   Impl& operator=(const Impl&) = delete;
 
-  template <typename T>
-  auto PoolEnd() const;
+  // Returns -1 for items that do not appear in any n-gram
+  int32_t TokenId(const std::string& s) const {
+    auto slot = str_tokens_.Find(s);
+    return slot == str_tokens_.npos ? -1 : static_cast<int32_t>(slot);
+  }
+
+  int32_t TokenId(int64_t v) const {
+    auto slot = int64_tokens_.Find(v);
+    return slot == int64_tokens_.npos ? -1 : static_cast<int32_t>(slot);
+  }
 
-  template <typename T>
-  auto PoolFind(const ngram_details::NgramEntry<T>&) const;
+  template <typename Pool>
+  void LoadPool(const std::vector<Pool>& pool, PerfectHashIndex<Pool>& tokens);
 
   void IncrementCount(size_t ngram_id, size_t row_num,
                       std::vector<uint32_t>& frequencies) const {
@@ -247,34 +197,66 @@ struct TfIdfVectorizer::Impl {
   }
 };
 
-template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<int64_t>() const {
-  return int64_set_.cend();
-}
-
-template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<int32_t>() const {
-  return PoolEnd<int64_t>();
-}
-
-template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<std::string>() const {
-  return str_set_.cend();
-}
-
-template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<int64_t>(const NgramEntry<int64_t>& i) const {
-  return int64_set_.find(i);
-}
-
-template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<int32_t>(const NgramEntry<int32_t>& i) const {
-  return int64_set_.find(i);
-}
+template <typename Pool>
+void TfIdfVectorizer::Impl::LoadPool(const std::vector<Pool>& pool, PerfectHashIndex<Pool>& tokens) {
+  const size_t total_items = pool.size();
+  const size_t min_gram_length = min_gram_length_;
+  const size_t max_gram_length = max_gram_length_;
+
+  // Validate the layout and collect the items of the n-grams we load
+  struct NgramRange {
+    size_t start_idx;
+    size_t ngrams;
+    size_t ngram_size;
+    size_t first_ngram_id;
+  };
+  std::vector<NgramRange> ranges;
+  std::unordered_map<Pool, int32_t> token_ids;
+  size_t ngram_id = 0;
+  size_t loaded_ngrams = 0;
+  size_t ngram_size = 1;
+  for (size_t i = 0; i < ngram_counts_.size(); ++i) {
+    size_t start_idx = ngram_counts_[i];
+    size_t end_idx = ((i + 1) < ngram_counts_.size()) ? ngram_counts_[i + 1] : total_items;
+    ORT_ENFORCE(end_idx >= start_idx && end_idx <= total_items,
+                "n-gram counts out of bounds for ", std::to_string(ngram_size), "-grams");
+    auto items = end_idx - start_idx;
+    if (items > 0) {
+      ORT_ENFORCE((items % ngram_size == 0),
+                  "Number of items must compose whole ", std::to_string(ngram_size), "-grams");
+      auto ngrams = items / ngram_size;
+      // Skip loading ngrams that are not in the range of [min_gram_length-max_gram_length]
+      if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
+        ranges.push_back({start_idx, ngrams, ngram_size, ngram_id});
+        loaded_ngrams += ngrams;
+        for (size_t idx = start_idx; idx < end_idx; ++idx) {
+          token_ids.insert({pool[idx], static_cast<int32_t>(token_ids.size())});
+        }
+      }
+      ngram_id += ngrams;
+    }
+    ++ngram_size;
+  }
 
-template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<std::string>(const NgramEntry<std::string>& i) const {
-  return str_set_.find(i);
+  std::vector<Pool> distinct(token_ids.size());
+  for (const auto& t : token_ids) {
+    distinct[t.second] = t.first;
+  }
+  std::vector<size_t> slots;
+  tokens = PerfectHashIndex<Pool>(distinct, &slots);
+
+  ngrams_.Reserve(loaded_ngrams);
+  std::vector<int32_t> ngram_tokens;
+  for (const auto& r : ranges) {
+    for (size_t n = 0; n < r.ngrams; ++n) {
+      ngram_tokens.clear();
+      for (size_t k = 0; k < r.ngram_size; ++k) {
+        ngram_tokens.push_back(static_cast<int32_t>(slots[token_ids[pool[r.start_idx + n * r.ngram_size + k]]]));
+      }
+      ORT_ENFORCE(ngrams_.Insert(ngram_tokens.data(), r.ngram_size, r.first_ngram_id + n),
+                  "pool duplicate ", std::to_string(r.ngram_size), "-grams detected");
+    }
+  }
 }
 
 TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), impl_(new Impl) {
@@ -333,48 +315,16 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
                 " must be of equal size");
   }
 
+  std::vector<std::string> pool_strings;
   std::vector<int64_t> pool_int64s;
-  status = info.GetAttrs("pool_strings", impl_->pool_strings_);
+  status = info.GetAttrs("pool_strings", pool_strings);
   if (status.IsOK()) {
-    ORT_ENFORCE(!impl_->pool_strings_.empty(), "pool_strings must not be empty if specified");
+    ORT_ENFORCE(!pool_strings.empty(), "pool_strings must not be empty if specified");
+    impl_->LoadPool(pool_strings, impl_->str_tokens_);
   } else {
     status = info.GetAttrs("pool_int64s", pool_int64s);
     ORT_ENFORCE(status.IsOK() && !pool_int64s.empty(), "non-empty pool_int64s is required if pool_strings not provided");
-  }
-
-  // Iterator via the pool. Insert 1 item for 1-grams, 2 items for 2-grams, etc.
-  const auto total_items = (impl_->pool_strings_.empty()) ? pool_int64s.size() : impl_->pool_strings_.size();
-  size_t ngram_id = 0;
-  // Load into dictionary only required gram sizes
-  const size_t min_gram_length = impl_->min_gram_length_;
-  const size_t max_gram_length = impl_->max_gram_length_;
-  size_t ngram_size = 1;
-  for (size_t i = 0; i < impl_->ngram_counts_.size(); ++i) {
-    size_t start_idx = impl_->ngram_counts_[i];
-    size_t end_idx = ((i + 1) < impl_->ngram_counts_.size()) ? impl_->ngram_counts_[i + 1] : total_items;
-    ORT_ENFORCE(end_idx >= start_idx && end_idx <= total_items,
-                "n-gram counts out of bounds for ", std::to_string(ngram_size), "-grams");
-    auto items = end_idx - start_idx;
-    if (items > 0) {
-      ORT_ENFORCE((items % ngram_size == 0),
-                  "Number of items must compose whole ", std::to_string(ngram_size), "-grams");
-      auto ngrams = items / ngram_size;
-      // Skip loading into hash_set ngrams that are not in the range of [min_gram_length-max_gram_length]
-      if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
-        if (impl_->pool_strings_.empty()) {
-          auto before_insert = impl_->int64_set_.size();
-          Emplace(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_set_);
-          ORT_ENFORCE((before_insert + ngrams) == impl_->int64_set_.size(), "pool_int64s duplicate ", std::to_string(ngram_size), "-grams detected");
-        } else {
-          auto before_insert = impl_->str_set_.size();
-          Emplace(impl_->pool_strings_.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_set_);
-          ORT_ENFORCE((before_insert + ngrams) == impl_->str_set_.size(), "poll_strings duplicate ", std::to_string(ngram_size), "-grams detected");
-        }
-      } else {
-        ngram_id += ngrams;
-      }
-    }
-    ++ngram_size;
+    impl_->LoadPool(pool_int64s, impl_->int64_tokens_);
   }
 }
 
@@ -436,7 +386,6 @@ void TfIdfVectorizer::OutputResult(OpKernelContext* ctx, size_t B, const std::ve
 template <typename T>
 Status TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx) const {
   const auto& impl = *impl_;
-  auto const set_end = impl.PoolEnd<T>();
 
   auto X = ctx->Input<Tensor>(0);
   auto& input_shape = X->Shape();
@@ -477,81 +426,61 @@ Status TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx) const {
   std::vector<uint32_t> frequencies;
   frequencies.resize(b_dim * impl.output_size_, 0);
 
-  const auto max_gram_length = impl.max_gram_length_;
-  const auto max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
-  auto start_ngram_size = impl.min_gram_length_;
+  const int64_t total = static_cast<int64_t>(total_items);
   auto const input_data = X->template Data<T>();
-  auto const end_data = input_data + total_items;
-  NgramEntry<T> sample;
-
-  // Treat 1-grams in a special way
-  if (start_ngram_size == 1) {
-    size_t row_num = 0;
-    auto ngram_start = input_data;
-    while (ngram_start < end_data) {
-      auto const ngram_row_end = ngram_start + C;
-      while (ngram_start < ngram_row_end) {
-        sample.Clear();
-        sample.AddItem(*ngram_start);
-        auto hit = impl.PoolFind<T>(sample);
-        if (hit != set_end) {
-          // record frequency
-          auto ngram_id = hit->Id();
-          impl.IncrementCount(ngram_id, row_num, frequencies);
-        }
-        ++ngram_start;
-      }
-      ++row_num;
-      ngram_start = ngram_row_end;
-    }
-    if (++start_ngram_size > max_gram_length) {
-      OutputResult(ctx, B, frequencies);
-      return Status::OK();
-    }
+  // Translate the input to token ids once
+  std::vector<int32_t> token_ids(total_items);
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < total; ++i) {
+    token_ids[i] = impl.TokenId(input_data[i]);
   }
 
-  for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
-    auto ngram_start = input_data;
-    size_t row_num = 0;
-    while (ngram_start < end_data) {
-      assert((B == 0) || (row_num < B));
-      auto const ngram_row_end = ngram_start + C;
-      assert(ngram_row_end <= end_data);
-      while (ngram_start < ngram_row_end) {
-        // Check if any n-gram size in [start_ngram_size..max_gram_length] range
-        // fit before the end of the row so we do not waste time adding [1..start_ngram_size)
-        // At least items of start_ngram_size should fit
-        // last row should match end_data
-        auto at_least_this = ngram_start + skip_distance * (start_ngram_size - 1);
-        if (at_least_this >= ngram_row_end) {
+  const size_t max_gram_length = impl.max_gram_length_;
+  const size_t min_gram_length = impl.min_gram_length_;
+  // 1-grams do not depend on skips, so only count them for the first skip distance
+  const size_t max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
+  const int64_t rows = static_cast<int64_t>(b_dim);
+
+  // Rows own disjoint slices of frequencies
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+  for (int64_t row_num = 0; row_num < rows; ++row_num) {
+    const int32_t* const row = token_ids.data() + row_num * C;
+    for (size_t skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
+      const size_t start_ngram_size = (skip_distance == 1) ? min_gram_length : std::max<size_t>(min_gram_length, 2);
+      if (start_ngram_size > max_gram_length) {
+        break;
+      }
+      for (size_t start = 0; start < C; ++start) {
+        // At least items of start_ngram_size should fit before the end of the row
+        if (start + skip_distance * (start_ngram_size - 1) >= C) {
           break;
         }
-        sample.Clear();
-        auto ngram_item = ngram_start;
-        for (auto ngram_size = 1;
-             ngram_size <= max_gram_length &&
-             ngram_item < ngram_row_end;
-             ++ngram_size, ngram_item += skip_distance) {
-          sample.AddItem(*ngram_item);
-
+        // One pass over all n-gram lengths starting at this item
+        uint64_t hash = 0;
+        size_t item = start;
+        for (size_t ngram_size = 1; ngram_size <= max_gram_length && item < C; ++ngram_size, item += skip_distance) {
+          const int32_t token_id = row[item];
+          if (token_id < 0) {
+            // No n-gram contains this item so no longer n-gram can match either
+            break;
+          }
+          hash = NgramIndex::Extend(hash, token_id);
           // Do not test anything before start_ngram_size
           if (ngram_size >= start_ngram_size) {
-            auto hit = impl.PoolFind<T>(sample);
-            if (hit != set_end) {
-              // record frequency
-              auto ngram_id = hit->Id();
+            auto ngram_id = impl.ngrams_.Find(hash, row + start, ngram_size, skip_distance);
+            if (ngram_id != NgramIndex::npos) {
               impl.IncrementCount(ngram_id, row_num, frequencies);
             }
           }
         }
-        // Sliding window shift
-        ++ngram_start;
       }
-      // Next row
-      ngram_start = ngram_row_end;
-      ++row_num;
     }
   }
+
   OutputResult(ctx, B, frequencies);
   return Status::OK();
 }
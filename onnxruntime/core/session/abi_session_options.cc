@@ -73,6 +73,56 @@ ORT_API(void, OrtDisableCpuMemArena, _In_ OrtSessionOptions* options) {
   options->value.enable_cpu_mem_arena = false;
 }
 
+// deduplicate the initializers on CPU with the other sessions enabling it
+ORT_API(void, OrtEnableInitializerSharing, _In_ OrtSessionOptions* options) {
+  options->value.share_initializers = true;
+}
+
+ORT_API(void, OrtDisableInitializerSharing, _In_ OrtSessionOptions* options) {
+  options->value.share_initializers = false;
+}
+
+// replace the nodes with constant inputs by initializers when initializing the session
+ORT_API(void, OrtEnableConstantFolding, _In_ OrtSessionOptions* options) {
+  options->value.enable_constant_folding = true;
+}
+
+ORT_API(void, OrtDisableConstantFolding, _In_ OrtSessionOptions* options) {
+  options->value.enable_constant_folding = false;
+}
+
+// push the Transpose nodes through the ops not depending on the layout and cancel the inverse ones
+ORT_API(void, OrtEnableTransposeOptimization, _In_ OrtSessionOptions* options) {
+  options->value.enable_transpose_optimization = true;
+}
+
+ORT_API(void, OrtDisableTransposeOptimization, _In_ OrtSessionOptions* options) {
+  options->value.enable_transpose_optimization = false;
+}
+
+// merge the nodes computing the same values from the same inputs
+ORT_API(void, OrtEnableCommonSubexpressionElimination, _In_ OrtSessionOptions* options) {
+  options->value.enable_common_subexpression_elimination = true;
+}
+
+ORT_API(void, OrtDisableCommonSubexpressionElimination, _In_ OrtSessionOptions* options) {
+  options->value.enable_common_subexpression_elimination = false;
+}
+
+// apply the rewrite rules, such as removing the Identity nodes
+ORT_API(void, OrtEnableRuleBasedOptimization, _In_ OrtSessionOptions* options) {
+  options->value.enable_rule_based_optimization = true;
+}
+
+ORT_API(void, OrtDisableRuleBasedOptimization, _In_ OrtSessionOptions* options) {
+  options->value.enable_rule_based_optimization = false;
+}
+
+// cache the models optimized by the graph transformers in a directory, or disable it if empty
+ORT_API(void, OrtSetOptimizedModelCacheDir, _In_ OrtSessionOptions* options, _In_ const char* cache_dir) {
+  options->value.optimized_model_cache_dir = cache_dir;
+}
+
 ///< logger id to use for session output
 ORT_API(void, OrtSetSessionLogId, _In_ OrtSessionOptions* options, const char* logid) {
   options->value.session_logid = logid;
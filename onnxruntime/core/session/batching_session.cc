@@ -0,0 +1,350 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/batching_session.h"
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+
+#include "core/framework/tensor.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+struct BatchingSession::Request {
+  NameMLValMap feeds;
+  std::vector<std::string> output_names;
+  int64_t num_rows = 0;
+  std::chrono::steady_clock::time_point enqueue_time;
+  std::promise<Status> done;
+  std::vector<MLValue> fetches;
+};
+
+namespace {
+
+// Rows of a request, after checking all its feeds are CPU tensors with the same dimension 0.
+Status GetNumRows(const NameMLValMap& feeds, int64_t& num_rows) {
+  if (feeds.empty()) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "BatchingSession requires at least one feed.");
+  }
+
+  num_rows = -1;
+  for (const auto& feed : feeds) {
+    if (!feed.second.IsTensor()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "BatchingSession: feed ", feed.first, " is not a tensor.");
+    }
+    const Tensor& tensor = feed.second.Get<Tensor>();
+    if (strcmp(tensor.Location().name, CPU) != 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "BatchingSession: feed ", feed.first,
+                             " is not on CPU.");
+    }
+    const TensorShape& shape = tensor.Shape();
+    if (shape.NumDimensions() == 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "BatchingSession: feed ", feed.first,
+                             " has no batch dimension.");
+    }
+    if (num_rows == -1) {
+      num_rows = shape[0];
+    } else if (shape[0] != num_rows) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "BatchingSession: feed ", feed.first, " has ", shape[0],
+                             " rows while the other feeds have ", num_rows);
+    }
+  }
+
+  return Status::OK();
+}
+
+bool HaveSameRowShape(const Tensor& a, const Tensor& b) {
+  if (a.DataType() != b.DataType()) return false;
+  const auto& a_dims = a.Shape().GetDims();
+  const auto& b_dims = b.Shape().GetDims();
+  return a_dims.size() == b_dims.size() && std::equal(a_dims.begin() + 1, a_dims.end(), b_dims.begin() + 1);
+}
+
+bool CanBatchTogether(const NameMLValMap& a_feeds, const std::vector<std::string>& a_output_names,
+                      const NameMLValMap& b_feeds, const std::vector<std::string>& b_output_names) {
+  if (a_output_names != b_output_names || a_feeds.size() != b_feeds.size()) {
+    return false;
+  }
+  for (const auto& a_feed : a_feeds) {
+    auto b_feed = b_feeds.find(a_feed.first);
+    if (b_feed == b_feeds.end() || !HaveSameRowShape(a_feed.second.Get<Tensor>(), b_feed->second.Get<Tensor>())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Tensor* CreateTensor(MLDataType element_type, const TensorShape& shape, const AllocatorPtr& allocator, MLValue& value) {
+  size_t size = shape.Size() * element_type->Size();
+  void* buffer = size > 0 ? allocator->Alloc(size) : nullptr;
+  // the rows of padded feeds are left zero, string tensors owning their buffer construct empty strings themselves
+  if (buffer != nullptr && element_type != DataTypeImpl::GetType<std::string>()) {
+    memset(buffer, 0, size);
+  }
+  auto tensor = std::make_unique<Tensor>(element_type, shape, buffer, allocator->Info(), allocator);
+  Tensor* p_tensor = tensor.get();
+  value.Init(tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return p_tensor;
+}
+
+void CopyRows(const Tensor& src, int64_t src_row, Tensor& dst, int64_t dst_row, int64_t num_rows) {
+  const int64_t row_size = src.Shape().SizeFromDimension(1);
+  if (src.DataType() == DataTypeImpl::GetType<std::string>()) {
+    const std::string* src_data = src.Data<std::string>() + src_row * row_size;
+    std::copy(src_data, src_data + num_rows * row_size, dst.MutableData<std::string>() + dst_row * row_size);
+  } else {
+    const size_t row_bytes = row_size * src.DataType()->Size();
+    if (num_rows * row_bytes > 0) {
+      memcpy(static_cast<char*>(dst.MutableDataRaw()) + dst_row * row_bytes,
+             static_cast<const char*>(src.DataRaw()) + src_row * row_bytes,
+             num_rows * row_bytes);
+    }
+  }
+}
+
+}  // namespace
+
+BatchingSession::BatchingSession(InferenceSession& session, const BatchingSessionOptions& options)
+    : session_(session), options_(options), allocator_(std::make_shared<CPUAllocator>()) {
+  ORT_ENFORCE(options_.max_batch_size > 0, "max_batch_size must be positive");
+  ORT_ENFORCE(options_.num_batch_threads > 0, "num_batch_threads must be positive");
+  ORT_ENFORCE(std::is_sorted(options_.batch_buckets.begin(), options_.batch_buckets.end()),
+              "batch_buckets must be in increasing order");
+  ORT_ENFORCE(options_.batch_buckets.empty() || options_.batch_buckets.front() > 0,
+              "batch_buckets must be positive");
+
+  batch_threads_.reserve(options_.num_batch_threads);
+  for (int i = 0; i < options_.num_batch_threads; ++i) {
+    batch_threads_.emplace_back(&BatchingSession::BatchLoop, this);
+  }
+}
+
+BatchingSession::~BatchingSession() {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  queue_changed_.notify_all();
+  for (auto& thread : batch_threads_) {
+    thread.join();
+  }
+}
+
+Status BatchingSession::Run(const NameMLValMap& feeds,
+                            const std::vector<std::string>& output_names,
+                            std::vector<MLValue>* p_fetches) {
+  return Run(feeds, output_names, p_fetches, options_.request_timeout);
+}
+
+Status BatchingSession::Run(const NameMLValMap& feeds,
+                            const std::vector<std::string>& output_names,
+                            std::vector<MLValue>* p_fetches,
+                            std::chrono::microseconds timeout) {
+  if (p_fetches == nullptr) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Output vector pointer is NULL");
+  }
+
+  auto request = std::make_shared<Request>();
+  ORT_RETURN_IF_ERROR(GetNumRows(feeds, request->num_rows));
+  request->feeds = feeds;
+  request->output_names = output_names;
+  std::future<Status> done = request->done.get_future();
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (shutdown_) {
+      return Status(common::ONNXRUNTIME, common::FAIL, "BatchingSession is shutting down.");
+    }
+    request->enqueue_time = std::chrono::steady_clock::now();
+    queue_.push_back(request);
+  }
+  queue_changed_.notify_all();
+
+  if (timeout.count() > 0 && done.wait_for(timeout) == std::future_status::timeout) {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = std::find(queue_.begin(), queue_.end(), request);
+    if (it != queue_.end()) {
+      queue_.erase(it);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "BatchingSession: request timed out after ", timeout.count(),
+                             " microseconds in the queue.");
+    }
+  }
+
+  Status status = done.get();
+  if (status.IsOK()) {
+    *p_fetches = std::move(request->fetches);
+  }
+  return status;
+}
+
+void BatchingSession::BatchLoop() {
+  for (;;) {
+    std::vector<RequestPtr> batch = NextBatch();
+    if (batch.empty()) {
+      return;
+    }
+    RunBatch(batch);
+  }
+}
+
+int64_t BatchingSession::NextBatchRows() const {
+  const Request& first = *queue_.front();
+  int64_t num_rows = 0;
+  for (const auto& request : queue_) {
+    if (request.get() != &first &&
+        !CanBatchTogether(first.feeds, first.output_names, request->feeds, request->output_names)) {
+      continue;
+    }
+    if (num_rows > 0 && num_rows + request->num_rows > options_.max_batch_size) {
+      // the batch can't grow anymore
+      return options_.max_batch_size;
+    }
+    num_rows += request->num_rows;
+    if (num_rows >= options_.max_batch_size) {
+      break;
+    }
+  }
+  return num_rows;
+}
+
+std::vector<BatchingSession::RequestPtr> BatchingSession::NextBatch() {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  for (;;) {
+    if (queue_.empty()) {
+      if (shutdown_) {
+        return {};
+      }
+      queue_changed_.wait(lock);
+      continue;
+    }
+
+    // on shutdown the queued requests are executed without waiting for more
+    if (!shutdown_ && NextBatchRows() < options_.max_batch_size) {
+      auto waited = std::chrono::steady_clock::now() - queue_.front()->enqueue_time;
+      if (waited < options_.max_batch_delay) {
+        queue_changed_.wait_for(lock, options_.max_batch_delay - waited);
+        continue;
+      }
+    }
+    break;
+  }
+
+  std::vector<RequestPtr> batch;
+  const RequestPtr first = queue_.front();
+  int64_t num_rows = 0;
+  for (auto it = queue_.begin(); it != queue_.end();) {
+    const Request& request = **it;
+    if (*it != first &&
+        !CanBatchTogether(first->feeds, first->output_names, request.feeds, request.output_names)) {
+      ++it;
+      continue;
+    }
+    if (num_rows > 0 && num_rows + request.num_rows > options_.max_batch_size) {
+      break;
+    }
+    num_rows += request.num_rows;
+    batch.push_back(*it);
+    it = queue_.erase(it);
+    if (num_rows >= options_.max_batch_size) {
+      break;
+    }
+  }
+
+  // let another batch thread look at the requests left
+  if (!queue_.empty()) {
+    queue_changed_.notify_one();
+  }
+  return batch;
+}
+
+int64_t BatchingSession::BucketRows(int64_t num_rows) const {
+  auto bucket = std::lower_bound(options_.batch_buckets.begin(), options_.batch_buckets.end(), num_rows);
+  return bucket == options_.batch_buckets.end() ? num_rows : *bucket;
+}
+
+void BatchingSession::RunBatch(const std::vector<RequestPtr>& batch) {
+  int64_t num_rows = 0;
+  for (const auto& request : batch) {
+    num_rows += request->num_rows;
+  }
+
+  std::vector<std::vector<MLValue>> request_fetches(batch.size());
+  Status status;
+  try {
+    status = RunBatch(batch, num_rows, request_fetches);
+  } catch (const std::exception& ex) {
+    status = Status(common::ONNXRUNTIME, common::FAIL, ex.what());
+  } catch (...) {
+    status = Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION, "Encountered unknown exception in RunBatch()");
+  }
+
+  for (size_t i = 0; i < batch.size(); ++i) {
+    if (status.IsOK()) {
+      batch[i]->fetches = std::move(request_fetches[i]);
+    }
+    batch[i]->done.set_value(status);
+  }
+}
+
+Status BatchingSession::RunBatch(const std::vector<RequestPtr>& batch, int64_t num_rows,
+                                 std::vector<std::vector<MLValue>>& request_fetches) {
+  const Request& first = *batch.front();
+  const int64_t batch_rows = BucketRows(num_rows);
+
+  // a lone request which needs no padding is executed as is
+  if (batch.size() == 1 && batch_rows == num_rows) {
+    return session_.Run(first.feeds, first.output_names, &request_fetches.front());
+  }
+
+  NameMLValMap feeds;
+  for (const auto& feed : first.feeds) {
+    const Tensor& first_tensor = feed.second.Get<Tensor>();
+    std::vector<int64_t> dims = first_tensor.Shape().GetDims();
+    dims[0] = batch_rows;
+    MLValue value;
+    Tensor* tensor = CreateTensor(first_tensor.DataType(), TensorShape(dims), allocator_, value);
+    int64_t row = 0;
+    for (const auto& request : batch) {
+      CopyRows(request->feeds.find(feed.first)->second.Get<Tensor>(), 0, *tensor, row, request->num_rows);
+      row += request->num_rows;
+    }
+    feeds.emplace(feed.first, value);
+  }
+
+  std::vector<MLValue> fetches;
+  ORT_RETURN_IF_ERROR(session_.Run(feeds, first.output_names, &fetches));
+
+  for (auto& values : request_fetches) {
+    values.resize(fetches.size());
+  }
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    const std::string& name = first.output_names[i];
+    if (!fetches[i].IsTensor()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "BatchingSession: output ", name, " is not a tensor.");
+    }
+    const Tensor& batched = fetches[i].Get<Tensor>();
+    if (strcmp(batched.Location().name, CPU) != 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "BatchingSession: output ", name, " is not on CPU.");
+    }
+    const TensorShape& shape = batched.Shape();
+    if (shape.NumDimensions() == 0 || shape[0] != batch_rows) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "BatchingSession: output ", name, " with shape ", shape,
+                             " does not have the ", batch_rows, " rows of the batch.");
+    }
+
+    std::vector<int64_t> dims = shape.GetDims();
+    int64_t row = 0;
+    for (size_t r = 0; r < batch.size(); ++r) {
+      dims[0] = batch[r]->num_rows;
+      Tensor* tensor = CreateTensor(batched.DataType(), TensorShape(dims), allocator_, request_fetches[r][i]);
+      CopyRows(batched, row, *tensor, 0, batch[r]->num_rows);
+      row += batch[r]->num_rows;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
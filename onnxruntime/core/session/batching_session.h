@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/ml_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+class InferenceSession;
+
+/**
+  * Configuration of a BatchingSession.
+  */
+struct BatchingSessionOptions {
+  // A batch is executed as soon as it holds this many rows.
+  int64_t max_batch_size = 32;
+
+  // How long the oldest queued request waits for others to join its batch.
+  std::chrono::microseconds max_batch_delay{1000};
+
+  // Batch sizes the model is executed with, in increasing order. A batch is padded with zeros
+  // up to the smallest bucket holding its rows, which bounds the number of distinct input shapes.
+  // A batch larger than the last bucket is executed as is. Empty to never pad.
+  std::vector<int64_t> batch_buckets;
+
+  // How long a request may stay queued before Run gives up on it. Zero to wait for ever.
+  // A request whose batch is already executing is always waited for.
+  std::chrono::microseconds request_timeout{0};
+
+  // How many batches execute concurrently.
+  int num_batch_threads = 1;
+};
+
+/**
+  * Coalesces concurrent Run calls on a model with a free batch dimension (dimension 0 of all
+  * its inputs and outputs) into a single execution.
+  * The requests are queued, their inputs concatenated along dimension 0 up to
+  * max_batch_size rows or until max_batch_delay expired, the session runs once and the
+  * outputs are split back between the callers.
+  * Requests are only batched together when they have the same feed names, element types and
+  * dimensions other than the first, and request the same outputs. All values must be CPU tensors.
+  *
+  * Sample usage:
+  *  BatchingSessionOptions bo;
+  *  bo.batch_buckets = {1, 8, 32};
+  *  BatchingSession batching_session{session_object, bo};
+  *  // from any number of threads
+  *  common::Status status = batching_session.Run(feeds, output_names, &fetches);
+  */
+class BatchingSession {
+ public:
+  /**
+    * @param session an initialized session, which must outlive the BatchingSession.
+    */
+  BatchingSession(InferenceSession& session, const BatchingSessionOptions& options);
+
+  /**
+    * Executes the requests still queued before returning.
+    */
+  ~BatchingSession();
+
+  /**
+    * Queue a request and wait for the batch it was added to.
+    * Multiple threads are allowed to run this function; hence its thread-safe.
+    * @param feeds named inputs, all with the same size of dimension 0.
+    * @param output_names output names
+    * @param p_fetches output values in the order specified by output_names, holding the rows of this request.
+    * @return OK if success, FAIL with a message naming the timeout if the request expired in the queue.
+    */
+  common::Status Run(const NameMLValMap& feeds,
+                     const std::vector<std::string>& output_names,
+                     std::vector<MLValue>* p_fetches);
+
+  /**
+    * Same as Run(feeds, output_names, p_fetches) with a timeout replacing
+    * BatchingSessionOptions::request_timeout for this request.
+    */
+  common::Status Run(const NameMLValMap& feeds,
+                     const std::vector<std::string>& output_names,
+                     std::vector<MLValue>* p_fetches,
+                     std::chrono::microseconds timeout);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BatchingSession);
+
+  struct Request;
+  using RequestPtr = std::shared_ptr<Request>;
+
+  void BatchLoop();
+
+  // Take the requests of the next batch out of the queue, or return an empty vector on shutdown.
+  std::vector<RequestPtr> NextBatch();
+
+  // Rows of the requests the batch started by the oldest request would take, up to max_batch_size.
+  int64_t NextBatchRows() const;
+
+  void RunBatch(const std::vector<RequestPtr>& batch);
+
+  common::Status RunBatch(const std::vector<RequestPtr>& batch, int64_t num_rows,
+                          std::vector<std::vector<MLValue>>& request_fetches);
+
+  int64_t BucketRows(int64_t num_rows) const;
+
+  InferenceSession& session_;
+  const BatchingSessionOptions options_;
+  AllocatorPtr allocator_;
+
+  OrtMutex mutex_;
+  OrtCondVar queue_changed_;
+  std::deque<RequestPtr> queue_;  // GUARDED_BY(mutex_)
+  bool shutdown_ = false;         // GUARDED_BY(mutex_)
+
+  std::vector<std::thread> batch_threads_;
+};
+}  // namespace onnxruntime
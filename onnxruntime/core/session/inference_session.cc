@@ -7,6 +7,9 @@
 
 #include "core/session/inference_session.h"
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include "core/platform/ort_mutex.h"
 #include <sstream>
@@ -15,12 +18,16 @@
 
 #include "core/common/logging/logging.h"
 #include "core/common/task_thread_pool.h"
+#include "core/graph/common_subexpression_elimination.h"
+#include "core/graph/identity_elimination.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/graph_transformer.h"
 #include "core/graph/graph_transformer_mgr.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/model.h"
+#include "core/graph/transpose_optimizer.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/constant_folding.h"
 #include "core/framework/customregistry.h"
 #include "core/framework/environment.h"
 #include "core/framework/execution_frame.h"
@@ -31,10 +38,12 @@
 #include "core/framework/ml_value_patterns_planner.h"
 #include "core/framework/mldata_type_utils.h"
 #include "core/framework/mlvalue_name_idx_map.h"
+#include "core/framework/packed_string_tensor.h"
 #include "core/framework/sequential_executor.h"
 #include "core/framework/parallel_executor.h"
 #include "core/framework/session_state.h"
 #include "core/framework/session_state_initializer.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/tensorutils.h"
 #include "core/framework/transformer_memcpy.h"
@@ -43,6 +52,7 @@
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/CustomOpsLoader.h"
 #include "core/session/IOBinding.h"
+#include "core/session/optimized_model_cache.h"
 
 #ifdef USE_EIGEN_THREADPOOL
 #include <unsupported/Eigen/CXX11/ThreadPool>
@@ -68,15 +78,7 @@ class InferenceSession::Impl {
     // currently the threadpool is used by the parallel executor only and hence
     // there is no point creating it when only sequential execution is enabled.
     if (!session_options.enable_sequential_execution) {
-      int pool_size = session_options_.session_thread_pool_size == 0
-                          ? std::thread::hardware_concurrency() / 2
-                          : session_options_.session_thread_pool_size;
-
-#ifdef USE_EIGEN_THREADPOOL
-      thread_pool_ = std::make_unique<Eigen::NonBlockingThreadPool>(pool_size);
-#else
-      thread_pool_ = std::make_unique<TaskThreadPool>(pool_size);
-#endif
+      thread_pool_ = CreateSessionThreadPool();
     }
 
     session_state_.SetThreadPool(thread_pool_.get());
@@ -88,6 +90,14 @@ class InferenceSession::Impl {
     }
   }
 
+  ~Impl() {
+    // complete the runs queued by RunAsync, destroying the pool would drop them
+    if (async_run_pool_ != nullptr) {
+      async_run_pool_->WaitWorkComplete();
+      async_run_pool_.reset();
+    }
+  }
+
   common::Status RegisterExecutionProvider(std::unique_ptr<IExecutionProvider> p_exec_provider) {
     if (p_exec_provider == nullptr) {
       return Status(common::ONNXRUNTIME, common::FAIL, "Received nullptr for exec provider");
@@ -143,6 +153,10 @@ class InferenceSession::Impl {
         return common::Status(common::ONNXRUNTIME, common::MODEL_LOADED, "This session already contains a loaded model.");
       }
 
+      if (!session_options_.optimized_model_cache_dir.empty()) {
+        ORT_RETURN_IF_ERROR(OptimizedModelCache::GetFileFingerprint(model_uri, model_fingerprint_));
+      }
+
       std::shared_ptr<onnxruntime::Model> p_tmp_model;
       ORT_RETURN_IF_ERROR(onnxruntime::Model::Load(model_uri, p_tmp_model,
                                                    HasLocalSchema() ? &custom_schema_registries_ : nullptr));
@@ -231,24 +245,45 @@ class InferenceSession::Impl {
   }
 
   common::Status Load(std::istream& model_istream) {
+    return Load(
+        [this, &model_istream](std::shared_ptr<onnxruntime::Model>& model) {
+          LOGS(*session_logger_, INFO) << "Loading model using istream";
+          auto model_proto = std::make_unique<ModelProto>();
+          ORT_RETURN_IF_ERROR(onnxruntime::Model::Load(model_istream, model_proto.get()));
+          return onnxruntime::Model::Load(std::move(model_proto), model,
+                                          HasLocalSchema() ? &custom_schema_registries_ : nullptr);
+        },
+        "model_loading_istream");
+  }
+
+  common::Status Load(const void* model_data, int model_data_len) {
+    return Load(
+        [this, model_data, model_data_len](std::shared_ptr<onnxruntime::Model>& model) {
+          LOGS(*session_logger_, INFO) << "Loading model from a buffer";
+          ORT_RETURN_IF_ERROR(onnxruntime::Model::LoadFromBytes(model_data_len, model_data, model,
+                                                                HasLocalSchema() ? &custom_schema_registries_
+                                                                                 : nullptr));
+          if (!session_options_.optimized_model_cache_dir.empty()) {
+            model_fingerprint_ = OptimizedModelCache::GetBytesFingerprint(model_data, model_data_len);
+          }
+          return Status::OK();
+        },
+        "model_loading_array");
+  }
+
+  // Loads the model created by loader unless one was already loaded, recording event_name in the profile.
+  common::Status Load(const std::function<common::Status(std::shared_ptr<onnxruntime::Model>&)>& loader,
+                      const std::string& event_name) {
     auto tp = session_profiler_.StartTime();
     try {
-      LOGS(*session_logger_, INFO) << "Loading model using istream";
       std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
       if (is_model_loaded_) {  // already loaded
         LOGS(*session_logger_, ERROR) << "This session already contains a loaded model.";
         return common::Status(common::ONNXRUNTIME, common::MODEL_LOADED, "This session already contains a loaded model.");
       }
 
-      ModelProto model_proto;
-      const bool result = model_proto.ParseFromIstream(&model_istream);
-      if (!result) {
-        return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF, "Failed to load model because protobuf parsing failed.");
-      }
-
       std::shared_ptr<onnxruntime::Model> p_tmp_model;
-      ORT_RETURN_IF_ERROR(onnxruntime::Model::Load(model_proto, p_tmp_model,
-                                                   HasLocalSchema() ? &custom_schema_registries_ : nullptr));
+      ORT_RETURN_IF_ERROR(loader(p_tmp_model));
       model_ = p_tmp_model;
 
       ORT_RETURN_IF_ERROR(DoPostLoadProcessing(*model_.get()));
@@ -264,7 +299,7 @@ class InferenceSession::Impl {
       return Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION, "Encountered unknown exception in Load()");
     }
     if (session_profiler_.FEnabled()) {
-      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_loading_istream", tp);
+      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, event_name, tp);
     }
     return common::Status::OK();
   }
@@ -274,16 +309,19 @@ class InferenceSession::Impl {
                                        const ExecutionProviders& providers,
                                        KernelRegistryManager& kernel_registry_manager,
                                        const InsertCastTransformer& insert_cast_transformer,
-                                       const SessionState& session_state) {
+                                       const SessionState& session_state,
+                                       bool apply_transformers = true) {
     // The transformer order:
-    // 1. built-in graph rewriter
+    // 1. built-in graph rewriter, unless applied by the caller
     // 2. each execution provider's transformer
     // 3. do node placement according to kernel definition
     // 4. insert copy nodes
     // 5. insert cast nodes.
 
     // first apply the default/system/basic graph to graph optimizations.
-    ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyAll(graph));
+    if (apply_transformers) {
+      ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyAll(graph));
+    }
 
     auto kernels{kernel_registry_manager.GetAllKernelRegistries()};
 
@@ -315,6 +353,69 @@ class InferenceSession::Impl {
     std::map<OrtAllocatorInfo, BufferUniquePtr> weights_buffers;
   };
 
+  /// Create the SessionState instances of the subgraphs of a cloned session.
+  /// @param graph The graph to iterate
+  /// @param source_state The SessionState instance for 'graph' in the session being cloned.
+  /// @param session_state The SessionState instance for 'graph' in this session.
+  common::Status CloneSubgraphSessions(const Graph& graph, const SessionState& source_state,
+                                       SessionState& session_state) {
+    for (auto& node : graph.Nodes()) {
+      for (auto& attribute : node.GetAttributes()) {
+        auto& name = attribute.first;
+        if (!attribute.second.has_g()) {
+          continue;
+        }
+
+        const Graph* subgraph = node.GetGraphAttribute(name);
+        const SessionState* source_subgraph_state = source_state.GetSubgraphSessionState(node.Index(), name);
+        ORT_ENFORCE(subgraph && source_subgraph_state, "Source session should have initialized all subgraphs.");
+
+        SubgraphMemory subgraph_info;
+        subgraph_info.session_state = std::make_unique<SessionState>(execution_providers_);
+        subgraph_info.session_state->SetProfiler(session_profiler_);
+        subgraph_info.session_state->SetLogger(*session_logger_);
+        subgraph_info.session_state->SetSourceState(*source_subgraph_state);
+        session_state.AddSubgraphSessionState(node.Index(), name, *subgraph_info.session_state);
+
+        ORT_RETURN_IF_ERROR(CloneSubgraphSessions(*subgraph, *source_subgraph_state, *subgraph_info.session_state));
+
+        subgraph_memory_.push_back(std::move(subgraph_info));
+      }
+    }
+
+    return Status::OK();
+  }
+
+  // Share the model, kernels and weights of an initialized session instead of loading and initializing.
+  common::Status InitializeFrom(const std::shared_ptr<Impl>& source) {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+
+    CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+    ORT_RETURN_IF_ERROR(execution_providers_.Add(onnxruntime::kCpuExecutionProvider,
+                                                 std::make_unique<CPUExecutionProvider>(epi)));
+
+    source_ = source;
+    model_ = source->model_;
+    session_state_.SetSourceState(source->session_state_);
+    session_state_.SetMemoryPatternCacheOptions(session_options_.mem_pattern_cache_options, GetDynamicInputDims());
+    ORT_RETURN_IF_ERROR(CloneSubgraphSessions(model_->MainGraph(), source->session_state_, session_state_));
+
+    model_metadata_ = source->model_metadata_;
+    required_input_def_list_ = source->required_input_def_list_;
+    input_def_list_ = source->input_def_list_;
+    output_def_list_ = source->output_def_list_;
+    required_model_input_names_ = source->required_model_input_names_;
+    model_input_names_ = source->model_input_names_;
+    model_output_names_ = source->model_output_names_;
+    input_value_types_ = source->input_value_types_;
+    output_value_types_ = source->output_value_types_;
+
+    is_model_loaded_ = true;
+    is_inited_ = true;
+    LOGS(*session_logger_, INFO) << "Session successfully cloned.";
+    return Status::OK();
+  }
+
   /// iterate nodes in graph looking for ones with graph attribute/s
   /// @param graph The graph to iterate
   /// @param session_state The SessionState instance for 'graph'.
@@ -339,6 +440,9 @@ class InferenceSession::Impl {
           // setup everything required to execute the subgraph and save it in subgraph_session_state
           SessionStateInitializer initializer{*subgraph, *subgraph_info.session_state,
                                               execution_providers_, kernel_registry_manager_};
+          if (shared_initializer_store_ != nullptr) {
+            initializer.SetSharedInitializerStore(shared_initializer_store_.get(), &shared_initializers_);
+          }
 
           ORT_RETURN_IF_ERROR(initializer.CreatePlan(node.ImplicitInputDefs(),
                                                      session_options_.enable_sequential_execution));
@@ -392,6 +496,52 @@ class InferenceSession::Impl {
                                  std::make_unique<CPUExecutionProvider>(epi));
       }
 
+      if (session_options_.enable_common_subexpression_elimination) {
+        // the transformers registered by the user, such as fusions, see the merged graph
+        ORT_RETURN_IF_ERROR(graph_transformation_mgr_.Register(std::make_unique<CommonSubexpressionElimination>(),
+                                                               GraphTransformerPriority::HighPriority));
+      }
+
+      if (session_options_.enable_rule_based_optimization) {
+        auto rule_transformer = std::make_unique<WorklistRuleBasedTransformer>("RuleBasedOptimization",
+                                                                               "Apply the rewrite rules");
+        ORT_RETURN_IF_ERROR(rule_transformer->Register("Identity", std::make_unique<EliminateIdentity>()));
+        ORT_RETURN_IF_ERROR(graph_transformation_mgr_.Register(std::move(rule_transformer)));
+      }
+
+      if (session_options_.enable_transpose_optimization) {
+        ORT_RETURN_IF_ERROR(graph_transformation_mgr_.Register(std::make_unique<TransposeOptimizer>()));
+      }
+
+      if (session_options_.enable_constant_folding) {
+        // the nodes are evaluated with a provider of their own, allocating the folded values without an arena
+        CPUExecutionProviderInfo epi{false};
+        ORT_RETURN_IF_ERROR(graph_transformation_mgr_.Register(
+            std::make_unique<ConstantFolding>(std::make_unique<CPUExecutionProvider>(epi))));
+      }
+
+      std::unique_ptr<OptimizedModelCache> model_cache;
+      std::string model_cache_key;
+      bool model_from_cache = false;
+      if (!session_options_.optimized_model_cache_dir.empty()) {
+        model_cache = std::make_unique<OptimizedModelCache>(session_options_.optimized_model_cache_dir);
+        if (model_fingerprint_.empty()) {
+          model_fingerprint_ = OptimizedModelCache::GetModelFingerprint(*model_);
+        }
+        model_cache_key = OptimizedModelCache::GetKey(model_fingerprint_, GetOptimizationSettings());
+
+        std::shared_ptr<onnxruntime::Model> cached_model;
+        Status cache_status = model_cache->Load(model_cache_key, cached_model,
+                                                HasLocalSchema() ? &custom_schema_registries_ : nullptr);
+        if (!cache_status.IsOK()) {
+          LOGS(*session_logger_, WARNING) << "Ignoring the cached optimized model: " << cache_status.ErrorMessage();
+        } else if (cached_model != nullptr) {
+          LOGS(*session_logger_, INFO) << "Using the optimized model cached under " << model_cache_key;
+          ORT_RETURN_IF_ERROR(ReplaceModel(cached_model));
+          model_from_cache = true;
+        }
+      }
+
       onnxruntime::Graph& graph = model_->MainGraph();
 
       // Collect the kernel registries from execution provider instances;
@@ -408,12 +558,33 @@ class InferenceSession::Impl {
 
       SessionStateInitializer session_initializer{graph, session_state_, execution_providers_,
                                                   kernel_registry_manager_};
+      if (session_options_.share_initializers) {
+        shared_initializer_store_ = Environment::GetSharedInitializerStore();
+        if (shared_initializer_store_ != nullptr) {
+          session_initializer.SetSharedInitializerStore(shared_initializer_store_.get(), &shared_initializers_);
+        }
+      }
+
+      // the transformers are skipped when the main graph was optimized by a previous session, otherwise their
+      // result is cached for the next ones. Partitioning depends on the providers registered and is not cached.
+      if (!model_from_cache) {
+        ORT_RETURN_IF_ERROR(graph_transformation_mgr_.ApplyAll(graph));
+        if (model_cache != nullptr) {
+          Status cache_status = model_cache->Save(model_cache_key, *model_);
+          if (cache_status.IsOK()) {
+            LOGS(*session_logger_, INFO) << "Optimized model cached under " << model_cache_key;
+          } else {
+            LOGS(*session_logger_, WARNING) << "Optimized model not cached: " << cache_status.ErrorMessage();
+          }
+        }
+      }
 
       // apply any transformations to the main graph and any subgraphs
       ORT_RETURN_IF_ERROR(TransformGraph(graph, graph_transformation_mgr_,
                                          execution_providers_, kernel_registry_manager_,
                                          insert_cast_transformer_,
-                                         session_state_));
+                                         session_state_,
+                                         false));
 
       ORT_RETURN_IF_ERROR(utils::ForAllMutableSubgraphs(graph, [this](Graph& subgraph) {
         return TransformGraph(subgraph, graph_transformation_mgr_,
@@ -426,12 +597,25 @@ class InferenceSession::Impl {
       ORT_RETURN_IF_ERROR(graph.Resolve());
 
       ORT_RETURN_IF_ERROR(session_initializer.CreatePlan({}, session_options_.enable_sequential_execution));
-      ORT_RETURN_IF_ERROR(session_initializer.InitializeAndSave(session_state_.GetEnableMemoryPattern(),
-                                                                weights_buffers_));
+      session_state_.SetMemoryPatternCacheOptions(session_options_.mem_pattern_cache_options, GetDynamicInputDims());
+
+      // the initializers are deserialized and the kernels created on the session thread pool. a pool is created
+      // for the duration of the initialization when the session has none as it only runs sequentially.
+      decltype(thread_pool_) initialization_thread_pool;
+      if (thread_pool_ == nullptr) {
+        initialization_thread_pool = CreateSessionThreadPool();
+        session_state_.SetThreadPool(initialization_thread_pool.get());
+      }
+      Status save_status = session_initializer.InitializeAndSave(session_state_.GetEnableMemoryPattern(),
+                                                                 weights_buffers_);
+      session_state_.SetThreadPool(thread_pool_.get());
+      ORT_RETURN_IF_ERROR(save_status);
 
       // handle any subgraphs
       ORT_RETURN_IF_ERROR(InitializeSubgraphSessions(graph, session_state_));
 
+      SaveValueTypes(graph);
+
       is_inited_ = true;
 
       LOGS(*session_logger_, INFO) << "Session successfully initialized.";
@@ -452,6 +636,33 @@ class InferenceSession::Impl {
     return status;
   }
 
+  static common::Status Clone(const std::shared_ptr<Impl>& source, const SessionOptions& session_options,
+                              std::shared_ptr<Impl>& clone) {
+    {
+      std::lock_guard<onnxruntime::OrtMutex> l(source->session_mutex_);
+      if (!source->is_inited_) {
+        LOGS(*source->session_logger_, ERROR) << "Session was not initialized";
+        return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+      }
+    }
+
+    // the kernels keep using the providers they were created with, the clone can only replace the CPU one.
+    for (const auto& provider : source->execution_providers_) {
+      if (provider->Type() != onnxruntime::kCpuExecutionProvider) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                               "Clone only supports sessions using the CPU execution provider. Found ",
+                               provider->Type());
+      }
+    }
+
+    SessionOptions options = session_options;
+    options.enable_sequential_execution = source->session_options_.enable_sequential_execution;
+    options.enable_cpu_mem_arena = source->session_options_.enable_cpu_mem_arena;
+
+    clone = std::make_shared<Impl>(options, source->logging_manager_);
+    return clone->InitializeFrom(source);
+  }
+
   int GetCurrentNumRuns() const {
     return current_num_runs_.load();
   }
@@ -463,6 +674,129 @@ class InferenceSession::Impl {
     return Run(run_options, feeds, output_names, p_fetches);
   }
 
+  // Save the types besides the registered ones that the kernels take for the graph inputs, and produce
+  // for the graph outputs only the caller reads. See KernelDefBuilder::InputValueType and OutputValueType.
+  void SaveValueTypes(const onnxruntime::Graph& graph) {
+    std::unordered_set<std::string> consumed;
+    std::vector<std::pair<std::string, const std::vector<MLDataType>*>> graph_outputs;
+    for (auto& node : graph.Nodes()) {
+      const auto& kernel_def = session_state_.GetKernel(node.Index())->KernelDef();
+      const auto& input_defs = node.InputDefs();
+      for (size_t i = 0; i < input_defs.size(); ++i) {
+        if (!input_defs[i]->Exists()) continue;
+        const auto& types = kernel_def.InputValueTypes(i);
+        const auto& name = input_defs[i]->Name();
+        if (consumed.insert(name).second) {
+          input_value_types_[name] = types;
+        } else {
+          // a type is only taken if all the consumers take it
+          auto& taken = input_value_types_[name];
+          taken.erase(std::remove_if(taken.begin(), taken.end(),
+                                     [&types](MLDataType type) {
+                                       return std::find(types.begin(), types.end(), type) == types.end();
+                                     }),
+                      taken.end());
+        }
+      }
+
+      // the subgraphs take the registered types
+      for (auto input_def : node.ImplicitInputDefs()) {
+        consumed.insert(input_def->Name());
+        input_value_types_[input_def->Name()].clear();
+      }
+
+      const auto& output_defs = node.OutputDefs();
+      for (size_t i = 0; i < output_defs.size(); ++i) {
+        if (output_defs[i]->Exists() && model_output_names_.count(output_defs[i]->Name())) {
+          graph_outputs.emplace_back(output_defs[i]->Name(), &kernel_def.OutputValueTypes(i));
+        }
+      }
+    }
+
+    for (auto it = input_value_types_.begin(); it != input_value_types_.end();) {
+      if (it->second.empty() || !model_input_names_.count(it->first) || model_output_names_.count(it->first)) {
+        it = input_value_types_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    for (const auto& output : graph_outputs) {
+      if (!output.second->empty() && !consumed.count(output.first)) {
+        output_value_types_[output.first] = *output.second;
+      }
+    }
+  }
+
+  static bool TakesValueType(const std::unordered_map<std::string, std::vector<MLDataType>>& value_types,
+                             const std::string& name, MLDataType type) {
+    auto it = value_types.find(name);
+    return it != value_types.end() && std::find(it->second.begin(), it->second.end(), type) != it->second.end();
+  }
+
+  AllocatorPtr GetCpuAllocator() const {
+    return execution_providers_.Get(onnxruntime::kCpuExecutionProvider)->GetAllocator(0, OrtMemTypeDefault);
+  }
+
+  // Convert the packed string feeds that the kernels do not take to tensors of std::string.
+  // p_feeds points to the converted feeds if any, to feeds otherwise.
+  Status ConvertPackedStringFeeds(const NameMLValMap& feeds, NameMLValMap& converted_feeds,
+                                  const NameMLValMap*& p_feeds) const {
+    const auto packed_type = DataTypeImpl::GetType<PackedStringTensor>();
+    for (const auto& feed : feeds) {
+      if (feed.second.Type() != packed_type || TakesValueType(input_value_types_, feed.first, packed_type)) {
+        continue;
+      }
+
+      if (p_feeds == &feeds) {
+        converted_feeds = feeds;
+        p_feeds = &converted_feeds;
+      }
+
+      const auto& packed = feed.second.Get<PackedStringTensor>();
+      auto allocator = GetCpuAllocator();
+      size_t size = 0;
+      if (!IAllocator::CalcMemSizeForArray(packed.Size(), sizeof(std::string), &size)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "size overflow converting input ", feed.first);
+      }
+      auto tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<std::string>(), packed.Shape(),
+                                             allocator->Alloc(size), allocator->Info(), allocator);
+      packed.CopyTo(*tensor);
+      converted_feeds[feed.first].Init(tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                                       DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    }
+    return Status::OK();
+  }
+
+  // Take the packed string fetches that the kernels do not produce out of fetches so that tensors of
+  // std::string are created instead.
+  void TakePackedStringFetches(const std::vector<std::string>& output_names, std::vector<MLValue>& fetches,
+                               std::vector<std::pair<size_t, MLValue>>& packed_string_fetches) const {
+    const auto packed_type = DataTypeImpl::GetType<PackedStringTensor>();
+    for (size_t i = 0; i < fetches.size(); ++i) {
+      if (fetches[i].Type() == packed_type && !TakesValueType(output_value_types_, output_names[i], packed_type)) {
+        packed_string_fetches.emplace_back(i, fetches[i]);
+        fetches[i] = MLValue();
+      }
+    }
+  }
+
+  // Pack the tensors of std::string produced for the fetches taken by TakePackedStringFetches into them.
+  Status FillPackedStringFetches(const std::vector<std::string>& output_names,
+                                 std::vector<std::pair<size_t, MLValue>>& packed_string_fetches,
+                                 std::vector<MLValue>& fetches) const {
+    for (auto& packed_fetch : packed_string_fetches) {
+      auto& fetch = fetches[packed_fetch.first];
+      if (!fetch.IsTensor() || fetch.Get<Tensor>().DataType() != DataTypeImpl::GetType<std::string>()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output ", output_names[packed_fetch.first],
+                               " is not a string tensor, it cannot be fetched as a packed string tensor");
+      }
+      packed_fetch.second.GetMutable<PackedStringTensor>()->Assign(fetch.Get<Tensor>(), GetCpuAllocator());
+      fetch = packed_fetch.second;
+    }
+    return Status::OK();
+  }
+
   static common::Status CheckTypes(MLDataType actual, MLDataType expected) {
     if (actual == expected) {
       return Status::OK();
@@ -484,6 +818,10 @@ class InferenceSession::Impl {
       auto input_type = input_ml_value.Type();
       auto expected_type = utils::GetMLDataType(*arg);
 
+      if (TakesValueType(input_value_types_, arg_name, input_type)) {
+        continue;
+      }
+
       if (!input_ml_value.IsTensor()) {
         auto retval = CheckTypes(input_type, expected_type);
         if (!retval.IsOK()) {
@@ -613,11 +951,22 @@ class InferenceSession::Impl {
         }
       }
 
-      ORT_CHECK_AND_SET_RETVAL(ValidateInputs(feeds));
+      // the string tensors packed in one buffer are converted for the kernels that do not take them
+      NameMLValMap converted_feeds;
+      const NameMLValMap* p_feeds = &feeds;
+      ORT_CHECK_AND_SET_RETVAL(ConvertPackedStringFeeds(feeds, converted_feeds, p_feeds));
+
+      ORT_CHECK_AND_SET_RETVAL(ValidateInputs(*p_feeds));
 
       // if the output vector is non-empty, ensure that its the same size as the output_names
       ORT_CHECK_AND_SET_RETVAL(ValidateOutputs(output_names, p_fetches));
 
+      // packed string fetches the kernels do not produce, filled once the graph is executed
+      std::vector<std::pair<size_t, MLValue>> packed_string_fetches;
+      if (retval.IsOK()) {
+        TakePackedStringFetches(output_names, *p_fetches, packed_string_fetches);
+      }
+
       if (!run_options.run_tag.empty()) {
         LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
       }
@@ -638,8 +987,10 @@ class InferenceSession::Impl {
       }
 
       ORT_CHECK_AND_SET_RETVAL(
-          utils::ExecuteGraph(session_state_, feeds, output_names, *p_fetches,
+          utils::ExecuteGraph(session_state_, *p_feeds, output_names, *p_fetches,
                               session_options_.enable_sequential_execution, run_options.terminate, run_logger));
+
+      ORT_CHECK_AND_SET_RETVAL(FillPackedStringFetches(output_names, packed_string_fetches, *p_fetches));
     } catch (const std::exception& e) {
       retval = Status(common::ONNXRUNTIME, common::FAIL, e.what());
     } catch (...) {
@@ -657,6 +1008,118 @@ class InferenceSession::Impl {
     return retval;
   }
 
+  Status RunAsync(const RunOptions* run_options,
+                  const NameMLValMap& feeds,
+                  const std::vector<std::string>& output_names,
+                  InferenceSession::RunAsyncCallback callback) {
+    if (!callback) {
+      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "RunAsync requires a callback.");
+    }
+
+    {
+      std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+      if (!is_inited_) {
+        LOGS(*session_logger_, ERROR) << "Session was not initialized";
+        return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+      }
+
+      if (async_run_pool_ == nullptr) {
+        int pool_size = session_options_.async_run_thread_pool_size == 0
+                            ? std::max(1, static_cast<int>(std::thread::hardware_concurrency() / 2))
+                            : session_options_.async_run_thread_pool_size;
+        async_run_pool_ = std::make_unique<TaskThreadPool>(pool_size);
+      }
+    }
+
+    // the queued run owns copies of the feeds, which share the input buffers
+    std::shared_ptr<RunOptions> default_run_options;
+    if (run_options == nullptr) {
+      default_run_options = std::make_shared<RunOptions>();
+      run_options = default_run_options.get();
+    }
+
+    std::packaged_task<void()> task{
+        [this, run_options, default_run_options, feeds, output_names, callback]() {
+          std::vector<MLValue> fetches;
+          Status status = Run(*run_options, feeds, output_names, &fetches);
+          try {
+            callback(status, fetches);
+          } catch (const std::exception& e) {
+            LOGS(*session_logger_, ERROR) << "Exception in RunAsync callback: " << e.what();
+          } catch (...) {
+            LOGS(*session_logger_, ERROR) << "Unknown exception in RunAsync callback";
+          }
+        }};
+
+    async_run_pool_->RunTask(std::move(task));
+    return Status::OK();
+  }
+
+  // Which dimensions of each required input have no fixed value in the model.
+  std::unordered_map<std::string, std::vector<bool>> GetDynamicInputDims() const {
+    std::unordered_map<std::string, std::vector<bool>> dynamic_dims;
+    for (const auto* input : required_input_def_list_) {
+      const auto* shape = input->Shape();
+      if (shape == nullptr) continue;
+      std::vector<bool> dynamic(shape->dim_size());
+      for (int i = 0; i < shape->dim_size(); ++i) {
+        dynamic[i] = !shape->dim(i).has_dim_value();
+      }
+      dynamic_dims[input->Name()] = std::move(dynamic);
+    }
+    return dynamic_dims;
+  }
+
+  common::Status WarmUp(const std::vector<std::unordered_map<std::string, std::vector<int64_t>>>& input_shapes) {
+    {
+      std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+      if (!is_inited_) {
+        LOGS(*session_logger_, ERROR) << "Session was not initialized";
+        return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+      }
+    }
+
+    auto allocator = execution_providers_.Get(onnxruntime::kCpuExecutionProvider)->GetAllocator(0, OrtMemTypeDefault);
+    std::vector<std::string> output_names;
+    for (const auto* output : output_def_list_) {
+      output_names.push_back(output->Name());
+    }
+
+    for (const auto& shapes : input_shapes) {
+      NameMLValMap feeds;
+      for (const auto* input : required_input_def_list_) {
+        auto shape = shapes.find(input->Name());
+        if (shape == shapes.end()) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "WarmUp: missing shape for input ", input->Name());
+        }
+        auto type = utils::GetMLDataType(*input);
+        if (!type->IsTensorType()) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "WarmUp: input ", input->Name(), " is not a tensor");
+        }
+        auto element_type = type->AsTensorType()->GetElementType();
+        TensorShape bucket_shape = session_state_.GetMemoryPatternBucketShape(input->Name(), TensorShape(shape->second));
+        if (bucket_shape.Size() < 0) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "WarmUp: invalid shape for input ", input->Name());
+        }
+
+        size_t size = bucket_shape.Size() * element_type->Size();
+        void* buffer = size > 0 ? allocator->Alloc(size) : nullptr;
+        // string tensors owning their buffer construct empty strings themselves
+        if (buffer != nullptr && element_type != DataTypeImpl::GetType<std::string>()) {
+          memset(buffer, 0, size);
+        }
+        auto tensor = std::make_unique<Tensor>(element_type, bucket_shape, buffer, allocator->Info(), allocator);
+        feeds.emplace(input->Name(), MLValue{tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                                             DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()});
+      }
+
+      std::vector<MLValue> fetches;
+      ORT_RETURN_IF_ERROR(Run(feeds, output_names, &fetches));
+    }
+
+    return Status::OK();
+  }
+
   std::pair<common::Status, const ModelMetadata*> GetModelMetadata() const {
     {
       std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
@@ -751,6 +1214,52 @@ class InferenceSession::Impl {
     return status;
   }
 
+#ifdef USE_EIGEN_THREADPOOL
+  std::unique_ptr<Eigen::NonBlockingThreadPool> CreateSessionThreadPool() const {
+#else
+  std::unique_ptr<TaskThreadPool> CreateSessionThreadPool() const {
+#endif
+    int pool_size = session_options_.session_thread_pool_size == 0
+                        ? std::thread::hardware_concurrency() / 2
+                        : session_options_.session_thread_pool_size;
+    // at least one thread runs the tasks
+    pool_size = std::max(pool_size, 1);
+
+#ifdef USE_EIGEN_THREADPOOL
+    return std::make_unique<Eigen::NonBlockingThreadPool>(pool_size);
+#else
+    return std::make_unique<TaskThreadPool>(pool_size);
+#endif
+  }
+
+  // Describes the transformers applied to the main graph, which the optimized model depends on.
+  std::string GetOptimizationSettings() const {
+    std::ostringstream settings;
+    settings << "steps=" << session_options_.max_num_graph_transformation_steps << ";transformers=";
+    for (const auto& name : graph_transformation_mgr_.GetTransformerNames()) {
+      settings << name << ",";
+    }
+    return settings.str();
+  }
+
+  // Replaces the loaded model by its optimized version, keeping the metadata of the loaded model.
+  common::Status ReplaceModel(std::shared_ptr<onnxruntime::Model> optimized_model) {
+    ModelMetadata model_metadata = model_metadata_;
+
+    // the input and output definitions saved belong to the graph replaced
+    required_input_def_list_.clear();
+    input_def_list_.clear();
+    output_def_list_.clear();
+    required_model_input_names_.clear();
+    model_input_names_.clear();
+    model_output_names_.clear();
+
+    model_ = std::move(optimized_model);
+    ORT_RETURN_IF_ERROR(SaveModelMetadata(*model_));
+    model_metadata_ = std::move(model_metadata);
+    return Status::OK();
+  }
+
   common::Status SaveModelMetadata(const onnxruntime::Model& model) {
     VLOGS(*session_logger_, 1) << "Saving model metadata";
     const onnxruntime::Graph& graph = model.MainGraph();
@@ -865,6 +1374,10 @@ class InferenceSession::Impl {
     return Status::OK();
   }
 
+  // Session this one was cloned from, which owns the kernels and weights shared with it.
+  // Declared first so that it is destroyed last.
+  std::shared_ptr<Impl> source_;
+
   CustomOpsLoader custom_ops_loader_;
 
   const SessionOptions session_options_;
@@ -895,6 +1408,10 @@ class InferenceSession::Impl {
   // if they need.
   std::shared_ptr<onnxruntime::Model> model_;
 
+  // Fingerprint of the loaded model keying the optimized model cache, taken from the file or the buffer the
+  // model was loaded from. Empty if the cache is disabled or the model was loaded from a ModelProto or a stream.
+  std::string model_fingerprint_;
+
   // A set of executors that can run in parallel.
   std::vector<std::unique_ptr<IExecutor>> executors_;  // TODO do we need this vector?
 
@@ -911,13 +1428,17 @@ class InferenceSession::Impl {
   std::unordered_set<std::string> model_input_names_;
   std::unordered_set<std::string> model_output_names_;
 
+  // Types besides the registered ones the caller may feed graph inputs and fetch graph outputs as,
+  // see SaveValueTypes
+  std::unordered_map<std::string, std::vector<MLDataType>> input_value_types_;
+  std::unordered_map<std::string, std::vector<MLDataType>> output_value_types_;
+
   // Environment for this session
   // not used now; we'll need it when we introduce threadpool
   // statically allocated pointer, no need to manage its lifetime.
   //Env* env_;
 
   // Threadpool for this session
-  //thread::ThreadPool thread_pool_; // not used for now; will add it later when implementing RunAsync
 #ifdef USE_EIGEN_THREADPOOL
   std::unique_ptr<Eigen::NonBlockingThreadPool> thread_pool_;
 #else
@@ -933,10 +1454,17 @@ class InferenceSession::Impl {
   bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
 
   std::map<OrtAllocatorInfo, BufferUniquePtr> weights_buffers_;
+
+  // Initialized tensors deduplicated with other sessions if SessionOptions::share_initializers is set.
+  std::shared_ptr<SharedInitializerStore> shared_initializer_store_;
+  std::vector<std::shared_ptr<const Tensor>> shared_initializers_;
   InsertCastTransformer insert_cast_transformer_;
 
   // memory allocations for any subgraphs
   std::vector<SubgraphMemory> subgraph_memory_;
+
+  // Executes the runs queued by RunAsync. Created on first use.
+  std::unique_ptr<TaskThreadPool> async_run_pool_;  // GUARDED_BY(session_mutex_) for creation
 };  // namespace onnxruntime
 
 //
@@ -944,7 +1472,11 @@ class InferenceSession::Impl {
 //
 InferenceSession::InferenceSession(const SessionOptions& session_options,
                                    logging::LoggingManager* logging_manager)
-    : impl_(std::make_unique<Impl>(session_options, logging_manager)) {
+    : impl_(std::make_shared<Impl>(session_options, logging_manager)) {
+}
+
+InferenceSession::InferenceSession(std::shared_ptr<Impl> impl)
+    : impl_(std::move(impl)) {
 }
 
 InferenceSession::~InferenceSession() = default;
@@ -961,6 +1493,10 @@ common::Status InferenceSession::Load(std::istream& model_istream) {
   return impl_->Load(model_istream);
 }
 
+common::Status InferenceSession::Load(const void* model_data, int model_data_len) {
+  return impl_->Load(model_data, model_data_len);
+}
+
 common::Status InferenceSession::Initialize() {
   return impl_->Initialize();
 }
@@ -1026,10 +1562,41 @@ common::Status InferenceSession::Load(std::unique_ptr<ModelProto> p_model_proto)
   return impl_->Load(std::move(p_model_proto));
 }
 
+common::Status InferenceSession::WarmUp(
+    const std::vector<std::unordered_map<std::string, std::vector<int64_t>>>& input_shapes) {
+  return impl_->WarmUp(input_shapes);
+}
+
+common::Status InferenceSession::Clone(const SessionOptions& session_options,
+                                       std::unique_ptr<InferenceSession>* clone) const {
+  if (clone == nullptr) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "clone is NULL");
+  }
+
+  std::shared_ptr<Impl> clone_impl;
+  ORT_RETURN_IF_ERROR(Impl::Clone(impl_, session_options, clone_impl));
+  // private constructor, can't use make_unique
+  *clone = std::unique_ptr<InferenceSession>(new InferenceSession(std::move(clone_impl)));
+  return Status::OK();
+}
+
 common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_binding) {
   return impl_->NewIOBinding(io_binding);
 }
 
+common::Status InferenceSession::RunAsync(const RunOptions& run_options,
+                                          const NameMLValMap& feeds,
+                                          const std::vector<std::string>& output_names,
+                                          RunAsyncCallback callback) {
+  return impl_->RunAsync(&run_options, feeds, output_names, std::move(callback));
+}
+
+common::Status InferenceSession::RunAsync(const NameMLValMap& feeds,
+                                          const std::vector<std::string>& output_names,
+                                          RunAsyncCallback callback) {
+  return impl_->RunAsync(nullptr, feeds, output_names, std::move(callback));
+}
+
 common::Status InferenceSession::Run(const RunOptions& run_options, IOBinding& io_binding) {
   return impl_->Run(run_options, io_binding);
 }
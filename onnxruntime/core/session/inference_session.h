@@ -3,12 +3,15 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
 #include "core/common/common.h"
 #include "core/common/status.h"
 #include "core/framework/framework_common.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/graph/basic_types.h"
 #include "core/common/logging/logging.h"
 
@@ -46,6 +49,15 @@ struct SessionOptions {
   // with a big chunk for all the internal memory allocation.
   bool enable_mem_pattern = true;
 
+  // Bucketing of dynamic input dimensions and bounds of the memory pattern cache.
+  // By default a pattern is kept for each of the 64 most recently used sets of input shapes.
+  MemoryPatternCacheOptions mem_pattern_cache_options;
+
+  // Deduplicate the initialized tensors (weights) on CPU with those of the other sessions setting this option,
+  // through the store held by the Environment. Identical weights are then only held once in the process.
+  // The weights are allocated individually instead of in a single buffer.
+  bool share_initializers = false;
+
   // enable the memory arena on CPU
   // Arena may pre-allocate memory for future usage.
   // set this option to false if you don't want it.
@@ -59,8 +71,31 @@ struct SessionOptions {
 
   unsigned max_num_graph_transformation_steps = 5;  // TODO choose a good default here?
 
+  // Evaluate the nodes whose inputs are all constant once, when initializing the session, and replace them
+  // by initializers. Static shape computations are folded too.
+  bool enable_constant_folding = true;
+
+  // Push the Transpose nodes down through the ops not depending on the layout, removing the ones which meet
+  // their inverse. Runs before constant folding, which folds the Transposes moved onto constants.
+  bool enable_transpose_optimization = true;
+
+  // Merge the nodes computing the same values from the same inputs. Runs before the other transformers.
+  bool enable_common_subexpression_elimination = true;
+
+  // Apply the rewrite rules of onnxruntime (e.g. removing Identity nodes), revisiting only the nodes around
+  // each rewrite.
+  bool enable_rule_based_optimization = true;
+
+  // Directory caching the models optimized by the graph transformers. A session finding the optimized version
+  // of its model in it skips the transformers, otherwise it adds it. Empty disables the cache.
+  std::string optimized_model_cache_dir;
+
   // How many threads in the session thread pool.
   int session_thread_pool_size = 0;
+
+  // How many threads execute the runs queued by RunAsync, which is also the number of
+  // asynchronous runs executing concurrently. 0 lets onnxruntime choose.
+  int async_run_thread_pool_size = 0;
 };
 
 /**
@@ -164,6 +199,14 @@ class InferenceSession {
     */
   common::Status Load(std::istream& model_istream);
 
+  /**
+    * Load an ONNX model from a buffer owned by the caller, which only has to be valid during the call.
+    * @param model_data buffer holding the serialized model.
+    * @param model_data_len size of the buffer in bytes.
+    * @return OK if success.
+    */
+  common::Status Load(const void* model_data, int model_data_len);
+
   /**
     * Initializes a previously loaded model. Initialization includes but is not
     * limited to graph transformations, construction of kernels, etc.
@@ -196,6 +239,57 @@ class InferenceSession {
                      const std::vector<std::string>& output_names,
                      std::vector<MLValue>* p_fetches);
 
+  /**
+    * Called once an asynchronous run completed.
+    * @param status status of the run.
+    * @param fetches output values in the order specified by output_names if the run succeeded.
+    */
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<MLValue>& fetches)>;
+
+  /**
+    * Queue a run of a pre-loaded and pre-initialized model on a thread pool owned by the session
+    * and return without waiting for it. Multiple threads are allowed to call this function.
+    * See Run(const RunOptions& run_options, const NameMLValMap& feeds, ...) for the other parameters.
+    * @param run_options must stay valid until callback is called. Use it to terminate the run.
+    * @param callback called on a thread of the pool once the run completed.
+    *        The session waits for the queued runs when destroyed, so it must not be destroyed by a callback.
+    * @return OK if the run was queued.
+    */
+  common::Status RunAsync(const RunOptions& run_options,
+                          const NameMLValMap& feeds,
+                          const std::vector<std::string>& output_names,
+                          RunAsyncCallback callback);
+
+  /**
+    * Same as RunAsync(const RunOptions& run_options, ...) with default run options.
+    */
+  common::Status RunAsync(const NameMLValMap& feeds,
+                          const std::vector<std::string>& output_names,
+                          RunAsyncCallback callback);
+
+  /**
+    * Run the model once per set of input shapes on zero-filled inputs, so that the memory patterns of
+    * these shapes are traced before the first real run. The dynamic dimensions are rounded up to their
+    * bucket (see SessionOptions::mem_pattern_cache_options), so one shape set per bucket is enough.
+    * @param input_shapes one map from the name of every required input to its shape per run.
+    * @return OK if success.
+    */
+  common::Status WarmUp(const std::vector<std::unordered_map<std::string, std::vector<int64_t>>>& input_shapes);
+
+  /**
+    * Create a session serving the model of this initialized session, e.g. one per NUMA node or tenant.
+    * The new session shares the graph, kernels and initialized tensors (weights) of this one, and only has
+    * its own CPU execution provider (so its own arena for the memory used during execution), thread pools,
+    * logger and profiler. Nothing is loaded or initialized again, which makes it cheap to create.
+    * Only sessions whose nodes all run on the CPU execution provider can be cloned.
+    * @param session_options options of the new session. enable_sequential_execution and enable_cpu_mem_arena
+    *        are taken from this session as the shared execution plan depends on them.
+    * @param clone the new session, ready to Run. It keeps the shared state alive so this session may be
+    *        destroyed first.
+    * @return OK if success.
+    */
+  common::Status Clone(const SessionOptions& session_options, std::unique_ptr<InferenceSession>* clone) const;
+
   /**
   * Creates a new binding object for binding inputs and outputs.
   * @param provider_type specifies the location where the inputs need to be potentially copied. 
@@ -271,6 +365,10 @@ class InferenceSession {
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(InferenceSession);
 
   class Impl;
-  std::unique_ptr<Impl> impl_;
+
+  explicit InferenceSession(std::shared_ptr<Impl> impl);
+
+  // shared with the sessions cloned from this one
+  std::shared_ptr<Impl> impl_;
 };
 }  // namespace onnxruntime
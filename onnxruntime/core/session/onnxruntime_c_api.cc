@@ -8,6 +8,7 @@
 #include "core/framework/execution_provider.h"
 #include <cassert>
 #include <cstring>
+#include <limits>
 #include <sstream>
 
 #include "core/common/logging/logging.h"
@@ -20,6 +21,7 @@
 #include "core/framework/environment.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
+#include "core/framework/packed_string_tensor.h"
 #include "core/session/inference_session.h"
 
 #include "abi_session_options_impl.h"
@@ -34,6 +36,7 @@ using onnxruntime::MLFloat16;
 using onnxruntime::MLStatus;
 using onnxruntime::MLValue;
 using onnxruntime::OutputDefList;
+using onnxruntime::PackedStringTensor;
 using onnxruntime::Tensor;
 using onnxruntime::ToOrtStatus;
 using onnxruntime::common::Status;
@@ -131,7 +134,13 @@ ORT_API_STATUS_IMPL(OrtInitialize, OrtLoggingLevel default_warning_level,
 }
 
 ORT_API_STATUS_IMPL(OrtGetStringTensorDataLength, _In_ const OrtValue* value, _Out_ size_t* out) {
-  TENSOR_READ_API_BEGIN
+  API_IMPL_BEGIN
+  auto v = reinterpret_cast<const ::onnxruntime::MLValue*>(value);
+  if (v->Type() == DataTypeImpl::GetType<PackedStringTensor>()) {
+    *out = v->Get<PackedStringTensor>().TotalLength();
+    return nullptr;
+  }
+  auto& tensor = v->Get<onnxruntime::Tensor>();
   const auto* src = tensor.Data<std::string>();
   int64_t len = tensor.Shape().Size();
   if (len >= 0) {
@@ -352,8 +361,9 @@ ORT_API_STATUS_IMPL(OrtCreateTensorAsOrtValue, _Inout_ OrtAllocator* allocator,
   API_IMPL_END
 }
 
-template <typename T>
-static OrtStatus* CreateSessionImpl(_In_ OrtEnv* env, _In_ T model_path,
+// load_model loads the model into the session created
+template <typename TLoad>
+static OrtStatus* CreateSessionImpl(_In_ OrtEnv* env, TLoad load_model,
                                     _In_ const OrtSessionOptions* options,
                                     _Out_ OrtSession** out) {
   API_IMPL_BEGIN
@@ -370,7 +380,7 @@ static OrtStatus* CreateSessionImpl(_In_ OrtEnv* env, _In_ T model_path,
       if (provider)
         sess->RegisterExecutionProvider(std::move(provider));
     }
-  status = sess->Load(model_path);
+  status = load_model(*sess);
   if (!status.IsOK())
     return ToOrtStatus(status);
   status = sess->Initialize();
@@ -385,29 +395,56 @@ static OrtStatus* CreateSessionImpl(_In_ OrtEnv* env, _In_ T model_path,
 ORT_API_STATUS_IMPL(OrtCreateSession, _In_ OrtEnv* env, _In_ const wchar_t* model_path,
                     _In_ const OrtSessionOptions* options, _Out_ OrtSession** out) {
   API_IMPL_BEGIN
-  return CreateSessionImpl(env, model_path, options, out);
+  return CreateSessionImpl(
+      env, [model_path](::onnxruntime::InferenceSession& sess) { return sess.Load(model_path); }, options, out);
   API_IMPL_END
 }
 #else
 ORT_API_STATUS_IMPL(OrtCreateSession, _In_ OrtEnv* env, _In_ const char* model_path,
                     _In_ const OrtSessionOptions* options, _Out_ OrtSession** out) {
   API_IMPL_BEGIN
-  return CreateSessionImpl(env, model_path, options, out);
+  return CreateSessionImpl(
+      env, [model_path](::onnxruntime::InferenceSession& sess) { return sess.Load(model_path); }, options, out);
   API_IMPL_END
 }
 #endif
 
-ORT_API_STATUS_IMPL(OrtRun, _In_ OrtSession* sess,
-                    _In_ OrtRunOptions* run_options,
-                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
-                    _In_ const char* const* output_names1, size_t output_names_len, _Out_ OrtValue** output) {
+ORT_API_STATUS_IMPL(OrtCreateSessionFromArray, _In_ OrtEnv* env, _In_ const void* model_data, size_t model_data_len,
+                    _In_ const OrtSessionOptions* options, _Out_ OrtSession** out) {
   API_IMPL_BEGIN
-  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
-  ::onnxruntime::NameMLValMap in;
+  if (model_data_len > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "model_data_len exceeds the 2GB limit of protobuf");
+  }
+  return CreateSessionImpl(
+      env,
+      [model_data, model_data_len](::onnxruntime::InferenceSession& sess) {
+        return sess.Load(model_data, static_cast<int>(model_data_len));
+      },
+      options, out);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtCloneSession, _In_ const OrtSession* sess, _In_opt_ const OrtSessionOptions* options,
+                    _Out_ OrtSession** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::unique_ptr<::onnxruntime::InferenceSession> clone;
+  Status status = session->Clone(options == nullptr ? onnxruntime::SessionOptions() : options->value, &clone);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *out = reinterpret_cast<OrtSession*>(clone.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+static OrtStatus* CreateFeedsAndOutputNames(_In_ const char* const* input_names, _In_ const OrtValue* const* input,
+                                            size_t input_len, _In_ const char* const* output_names1,
+                                            size_t output_names_len, ::onnxruntime::NameMLValMap& feeds,
+                                            std::vector<std::string>& output_names) {
   const int queue_id = 0;
   for (size_t i = 0; i != input_len; ++i) {
-    auto kvp = in.insert(std::make_pair(std::string(input_names[i]),
-                                        *reinterpret_cast<const ::onnxruntime::MLValue*>(input[i])));
+    auto kvp = feeds.insert(std::make_pair(std::string(input_names[i]),
+                                           *reinterpret_cast<const ::onnxruntime::MLValue*>(input[i])));
     if (!kvp.second) {
       return OrtCreateStatus(ORT_INVALID_ARGUMENT, "duplicated input name");
     }
@@ -416,13 +453,28 @@ ORT_API_STATUS_IMPL(OrtRun, _In_ OrtSession* sess,
       value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
   }
   // Create output feed
-  std::vector<std::string> output_names(output_names_len);
+  output_names.resize(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
     if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
       return OrtCreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
     }
     output_names[i] = output_names1[i];
   }
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtRun, _In_ OrtSession* sess,
+                    _In_ OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Out_ OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  ::onnxruntime::NameMLValMap in;
+  std::vector<std::string> output_names;
+  const int queue_id = 0;
+  OrtStatus* st = CreateFeedsAndOutputNames(input_names, input, input_len, output_names1, output_names_len,
+                                            in, output_names);
+  if (st != nullptr) return st;
 
   std::vector<MLValue> fetches(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
@@ -455,6 +507,48 @@ ORT_API_STATUS_IMPL(OrtRun, _In_ OrtSession* sess,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtRunAsync, _Inout_ OrtSession* sess,
+                    _In_opt_ OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len,
+                    _In_ OrtRunAsyncCallback callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  if (callback == nullptr) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "callback cannot be NULL");
+  }
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  ::onnxruntime::NameMLValMap in;
+  std::vector<std::string> output_names;
+  OrtStatus* st = CreateFeedsAndOutputNames(input_names, input, input_len, output_names1, output_names_len,
+                                            in, output_names);
+  if (st != nullptr) return st;
+
+  auto on_completed = [callback, user_data](const Status& status, std::vector<MLValue>& fetches) {
+    if (!status.IsOK()) {
+      callback(user_data, nullptr, 0, ToOrtStatus(status));
+      return;
+    }
+    const int queue_id = 0;
+    std::vector<OrtValue*> output(fetches.size());
+    for (size_t i = 0; i != fetches.size(); ++i) {
+      ::onnxruntime::MLValue& value = fetches[i];
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+      output[i] = reinterpret_cast<OrtValue*>(new MLValue(value));
+    }
+    callback(user_data, output.data(), output.size(), nullptr);
+  };
+
+  Status status;
+  if (run_options == nullptr) {
+    status = session->RunAsync(in, output_names, on_completed);
+  } else {
+    status = session->RunAsync(*run_options, in, output_names, on_completed);
+  }
+  return status.IsOK() ? nullptr : ToOrtStatus(status);
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtGetTensorMutableData, _In_ OrtValue* value, _Out_ void** output) {
   TENSOR_READWRITE_API_BEGIN
   //TODO: test if it's a string tensor
@@ -465,7 +559,22 @@ ORT_API_STATUS_IMPL(OrtGetTensorMutableData, _In_ OrtValue* value, _Out_ void**
 
 ORT_API_STATUS_IMPL(OrtGetStringTensorContent, _In_ const OrtValue* value,
                     _Out_ void* s, size_t s_len, _Out_ size_t* offsets, size_t offsets_len) {
-  TENSOR_READ_API_BEGIN
+  API_IMPL_BEGIN
+  auto v = reinterpret_cast<const ::onnxruntime::MLValue*>(value);
+  if (v->Type() == DataTypeImpl::GetType<PackedStringTensor>()) {
+    const auto& strings = v->Get<PackedStringTensor>();
+    if (offsets_len < strings.Size() || s_len < strings.TotalLength()) {
+      return OrtCreateStatus(ORT_FAIL, "space is not enough");
+    }
+    if (strings.TotalLength() > 0) {
+      memcpy(s, strings.Bytes(), strings.TotalLength());
+    }
+    if (strings.Size() > 0) {
+      memcpy(offsets, strings.Offsets(), strings.Size() * sizeof(size_t));
+    }
+    return nullptr;
+  }
+  auto& tensor = v->Get<onnxruntime::Tensor>();
   const auto* input = tensor.Data<std::string>();
   auto len = static_cast<size_t>(tensor.Shape().Size());
   if (offsets_len < len) {
@@ -482,9 +591,8 @@ ORT_API_STATUS_IMPL(OrtGetStringTensorContent, _In_ const OrtValue* value,
   }
   size_t f = 0;
   char* p = static_cast<char*>(s);
-  for (size_t i = 0; i != offsets_len; ++i, ++offsets) {
-    memcpy(p, input[i].data(), input[i].size());
-    p += input[i].size();
+  for (size_t i = 0; i != len; ++i, ++offsets) {
+    memcpy(p + f, input[i].data(), input[i].size());
     *offsets = f;
     f += input[i].size();
   }
@@ -492,6 +600,87 @@ ORT_API_STATUS_IMPL(OrtGetStringTensorContent, _In_ const OrtValue* value,
   API_IMPL_END
 }
 
+static OrtStatus* GetPackedStringTensorShape(const size_t* shape, size_t shape_len, size_t strings_len,
+                                             std::vector<int64_t>& shapes) {
+  size_t elem_count = 1;
+  shapes.resize(shape_len);
+  for (size_t i = 0; i != shape_len; ++i) {
+    elem_count *= shape[i];
+    shapes[i] = shape[i];
+  }
+  if (elem_count != strings_len) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "the number of strings doesn't match the shape");
+  }
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtCreatePackedStringTensorAsOrtValue, _Inout_ OrtAllocator* allocator,
+                    _In_ const size_t* shape, size_t shape_len, _In_ const char* const* s, size_t s_len,
+                    _Out_ OrtValue** out) {
+  API_IMPL_BEGIN
+  std::vector<int64_t> shapes;
+  ORT_API_RETURN_IF_ERROR(GetPackedStringTensorShape(shape, shape_len, s_len, shapes));
+  std::vector<size_t> lengths(s_len);
+  size_t total_length = 0;
+  for (size_t i = 0; i != s_len; ++i) {
+    lengths[i] = strlen(s[i]);
+    total_length += lengths[i];
+  }
+  auto strings = std::make_unique<PackedStringTensor>();
+  strings->Reset(onnxruntime::TensorShape(shapes), total_length,
+                 std::make_shared<onnxruntime::AllocatorWrapper>(allocator));
+  size_t* offsets = strings->MutableOffsets();
+  char* p = strings->MutableBytes();
+  size_t f = 0;
+  for (size_t i = 0; i != s_len; ++i) {
+    memcpy(p + f, s[i], lengths[i]);
+    offsets[i] = f;
+    f += lengths[i];
+  }
+  std::unique_ptr<MLValue> value = std::make_unique<MLValue>();
+  value->Init(strings.release(),
+              DataTypeImpl::GetType<PackedStringTensor>(),
+              DataTypeImpl::GetType<PackedStringTensor>()->GetDeleteFunc());
+  *out = reinterpret_cast<OrtValue*>(value.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtCreatePackedStringTensorWithDataAsOrtValue, _In_ void* s, size_t s_len,
+                    _In_ size_t* offsets, size_t offsets_len, _In_ const size_t* shape, size_t shape_len,
+                    _Out_ OrtValue** out) {
+  API_IMPL_BEGIN
+  std::vector<int64_t> shapes;
+  ORT_API_RETURN_IF_ERROR(GetPackedStringTensorShape(shape, shape_len, offsets_len, shapes));
+  for (size_t i = 0; i != offsets_len; ++i) {
+    if (offsets[i] > s_len || (i > 0 && offsets[i] < offsets[i - 1])) {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "offsets must be increasing and not exceed s_len");
+    }
+  }
+  auto strings = std::make_unique<PackedStringTensor>();
+  strings->Reset(onnxruntime::TensorShape(shapes), static_cast<char*>(s), s_len, offsets);
+  std::unique_ptr<MLValue> value = std::make_unique<MLValue>();
+  value->Init(strings.release(),
+              DataTypeImpl::GetType<PackedStringTensor>(),
+              DataTypeImpl::GetType<PackedStringTensor>()->GetDeleteFunc());
+  *out = reinterpret_cast<OrtValue*>(value.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtGetPackedStringTensorContent, _In_ const OrtValue* value, _Out_ const void** s,
+                    _Out_ size_t* s_len, _Out_ const size_t** offsets, _Out_ size_t* offsets_len) {
+  API_IMPL_BEGIN
+  auto v = reinterpret_cast<const ::onnxruntime::MLValue*>(value);
+  const auto& strings = v->Get<PackedStringTensor>();
+  *s = strings.Bytes();
+  *s_len = strings.TotalLength();
+  *offsets = strings.Offsets();
+  *offsets_len = strings.Size();
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtTensorProtoToOrtValue, _Inout_ OrtAllocator* allocator,
                     const void* input, int input_len, _Out_ OrtValue** out) {
   API_IMPL_BEGIN
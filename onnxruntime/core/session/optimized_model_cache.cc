@@ -0,0 +1,183 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/optimized_model_cache.h"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#include "core/platform/env.h"
+
+// set by the build from VERSION_NUMBER
+#ifndef ORT_VERSION
+#define ORT_VERSION "unknown"
+#endif
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+
+// Changes when the optimized models of a same version are no longer compatible.
+static const char* const kCacheFormatVersion = "1";
+
+// Metadata of the cached models holding their key.
+static const char* const kCacheKeyMetadata = "onnxruntime.optimized_model_cache_key";
+
+namespace {
+// FNV-1a of each value added
+class Hash {
+ public:
+  void Add(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      value_ ^= bytes[i];
+      value_ *= 1099511628211ULL;
+    }
+  }
+
+  // preceded by its size, so that consecutive strings can't be confused
+  void Add(const std::string& value) {
+    const uint64_t size = value.size();
+    for (size_t i = 0; i < sizeof(size); ++i) {
+      const uint8_t byte = static_cast<uint8_t>(size >> (8 * i));
+      Add(&byte, 1);
+    }
+    Add(value.data(), value.size());
+  }
+
+  std::string ToString() const {
+    std::ostringstream hex;
+    hex << std::hex << std::setw(16) << std::setfill('0') << value_;
+    return hex.str();
+  }
+
+ private:
+  uint64_t value_ = 14695981039346656037ULL;
+};
+
+template <typename T>
+Status GetFileFingerprintImpl(const T& path, std::string& fingerprint) {
+  int fd;
+  ORT_RETURN_IF_ERROR(Env::Default().FileOpenRd(path, fd));
+#ifdef _WIN32
+  struct _stat64 file_status;
+  const int result = _fstat64(fd, &file_status);
+#else
+  struct stat file_status;
+  const int result = fstat(fd, &file_status);
+#endif
+  ORT_RETURN_IF_ERROR(Env::Default().FileClose(fd));
+  if (result != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to get the size and modification time of the model file");
+  }
+
+  Hash path_hash;
+  path_hash.Add(path.data(), path.size() * sizeof(typename T::value_type));
+  std::ostringstream description;
+  description << "file:" << path_hash.ToString() << ':' << file_status.st_size << ':' << file_status.st_mtime
+              << ':' << file_status.st_dev << ':' << file_status.st_ino;
+  fingerprint = description.str();
+  return Status::OK();
+}
+}  // namespace
+
+Status OptimizedModelCache::GetFileFingerprint(const std::string& path, std::string& fingerprint) {
+  return GetFileFingerprintImpl(path, fingerprint);
+}
+
+#ifdef _WIN32
+Status OptimizedModelCache::GetFileFingerprint(const std::wstring& path, std::string& fingerprint) {
+  return GetFileFingerprintImpl(path, fingerprint);
+}
+#endif
+
+std::string OptimizedModelCache::GetBytesFingerprint(const void* data, size_t size) {
+  Hash hash;
+  hash.Add(data, size);
+  return "bytes:" + hash.ToString() + ':' + std::to_string(size);
+}
+
+std::string OptimizedModelCache::GetModelFingerprint(Model& model) {
+  std::string model_bytes;
+  model.ToProto().SerializeToString(&model_bytes);
+  return GetBytesFingerprint(model_bytes.data(), model_bytes.size());
+}
+
+std::string OptimizedModelCache::GetKey(const std::string& fingerprint, const std::string& settings) {
+  Hash hash;
+  hash.Add(fingerprint);
+  hash.Add(ORT_VERSION);
+  hash.Add(kCacheFormatVersion);
+  hash.Add(settings);
+  return hash.ToString();
+}
+
+std::string OptimizedModelCache::GetPath(const std::string& key) const {
+  if (directory_.empty() || directory_.back() == '/' || directory_.back() == '\\') {
+    return directory_ + key + ".onnx";
+  }
+  return directory_ + "/" + key + ".onnx";
+}
+
+Status OptimizedModelCache::Load(const std::string& key, std::shared_ptr<Model>& model,
+                                 const IOnnxRuntimeOpSchemaRegistryList* local_registries) const {
+  model = nullptr;
+  const std::string path = GetPath(key);
+  if (!std::ifstream(path).good()) {
+    return Status::OK();
+  }
+
+  std::shared_ptr<Model> cached_model;
+  ORT_RETURN_IF_ERROR(Model::Load(path, cached_model, local_registries));
+  const auto& metadata = cached_model->MetaData();
+  auto entry = metadata.find(kCacheKeyMetadata);
+  if (entry == metadata.cend() || entry->second != key) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, path, " is not the optimized model cached under ", key);
+  }
+
+  model = cached_model;
+  return Status::OK();
+}
+
+Status OptimizedModelCache::Save(const std::string& key, Model& model) const {
+  ModelProto model_proto = model.ToProto();
+  StringStringEntryProto* key_entry = model_proto.add_metadata_props();
+  key_entry->set_key(kCacheKeyMetadata);
+  key_entry->set_value(key);
+
+  // written under another name first, so that the sessions loading the model never read a partial file
+  const std::string path = GetPath(key);
+  const std::string temp_path = path + "." + std::to_string(Env::Default().GetSelfPid()) + ".tmp";
+  std::ofstream output(temp_path, std::ios::binary | std::ios::trunc);
+  const bool written = output && model_proto.SerializeToOstream(&output);
+  output.close();
+  if (!written || !output) {
+    std::remove(temp_path.c_str());
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write the optimized model to ", temp_path);
+  }
+
+  // replaces the model cached under key atomically, so that it exists for the other sessions at any time.
+  // rename replaces the target on POSIX but not on Windows.
+#ifdef _WIN32
+  const bool moved = MoveFileExA(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+  const bool moved = std::rename(temp_path.c_str(), path.c_str()) == 0;
+#endif
+  if (!moved) {
+    std::remove(temp_path.c_str());
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to move the optimized model to ", path);
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/graph/model.h"
+
+namespace onnxruntime {
+
+/**
+@class OptimizedModelCache
+
+Cache of the models optimized by the graph transformers of a session, kept in a directory as ONNX models.
+A model is cached under a key hashing a fingerprint of the original model, the onnxruntime version and the
+settings the optimized graph depends on, so that a changed model or another build never reads a stale entry.
+The fingerprint is taken when the model is loaded, from what it was loaded from, rather than by serializing
+the model again. The cached models are only written once complete, several processes may share a directory.
+*/
+class OptimizedModelCache {
+ public:
+  explicit OptimizedModelCache(const std::string& directory) : directory_(directory) {}
+
+  /**
+  Gets the fingerprint of a model file from its path, size, modification time and, where the platform has
+  them, its device and inode. A file replaced by another one therefore gets another fingerprint, while one
+  rewritten in place to the same size within the resolution of the modification time keeps it.
+  Must be called before reading the model, so that a model changed while it's loaded is not cached under
+  the fingerprint of its next version.
+  */
+  static common::Status GetFileFingerprint(const std::string& path, /*out*/ std::string& fingerprint);
+#ifdef _WIN32
+  static common::Status GetFileFingerprint(const std::wstring& path, /*out*/ std::string& fingerprint);
+#endif
+
+  // Gets the fingerprint of a serialized model by hashing its bytes.
+  static std::string GetBytesFingerprint(const void* data, size_t size);
+
+  // Gets the fingerprint of a model only available in memory, which is serialized for it.
+  static std::string GetModelFingerprint(Model& model);
+
+  /**
+  Gets the key of a model.
+  @param fingerprint Fingerprint of the model before optimization.
+  @param settings Description of the optimizations applied to the model.
+  */
+  static std::string GetKey(const std::string& fingerprint, const std::string& settings);
+
+  /**
+  Loads the model cached under key.
+  @param model Set to the cached model, or to nullptr if there is none.
+  */
+  common::Status Load(const std::string& key, /*out*/ std::shared_ptr<Model>& model,
+                      const IOnnxRuntimeOpSchemaRegistryList* local_registries = nullptr) const;
+
+  // Saves model under key, replacing any model cached under it.
+  common::Status Save(const std::string& key, Model& model) const;
+
+ private:
+  std::string GetPath(const std::string& key) const;
+
+  const std::string directory_;
+};
+
+}  // namespace onnxruntime
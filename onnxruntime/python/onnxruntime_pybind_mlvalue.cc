@@ -75,7 +75,60 @@ bool PyObjectCheck_Array(PyObject* o) {
   return PyObject_HasAttrString(o, "__array_finalize__");
 }
 
+// Keeps a numpy array alive while a Tensor uses its data. The memory belongs to the array so Free does nothing.
+class NumpyArrayBufferOwner : public IAllocator {
+ public:
+  NumpyArrayBufferOwner(PyArrayObject* array, const OrtAllocatorInfo& info) : array_(array), info_(info) {
+    Py_INCREF(array_);
+  }
+
+  ~NumpyArrayBufferOwner() override {
+    py::gil_scoped_acquire gil;
+    Py_DECREF(array_);
+  }
+
+  void* Alloc(size_t) override {
+    ORT_THROW("NumpyArrayBufferOwner cannot allocate memory.");
+  }
+
+  void Free(void*) override {}
+
+  const OrtAllocatorInfo& Info() const override {
+    return info_;
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NumpyArrayBufferOwner);
+
+  PyArrayObject* array_;
+  OrtAllocatorInfo info_;
+};
+
+static bool IsNumericNumpyType(int npy_type) {
+  return npy_type != NPY_UNICODE && npy_type != NPY_STRING && npy_type != NPY_OBJECT && npy_type != NPY_VOID;
+}
+
 void CreateTensorMLValue(AllocatorPtr alloc, const std::string& name_input, PyArrayObject* pyObject, MLValue* p_mlvalue) {
+  // Use the data of C contiguous numeric arrays in place.
+  // Graph inputs are never written to, so the array is only read during the run.
+  const int in_npy_type = PyArray_TYPE(pyObject);
+  if (IsNumericNumpyType(in_npy_type) && PyArray_ISCARRAY_RO(pyObject) && PyArray_ISNOTSWAPPED(pyObject)) {
+    auto element_type = NumpyToOnnxRuntimeTensorType(in_npy_type);
+    if (element_type->Size() == static_cast<size_t>(PyArray_ITEMSIZE(pyObject))) {
+      const int ndim = PyArray_NDIM(pyObject);
+      const npy_intp* npy_dims = PyArray_DIMS(pyObject);
+      std::vector<int64_t> dims(npy_dims, npy_dims + ndim);
+
+      auto owner = std::make_shared<NumpyArrayBufferOwner>(pyObject, alloc->Info());
+      std::unique_ptr<Tensor> p_tensor = std::make_unique<Tensor>(element_type, TensorShape(dims),
+                                                                  PyArray_DATA(pyObject), alloc->Info(), owner);
+      p_mlvalue->Init(p_tensor.release(),
+                      DataTypeImpl::GetType<Tensor>(),
+                      DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+      return;
+    }
+  }
+
   PyArrayObject* darray = PyArray_GETCONTIGUOUS(pyObject);
   if (darray == NULL) {
     throw std::runtime_error(std::string("The object must be a contiguous array for input '") + name_input + std::string("'."));
@@ -249,12 +302,25 @@ void CreateMapMLValue_VectorMap(Py_ssize_t& pos, PyObject*& key, const std::stri
   std::unique_ptr<std::vector<std::map<KeyType, ValueType>>> dstVector;
   dstVector = std::make_unique<std::vector<std::map<KeyType, ValueType>>>();
   int index = 0;
+  // the caller already moved to the first pair of the first dictionary
+  bool has_pair = true;
   do {
     dstVector->push_back(std::map<KeyType, ValueType>());
-    CreateMapMLValue_LoopIntoMap(pos, key, name_input, value, item, (*dstVector)[index], keyGetter, valueGetter);
+    if (has_pair) {
+      CreateMapMLValue_LoopIntoMap(pos, key, name_input, value, item, (*dstVector)[index], keyGetter, valueGetter);
+    }
     Py_DECREF(item);
     ++index;
     item = iterator == NULL ? NULL : PyIter_Next(iterator);
+    if (item != NULL) {
+      if (!PyDict_Check(item)) {
+        Py_DECREF(item);
+        throw std::runtime_error("Input '" + name_input + "' must be a list of dictionaries.");
+      }
+      // restart the iteration on the next dictionary
+      pos = 0;
+      has_pair = PyDict_Next(item, &pos, &key, &value) != 0;
+    }
   } while (item != NULL);
   p_mlvalue->Init(dstVector.release(), DataTypeImpl::GetType<std::vector<std::map<KeyType, ValueType>>>(),
                   DataTypeImpl::GetType<std::vector<std::map<KeyType, ValueType>>>()->GetDeleteFunc());
@@ -68,7 +68,9 @@ std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_BrainS
 #pragma warning(disable : 4267 4996 4503 4003)
 #endif  // _MSC_VER
 
+#include <algorithm>
 #include <iterator>
+#include <limits>
 
 #if defined(_MSC_VER)
 #pragma warning(disable : 4267 4996 4503 4003)
@@ -92,6 +94,184 @@ static const SessionOptions& GetDefaultCPUSessionOptions() {
   return so;
 }
 
+// Views over a ColumnarMapSequence output (e.g. ZipMap's) which avoid building a dict per row.
+// The values are exposed as a read-only numpy array sharing the output buffer, a dict is only
+// built for a row when it is converted explicitly. Both views hold a reference to the MLValue.
+template <typename K>
+struct ColumnarMapSequenceView {
+  MLValue value;
+
+  const ColumnarMapSequence<K, float>& Get() const {
+    return value.Get<ColumnarMapSequence<K, float>>();
+  }
+};
+
+template <typename K>
+struct ColumnarMapRowView {
+  MLValue value;
+  size_t row;
+
+  const ColumnarMapSequence<K, float>& Get() const {
+    return value.Get<ColumnarMapSequence<K, float>>();
+  }
+};
+
+// Wraps data owned by value in a numpy array which keeps value alive through a capsule.
+static py::object CreateNumpyArrayOverMLValue(const MLValue& value, int numpy_type, const void* data,
+                                              std::vector<npy_intp> dims, bool writeable) {
+  py::capsule owner(new MLValue(value), [](void* p) { delete reinterpret_cast<MLValue*>(p); });
+  PyObject* arr = PyArray_SimpleNewFromData(static_cast<int>(dims.size()), dims.data(), numpy_type,
+                                            const_cast<void*>(data));
+  if (arr == nullptr) {
+    throw py::error_already_set();
+  }
+  py::object obj = py::reinterpret_steal<py::object>(arr);
+  if (!writeable) {
+    PyArray_CLEARFLAGS(reinterpret_cast<PyArrayObject*>(arr), NPY_ARRAY_WRITEABLE);
+  }
+  // PyArray_SetBaseObject steals the reference to owner
+  if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(arr), owner.release().ptr()) != 0) {
+    throw py::error_already_set();
+  }
+  return obj;
+}
+
+// Position of key in keys, the last one wins if a label is repeated as it does for a std::map.
+template <typename K>
+static bool FindColumnarMapKey(const std::vector<K>& keys, const py::object& key, size_t& index) {
+  K ckey;
+  try {
+    ckey = key.cast<K>();
+  } catch (const py::cast_error&) {
+    return false;
+  }
+  auto it = std::find(keys.rbegin(), keys.rend(), ckey);
+  if (it == keys.rend()) {
+    return false;
+  }
+  index = static_cast<size_t>(keys.rend() - it) - 1;
+  return true;
+}
+
+template <typename K>
+static py::dict ColumnarMapRowToDict(const ColumnarMapRowView<K>& self) {
+  const auto& seq = self.Get();
+  const auto& keys = seq.Keys();
+  const float* row = seq.Row(self.row);
+  py::dict result;
+  for (size_t k = 0; k < keys.size(); ++k) {
+    result[py::cast(keys[k])] = py::cast(row[k]);
+  }
+  return result;
+}
+
+template <typename K>
+static py::list ColumnarMapSequenceToList(const ColumnarMapSequenceView<K>& self) {
+  py::list result;
+  for (size_t i = 0, end = self.Get().size(); i < end; ++i) {
+    result.append(ColumnarMapRowToDict(ColumnarMapRowView<K>{self.value, i}));
+  }
+  return result;
+}
+
+static bool PyObjectsEqual(const py::object& a, const py::object& b) {
+  int rc = PyObject_RichCompareBool(a.ptr(), b.ptr(), Py_EQ);
+  if (rc < 0) {
+    throw py::error_already_set();
+  }
+  return rc == 1;
+}
+
+template <typename K>
+void addColumnarMapViews(py::module& m, const std::string& name) {
+  using Row = ColumnarMapRowView<K>;
+  using Sequence = ColumnarMapSequenceView<K>;
+
+  py::class_<Row> row_class(m, (name + "Row").c_str(), R"pbdoc(Read-only dict-like view of one row of a sequence of maps.)pbdoc");
+  row_class
+      .def("__len__", [](const Row& self) { return self.Get().NumKeys(); })
+      .def("__getitem__", [](const Row& self, const py::object& key) {
+        size_t index;
+        if (!FindColumnarMapKey(self.Get().Keys(), key, index)) {
+          throw py::key_error(std::string(py::repr(key)));
+        }
+        return self.Get().Row(self.row)[index];
+      })
+      .def("__contains__", [](const Row& self, const py::object& key) {
+        size_t index;
+        return FindColumnarMapKey(self.Get().Keys(), key, index);
+      })
+      .def("__iter__", [](const Row& self) { return py::iter(py::cast(self.Get().Keys())); })
+      .def("__eq__", [](const Row& self, const py::object& other) {
+        return PyObjectsEqual(ColumnarMapRowToDict(self), other);
+      })
+      .def("__repr__", [](const Row& self) { return py::repr(ColumnarMapRowToDict(self)); })
+      .def("get", [](const Row& self, const py::object& key, const py::object& default_value) -> py::object {
+        size_t index;
+        if (!FindColumnarMapKey(self.Get().Keys(), key, index)) {
+          return default_value;
+        }
+        return py::cast(self.Get().Row(self.row)[index]);
+      },
+           py::arg("key"), py::arg("default") = py::none())
+      .def("keys", [](const Row& self) { return self.Get().Keys(); })
+      .def("values", [](const Row& self) {
+        return CreateNumpyArrayOverMLValue(self.value, NPY_FLOAT, self.Get().Row(self.row),
+                                           {static_cast<npy_intp>(self.Get().NumKeys())}, false);
+      },
+           "Values of the row in the order of keys() as a numpy array.")
+      .def("items", [](const Row& self) {
+        const auto& keys = self.Get().Keys();
+        const float* row = self.Get().Row(self.row);
+        py::list result;
+        for (size_t k = 0; k < keys.size(); ++k) {
+          result.append(py::make_tuple(keys[k], row[k]));
+        }
+        return result;
+      })
+      .def("to_dict", &ColumnarMapRowToDict<K>, "Converts the row into a dict.");
+
+  py::class_<Sequence> sequence_class(m, name.c_str(), R"pbdoc(Read-only list-like view of a sequence of maps which all have the same keys.
+The values are available as a 2D numpy array without converting every row into a dict.)pbdoc");
+  sequence_class
+      .def("__len__", [](const Sequence& self) { return self.Get().size(); })
+      .def("__getitem__", [](const Sequence& self, int64_t i) {
+        const auto size = static_cast<int64_t>(self.Get().size());
+        if (i < 0) {
+          i += size;
+        }
+        if (i < 0 || i >= size) {
+          throw py::index_error("sequence index out of range");
+        }
+        return Row{self.value, static_cast<size_t>(i)};
+      })
+      .def("__iter__", [](const Sequence& self) {
+        py::list rows;
+        for (size_t i = 0, end = self.Get().size(); i < end; ++i) {
+          rows.append(Row{self.value, i});
+        }
+        return py::iter(rows);
+      })
+      .def("__eq__", [](const Sequence& self, const py::object& other) {
+        return PyObjectsEqual(ColumnarMapSequenceToList(self), other);
+      })
+      .def("__repr__", [](const Sequence& self) { return py::repr(ColumnarMapSequenceToList(self)); })
+      .def_property_readonly("keys", [](const Sequence& self) { return self.Get().Keys(); },
+                             "Keys shared by all the rows.")
+      .def_property_readonly("values", [](const Sequence& self) {
+        const auto& seq = self.Get();
+        return CreateNumpyArrayOverMLValue(self.value, NPY_FLOAT, seq.Values().data(),
+                                           {static_cast<npy_intp>(seq.size()), static_cast<npy_intp>(seq.NumKeys())},
+                                           false);
+      },
+                             "Values as a [rows x keys] numpy array.")
+      .def("to_list", &ColumnarMapSequenceToList<K>, "Converts the sequence into a list of dicts.");
+
+  auto abc = py::module::import("collections.abc");
+  abc.attr("Mapping").attr("register")(row_class);
+  abc.attr("Sequence").attr("register")(sequence_class);
+}
+
 template <typename T>
 void AddNonTensor(onnxruntime::MLValue& val, vector<py::object>& pyobjs) {
   pyobjs.push_back(py::cast(val.Get<T>()));
@@ -126,6 +306,10 @@ void AddNonTensorAsPyObj(onnxruntime::MLValue& val, vector<py::object>& pyobjs)
     AddNonTensor<VectorMapStringToFloat>(val, pyobjs);
   } else if (val.Type() == DataTypeImpl::GetType<VectorMapInt64ToFloat>()) {
     AddNonTensor<VectorMapInt64ToFloat>(val, pyobjs);
+  } else if (val.Type() == DataTypeImpl::GetType<ColumnarMapStringToFloat>()) {
+    pyobjs.push_back(py::cast(ColumnarMapSequenceView<std::string>{val}));
+  } else if (val.Type() == DataTypeImpl::GetType<ColumnarMapInt64ToFloat>()) {
+    pyobjs.push_back(py::cast(ColumnarMapSequenceView<int64_t>{val}));
   } else {
     throw std::runtime_error("Output is a non-tensor type which is not supported.");
   }
@@ -142,6 +326,15 @@ void AddTensorAsPyObj(onnxruntime::MLValue& val, vector<py::object>& pyobjs) {
 
   MLDataType dtype = rtensor.DataType();
   const int numpy_type = OnnxRuntimeTensorToNumpyType(dtype);
+
+  // A tensor owning its CPU buffer is not referenced by the session anymore,
+  // so the array can use the buffer directly instead of a copy.
+  if (numpy_type != NPY_OBJECT && rtensor.OwnsBuffer() && shape.Size() > 0 &&
+      strcmp(rtensor.Location().name, CPU) == 0) {
+    pyobjs.push_back(CreateNumpyArrayOverMLValue(val, numpy_type, rtensor.DataRaw(dtype), npy_dims, true));
+    return;
+  }
+
   py::object obj = py::reinterpret_steal<py::object>(PyArray_SimpleNew(
       shape.NumDimensions(), npy_dims.data(), numpy_type));
 
@@ -161,6 +354,42 @@ void AddTensorAsPyObj(onnxruntime::MLValue& val, vector<py::object>& pyobjs) {
   pyobjs.push_back(obj);
 }
 
+static NameMLValMap CreateFeeds(std::map<std::string, py::object>& pyfeeds) {
+  NameMLValMap feeds;
+  for (auto _ : pyfeeds) {
+    MLValue ml_value;
+    CreateGenericMLValue(GetAllocator(), _.first, _.second, &ml_value);
+    if (PyErr_Occurred()) {
+      PyObject *ptype, *pvalue, *ptraceback;
+      PyErr_Fetch(&ptype, &pvalue, &ptraceback);
+
+      PyObject* pStr = PyObject_Str(ptype);
+      std::string sType = py::reinterpret_borrow<py::str>(pStr);
+      Py_XDECREF(pStr);
+      pStr = PyObject_Str(pvalue);
+      sType += ": ";
+      sType += py::reinterpret_borrow<py::str>(pStr);
+      Py_XDECREF(pStr);
+      throw std::runtime_error(sType);
+    }
+    feeds.insert(std::make_pair(_.first, ml_value));
+  }
+  return feeds;
+}
+
+static std::vector<py::object> FetchesToPyObjs(std::vector<MLValue>& fetches) {
+  std::vector<py::object> rfetch;
+  rfetch.reserve(fetches.size());
+  for (auto _ : fetches) {
+    if (_.IsTensor()) {
+      AddTensorAsPyObj(_, rfetch);
+    } else {
+      AddNonTensorAsPyObj(_, rfetch);
+    }
+  }
+  return rfetch;
+}
+
 class SessionObjectInitializer {
  public:
   typedef const SessionOptions& Arg1;
@@ -217,6 +446,15 @@ void InitializeSession(InferenceSession* sess) {
   }
 }  // namespace python
 
+// Destroys the sessions collected by Python. The destructor waits for the runs queued by run_async, whose
+// callbacks are called with the GIL, so it's released meanwhile.
+struct InferenceSessionDeleter {
+  void operator()(InferenceSession* sess) const {
+    py::gil_scoped_release release;
+    delete sess;
+  }
+};
+
 void addGlobalMethods(py::module& m) {
   m.def("get_session_initializer", &SessionObjectInitializer::Get, "Return a default session object initializer.");
   m.def(
@@ -227,6 +465,9 @@ void addGlobalMethods(py::module& m) {
 void addObjectMethods(py::module& m) {
   // allow unit tests to redirect std::cout and std::cerr to sys.stdout and sys.stderr
   py::add_ostream_redirect(m, "onnxruntime_ostream_redirect");
+  addColumnarMapViews<std::string>(m, "ColumnarMapStringToFloat");
+  addColumnarMapViews<int64_t>(m, "ColumnarMapInt64ToFloat");
+
   py::class_<SessionOptions>(m, "SessionOptions", R"pbdoc(Configuration information for a session.)pbdoc")
       .def(py::init())
       .def_readwrite("enable_mem_pattern", &SessionOptions::enable_mem_pattern,
@@ -234,9 +475,52 @@ void addObjectMethods(py::module& m) {
 The idea is if the input shapes are the same, we could trace the internal memory allocation
 and generate a memory pattern for future request. So next time we could just do one allocation
 with a big chunk for all the internal memory allocation. Default is true.)pbdoc")
+      .def_property(
+          "mem_pattern_dim_buckets",
+          [](const SessionOptions& options) { return options.mem_pattern_cache_options.dim_buckets; },
+          [](SessionOptions& options, std::vector<int64_t> buckets) {
+            options.mem_pattern_cache_options.dim_buckets = std::move(buckets);
+          },
+          R"pbdoc(Sorted sizes the dynamic dimensions of the inputs are rounded up to, so that one memory pattern
+serves every shape of a bucket. Default is empty, a pattern is then only used for the shapes it was traced with.)pbdoc")
+      .def_property(
+          "mem_pattern_cache_max_entries",
+          [](const SessionOptions& options) { return options.mem_pattern_cache_options.max_entries; },
+          [](SessionOptions& options, size_t max_entries) {
+            options.mem_pattern_cache_options.max_entries = max_entries;
+          },
+          R"pbdoc(Maximum number of memory patterns kept, the least recently used are evicted first.
+0 means unbounded. Default is 64.)pbdoc")
+      .def_property(
+          "mem_pattern_cache_max_bytes",
+          [](const SessionOptions& options) { return options.mem_pattern_cache_options.max_bytes; },
+          [](SessionOptions& options, size_t max_bytes) {
+            options.mem_pattern_cache_options.max_bytes = max_bytes;
+          },
+          R"pbdoc(Maximum sum of the peak sizes in bytes of the memory patterns kept. 0 means unbounded, which is
+the default.)pbdoc")
       .def_readwrite("enable_cpu_mem_arena", &SessionOptions::enable_cpu_mem_arena,
                      R"pbdoc(Enables the memory arena on CPU. Arena may pre-allocate memory for future usage.
 Set this option to false if you don't want it. Default is True.)pbdoc")
+      .def_readwrite("enable_constant_folding", &SessionOptions::enable_constant_folding,
+                     R"pbdoc(Evaluates the nodes with constant inputs once when initializing the session and replaces
+them by initializers. Default is True.)pbdoc")
+      .def_readwrite("enable_transpose_optimization", &SessionOptions::enable_transpose_optimization,
+                     R"pbdoc(Pushes the Transpose nodes through the ops not depending on the layout and removes the ones
+cancelling each other when initializing the session. Default is True.)pbdoc")
+      .def_readwrite("enable_common_subexpression_elimination",
+                     &SessionOptions::enable_common_subexpression_elimination,
+                     R"pbdoc(Merges the nodes computing the same values from the same inputs when initializing the
+session, before the other graph transformers run. Default is True.)pbdoc")
+      .def_readwrite("enable_rule_based_optimization", &SessionOptions::enable_rule_based_optimization,
+                     R"pbdoc(Applies the rewrite rules of onnxruntime, such as removing the Identity nodes, when
+initializing the session. Default is True.)pbdoc")
+      .def_readwrite("optimized_model_cache_dir", &SessionOptions::optimized_model_cache_dir,
+                     R"pbdoc(Directory caching the models optimized by the graph transformers. A session finding the
+optimized version of its model there skips the transformers. Default is empty, which disables the cache.)pbdoc")
+      .def_readwrite("share_initializers", &SessionOptions::share_initializers,
+                     R"pbdoc(Shares the weights on CPU with the other sessions setting this option, identical weights
+of different models are only held once in the process. Default is False.)pbdoc")
       .def_readwrite("enable_profiling", &SessionOptions::enable_profiling,
                      R"pbdoc(Enable profiling for this session. Default is false.)pbdoc")
       .def_readwrite("enable_sequential_execution", &SessionOptions::enable_sequential_execution,
@@ -249,7 +533,9 @@ Set this option to false if you don't want it. Default is True.)pbdoc")
                      R"pbdoc(Applies to session load, initialization, etc. Default is 0.)pbdoc")
       .def_readwrite("session_thread_pool_size", &SessionOptions::session_thread_pool_size,
                      R"pbdoc(How many threads in the session thread pool. Default is 0 to let onnxruntime choose.
-This parameter is unused unless *enable_sequential_execution* is false.)pbdoc");
+This parameter is unused unless *enable_sequential_execution* is false.)pbdoc")
+      .def_readwrite("async_run_thread_pool_size", &SessionOptions::async_run_thread_pool_size,
+                     R"pbdoc(How many threads execute the runs queued by *run_async*. Default is 0 to let onnxruntime choose.)pbdoc");
 
   py::class_<RunOptions>(m, "RunOptions", R"pbdoc(Configuration information for a single Run.)pbdoc")
       .def(py::init())
@@ -327,7 +613,7 @@ including arg name, arg type (contains both type and shape).)pbdoc")
           "node shape (assuming the node holds a tensor)");
 
   py::class_<SessionObjectInitializer>(m, "SessionObjectInitializer");
-  py::class_<InferenceSession>(m, "InferenceSession", R"pbdoc(This is the main class used to run a model.)pbdoc")
+  py::class_<InferenceSession, std::unique_ptr<InferenceSession, InferenceSessionDeleter>>(m, "InferenceSession", R"pbdoc(This is the main class used to run a model.)pbdoc")
       .def(py::init<SessionObjectInitializer, SessionObjectInitializer>())
       .def(py::init<SessionOptions, SessionObjectInitializer>())
       .def(
@@ -341,8 +627,16 @@ including arg name, arg type (contains both type and shape).)pbdoc")
           R"pbdoc(Load a model saved in ONNX format.)pbdoc")
       .def(
           "read_bytes", [](InferenceSession* sess, const py::bytes& serializedModel) {
-            std::istringstream buffer(serializedModel);
-            auto status = sess->Load(buffer);
+            // parse the content of the bytes object in place rather than a copy of it
+            char* data = nullptr;
+            Py_ssize_t size = 0;
+            if (PyBytes_AsStringAndSize(serializedModel.ptr(), &data, &size) != 0) {
+              throw py::error_already_set();
+            }
+            if (size > std::numeric_limits<int>::max()) {
+              throw std::runtime_error("The serialized model exceeds the 2GB limit of protobuf.");
+            }
+            auto status = sess->Load(data, static_cast<int>(size));
             if (!status.IsOK()) {
               throw std::runtime_error(status.ToString().c_str());
             }
@@ -350,26 +644,7 @@ including arg name, arg type (contains both type and shape).)pbdoc")
           },
           R"pbdoc(Load a model serialized in ONNX format.)pbdoc")
       .def("run", [](InferenceSession* sess, std::vector<std::string> output_names, std::map<std::string, py::object> pyfeeds, RunOptions* run_options = nullptr) -> std::vector<py::object> {
-        NameMLValMap feeds;
-        for (auto _ : pyfeeds) {
-          MLValue ml_value;
-          CreateGenericMLValue(GetAllocator(), _.first, _.second, &ml_value);
-          if (PyErr_Occurred()) {
-            PyObject *ptype, *pvalue, *ptraceback;
-            PyErr_Fetch(&ptype, &pvalue, &ptraceback);
-
-            PyObject* pStr = PyObject_Str(ptype);
-            std::string sType = py::reinterpret_borrow<py::str>(pStr);
-            Py_XDECREF(pStr);
-            pStr = PyObject_Str(pvalue);
-            sType += ": ";
-            sType += py::reinterpret_borrow<py::str>(pStr);
-            Py_XDECREF(pStr);
-            throw std::runtime_error(sType);
-          }
-          feeds.insert(std::make_pair(_.first, ml_value));
-        }
-
+        NameMLValMap feeds = CreateFeeds(pyfeeds);
         std::vector<MLValue> fetches;
         common::Status status;
 
@@ -384,17 +659,63 @@ including arg name, arg type (contains both type and shape).)pbdoc")
           throw std::runtime_error(std::string("Method run failed due to: ") + std::string(mes.c_str()));
         }
 
-        std::vector<py::object> rfetch;
-        rfetch.reserve(fetches.size());
-        for (auto _ : fetches) {
-          if (_.IsTensor()) {
-            AddTensorAsPyObj(_, rfetch);
+        return FetchesToPyObjs(fetches);
+      })
+      .def("run_async", [](InferenceSession* sess, std::vector<std::string> output_names, std::map<std::string, py::object> pyfeeds, py::object callback, RunOptions* run_options = nullptr) {
+        NameMLValMap feeds = CreateFeeds(pyfeeds);
+
+        // the callback is released by a thread of the session, which needs the GIL for it
+        std::shared_ptr<py::object> py_callback(new py::object(std::move(callback)), [](py::object* p) {
+          py::gil_scoped_acquire gil;
+          delete p;
+        });
+        auto on_completed = [py_callback](const common::Status& status, std::vector<MLValue>& fetches) {
+          py::gil_scoped_acquire gil;
+          if (!status.IsOK()) {
+            (*py_callback)(py::none(), std::string("Method run_async failed due to: ") + status.ToString());
+            return;
+          }
+          py::object results;
+          try {
+            results = py::cast(FetchesToPyObjs(fetches));
+          } catch (const std::exception& e) {
+            (*py_callback)(py::none(), std::string(e.what()));
+            return;
+          }
+          (*py_callback)(results, py::none());
+        };
+
+        common::Status status;
+        {
+          // a thread of the session may be releasing a previous callback or feeds, which needs the GIL,
+          // while holding the lock of the queue RunAsync takes
+          py::gil_scoped_release release;
+          if (run_options != nullptr) {
+            status = sess->RunAsync(*run_options, feeds, output_names, on_completed);
           } else {
-            AddNonTensorAsPyObj(_, rfetch);
+            status = sess->RunAsync(feeds, output_names, on_completed);
           }
         }
-        return rfetch;
-      })
+
+        if (!status.IsOK()) {
+          auto mes = status.ToString();
+          throw std::runtime_error(std::string("Method run_async failed due to: ") + std::string(mes.c_str()));
+        }
+      },
+           R"pbdoc(Queue a run and return immediately. callback(results, error) is called from a thread of the session
+once the run completed, results is None if it failed.)pbdoc")
+      .def("warm_up", [](InferenceSession* sess, const std::vector<std::unordered_map<std::string, std::vector<int64_t>>>& input_shapes) {
+        common::Status status;
+        {
+          py::gil_scoped_release release;
+          status = sess->WarmUp(input_shapes);
+        }
+        if (!status.IsOK()) {
+          throw std::runtime_error(std::string("Method warm_up failed due to: ") + status.ToString());
+        }
+      },
+           R"pbdoc(Run the model once per dictionary of input shapes on zero-filled inputs, so that the memory
+patterns of these shapes exist before the first real run.)pbdoc")
       .def("end_profiling", [](InferenceSession* sess) -> std::string {
         return sess->EndProfiling();
       })
@@ -3,6 +3,7 @@
 # Licensed under the MIT License.
 #--------------------------------------------------------------------------
 
+import asyncio
 import sys
 import os
 
@@ -71,6 +72,62 @@ class InferenceSession:
             output_names = [output.name for output in self._outputs_meta]
         return self._sess.run(output_names, input_feed, run_options)
 
+    def run_async(self, output_names, input_feed, run_options=None):
+        """
+        Queue the computation of the predictions and return an awaitable
+        resolved with the outputs once the run completed.
+        The run happens on a thread of the session, the current event loop
+        is not blocked.
+
+        :param output_names: name of the outputs
+        :param input_feed: dictionary ``{ input_name: input_value }``
+        :param run_options: See :class:`onnxruntime.RunOptions`,
+            it must not be modified until the run completed.
+
+        ::
+
+            res = await sess.run_async([output_name], {input_name: x})
+        """
+        num_required_inputs = len(self._inputs_meta)
+        num_inputs = len(input_feed)
+        if num_inputs < num_required_inputs:
+            raise ValueError("Model requires {} inputs. Input Feed contains {}".format(num_required_inputs, num_inputs))
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+
+        loop = asyncio.get_event_loop()
+        future = loop.create_future()
+
+        def set_result(results, error):
+            if future.cancelled():
+                return
+            if error is not None:
+                future.set_exception(RuntimeError(error))
+            else:
+                future.set_result(results)
+
+        def on_completed(results, error):
+            loop.call_soon_threadsafe(set_result, results, error)
+
+        self._sess.run_async(output_names, input_feed, on_completed, run_options)
+        return future
+
+    def warm_up(self, input_shapes):
+        """
+        Run the model once per set of input shapes on zero-filled inputs,
+        so that the memory patterns of these shapes are traced before the
+        first real run. The dynamic dimensions are rounded up to
+        :meth:`onnxruntime.SessionOptions.mem_pattern_dim_buckets`.
+
+        :param input_shapes: list of dictionaries ``{ input_name: shape }``,
+            one per run, covering all the required inputs
+
+        ::
+
+            sess.warm_up([{input_name: [1, 32]}, {input_name: [1, 64]}])
+        """
+        self._sess.warm_up([{name: list(shape) for name, shape in shapes.items()} for shapes in input_shapes])
+
     def end_profiling(self):
         """
         End profiling and return results in a file.
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/perfect_hash.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(PerfectHashTest, IndexFindsAllKeys) {
+  for (size_t n : {0, 1, 2, 3, 17, 1000}) {
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < n; ++i) {
+      keys.push_back("key" + std::to_string(i * 7));
+    }
+    std::vector<size_t> slots;
+    PerfectHashIndex<std::string> index(keys, &slots);
+    ASSERT_EQ(n, index.size());
+    ASSERT_EQ(n, slots.size());
+    std::vector<bool> used(n, false);
+    for (size_t i = 0; i < n; ++i) {
+      size_t slot = index.Find(keys[i]);
+      ASSERT_EQ(slots[i], slot);
+      ASSERT_FALSE(used[slot]);
+      used[slot] = true;
+      ASSERT_EQ(keys[i], index.KeyAt(slot));
+    }
+    ASSERT_FALSE(index.Contains("key1"));
+    ASSERT_FALSE(index.Contains(""));
+  }
+}
+
+TEST(PerfectHashTest, MapLookup) {
+  std::vector<int64_t> keys{-5, 0, 7, 1LL << 40, 12};
+  std::vector<std::string> values{"a", "b", "c", "d", "e"};
+  PerfectHashMap<int64_t, std::string> map(keys, values);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const std::string* value = map.Find(keys[i]);
+    ASSERT_NE(nullptr, value);
+    ASSERT_EQ(values[i], *value);
+    ASSERT_EQ(value, map.FindHashed(keys[i], map.Hash(keys[i])));
+  }
+  ASSERT_EQ(nullptr, map.Find(1));
+}
+
+TEST(PerfectHashTest, DuplicateKeysRejected) {
+  std::vector<std::string> keys{"a", "b", "a"};
+  EXPECT_THROW(PerfectHashIndex<std::string>{keys}, OnnxRuntimeException);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// batch_size 1, sequence_length 2, hidden_size 4 and 2 heads
+static void AddAttentionInputs(OpTester& test) {
+  std::vector<float> weight(4 * 12);
+  for (size_t i = 0; i < weight.size(); ++i) {
+    weight[i] = ((i % 7) - 3.f) * 0.1f;
+  }
+  std::vector<float> bias(12);
+  for (size_t i = 0; i < bias.size(); ++i) {
+    bias[i] = i * 0.01f;
+  }
+
+  test.AddAttribute<int64_t>("num_heads", 2);
+  test.AddInput<float>("input", {1, 2, 4}, {0.5f, -0.2f, 0.3f, 1.0f, 0.1f, 0.4f, -0.6f, 0.2f});
+  test.AddInput<float>("weight", {4, 12}, weight);
+  test.AddInput<float>("bias", {12}, bias);
+}
+
+TEST(ContribOpTest, Attention) {
+  OpTester test("Attention", 1, onnxruntime::kMSDomain);
+  AddAttentionInputs(test);
+  test.AddOutput<float>("output", {1, 2, 4}, {-0.02381121f, -0.00152165f, 0.08434749f, 0.29522665f,
+                                              -0.02518120f, 0.00023193f, 0.10712794f, 0.29474196f});
+  test.Run();
+}
+
+TEST(ContribOpTest, Attention_Mask) {
+  // the second token is masked, so the context of both tokens is the value of the first one
+  OpTester test("Attention", 1, onnxruntime::kMSDomain);
+  AddAttentionInputs(test);
+  test.AddInput<float>("mask", {1, 1, 1, 2}, {0.f, -10000.f});
+  test.AddOutput<float>("output", {1, 2, 4}, {-0.15f, 0.16f, 0.33f, 0.29f, -0.15f, 0.16f, 0.33f, 0.29f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ContribOpTest, FusedGemmRowBiasRelu) {
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)0);
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", "Relu");
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {4, 3}, std::vector<float>(12, 1.0f));
+  test.AddInput<float>("C", {2, 1}, std::vector<float>{1.0f, 2.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {11.0f, 11.0f, 11.0f,
+                         0.0f, 0.0f, 0.0f});
+  test.Run();
+}
+
+TEST(ContribOpTest, FusedGemmResidualLeakyRelu) {
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)0);
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", "LeakyRelu");
+  test.AddAttribute("leaky_relu_alpha", 0.5f);
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {4, 3}, std::vector<float>(12, 1.0f));
+  test.AddInput<float>("C", {2, 3}, std::vector<float>{1.0f, 2.0f, 3.0f, 2.0f, 4.0f, 12.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {11.0f, 12.0f, 13.0f,
+                         -4.0f, -3.0f, 2.0f});
+  test.Run();
+}
+
+TEST(ContribOpTest, FusedGemmTransResidualTanh) {
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("transA", (int64_t)1);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("alpha", 0.1f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", "Tanh");
+
+  test.AddInput<float>("A", {4, 2},
+                       {1.0f, -1.0f,
+                        2.0f, -2.0f,
+                        3.0f, -3.0f,
+                        4.0f, -4.0f});
+  test.AddInput<float>("B", {3, 4}, std::vector<float>(12, 1.0f));
+  test.AddInput<float>("C", {2, 3}, std::vector<float>{0.0f, 0.5f, -0.5f, 0.0f, 0.5f, 1.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {0.7615942f, 0.9051483f, 0.4621172f,
+                         -0.7615942f, -0.4621172f, 0.0f});
+  test.Run();
+}
+
+TEST(ContribOpTest, FusedGemmZeroK) {
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)0);
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", "Relu");
+
+  // the product is empty, Y is the activation of C
+  test.AddInput<float>("A", {2, 0}, {});
+  test.AddInput<float>("B", {0, 3}, {});
+  test.AddInput<float>("C", {2, 3}, std::vector<float>{1.0f, -1.0f, 2.0f, -2.0f, 3.0f, -3.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {1.0f, 0.0f, 2.0f,
+                         0.0f, 3.0f, 0.0f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,18 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ContribOpTest, Gelu) {
+  OpTester test("Gelu", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("X", {2, 3}, {-2.f, -1.f, 0.f, 1.f, 2.f, 3.f});
+  test.AddOutput<float>("Y", {2, 3}, {-0.04550026f, -0.15865525f, 0.f, 0.84134475f, 1.95449974f, 2.99595031f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
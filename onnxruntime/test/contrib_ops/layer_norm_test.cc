@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ContribOpTest, LayerNormalization) {
+  OpTester test("LayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<float>("epsilon", 1e-5f);
+  test.AddInput<float>("X", {2, 3}, {1.f, 2.f, 3.f, 4.f, 6.f, 8.f});
+  test.AddInput<float>("scale", {3}, {1.f, 1.f, 2.f});
+  test.AddInput<float>("B", {3}, {0.f, 1.f, 0.f});
+  test.AddOutput<float>("Y", {2, 3}, {-1.2247357f, 1.f, 2.4494714f, -1.2247426f, 1.f, 2.4494852f});
+  test.Run();
+}
+
+TEST(ContribOpTest, LayerNormalization_Axis) {
+  // normalize over the last two dimensions
+  OpTester test("LayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("axis", 1);
+  test.AddInput<float>("X", {1, 2, 2}, {1.f, 1.f, 3.f, 3.f});
+  test.AddInput<float>("scale", {2, 2}, {1.f, 1.f, 1.f, 1.f});
+  test.AddInput<float>("B", {2, 2}, {0.f, 0.f, 0.f, 0.f});
+  test.AddOutput<float>("Y", {1, 2, 2}, {-0.999995f, -0.999995f, 0.999995f, 0.999995f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -180,6 +180,52 @@ TEST(ContribOpTest, StringNormalizerTest) {
     test.Run(OpTester::ExpectResult::kExpectSuccess);
   }
 
+  // - case-INSENSETIVE approach
+  // - stopwords given in a different case than the input, including non-ascii
+  // - LOWER, strings longer than a machine word and mappings that shrink
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "LOWER", false, {u8"MONDAY", u8"ПОНЕДЕЛЬНИК"}, "");
+    std::vector<int64_t> dims{5};
+    std::vector<std::string> input = {std::string(u8"Monday"),
+                                      std::string(u8"понедельник"),
+                                      std::string(u8"The Quick Brown Fox Jumps Over The Lazy Dog"),
+                                      std::string(u8"ΆΘΗΝΑ Ÿ İ Ａ"),
+                                      std::string(u8"[@Z`{]")};
+    test.AddInput<std::string>("T", dims, input);
+
+    std::vector<std::string> output = {std::string(u8"the quick brown fox jumps over the lazy dog"),
+                                       std::string(u8"άθηνα ÿ i ａ"),
+                                       std::string(u8"[@z`{]")};
+    test.AddOutput<std::string>("Y", {3}, output);
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+  // - case-INSENSETIVE approach
+  // - NONE keeps the original case of the strings that are not filtered
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "NONE", false, {u8"Été"}, "");
+    std::vector<int64_t> dims{1, 3};
+    std::vector<std::string> input = {std::string(u8"ÉTÉ"),
+                                      std::string(u8"Hiver"),
+                                      std::string(u8"été")};
+    test.AddInput<std::string>("T", dims, input);
+
+    std::vector<std::string> output = {std::string(u8"Hiver")};
+    test.AddOutput<std::string>("Y", {1, 1}, output);
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+  // Invalid utf8 input
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "UPPER", true, {}, "");
+    std::vector<int64_t> dims{2};
+    std::vector<std::string> input = {std::string("monday"), std::string("tuesday\xc3\x28")};
+    test.AddInput<std::string>("T", dims, input);
+    test.AddOutput<std::string>("Y", dims, input);
+    test.Run(OpTester::ExpectResult::kExpectFailure, "Input contains invalid utf8 chars");
+  }
+
   // Empty output case
   // - casesensitive approach
   // - filter out monday
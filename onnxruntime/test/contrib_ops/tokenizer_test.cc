@@ -3,7 +3,11 @@
 
 #include <codecvt>
 #include "gtest/gtest.h"
+#include "core/framework/packed_string_tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/test_environment.h"
 
 namespace onnxruntime {
 namespace test {
@@ -704,5 +708,141 @@ TEST(ContribOpTest, TokenizerWithSeparators_MixCharCommonPrefixC) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+TEST(ContribOpTest, TokenizerWithSeparators_MultiByteTokensNoMarkersNC) {
+  // Tokens with 1, 2 and 3 byte utf8 characters are cut from the input
+  // at the right byte offsets
+  // [N][C] dimensions
+  // Output [N][C][D]
+  std::vector<std::string> separators = {
+      u8" ",
+      u8"ñ"};
+
+  OpTester test("Tokenizer", opset_ver, domain);
+  InitTestAttr(test, false, separators, 1);
+
+  std::vector<int64_t> dims{2, 2};
+  std::vector<std::string> input{u8"中文 Абс", u8"añb 文", u8"Ко", u8" x中 ñ"};
+  test.AddInput<std::string>("T", dims, input);
+
+  std::vector<int64_t> output_dims(dims);
+  output_dims.push_back(int64_t(3));
+  std::vector<std::string> output{
+      u8"中文",
+      u8"Абс",
+      padval,
+      u8"a",
+      u8"b",
+      u8"文",
+      u8"Ко",
+      padval,
+      padval,
+      u8"x中",
+      padval,
+      padval,
+  };
+
+  test.AddOutput<std::string>("Y", output_dims, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(ContribOpTest, TokenizerWithSeparators_NonBmpCharsNoMarkersC) {
+  // 4 byte utf8 characters take a surrogate pair where wchar_t is 2 bytes wide
+  // and must still be cut at the right byte offsets
+  // [C] dimensions
+  // Output [C][D]
+  std::vector<std::string> separators = {
+      u8"-",
+      u8"\U0001F600"};
+
+  OpTester test("Tokenizer", opset_ver, domain);
+  InitTestAttr(test, false, separators, 1);
+
+  std::vector<int64_t> dims{2};
+  std::vector<std::string> input{u8"\U0001F642a-b\U0001F642", u8"x\U0001F600\U00020000y"};
+  test.AddInput<std::string>("T", dims, input);
+
+  std::vector<int64_t> output_dims(dims);
+  output_dims.push_back(int64_t(2));
+  std::vector<std::string> output{
+      u8"\U0001F642a",
+      u8"b\U0001F642",
+      u8"x",
+      u8"\U00020000y",
+  };
+
+  test.AddOutput<std::string>("Y", output_dims, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+static std::vector<std::string> Unpack(const MLValue& value) {
+  const auto& strings = value.Get<PackedStringTensor>();
+  std::vector<std::string> result;
+  for (size_t i = 0; i < strings.Size(); ++i) {
+    result.emplace_back(strings.Data(i), strings.Length(i));
+  }
+  return result;
+}
+
+TEST(ContribOpTest, TokenizerPackedStrings) {
+  // The Tokenizer takes and produces the packed strings, Identity doesn't and they're converted for it
+  for (bool converted : {false, true}) {
+    SessionOptions so;
+    so.session_logid = "ContribOpTest.TokenizerPackedStrings";
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+
+    std::unordered_map<std::string, int> domain_to_version = {{onnxruntime::kOnnxDomain, 9}, {domain, opset_ver}};
+    Model model("TokenizerPackedStrings", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version);
+    auto& graph = model.MainGraph();
+
+    ONNX_NAMESPACE::TypeProto string_tensor(*DataTypeImpl::GetTensorType<std::string>()->GetTypeProto());
+    auto& input_arg = graph.GetOrCreateNodeArg("T", &string_tensor);
+    auto& tokenizer = graph.AddNode("tokenizer", "Tokenizer", "", {&input_arg},
+                                    {&graph.GetOrCreateNodeArg("Y", &string_tensor)}, nullptr, domain);
+    tokenizer.AddAttribute("mark", int64_t{0});
+    tokenizer.AddAttribute("separators", std::vector<std::string>{""});
+    tokenizer.AddAttribute("pad_value", padval);
+    tokenizer.AddAttribute("mincharnum", int64_t{1});
+    std::vector<std::string> output_names{"Y"};
+    if (converted) {
+      graph.AddNode("identity", "Identity", "", {&input_arg}, {&graph.GetOrCreateNodeArg("Z", &string_tensor)});
+      output_names.push_back("Z");
+    }
+    auto status = graph.Resolve();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    std::stringstream serialized_model;
+    EXPECT_TRUE(model.ToProto().SerializeToOstream(&serialized_model));
+    EXPECT_TRUE(session_object.Load(serialized_model).IsOK());
+    status = session_object.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    // {"abc", "de"} in buffers of the caller
+    char bytes[] = "abcde";
+    size_t offsets[] = {0, 3};
+    auto packed_type = DataTypeImpl::GetType<PackedStringTensor>();
+    auto input = std::make_unique<PackedStringTensor>();
+    input->Reset(TensorShape({2}), bytes, 5, offsets);
+    MLValue feed;
+    feed.Init(input.release(), packed_type, packed_type->GetDeleteFunc());
+    NameMLValMap feeds{{"T", feed}};
+
+    std::vector<MLValue> fetches(output_names.size());
+    for (auto& fetch : fetches) {
+      fetch.Init(new PackedStringTensor(), packed_type, packed_type->GetDeleteFunc());
+    }
+    status = session_object.Run(feeds, output_names, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    ASSERT_EQ(packed_type, fetches[0].Type());
+    EXPECT_EQ(TensorShape({2, 3}), fetches[0].Get<PackedStringTensor>().Shape());
+    EXPECT_EQ(Unpack(fetches[0]), (std::vector<std::string>{"a", "b", "c", "d", "e", padval}));
+    if (converted) {
+      ASSERT_EQ(packed_type, fetches[1].Type());
+      EXPECT_EQ(Unpack(fetches[1]), (std::vector<std::string>{"abc", "de"}));
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
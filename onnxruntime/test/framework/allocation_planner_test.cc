@@ -146,9 +146,11 @@ class PlannerTest : public ::testing::Test {
 
   // some standard components used to build test-cases:
   Type float_type_;
+  Type string_type_;
 
   std::unique_ptr<::onnxruntime::KernelDef> std_kernel_;       // a unary kernel with no-aliasing and no-in-place
   std::unique_ptr<::onnxruntime::KernelDef> in_place_kernel_;  // a unary kernel with in-place
+  std::unique_ptr<::onnxruntime::KernelDef> concat_kernel_;    // a kernel with no-aliasing that takes any type
 
   std::unordered_map<std::string, onnxruntime::NodeArg*> name_to_arg_;
   std::vector<std::unique_ptr<UnaryNode>> nodes_;
@@ -163,6 +165,8 @@ class PlannerTest : public ::testing::Test {
   PlannerTest() : model_("test"), graph_{model_.MainGraph()}, state_{execution_providers_} {
     std_kernel_ = KernelDefBuilder().SetName("Transpose").Build();
     in_place_kernel_ = KernelDefBuilder().SetName("Clip").MayInplace(0, 0).Build();
+    concat_kernel_ = KernelDefBuilder().SetName("Concat").Build();
+    string_type_.value.mutable_tensor_type()->set_elem_type(TensorProto_DataType_STRING);
     CPUExecutionProviderInfo epi;
     auto execution_provider = std::make_unique<CPUExecutionProvider>(epi);
     execution_providers_.Add("CPUExecutionProvider", std::move(execution_provider));
@@ -176,6 +180,11 @@ class PlannerTest : public ::testing::Test {
     return (name_to_arg_[name] = &graph_.GetOrCreateNodeArg(name, &float_type_.value));
   }
 
+  // Creates a string tensor; must be called before the tensor is used by any node
+  onnxruntime::NodeArg* StringArg(const std::string& name) {
+    return (name_to_arg_[name] = &graph_.GetOrCreateNodeArg(name, &string_type_.value));
+  }
+
   onnxruntime::Node* AddNode(::onnxruntime::KernelDef& kernel_def, std::string& input, std::string& output) {
     auto node = std::make_unique<UnaryNode>(graph_, kernel_def.OpName(), Arg(input), Arg(output));
     auto* p_node = node->p_node;
@@ -193,6 +202,13 @@ class PlannerTest : public ::testing::Test {
     return AddNode(*in_place_kernel_, input, output);
   }
 
+  // A single-input Concat, for tensors of types Transpose is not implemented for
+  onnxruntime::Node* AddConcatNode(std::string& input, std::string& output) {
+    auto p_node = AddNode(*concat_kernel_, input, output);
+    p_node->AddAttribute("axis", static_cast<int64_t>(0));
+    return p_node;
+  }
+
   void BindKernel(onnxruntime::Node* p_node, ::onnxruntime::KernelDef& kernel_def) {
     auto info = std::make_unique<OpKernelInfo>(*p_node, kernel_def, *execution_providers_.Get(*p_node), state_);
     auto dummy = std::make_unique<DummyOpKernel>(*info);
@@ -247,6 +263,14 @@ class PlannerTest : public ::testing::Test {
     EXPECT_EQ(plan_->allocation_plan[id].alloc_kind, kind) << "Error in allocation kind for " << name;
   }
 
+  void CheckReusedBuffer(const std::string& name, const std::string& reused) {
+    int id, reused_id;
+    index(name, id);
+    index(reused, reused_id);
+    EXPECT_EQ(plan_->allocation_plan[id].alloc_kind, AllocKind::kReuse) << "Error in allocation kind for " << name;
+    EXPECT_EQ(plan_->allocation_plan[id].reused_buffer, reused_id) << "Error in reused buffer for " << name;
+  }
+
   void CheckFreed(int step_number, std::initializer_list<std::string> freed_items) {
     // create set and check equality
     std::unordered_set<int> expected;
@@ -409,6 +433,109 @@ TEST_F(PlannerTest, InPlaceSizeMismatchTest) {
   CheckFreed(3, {X2});
 }
 
+// SymbolicShapeReuseTest: Check that buffers are reused across symbolic shapes whose sizes are
+// provably large enough, and not otherwise.
+TEST_F(PlannerTest, SymbolicShapeReuseTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6"), X7("X7");
+
+  // graph structure:
+  AddNormalNode(X1, X2);
+  AddNormalNode(X2, X3);
+  AddNormalNode(X3, X4);
+  AddNormalNode(X4, X5);
+  AddNormalNode(X5, X6);
+  AddNormalNode(X6, X7);
+
+  // simulate shape-inference results:
+  Shape batch_seq{"batch", "seq"};
+  Shape seq_batch{"seq", "batch"};
+  Shape batch_4{"batch"};
+  batch_4.value.add_dim()->set_dim_value(4);
+  Shape batch_2{"batch"};
+  batch_2.value.add_dim()->set_dim_value(2);
+  Shape batch_seq_2{"batch", "seq"};
+  batch_seq_2.value.add_dim()->set_dim_value(2);
+  SetShape({{X1, &batch_seq.value}, {X2, &batch_seq.value}, {X3, &batch_4.value}, {X4, &seq_batch.value},
+            {X5, &batch_2.value}, {X6, &batch_seq_2.value}, {X7, &batch_seq_2.value}});
+
+  CreatePlan();
+
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckReusedBuffer(X4, X2);  // batch * seq elements either way
+  CheckReusedBuffer(X5, X3);  // batch * 2 fits into batch * 4
+  CheckAllocKind(X6, AllocKind::kAllocate);  // batch * seq * 2 does not fit into batch * seq
+  CheckAllocKind(X7, AllocKind::kAllocateOutput);
+}
+
+// BestFitReuseTest: Check that the smallest sufficient free buffer is reused rather than the most recent one.
+TEST_F(PlannerTest, BestFitReuseTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6");
+
+  // graph structure:
+  AddNormalNode(X1, X2);
+  AddNormalNode(X2, X3);
+  AddNormalNode(X3, X4);
+  AddNormalNode(X4, X5);
+  AddNormalNode(X5, X6);
+
+  // simulate shape-inference results:
+  Shape small{"batch"};
+  small.value.add_dim()->set_dim_value(2);
+  Shape medium{"batch"};
+  medium.value.add_dim()->set_dim_value(8);
+  Shape large{"batch"};
+  large.value.add_dim()->set_dim_value(16);
+  SetShape({{X1, &small.value}, {X2, &small.value}, {X3, &medium.value}, {X4, &large.value},
+            {X5, &small.value}, {X6, &small.value}});
+
+  CreatePlan();
+
+  // X2 and then X3 are freed before X5 is defined; X3 is the more recent but X2 is the exact fit.
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(X4, AllocKind::kAllocate);
+  CheckReusedBuffer(X5, X2);
+  CheckAllocKind(X6, AllocKind::kAllocateOutput);
+}
+
+// StringReuseTest: Check that string and non-string tensors never share a buffer, even when their sizes in
+// bytes are the same, while tensors of the same element type still do.
+TEST_F(PlannerTest, StringReuseTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), S1("S1"), S2("S2"), S3("S3"), S4("S4"), Y1("Y1"), Y2("Y2"), Y3("Y3");
+  StringArg(S1);
+  StringArg(S2);
+  StringArg(S3);
+  StringArg(S4);
+
+  // graph structure: three independent chains, the one added last runs first
+  AddNormalNode(Y1, Y2);  // float, runs after the string chain
+  AddNormalNode(Y2, Y3);
+  AddConcatNode(S1, S2);  // string, runs after the first float chain
+  AddConcatNode(S2, S3);
+  AddConcatNode(S3, S4);
+  AddNormalNode(X1, X2);  // float, runs first
+  AddNormalNode(X2, X3);
+
+  // simulate shape-inference results: float[batch, n] takes as many bytes as string[batch]
+  Shape strings{"batch"};
+  Shape floats{"batch"};
+  floats.value.add_dim()->set_dim_value(static_cast<int64_t>(sizeof(std::string) / sizeof(float)));
+  SetShape({{X1, &floats.value}, {X2, &floats.value}, {X3, &floats.value},
+            {S1, &strings.value}, {S2, &strings.value}, {S3, &strings.value}, {S4, &strings.value},
+            {Y1, &floats.value}, {Y2, &floats.value}, {Y3, &floats.value}});
+
+  CreatePlan();
+
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(S2, AllocKind::kAllocate);  // X2 is free but holds floats
+  CheckAllocKind(S3, AllocKind::kAllocate);
+  CheckReusedBuffer(Y2, X2);  // S2 and S3 were freed more recently but hold strings
+}
+
 // Test operator<< to output details of an allocation & execution plan.
 TEST_F(PlannerTest, PlanOutputTest) {
   // tensor variables:
@@ -0,0 +1,143 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/batching_session.h"
+
+#include <future>
+#include <sstream>
+#include <thread>
+
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "test/framework/test_utils.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+// Y = X * X, with a free shape for X.
+static void LoadSquareModel(InferenceSession& session_object) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& y = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  graph.AddNode("node1", "Mul", "Mul", {&x, &x}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::stringstream s1;
+  model.ToProto().SerializeToOstream(&s1);
+  ASSERT_TRUE(session_object.Load(s1).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+}
+
+static NameMLValMap CreateFeeds(const std::vector<int64_t>& dims, const std::vector<float>& values) {
+  MLValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims, values, &ml_value);
+  return {{"X", ml_value}};
+}
+
+static void VerifySquares(const std::vector<MLValue>& fetches,
+                          const std::vector<int64_t>& dims, const std::vector<float>& values) {
+  ASSERT_EQ(fetches.size(), 1u);
+  const Tensor& tensor = fetches[0].Get<Tensor>();
+  ASSERT_EQ(tensor.Shape(), TensorShape(dims));
+  const float* data = tensor.Data<float>();
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(data[i], values[i] * values[i]);
+  }
+}
+
+TEST(BatchingSessionTest, ConcurrentRequests) {
+  SessionOptions so;
+  InferenceSession session_object{so};
+  LoadSquareModel(session_object);
+
+  BatchingSessionOptions bo;
+  bo.max_batch_size = 8;
+  bo.max_batch_delay = std::chrono::milliseconds(100);
+  bo.batch_buckets = {4, 8};
+  BatchingSession batching_session{session_object, bo};
+
+  // requests of 1 to 3 rows, batched together and padded to a bucket
+  std::vector<std::future<void>> results;
+  for (int i = 0; i < 6; ++i) {
+    results.push_back(std::async(std::launch::async, [&batching_session, i]() {
+      int64_t num_rows = i % 3 + 1;
+      std::vector<float> values(num_rows * 2);
+      for (size_t j = 0; j < values.size(); ++j) {
+        values[j] = static_cast<float>(i * 10 + j);
+      }
+      std::vector<MLValue> fetches;
+      Status status = batching_session.Run(CreateFeeds({num_rows, 2}, values), {"Y"}, &fetches);
+      ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+      VerifySquares(fetches, {num_rows, 2}, values);
+    }));
+  }
+  for (auto& result : results) {
+    result.get();
+  }
+}
+
+TEST(BatchingSessionTest, IncompatibleShapesRunInSeparateBatches) {
+  SessionOptions so;
+  InferenceSession session_object{so};
+  LoadSquareModel(session_object);
+
+  BatchingSessionOptions bo;
+  bo.max_batch_delay = std::chrono::milliseconds(10);
+  BatchingSession batching_session{session_object, bo};
+
+  auto run = [&batching_session](std::vector<int64_t> dims, std::vector<float> values) {
+    std::vector<MLValue> fetches;
+    Status status = batching_session.Run(CreateFeeds(dims, values), {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    VerifySquares(fetches, dims, values);
+  };
+  auto narrow = std::async(std::launch::async, run, std::vector<int64_t>{1, 2}, std::vector<float>{1.f, 2.f});
+  auto wide = std::async(std::launch::async, run, std::vector<int64_t>{1, 3}, std::vector<float>{3.f, 4.f, 5.f});
+  narrow.get();
+  wide.get();
+}
+
+TEST(BatchingSessionTest, RequestTimeout) {
+  SessionOptions so;
+  InferenceSession session_object{so};
+  LoadSquareModel(session_object);
+
+  // the batch waits longer for more rows than the request may stay queued
+  BatchingSessionOptions bo;
+  bo.max_batch_delay = std::chrono::seconds(10);
+  bo.request_timeout = std::chrono::milliseconds(10);
+  BatchingSession batching_session{session_object, bo};
+
+  std::vector<MLValue> fetches;
+  Status status = batching_session.Run(CreateFeeds({1, 2}, {1.f, 2.f}), {"Y"}, &fetches);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_NE(status.ErrorMessage().find("timed out"), std::string::npos);
+
+  // a full batch does not wait
+  status = batching_session.Run(CreateFeeds({32, 1}, std::vector<float>(32, 2.f)), {"Y"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  VerifySquares(fetches, {32, 1}, std::vector<float>(32, 2.f));
+}
+
+TEST(BatchingSessionTest, InvalidFeeds) {
+  SessionOptions so;
+  InferenceSession session_object{so};
+  LoadSquareModel(session_object);
+
+  BatchingSession batching_session{session_object, BatchingSessionOptions{}};
+  std::vector<MLValue> fetches;
+  Status status = batching_session.Run(CreateFeeds({}, {1.f}), {"Y"}, &fetches);
+  EXPECT_EQ(status.Code(), common::INVALID_ARGUMENT);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -5,6 +5,7 @@
 #include <math.h> //for fabs
 
 #include "core/framework/data_types.h"
+#include "core/framework/packed_string_tensor.h"
 #include "core/graph/onnx_protobuf.h"
 #include "gtest/gtest.h"
 
@@ -352,6 +353,46 @@ TEST_F(DataTypeTest, VectorMapInt64ToFloatTest) {
   EXPECT_FALSE(DataTypeImpl::GetType<VectorMapInt64ToFloat>()->IsCompatible(tensor_type));
 }
 
+TEST_F(DataTypeTest, ColumnarMapSequenceTest) {
+  TypeProto type_proto;
+  type_proto.mutable_sequence_type()->mutable_elem_type()->mutable_map_type()->set_key_type(TensorProto_DataType_INT64);
+  type_proto.mutable_sequence_type()->mutable_elem_type()->mutable_map_type()->mutable_value_type()->mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  EXPECT_TRUE(DataTypeImpl::GetType<ColumnarMapInt64ToFloat>()->IsCompatible(type_proto));
+  EXPECT_FALSE(DataTypeImpl::GetType<ColumnarMapStringToFloat>()->IsCompatible(type_proto));
+  // the columnar form is only an alternative representation, the proto maps to the vector of maps
+  EXPECT_EQ(DataTypeImpl::TypeFromProto(type_proto), DataTypeImpl::GetType<VectorMapInt64ToFloat>());
+
+  ColumnarMapInt64ToFloat seq;
+  seq.Reset(std::make_shared<const std::vector<int64_t>>(std::vector<int64_t>{20, 10}), 2);
+  seq.MutableValues() = {1.f, 2.f, 3.f, 4.f};
+  EXPECT_EQ(seq.size(), 2u);
+  EXPECT_EQ(seq.Row(1)[0], 3.f);
+  EXPECT_EQ(seq.MapAt(0), (MapInt64ToFloat{{10, 2.f}, {20, 1.f}}));
+  EXPECT_EQ(seq.ToMaps(), (VectorMapInt64ToFloat{{{10, 2.f}, {20, 1.f}}, {{10, 4.f}, {20, 3.f}}}));
+}
+
+TEST_F(DataTypeTest, PackedStringTensorTest) {
+  TypeProto type_proto;
+  type_proto.mutable_tensor_type()->set_elem_type(TensorProto_DataType_STRING);
+
+  EXPECT_TRUE(DataTypeImpl::GetType<PackedStringTensor>()->IsCompatible(type_proto));
+  type_proto.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  EXPECT_FALSE(DataTypeImpl::GetType<PackedStringTensor>()->IsCompatible(type_proto));
+  // the packed form is only an alternative representation, the proto maps to the tensor
+  type_proto.mutable_tensor_type()->set_elem_type(TensorProto_DataType_STRING);
+  EXPECT_EQ(DataTypeImpl::TypeFromProto(type_proto), DataTypeImpl::GetTensorType<std::string>());
+
+  char bytes[] = "abde";
+  size_t offsets[] = {0, 2, 2};
+  PackedStringTensor strings;
+  strings.Reset(TensorShape({3}), bytes, 4, offsets);
+  EXPECT_EQ(strings.Size(), 3u);
+  EXPECT_EQ(std::string(strings.Data(0), strings.Length(0)), "ab");
+  EXPECT_EQ(strings.Length(1), 0u);
+  EXPECT_EQ(std::string(strings.Data(2), strings.Length(2)), "de");
+}
+
 TEST_F(DataTypeTest, BFloat16Test) {
   // Test data type
   {
@@ -261,5 +261,119 @@ TEST(ExecutionFrameTest, MemPatternTest) {
   EXPECT_EQ(p->GetBlock(3)->offset_, 0);
   EXPECT_EQ(p->GetBlock(4)->offset_, 64);
 }
+
+TEST(ExecutionFrameTest, RebindFeedsWithGeneratedPatternTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def1("X1", &tensor_float),
+      input_def2("X2", &tensor_float),
+      input_def3("X3", &tensor_float),
+      gemm1_out_def("T1", &tensor_float),
+      gemm2_out_def("T2", &tensor_float),
+      clip_out_def("T3", &tensor_float);
+
+  graph.AddNode("node1", "MatMul", "gemm1", ArgMap{&input_def1, &input_def2}, ArgMap{&gemm1_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "MatMul", "gemm2", ArgMap{&gemm1_out_def, &input_def3}, ArgMap{&gemm2_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node3", "Clip", "clip1", ArgMap{&gemm2_out_def}, ArgMap{&clip_out_def})
+      .SetExecutionProviderType(xp_type);
+
+  auto status = graph.Resolve();
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  KernelRegistryManager kernel_registry_manager;
+  kernel_registry_manager.RegisterKernelRegistry(cpu_xp->GetKernelRegistry(), KernelRegistryPriority::LowPriority);
+
+  ExecutionProviders execution_providers;
+  execution_providers.Add(xp_type, std::move(cpu_xp));
+
+  //1. prepare input
+  SessionState state{execution_providers};
+  state.SetGraphViewer(std::make_unique<GraphViewer>(graph));
+
+  MLValueNameIdxMap& mlvalue_name_idx_map{state.GetMLValueNameIdxMap()};
+
+  mlvalue_name_idx_map.Add("X1");
+  mlvalue_name_idx_map.Add("X2");
+  mlvalue_name_idx_map.Add("X3");
+  mlvalue_name_idx_map.Add("T1");
+  mlvalue_name_idx_map.Add("T2");
+  mlvalue_name_idx_map.Add("T3");
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->GetAllocator(0, OrtMemTypeDefault);
+
+  MLValue v1, v2, v3;
+  CreateMLValue<float>(cpu_allocator,
+                       std::vector<int64_t>{1, 2},
+                       std::vector<float>{1.0f, 1.0f}, &v1);
+  CreateMLValue<float>(cpu_allocator,
+                       std::vector<int64_t>{2, 2},
+                       std::vector<float>(4, 1.0f), &v2);
+  CreateMLValue<float>(cpu_allocator,
+                       std::vector<int64_t>{2, 3},
+                       std::vector<float>(6, 1.0f), &v3);
+
+  std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan = std::make_unique<SequentialExecutionPlan>();
+  status = SequentialPlanner::CreatePlan(GraphViewer(graph), {}, execution_providers, kernel_registry_manager, mlvalue_name_idx_map,
+                                         p_seq_exec_plan);
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  state.SetExecutionPlan(std::move(p_seq_exec_plan));
+
+  // bind by index as a caller executing the graph repeatedly would
+  std::vector<int> feed_mlvalue_idxs{0, 1, 2};
+  std::vector<int> fetch_mlvalue_idxs{5};
+  vector<MLValue> outputs(1);
+  ExecutionFrame frame(feed_mlvalue_idxs, {v1, v2, v3}, fetch_mlvalue_idxs, outputs, state);
+  EXPECT_TRUE(frame.HasPlan());
+
+  // first execution traces the allocations
+  status = frame.AllocateMLValueTensorSelfOwnBuffer(3,
+                                                    DataTypeImpl::GetType<float>(),
+                                                    cpu_allocator->Info(),
+                                                    TensorShape(std::vector<int64_t>{2, 2}));
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  status = frame.AllocateMLValueTensorSelfOwnBuffer(4,
+                                                    DataTypeImpl::GetType<float>(),
+                                                    cpu_allocator->Info(),
+                                                    TensorShape(std::vector<int64_t>{2, 3}));
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_TRUE(frame.ReleaseMLValue(3).IsOK());
+  EXPECT_TRUE(frame.ReleaseMLValue(4).IsOK());
+
+  status = frame.UseGeneratedPatterns();
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_FALSE(frame.HasPlan());
+
+  // second execution with new feeds of the same shapes is placed in the pre-allocated buffer
+  MLValue v4;
+  CreateMLValue<float>(cpu_allocator,
+                       std::vector<int64_t>{1, 2},
+                       std::vector<float>{2.0f, 2.0f}, &v4);
+  frame.UpdateFeedsAndFetches(feed_mlvalue_idxs, {v4, v2, v3}, fetch_mlvalue_idxs, outputs);
+  EXPECT_EQ(frame.GetMLValue(0).Get<Tensor>().Data<float>()[0], 2.0f);
+
+  status = frame.AllocateMLValueTensorSelfOwnBuffer(3,
+                                                    DataTypeImpl::GetType<float>(),
+                                                    cpu_allocator->Info(),
+                                                    TensorShape(std::vector<int64_t>{2, 2}));
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  status = frame.AllocateMLValueTensorSelfOwnBuffer(4,
+                                                    DataTypeImpl::GetType<float>(),
+                                                    cpu_allocator->Info(),
+                                                    TensorShape(std::vector<int64_t>{2, 3}));
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  auto* t1 = static_cast<const char*>(frame.GetMLValue(3).Get<Tensor>().DataRaw());
+  auto* t2 = static_cast<const char*>(frame.GetMLValue(4).Get<Tensor>().DataRaw());
+  EXPECT_EQ(t2 - t1, 64);  // offsets of the generated pattern
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -5,7 +5,9 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <cstdio>
 #include <functional>
+#include <future>
 #include <iterator>
 #include <thread>
 #include <fstream>
@@ -14,10 +16,12 @@
 #include "core/platform/env.h"
 #include "core/common/logging/logging.h"
 #include "core/common/profiler.h"
+#include "core/framework/environment.h"
 #include "core/framework/execution_provider.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/compute_capability.h"
 #include "core/graph/model.h"
@@ -26,6 +30,7 @@
 #include "core/providers/cpu/math/element_wise_ops.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/session/IOBinding.h"
+#include "core/session/optimized_model_cache.h"
 #include "test/capturing_sink.h"
 #include "test/test_environment.h"
 #include "test/providers/provider_test_utils.h"
@@ -317,6 +322,284 @@ TEST(InferenceSessionTests, NoTimeout) {
   RunModel(session_object, run_options);
 }
 
+TEST(InferenceSessionTests, Clone) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.Clone";
+
+  std::unique_ptr<InferenceSession> clone;
+  {
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+    ASSERT_FALSE(session_object.Clone(so, &clone).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    SessionOptions clone_so;
+    clone_so.enable_sequential_execution = false;  // ignored, the plan of session_object is shared
+    clone_so.session_logid = "InferenceSessionTests.Clone.Clone";
+    Status st = session_object.Clone(clone_so, &clone);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+    RunOptions run_options;
+    RunModel(session_object, run_options);
+    RunModel(*clone, run_options);
+  }
+
+  // the clone keeps the weights and kernels alive
+  RunOptions run_options;
+  RunModel(*clone, run_options);
+  ASSERT_EQ(clone->GetModelInputs().second->size(), 1u);
+
+  std::unique_ptr<InferenceSession> clone_of_clone;
+  ASSERT_TRUE(clone->Clone(so, &clone_of_clone).IsOK());
+  clone.reset();
+  RunModel(*clone_of_clone, run_options);
+}
+
+TEST(InferenceSessionTests, ShareInitializers) {
+  auto store = Environment::GetSharedInitializerStore();
+  ASSERT_NE(store, nullptr);
+  size_t num_shared = store->Size();
+
+  SessionOptions so;
+  so.share_initializers = true;
+  {
+    InferenceSession session_object_1{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object_1.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object_1.Initialize().IsOK());
+    // the weight of mul_1 is added once
+    EXPECT_EQ(store->Size(), num_shared + 1);
+
+    InferenceSession session_object_2{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object_2.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object_2.Initialize().IsOK());
+    EXPECT_EQ(store->Size(), num_shared + 1);
+
+    RunOptions run_options;
+    RunModel(session_object_1, run_options);
+    RunModel(session_object_2, run_options);
+  }
+  EXPECT_EQ(store->Size(), num_shared);
+}
+
+TEST(InferenceSessionTests, OptimizedModelCache) {
+  SessionOptions so;
+  so.optimized_model_cache_dir = ".";
+
+  auto capturing_sink = new CapturingSink();
+  auto logging_manager = std::make_unique<logging::LoggingManager>(
+      std::unique_ptr<ISink>(capturing_sink), logging::Severity::kINFO, false, LoggingManager::InstanceType::Temporal);
+  auto find_key = [capturing_sink](const std::string& message) {
+    for (const auto& msg : capturing_sink->Messages()) {
+      auto pos = msg.find(message);
+      if (pos != std::string::npos) {
+        return msg.substr(pos + message.size());
+      }
+    }
+    return std::string();
+  };
+
+  RunOptions run_options;
+  InferenceSession session_object_1{so, logging_manager.get()};
+  ASSERT_TRUE(session_object_1.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object_1.Initialize().IsOK());
+  RunModel(session_object_1, run_options);
+  const std::string key = find_key("Optimized model cached under ");
+  ASSERT_FALSE(key.empty());
+
+  // the second session loads the optimized model instead of running the transformers
+  InferenceSession session_object_2{so, logging_manager.get()};
+  ASSERT_TRUE(session_object_2.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object_2.Initialize().IsOK());
+  RunModel(session_object_2, run_options);
+  EXPECT_EQ(find_key("Using the optimized model cached under "), key);
+  EXPECT_EQ(session_object_2.GetModelInputs().second->size(), session_object_1.GetModelInputs().second->size());
+
+  std::remove(("./" + key + ".onnx").c_str());
+}
+
+TEST(InferenceSessionTests, OptimizedModelCacheFingerprints) {
+  std::ifstream model_file(MODEL_URI, std::ios::binary);
+  const std::string model_bytes((std::istreambuf_iterator<char>(model_file)), std::istreambuf_iterator<char>());
+  ASSERT_FALSE(model_bytes.empty());
+
+  const std::string copy_path = "optimized_model_cache_fingerprint.onnx";
+  auto write_copy = [&copy_path, &model_bytes](const std::string& path) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << model_bytes;
+    std::remove(copy_path.c_str());
+    ASSERT_EQ(std::rename(path.c_str(), copy_path.c_str()), 0);
+  };
+  write_copy(copy_path + ".1");
+
+  std::string fingerprint_1, fingerprint_2;
+  ASSERT_TRUE(OptimizedModelCache::GetFileFingerprint(copy_path, fingerprint_1).IsOK());
+  ASSERT_TRUE(OptimizedModelCache::GetFileFingerprint(copy_path, fingerprint_2).IsOK());
+  EXPECT_EQ(fingerprint_1, fingerprint_2);
+
+#ifndef _WIN32
+  // a model replaced by another file at the same path with the same size is not served the stale entry,
+  // the new file has another inode even if written within the same second
+  write_copy(copy_path + ".2");
+  std::string fingerprint_3;
+  ASSERT_TRUE(OptimizedModelCache::GetFileFingerprint(copy_path, fingerprint_3).IsOK());
+  EXPECT_NE(fingerprint_1, fingerprint_3);
+  EXPECT_NE(OptimizedModelCache::GetKey(fingerprint_1, "settings"), OptimizedModelCache::GetKey(fingerprint_3, "settings"));
+#endif
+  std::remove(copy_path.c_str());
+
+  const std::string bytes_fingerprint = OptimizedModelCache::GetBytesFingerprint(model_bytes.data(), model_bytes.size());
+  EXPECT_EQ(bytes_fingerprint, OptimizedModelCache::GetBytesFingerprint(model_bytes.data(), model_bytes.size()));
+  EXPECT_NE(bytes_fingerprint, OptimizedModelCache::GetBytesFingerprint(model_bytes.data(), model_bytes.size() - 1));
+  EXPECT_NE(OptimizedModelCache::GetKey(bytes_fingerprint, "settings"),
+            OptimizedModelCache::GetKey(bytes_fingerprint, "other settings"));
+
+  std::string missing;
+  EXPECT_FALSE(OptimizedModelCache::GetFileFingerprint("testdata/missing_model.onnx", missing).IsOK());
+}
+
+// Y = X + W0 + ... + W(num_nodes-1), followed by an LRN whose kernel fails to construct if invalid_kernel.
+static ONNX_NAMESPACE::ModelProto CreateAddChainModel(int num_nodes, bool invalid_kernel) {
+  Model model("AddChain");
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (int64_t dim : {1, 2, 1, 1}) {
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+
+  NodeArg* sum = &graph.GetOrCreateNodeArg("X", &float_tensor);
+  for (int i = 0; i < num_nodes; ++i) {
+    TensorProto weight;
+    for (int64_t dim : {1, 2, 1, 1}) {
+      weight.add_dims(dim);
+    }
+    weight.set_data_type(TensorProto_DataType_FLOAT);
+    weight.add_float_data(static_cast<float>(i));
+    weight.add_float_data(static_cast<float>(2 * i));
+    weight.set_name("W" + std::to_string(i));
+    graph.AddInitializedTensor(weight);
+
+    auto& output = graph.GetOrCreateNodeArg(i == num_nodes - 1 && !invalid_kernel ? "Y" : "sum" + std::to_string(i),
+                                            &float_tensor);
+    graph.AddNode("add" + std::to_string(i), "Add", "", {sum, &graph.GetOrCreateNodeArg(weight.name(), nullptr)},
+                  {&output});
+    sum = &output;
+  }
+
+  if (invalid_kernel) {
+    // the CPU kernel of LRN only accepts an odd size
+    auto& lrn = graph.AddNode("lrn", "LRN", "", {sum}, {&graph.GetOrCreateNodeArg("Y", &float_tensor)});
+    lrn.AddAttribute("size", int64_t(2));
+  }
+
+  auto status = graph.Resolve();
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  return model.ToProto();
+}
+
+// The initializers and kernels are created on the session thread pool, or on a pool created for the
+// initialization of sessions running sequentially.
+TEST(InferenceSessionTests, InitializeOnThreadPool) {
+  constexpr int num_nodes = 32;
+  std::stringstream model_stream;
+  CreateAddChainModel(num_nodes, false).SerializeToOstream(&model_stream);
+  const std::string model_bytes = model_stream.str();
+
+  std::vector<float> values_x = {1.0f, 2.0f};
+  std::vector<float> expected_values_y = values_x;
+  for (int i = 0; i < num_nodes; ++i) {
+    expected_values_y[0] += static_cast<float>(i);
+    expected_values_y[1] += static_cast<float>(2 * i);
+  }
+
+  for (bool sequential : {true, false}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.InitializeOnThreadPool";
+    so.enable_sequential_execution = sequential;
+    so.session_thread_pool_size = 4;
+
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(model_bytes.data(), static_cast<int>(model_bytes.size())).IsOK());
+    auto status = session_object.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    MLValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1, 2, 1, 1}, values_x,
+                         &ml_value);
+    NameMLValMap feeds{{"X", ml_value}};
+    std::vector<MLValue> fetches;
+    status = session_object.Run(feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    VerifyOutputs(fetches, {1, 2, 1, 1}, expected_values_y);
+  }
+}
+
+TEST(InferenceSessionTests, InitializeOnThreadPoolKernelFailure) {
+  std::stringstream model_stream;
+  CreateAddChainModel(32, true).SerializeToOstream(&model_stream);
+  const std::string model_bytes = model_stream.str();
+
+  for (bool sequential : {true, false}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.InitializeOnThreadPoolKernelFailure";
+    so.enable_sequential_execution = sequential;
+    so.session_thread_pool_size = 4;
+
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(model_bytes.data(), static_cast<int>(model_bytes.size())).IsOK());
+    // the failure of the task constructing the kernel is returned once the other tasks are done
+    auto status = session_object.Initialize();
+    ASSERT_FALSE(status.IsOK());
+    EXPECT_NE(status.ErrorMessage().find("size_ % 2 == 1"), std::string::npos) << status.ErrorMessage();
+
+    NameMLValMap feeds;
+    std::vector<MLValue> fetches;
+    EXPECT_FALSE(session_object.Run(feeds, {"Y"}, &fetches).IsOK());
+  }
+}
+
+TEST(InferenceSessionTests, RunAsync) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RunAsync";
+  so.async_run_thread_pool_size = 2;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+
+  // runs cannot be queued before the session is initialized
+  ASSERT_FALSE(session_object.RunAsync({}, {"Y"}, [](const Status&, std::vector<MLValue>&) {}).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  MLValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x, &ml_value);
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("X", ml_value));
+
+  constexpr int num_runs = 8;
+  std::vector<std::promise<std::vector<MLValue>>> results(num_runs);
+  for (auto& result : results) {
+    auto st = session_object.RunAsync(feeds, {"Y"}, [&result](const Status& status, std::vector<MLValue>& fetches) {
+      EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+      result.set_value(fetches);
+    });
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  }
+
+  for (auto& result : results) {
+    VerifyOutputs(result.get_future().get(), {3, 2}, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+  }
+
+  // a failing run reports its status through the callback
+  std::promise<Status> failed;
+  ASSERT_TRUE(session_object.RunAsync({}, {"Y"}, [&failed](const Status& status, std::vector<MLValue>&) {
+                                failed.set_value(status);
+                              })
+                  .IsOK());
+  ASSERT_FALSE(failed.get_future().get().IsOK());
+}
+
 TEST(InferenceSessionTests, DisableCPUArena) {
   SessionOptions so;
 
@@ -633,6 +916,31 @@ TEST(InferenceSessionTests, TestWithIstream) {
   RunModel(session_object, run_options);
 }
 
+TEST(InferenceSessionTests, TestWithBuffer) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.TestWithBuffer";
+
+  std::ifstream model_file_stream(MODEL_URI, ios::in | ios::binary);
+  const std::string model_bytes((std::istreambuf_iterator<char>(model_file_stream)),
+                                std::istreambuf_iterator<char>());
+  ASSERT_FALSE(model_bytes.empty());
+
+  // a truncated model is rejected rather than parsed partially
+  InferenceSession truncated_session_object{so};
+  EXPECT_FALSE(truncated_session_object.Load(model_bytes.data(), static_cast<int>(model_bytes.size()) - 1).IsOK());
+
+  InferenceSession session_object{so};
+  ASSERT_TRUE(session_object.Load(model_bytes.data(), static_cast<int>(model_bytes.size())).IsOK());
+  EXPECT_EQ(session_object.Load(model_bytes.data(), static_cast<int>(model_bytes.size())).Code(),
+            common::MODEL_LOADED);
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "InferenceSessionTests.TestWithBuffer";
+  RunModel(session_object, run_options);
+}
+
 TEST(InferenceSessionTests, TestRegisterExecutionProvider) {
   SessionOptions so;
 
@@ -184,6 +184,49 @@ OpKernel* CreateOptionalOpKernel(const OpKernelInfo& kernel_info) {
   return new OptionalOpKernel<float>(kernel_info);
 }
 
+// kernel summing the values of each map of a sequence, such as the output of ZipMap
+class SumMapValuesKernel : public OpKernel {
+ public:
+  SumMapValuesKernel(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const {
+    const auto* X = context->Input<VectorMapInt64ToFloat>(0);
+    auto* Y = context->Output(0, {static_cast<int64_t>(X->size())});
+    auto* Y_Data = Y->MutableData<float>();
+    for (const auto& map : *X) {
+      float sum = 0.f;
+      for (const auto& entry : map) {
+        sum += entry.second;
+      }
+      *Y_Data++ = sum;
+    }
+    return Status::OK();
+  }
+};
+
+ONNX_NAMESPACE::OpSchema GetSumMapValuesSchema() {
+  ONNX_NAMESPACE::OpSchema schema("SumMapValues", "unknown", 0);
+  schema.Input(0, "X", "Sequence of maps.", "T");
+  schema.Output(0, "Y", "Sum of the values of each map.", "tensor(float)");
+  schema.TypeConstraint("T", {"seq(map(int64, float))"}, "Only a sequence of int64 to float maps is allowed.");
+  schema.SinceVersion(7);
+  return schema;
+}
+
+KernelDefBuilder SumMapValuesKernelDef() {
+  KernelDefBuilder def;
+  def.SetName("SumMapValues")
+      .SetDomain(onnxruntime::kOnnxDomain)
+      .SinceVersion(7)
+      .Provider(onnxruntime::kCpuExecutionProvider)
+      .TypeConstraint("T", DataTypeImpl::GetType<VectorMapInt64ToFloat>());
+  return def;
+}
+
+OpKernel* CreateSumMapValuesKernel(const OpKernelInfo& kernel_info) {
+  return new SumMapValuesKernel(kernel_info);
+}
+
 static const std::string MUL_MODEL_URI = "testdata/mul_1.pb";
 static const std::string FOO_MODEL_URI = "testdata/foo_1.pb";
 static const std::string FOO_TRUNCATE_MODEL_URI = "testdata/foo_2.pb";
@@ -325,5 +368,72 @@ TEST(CustomKernelTests, CustomKernelWithOptionalOutput) {
   // Now run
   RunSession(session_object, run_options, dims_x, values_x, expected_dims_y, expected_values_y);
 }
+
+// ZipMap may produce a columnar sequence of maps for an output only the caller reads,
+// while the kernels consuming its output get the registered vector of maps.
+TEST(CustomKernelTests, CustomKernelConsumesZipMapOutput) {
+  for (bool consumed : {true, false}) {
+    SessionOptions so;
+    so.session_logid = "CustomKernelTests.CustomKernelConsumesZipMapOutput";
+
+    std::shared_ptr<CustomRegistry> registry = std::make_shared<CustomRegistry>();
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    EXPECT_TRUE(session_object.RegisterCustomRegistry(registry).IsOK());
+
+    std::vector<OpSchema> schemas = {GetSumMapValuesSchema()};
+    EXPECT_TRUE(registry->RegisterOpSet(schemas, onnxruntime::kOnnxDomain, 5, 7).IsOK());
+    auto def = SumMapValuesKernelDef();
+    EXPECT_TRUE(registry->RegisterCustomKernel(def, CreateSumMapValuesKernel).IsOK());
+
+    IOnnxRuntimeOpSchemaRegistryList custom_schema_registries = {registry};
+    std::unordered_map<std::string, int> domain_to_version = {{onnxruntime::kOnnxDomain, 7},
+                                                              {onnxruntime::kMLDomain, 1}};
+    Model model("ZipMapConsumer", false, ModelMetaData(), custom_schema_registries, domain_to_version);
+    auto& graph = model.MainGraph();
+
+    TypeProto input_tensor(*DataTypeImpl::GetTensorType<float>()->GetTypeProto());
+    input_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+    input_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+    TypeProto map_sequence(*DataTypeImpl::GetType<VectorMapInt64ToFloat>()->GetTypeProto());
+    TypeProto output_tensor(*DataTypeImpl::GetTensorType<float>()->GetTypeProto());
+    output_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    auto& maps_arg = graph.GetOrCreateNodeArg("Z", &map_sequence);
+    auto& zipmap = graph.AddNode("zipmap", "ZipMap", "", {&graph.GetOrCreateNodeArg("X", &input_tensor)},
+                                 {&maps_arg}, nullptr, onnxruntime::kMLDomain);
+    zipmap.AddAttribute("classlabels_int64s", std::vector<int64_t>{30, 10, 20});
+    if (consumed) {
+      graph.AddNode("sum", "SumMapValues", "", {&maps_arg}, {&graph.GetOrCreateNodeArg("Y", &output_tensor)});
+    }
+    auto status = graph.Resolve();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    std::stringstream serialized_model;
+    EXPECT_TRUE(model.ToProto().SerializeToOstream(&serialized_model));
+    EXPECT_TRUE(session_object.Load(serialized_model).IsOK());
+    status = session_object.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    MLValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 3},
+                         {1.f, 2.f, 3.f, 4.f, 5.f, 6.f}, &ml_value);
+    NameMLValMap feeds{{"X", ml_value}};
+    std::vector<MLValue> fetches;
+    status = session_object.Run(feeds, {consumed ? "Y" : "Z"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    ASSERT_EQ(1, fetches.size());
+
+    if (consumed) {
+      auto& rtensor = fetches.front().Get<Tensor>();
+      ASSERT_EQ(TensorShape({2}), rtensor.Shape());
+      EXPECT_EQ(6.f, rtensor.Data<float>()[0]);
+      EXPECT_EQ(15.f, rtensor.Data<float>()[1]);
+    } else {
+      ASSERT_EQ(DataTypeImpl::GetType<ColumnarMapInt64ToFloat>(), fetches.front().Type());
+      EXPECT_EQ(fetches.front().Get<ColumnarMapInt64ToFloat>().ToMaps(),
+                (VectorMapInt64ToFloat{{{10, 2.f}, {20, 3.f}, {30, 1.f}}, {{10, 5.f}, {20, 6.f}, {30, 4.f}}}));
+    }
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
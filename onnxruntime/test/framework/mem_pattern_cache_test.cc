@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+#include "core/framework/mem_pattern_planner.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::unique_ptr<MemoryPatternGroup> CreatePatternGroup(size_t peak_size) {
+  MemPatternPlanner planner;
+  planner.TraceAllocation(0, peak_size);
+  auto group = std::make_unique<MemoryPatternGroup>();
+  group->locations.push_back(OrtAllocatorInfo(CPU, OrtDeviceAllocator));
+  group->patterns.push_back(planner.GenerateMemPattern());
+  return group;
+}
+
+static MemoryPatternCache::InputShapes Shapes(int64_t batch, int64_t seq) {
+  return {{"X", {batch, seq, 8}}};
+}
+
+TEST(MemoryPatternCacheTest, ExactShapesWithoutBuckets) {
+  MemoryPatternCache cache;
+  cache.SetDynamicDims({{"X", {true, true, false}}});
+
+  cache.Put(Shapes(1, 10), CreatePatternGroup(100));
+  EXPECT_NE(cache.Get(Shapes(1, 10)), nullptr);
+  EXPECT_EQ(cache.Get(Shapes(1, 9)), nullptr);
+  EXPECT_EQ(cache.Get(Shapes(2, 10)), nullptr);
+}
+
+TEST(MemoryPatternCacheTest, BucketedShapes) {
+  MemoryPatternCache cache;
+  MemoryPatternCacheOptions options;
+  options.dim_buckets = {16, 32, 64};
+  cache.SetOptions(options);
+  cache.SetDynamicDims({{"X", {false, true, false}}});
+
+  EXPECT_EQ(cache.BucketShape("X", {3, 20, 8}), std::vector<int64_t>({3, 32, 8}));
+  EXPECT_EQ(cache.BucketShape("X", {3, 100, 8}), std::vector<int64_t>({3, 100, 8}));
+  EXPECT_EQ(cache.BucketShape("Y", {3, 20, 8}), std::vector<int64_t>({3, 20, 8}));
+
+  // a pattern traced at seq 24 serves smaller lengths of its bucket only
+  cache.Put(Shapes(1, 24), CreatePatternGroup(100));
+  EXPECT_NE(cache.Get(Shapes(1, 17)), nullptr);
+  EXPECT_EQ(cache.Get(Shapes(1, 30)), nullptr);
+  EXPECT_EQ(cache.Get(Shapes(1, 10)), nullptr);
+  EXPECT_EQ(cache.Get(Shapes(2, 17)), nullptr);
+
+  // tracing the upper bound of the bucket replaces it
+  cache.Put(Shapes(1, 32), CreatePatternGroup(200));
+  EXPECT_EQ(cache.Size(), 1u);
+  auto group = cache.Get(Shapes(1, 30));
+  ASSERT_NE(group, nullptr);
+  EXPECT_EQ(group->patterns[0].PeakSize(), 200u);
+  EXPECT_NE(cache.Get(Shapes(1, 24)), nullptr);
+}
+
+TEST(MemoryPatternCacheTest, LeastRecentlyUsedEviction) {
+  MemoryPatternCache cache;
+  MemoryPatternCacheOptions options;
+  options.max_entries = 2;
+  cache.SetOptions(options);
+
+  cache.Put(Shapes(1, 1), CreatePatternGroup(100));
+  cache.Put(Shapes(1, 2), CreatePatternGroup(100));
+  auto in_use = cache.Get(Shapes(1, 1));
+  ASSERT_NE(in_use, nullptr);
+  cache.Put(Shapes(1, 3), CreatePatternGroup(100));
+
+  EXPECT_EQ(cache.Size(), 2u);
+  EXPECT_NE(cache.Get(Shapes(1, 1)), nullptr);
+  EXPECT_EQ(cache.Get(Shapes(1, 2)), nullptr);
+  EXPECT_NE(cache.Get(Shapes(1, 3)), nullptr);
+
+  // evicting a pattern does not invalidate it for a run still using it
+  cache.Put(Shapes(1, 4), CreatePatternGroup(100));
+  cache.Put(Shapes(1, 5), CreatePatternGroup(100));
+  EXPECT_EQ(cache.Get(Shapes(1, 1)), nullptr);
+  EXPECT_EQ(in_use->patterns[0].PeakSize(), 100u);
+}
+
+TEST(MemoryPatternCacheTest, BoundedByDefault) {
+  MemoryPatternCache cache;
+  const size_t max_entries = MemoryPatternCacheOptions().max_entries;
+  ASSERT_GT(max_entries, 0u);
+
+  for (size_t i = 0; i < max_entries * 2; ++i) {
+    cache.Put(Shapes(1, static_cast<int64_t>(i)), CreatePatternGroup(100));
+  }
+  EXPECT_EQ(cache.Size(), max_entries);
+  EXPECT_EQ(cache.Get(Shapes(1, 0)), nullptr);
+  EXPECT_NE(cache.Get(Shapes(1, static_cast<int64_t>(max_entries * 2 - 1))), nullptr);
+}
+
+TEST(MemoryPatternCacheTest, MemoryLimit) {
+  MemoryPatternCache cache;
+  MemoryPatternCacheOptions options;
+  options.max_bytes = 250;
+  cache.SetOptions(options);
+
+  cache.Put(Shapes(1, 1), CreatePatternGroup(300));
+  EXPECT_EQ(cache.Size(), 0u);
+
+  cache.Put(Shapes(1, 2), CreatePatternGroup(100));
+  cache.Put(Shapes(1, 3), CreatePatternGroup(100));
+  cache.Put(Shapes(1, 4), CreatePatternGroup(100));
+  EXPECT_EQ(cache.Size(), 2u);
+  EXPECT_EQ(cache.Get(Shapes(1, 2)), nullptr);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_store.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::unique_ptr<Tensor> CreateTensor(const std::vector<int64_t>& dims, const std::vector<float>& values) {
+  static AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  TensorShape shape(dims);
+  void* buffer = allocator->Alloc(shape.Size() * sizeof(float));
+  memcpy(buffer, values.data(), values.size() * sizeof(float));
+  return std::make_unique<Tensor>(DataTypeImpl::GetType<float>(), shape, buffer, allocator->Info(), allocator);
+}
+
+TEST(SharedInitializerStoreTest, DeduplicatesIdenticalTensors) {
+  SharedInitializerStore store;
+
+  auto a = store.GetOrAdd(CreateTensor({2, 2}, {1.f, 2.f, 3.f, 4.f}));
+  auto b = store.GetOrAdd(CreateTensor({2, 2}, {1.f, 2.f, 3.f, 4.f}));
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(store.Size(), 1u);
+
+  // same content with another shape, or another content, is not shared
+  auto c = store.GetOrAdd(CreateTensor({4}, {1.f, 2.f, 3.f, 4.f}));
+  auto d = store.GetOrAdd(CreateTensor({2, 2}, {1.f, 2.f, 3.f, 5.f}));
+  EXPECT_NE(a, c);
+  EXPECT_NE(a, d);
+  EXPECT_EQ(store.Size(), 3u);
+}
+
+TEST(SharedInitializerStoreTest, ReleasesUnusedTensors) {
+  SharedInitializerStore store;
+
+  auto a = store.GetOrAdd(CreateTensor({2}, {1.f, 2.f}));
+  auto b = store.GetOrAdd(CreateTensor({2}, {1.f, 2.f}));
+  a.reset();
+  EXPECT_EQ(store.Size(), 1u);
+  b.reset();
+  EXPECT_EQ(store.Size(), 0u);
+
+  // an identical tensor added later is stored again
+  auto c = store.GetOrAdd(CreateTensor({2}, {1.f, 2.f}));
+  EXPECT_EQ(c->Data<float>()[1], 2.f);
+  EXPECT_EQ(store.Size(), 1u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -831,6 +831,40 @@ TEST(TypeInferenceTest, VariadicOutput) {
   CheckTensorEltType(Z.TypeAsProto(), TensorProto_DataType_FLOAT);
 }
 
+// Test that a Resolve after edits infers the types and shapes of the nodes affected by the edits again
+TEST(TypeInferenceTest, IncrementalResolve) {
+  TypeProto tensor_type;
+  tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  Model model("graph_1");
+  auto& graph = model.MainGraph();
+  auto& X = graph.GetOrCreateNodeArg("X", &tensor_type);
+  auto& A = graph.GetOrCreateNodeArg("A", nullptr);
+  auto& B = graph.GetOrCreateNodeArg("B", nullptr);
+  graph.AddNode("node_1", "Relu", "node 1.", {&X}, {&A});
+  graph.AddNode("node_2", "Relu", "node 2.", {&A}, {&B});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_NE(B.Shape(), nullptr);
+  EXPECT_EQ(B.Shape()->dim(0).dim_param(), "N");
+
+  // the new shape of X flows through the nodes inferred before, up to the node added
+  TensorShapeProto shape;
+  shape.add_dim()->set_dim_value(2);
+  shape.add_dim()->set_dim_value(3);
+  X.SetShape(shape);
+  auto& C = graph.GetOrCreateNodeArg("C", nullptr);
+  graph.AddNode("node_3", "Abs", "node 3.", {&B}, {&C});
+  status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_EQ(A.Shape()->dim(0).dim_value(), 2);
+  EXPECT_EQ(B.Shape()->dim(0).dim_value(), 2);
+  ASSERT_NE(C.Shape(), nullptr);
+  EXPECT_EQ(C.Shape()->dim(0).dim_value(), 2);
+  CheckTensorEltType(C.TypeAsProto(), TensorProto_DataType_FLOAT);
+}
+
 // Test that Graph::Resolve identifies name-duplication across initializer and node-output-arg
 TEST(NameResolutionTest, DuplicateName) {
   Model model("graph_1");
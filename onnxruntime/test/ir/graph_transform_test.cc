@@ -13,6 +13,13 @@
 #include "core/graph/conv_activation_fusion.h"
 #include "core/graph/matmul_add_fusion.h"
 #include "core/graph/gemm_activation_fusion.h"
+#include "core/graph/transpose_optimizer.h"
+#include "core/graph/layer_norm_fusion.h"
+#include "core/graph/gelu_fusion.h"
+#include "core/graph/attention_fusion.h"
+#include "core/graph/common_subexpression_elimination.h"
+#include "core/framework/constant_folding.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/platform/env.h"
 
 #include "test/capturing_sink.h"
@@ -254,5 +261,550 @@ TEST(GraphTransformationTests, Gemm_Relu_three_input) {
 }
 
 
+static NodeArg& AddInitializer(Graph& graph, const std::string& name, TensorProto_DataType type,
+                               const std::vector<int64_t>& dims, const std::string& raw_data) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(type);
+  for (auto dim : dims) {
+    tensor_proto.add_dims(dim);
+  }
+  tensor_proto.set_raw_data(raw_data);
+  graph.AddInitializedTensor(tensor_proto);
+  return *graph.GetNodeArg(name);
+}
+
+// Adds a Constant node and returns its output.
+static NodeArg& AddConstant(Graph& graph, const std::string& name, TensorProto_DataType type,
+                            const std::vector<int64_t>& dims, const std::string& raw_data) {
+  TensorProto tensor_proto;
+  tensor_proto.set_data_type(type);
+  for (auto dim : dims) {
+    tensor_proto.add_dims(dim);
+  }
+  tensor_proto.set_raw_data(raw_data);
+  TypeProto tensor_type;
+  tensor_type.mutable_tensor_type()->set_elem_type(type);
+  auto& output = graph.GetOrCreateNodeArg(name, &tensor_type);
+  graph.AddNode(name + "_constant", "Constant", "", {}, {&output}).AddAttribute("value", tensor_proto);
+  return output;
+}
+
+template <typename T>
+static std::string ToRawData(const std::vector<T>& values) {
+  return std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+static MLValue CreateFloatMLValue(const TensorShape& shape, const std::vector<float>& values) {
+  static AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  void* buffer = allocator->Alloc(values.size() * sizeof(float));
+  memcpy(buffer, values.data(), values.size() * sizeof(float));
+  MLValue value;
+  value.Init(new Tensor(DataTypeImpl::GetType<float>(), shape, buffer, allocator->Info(), allocator),
+             DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return value;
+}
+
+// Z = Reshape(X + Transpose(W), Concat(Unsqueeze(Gather(Shape(X), 0)), -1)) with a static shape for X,
+// where W, 0 and -1 are Constant nodes and everything but the Add and the Reshape can be folded.
+static void BuildConstantFoldingGraph(Graph& graph) {
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TypeProto int64_tensor;
+  int64_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  TypeProto x_type{float_tensor};
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& w = AddConstant(graph, "W", TensorProto_DataType_FLOAT, {3, 2},
+                        ToRawData(std::vector<float>{1.f, 2.f, 3.f, 4.f, 5.f, 6.f}));
+  auto& zero = AddConstant(graph, "zero", TensorProto_DataType_INT64, {}, ToRawData(std::vector<int64_t>{0}));
+  auto& minus_one = AddConstant(graph, "minus_one", TensorProto_DataType_INT64, {1},
+                                ToRawData(std::vector<int64_t>{-1}));
+
+  auto& wt = graph.GetOrCreateNodeArg("WT", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& x_shape = graph.GetOrCreateNodeArg("x_shape", &int64_tensor);
+  auto& dim0 = graph.GetOrCreateNodeArg("dim0", &int64_tensor);
+  auto& unsqueezed_dim0 = graph.GetOrCreateNodeArg("unsqueezed_dim0", &int64_tensor);
+  auto& new_shape = graph.GetOrCreateNodeArg("new_shape", &int64_tensor);
+  auto& z = graph.GetOrCreateNodeArg("Z", &float_tensor);
+
+  graph.AddNode("transpose", "Transpose", "", {&w}, {&wt});
+  graph.AddNode("add", "Add", "", {&x, &wt}, {&y});
+  graph.AddNode("shape", "Shape", "", {&x}, {&x_shape});
+  graph.AddNode("gather", "Gather", "", {&x_shape, &zero}, {&dim0});
+  graph.AddNode("unsqueeze", "Unsqueeze", "", {&dim0}, {&unsqueezed_dim0})
+      .AddAttribute("axes", std::vector<int64_t>{0});
+  graph.AddNode("concat", "Concat", "", {&unsqueezed_dim0, &minus_one}, {&new_shape})
+      .AddAttribute("axis", int64_t{0});
+  graph.AddNode("reshape", "Reshape", "", {&y, &new_shape}, {&z});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+}
+
+TEST(GraphTransformationTests, ConstantFolding) {
+  Model model("ConstantFolding", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 7}});
+  Graph& graph = model.MainGraph();
+  BuildConstantFoldingGraph(graph);
+
+  ConstantFolding constant_folding{std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo{false})};
+  bool modified = false;
+  ASSERT_TRUE(constant_folding.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+
+  std::vector<std::string> op_types;
+  for (auto& node : graph.Nodes()) {
+    op_types.push_back(node.OpType());
+  }
+  EXPECT_EQ(op_types, (std::vector<std::string>{"Add", "Reshape"}));
+
+  const TensorProto* wt = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("WT", wt));
+  EXPECT_EQ(wt->raw_data(), ToRawData(std::vector<float>{1.f, 3.f, 5.f, 2.f, 4.f, 6.f}));
+  const TensorProto* new_shape = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("new_shape", new_shape));
+  EXPECT_EQ(new_shape->raw_data(), ToRawData(std::vector<int64_t>{2, -1}));
+  // the values of the Constant nodes were only used by folded nodes
+  const TensorProto* w = nullptr;
+  EXPECT_FALSE(graph.GetInitializedTensor("W", w));
+
+  // nothing is left to fold
+  modified = false;
+  ASSERT_TRUE(constant_folding.Apply(graph, modified).IsOK());
+  EXPECT_FALSE(modified);
+}
+
+TEST(GraphTransformationTests, ConstantFoldingInSession) {
+  Model model("ConstantFolding", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 7}});
+  BuildConstantFoldingGraph(model.MainGraph());
+  std::stringstream model_stream;
+  model.ToProto().SerializeToOstream(&model_stream);
+
+  SessionOptions so;
+  so.session_logid = "GraphTransformationTests.ConstantFoldingInSession";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  TensorShape shape({2, 3});
+  MLValue x = CreateFloatMLValue(shape, {1.f, 1.f, 1.f, 2.f, 2.f, 2.f});
+
+  std::vector<MLValue> fetches;
+  ASSERT_TRUE(session_object.Run(NameMLValMap{{"X", x}}, {"Z"}, &fetches).IsOK());
+  const Tensor& z = fetches[0].Get<Tensor>();
+  ASSERT_EQ(z.Shape(), shape);
+  std::vector<float> expected{2.f, 4.f, 6.f, 4.f, 6.f, 8.f};
+  EXPECT_EQ(std::vector<float>(z.Data<float>(), z.Data<float>() + 6), expected);
+}
+
+TEST(GraphTransformationTests, ConstantFoldingSkipsOverridableInitializers) {
+  Model model("ConstantFolding", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 7}});
+  Graph& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  // Y = X + Neg(W), where W is an initializer listed in the graph inputs as all the initializers of a graph
+  // built in memory
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& w = AddInitializer(graph, "W", TensorProto_DataType_FLOAT, {2}, ToRawData(std::vector<float>{1.f, 2.f}));
+  auto& minus_w = graph.GetOrCreateNodeArg("minus_W", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("neg", "Neg", "", {&w}, {&minus_w});
+  graph.AddNode("add", "Add", "", {&x, &minus_w}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  ConstantFolding constant_folding{std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo{false})};
+  bool modified = false;
+  ASSERT_TRUE(constant_folding.Apply(graph, modified).IsOK());
+  EXPECT_FALSE(modified);
+
+  // the value fed for W is used
+  std::stringstream model_stream;
+  model.ToProto().SerializeToOstream(&model_stream);
+  SessionOptions so;
+  so.session_logid = "GraphTransformationTests.ConstantFoldingSkipsOverridableInitializers";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::vector<MLValue> fetches;
+  NameMLValMap feeds{{"X", CreateFloatMLValue(TensorShape({2}), {1.f, 1.f})},
+                     {"W", CreateFloatMLValue(TensorShape({2}), {5.f, 6.f})}};
+  ASSERT_TRUE(session_object.Run(feeds, {"Y"}, &fetches).IsOK());
+  const Tensor& result = fetches[0].Get<Tensor>();
+  EXPECT_EQ(std::vector<float>(result.Data<float>(), result.Data<float>() + 2), (std::vector<float>{-4.f, -5.f}));
+}
+
+// Z = Transpose(Add(Relu(Transpose(X)), bias)) converting X from NHWC to NCHW and back.
+static void BuildTransposeGraph(Graph& graph) {
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TypeProto x_type{float_tensor};
+  for (int64_t dim : {1, 2, 2, 3}) {
+    x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& bias = AddInitializer(graph, "bias", TensorProto_DataType_FLOAT, {3, 1, 1},
+                              ToRawData(std::vector<float>{1.f, 2.f, 3.f}));
+  auto& x_nchw = graph.GetOrCreateNodeArg("X_nchw", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& y_biased = graph.GetOrCreateNodeArg("Y_biased", &float_tensor);
+  auto& z = graph.GetOrCreateNodeArg("Z", &float_tensor);
+
+  graph.AddNode("to_nchw", "Transpose", "", {&x}, {&x_nchw}).AddAttribute("perm", std::vector<int64_t>{0, 3, 1, 2});
+  graph.AddNode("relu", "Relu", "", {&x_nchw}, {&y});
+  graph.AddNode("add", "Add", "", {&y, &bias}, {&y_biased});
+  graph.AddNode("to_nhwc", "Transpose", "", {&y_biased}, {&z}).AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+}
+
+TEST(GraphTransformationTests, TransposeOptimizer) {
+  Model model("TransposeOptimizer", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 7}});
+  Graph& graph = model.MainGraph();
+  BuildTransposeGraph(graph);
+
+  TransposeOptimizer transpose_optimizer;
+  bool modified = false;
+  ASSERT_TRUE(transpose_optimizer.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+
+  // the Transposes cancelled each other, the bias is transposed instead
+  std::vector<std::string> op_types;
+  for (auto& node : graph.Nodes()) {
+    op_types.push_back(node.OpType());
+  }
+  EXPECT_EQ(op_types, (std::vector<std::string>{"Relu", "Add", "Unsqueeze", "Transpose"}));
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Relu") {
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "X");
+    } else if (node.OpType() == "Add") {
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "Z");
+    } else if (node.OpType() == "Transpose") {
+      EXPECT_EQ(node.GetAttributes().at("perm").ints_size(), 4);
+      EXPECT_EQ(node.GetAttributes().at("perm").ints(3), 1);
+    }
+  }
+
+  modified = false;
+  ASSERT_TRUE(transpose_optimizer.Apply(graph, modified).IsOK());
+  EXPECT_FALSE(modified);
+}
+
+TEST(GraphTransformationTests, TransposeOptimizerInSession) {
+  Model model("TransposeOptimizer", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 7}});
+  BuildTransposeGraph(model.MainGraph());
+  std::stringstream model_stream;
+  model.ToProto().SerializeToOstream(&model_stream);
+
+  SessionOptions so;
+  so.session_logid = "GraphTransformationTests.TransposeOptimizerInSession";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  static AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  TensorShape shape({1, 2, 2, 3});
+  std::vector<float> x_values{-6.f, -5.f, -4.f, -3.f, -2.f, -1.f, 0.f, 1.f, 2.f, 3.f, 4.f, 5.f};
+  void* buffer = allocator->Alloc(x_values.size() * sizeof(float));
+  memcpy(buffer, x_values.data(), x_values.size() * sizeof(float));
+  MLValue x;
+  x.Init(new Tensor(DataTypeImpl::GetType<float>(), shape, buffer, allocator->Info(), allocator),
+         DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+
+  std::vector<MLValue> fetches;
+  ASSERT_TRUE(session_object.Run(NameMLValMap{{"X", x}}, {"Z"}, &fetches).IsOK());
+  const Tensor& z = fetches[0].Get<Tensor>();
+  ASSERT_EQ(z.Shape(), shape);
+  std::vector<float> expected{1.f, 2.f, 3.f, 1.f, 2.f, 3.f, 1.f, 3.f, 5.f, 4.f, 6.f, 8.f};
+  EXPECT_EQ(std::vector<float>(z.Data<float>(), z.Data<float>() + 12), expected);
+}
+
+static std::vector<std::string> GetOpTypes(const Graph& graph) {
+  std::vector<std::string> op_types;
+  for (auto& node : graph.Nodes()) {
+    op_types.push_back(node.OpType());
+  }
+  return op_types;
+}
+
+// Run the model with X as input and return Z, applying transformer if not null.
+static std::vector<float> RunWithTransformer(Model& model, std::unique_ptr<GraphTransformer> transformer,
+                                             const std::vector<int64_t>& x_dims, const std::vector<float>& x_values) {
+  std::stringstream model_stream;
+  model.ToProto().SerializeToOstream(&model_stream);
+
+  SessionOptions so;
+  so.session_logid = "GraphTransformationTests.RunWithTransformer";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  if (transformer != nullptr) {
+    EXPECT_TRUE(session_object.RegisterGraphTransformer(std::move(transformer)).IsOK());
+  }
+  EXPECT_TRUE(session_object.Load(model_stream).IsOK());
+  EXPECT_TRUE(session_object.Initialize().IsOK());
+
+  static AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  void* buffer = allocator->Alloc(x_values.size() * sizeof(float));
+  memcpy(buffer, x_values.data(), x_values.size() * sizeof(float));
+  MLValue x;
+  x.Init(new Tensor(DataTypeImpl::GetType<float>(), TensorShape(x_dims), buffer, allocator->Info(), allocator),
+         DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  std::vector<MLValue> fetches;
+  EXPECT_TRUE(session_object.Run(NameMLValMap{{"X", x}}, {"Z"}, &fetches).IsOK());
+  if (fetches.empty()) {
+    return {};
+  }
+  const Tensor& z = fetches[0].Get<Tensor>();
+  return std::vector<float>(z.Data<float>(), z.Data<float>() + z.Shape().Size());
+}
+
+static NodeArg& AddFloatScalar(Graph& graph, const std::string& name, float value) {
+  return AddInitializer(graph, name, TensorProto_DataType_FLOAT, {}, ToRawData(std::vector<float>{value}));
+}
+
+TEST(GraphTransformationTests, LayerNormFusion) {
+  Model model("LayerNormFusion", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 7}, {kMSDomain, 1}});
+  Graph& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TypeProto x_type{float_tensor};
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& two = AddFloatScalar(graph, "two", 2.f);
+  auto& epsilon = AddFloatScalar(graph, "epsilon", 1e-5f);
+  auto& scale = AddInitializer(graph, "scale", TensorProto_DataType_FLOAT, {3}, ToRawData(std::vector<float>{1.f, 1.f, 2.f}));
+  auto& bias = AddInitializer(graph, "bias", TensorProto_DataType_FLOAT, {3}, ToRawData(std::vector<float>{0.f, 1.f, 0.f}));
+  std::vector<NodeArg*> values;
+  for (const char* name : {"mean", "deviation", "square", "variance", "variance_epsilon", "std_dev", "normalized", "scaled", "Z"}) {
+    values.push_back(&graph.GetOrCreateNodeArg(name, &float_tensor));
+  }
+
+  graph.AddNode("mean", "ReduceMean", "", {&x}, {values[0]}).AddAttribute("axes", std::vector<int64_t>{-1});
+  graph.AddNode("sub", "Sub", "", {&x, values[0]}, {values[1]});
+  graph.AddNode("pow", "Pow", "", {values[1], &two}, {values[2]});
+  graph.AddNode("variance", "ReduceMean", "", {values[2]}, {values[3]}).AddAttribute("axes", std::vector<int64_t>{-1});
+  graph.AddNode("add_epsilon", "Add", "", {values[3], &epsilon}, {values[4]});
+  graph.AddNode("sqrt", "Sqrt", "", {values[4]}, {values[5]});
+  graph.AddNode("div", "Div", "", {values[1], values[5]}, {values[6]});
+  graph.AddNode("mul", "Mul", "", {values[6], &scale}, {values[7]});
+  graph.AddNode("add", "Add", "", {values[7], &bias}, {values[8]});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::vector<float> x_values{1.f, 2.f, 3.f, 4.f, 6.f, 8.f};
+  std::vector<float> expected = RunWithTransformer(model, nullptr, {2, 3}, x_values);
+  std::vector<float> z = RunWithTransformer(model, std::make_unique<LayerNormFusion>(), {2, 3}, x_values);
+  ASSERT_EQ(z.size(), expected.size());
+  for (size_t i = 0; i < z.size(); ++i) {
+    EXPECT_NEAR(z[i], expected[i], 1e-5f);
+  }
+
+  bool modified = false;
+  ASSERT_TRUE(LayerNormFusion().Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  EXPECT_EQ(GetOpTypes(graph), std::vector<std::string>{"LayerNormalization"});
+}
+
+TEST(GraphTransformationTests, GeluFusion) {
+  Model model("GeluFusion", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 9}, {kMSDomain, 1}});
+  Graph& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& sqrt_2 = AddFloatScalar(graph, "sqrt_2", 1.4142135f);
+  auto& one = AddFloatScalar(graph, "one", 1.f);
+  auto& half = AddFloatScalar(graph, "half", 0.5f);
+  std::vector<NodeArg*> values;
+  for (const char* name : {"scaled", "erf", "erf_plus_one", "product", "Z"}) {
+    values.push_back(&graph.GetOrCreateNodeArg(name, &float_tensor));
+  }
+
+  graph.AddNode("div", "Div", "", {&x, &sqrt_2}, {values[0]});
+  graph.AddNode("erf", "Erf", "", {values[0]}, {values[1]});
+  graph.AddNode("add", "Add", "", {values[1], &one}, {values[2]});
+  graph.AddNode("mul", "Mul", "", {&x, values[2]}, {values[3]});
+  graph.AddNode("half", "Mul", "", {values[3], &half}, {values[4]});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::vector<float> x_values{-2.f, -1.f, 0.f, 1.f, 2.f, 3.f};
+  std::vector<float> expected = RunWithTransformer(model, nullptr, {2, 3}, x_values);
+  std::vector<float> z = RunWithTransformer(model, std::make_unique<GeluFusion>(), {2, 3}, x_values);
+  ASSERT_EQ(z.size(), expected.size());
+  for (size_t i = 0; i < z.size(); ++i) {
+    EXPECT_NEAR(z[i], expected[i], 1e-5f);
+  }
+
+  bool modified = false;
+  ASSERT_TRUE(GeluFusion().Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  EXPECT_EQ(GetOpTypes(graph), std::vector<std::string>{"Gelu"});
+}
+
+TEST(GraphTransformationTests, AttentionFusion) {
+  // batch 1, sequence 2, hidden 4 and 2 heads
+  Model model("AttentionFusion", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 9}, {kMSDomain, 1}});
+  Graph& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TypeProto x_type{float_tensor};
+  for (int64_t dim : {1, 2, 4}) {
+    x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& heads_shape = AddInitializer(graph, "heads_shape", TensorProto_DataType_INT64, {4},
+                                     ToRawData(std::vector<int64_t>{0, 0, 2, 2}));
+  auto& hidden_shape = AddInitializer(graph, "hidden_shape", TensorProto_DataType_INT64, {3},
+                                      ToRawData(std::vector<int64_t>{0, 0, 4}));
+  auto& sqrt_head_size = AddFloatScalar(graph, "sqrt_head_size", 1.4142135f);
+
+  std::vector<NodeArg*> projections;
+  for (const std::string& name : {"q", "k", "v"}) {
+    std::vector<float> weight(16);
+    for (size_t i = 0; i < weight.size(); ++i) {
+      weight[i] = ((i * 5 + name[0]) % 7 - 3.f) * 0.1f;
+    }
+    auto& w = AddInitializer(graph, name + "_weight", TensorProto_DataType_FLOAT, {4, 4}, ToRawData(weight));
+    auto& b = AddInitializer(graph, name + "_bias", TensorProto_DataType_FLOAT, {4},
+                             ToRawData(std::vector<float>{0.1f, -0.1f, 0.2f, 0.f}));
+    auto& product = graph.GetOrCreateNodeArg(name + "_product", &float_tensor);
+    auto& biased = graph.GetOrCreateNodeArg(name + "_biased", &float_tensor);
+    auto& heads = graph.GetOrCreateNodeArg(name + "_heads", &float_tensor);
+    auto& transposed = graph.GetOrCreateNodeArg(name + "_transposed", &float_tensor);
+    graph.AddNode(name + "_matmul", "MatMul", "", {&x, &w}, {&product});
+    graph.AddNode(name + "_add", "Add", "", {&product, &b}, {&biased});
+    graph.AddNode(name + "_reshape", "Reshape", "", {&biased, &heads_shape}, {&heads});
+    graph.AddNode(name + "_transpose", "Transpose", "", {&heads}, {&transposed})
+        .AddAttribute("perm", name == "k" ? std::vector<int64_t>{0, 2, 3, 1} : std::vector<int64_t>{0, 2, 1, 3});
+    projections.push_back(&transposed);
+  }
+
+  std::vector<NodeArg*> values;
+  for (const char* name : {"qk", "scores", "probs", "context", "context_transposed", "Z"}) {
+    values.push_back(&graph.GetOrCreateNodeArg(name, &float_tensor));
+  }
+  graph.AddNode("qk", "MatMul", "", {projections[0], projections[1]}, {values[0]});
+  graph.AddNode("scale", "Div", "", {values[0], &sqrt_head_size}, {values[1]});
+  graph.AddNode("softmax", "Softmax", "", {values[1]}, {values[2]}).AddAttribute("axis", int64_t{3});
+  graph.AddNode("context", "MatMul", "", {values[2], projections[2]}, {values[3]});
+  graph.AddNode("context_transpose", "Transpose", "", {values[3]}, {values[4]})
+      .AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+  graph.AddNode("output_reshape", "Reshape", "", {values[4], &hidden_shape}, {values[5]});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::vector<float> x_values{0.5f, -0.2f, 0.3f, 1.0f, 0.1f, 0.4f, -0.6f, 0.2f};
+  std::vector<float> expected = RunWithTransformer(model, nullptr, {1, 2, 4}, x_values);
+  std::vector<float> z = RunWithTransformer(model, std::make_unique<AttentionFusion>(), {1, 2, 4}, x_values);
+  ASSERT_EQ(z.size(), expected.size());
+  for (size_t i = 0; i < z.size(); ++i) {
+    EXPECT_NEAR(z[i], expected[i], 1e-5f);
+  }
+
+  bool modified = false;
+  ASSERT_TRUE(AttentionFusion().Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  EXPECT_EQ(GetOpTypes(graph), std::vector<std::string>{"Attention"});
+}
+
+TEST(GraphTransformationTests, IdentityEliminationWorklist) {
+  Model model("IdentityEliminationWorklist", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 9}});
+  Graph& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  std::vector<NodeArg*> values;
+  for (const char* name : {"X", "id_1", "id_2", "relu", "Z"}) {
+    values.push_back(&graph.GetOrCreateNodeArg(name, &float_tensor));
+  }
+  graph.AddNode("id_1", "Identity", "", {values[0]}, {values[1]});
+  graph.AddNode("id_2", "Identity", "", {values[1]}, {values[2]});
+  graph.AddNode("relu", "Relu", "", {values[2]}, {values[3]});
+  graph.AddNode("id_3", "Identity", "", {values[3]}, {values[4]});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  // sessions apply the rule through the transformer by default
+  EXPECT_EQ(RunWithTransformer(model, nullptr, {2}, {-1.f, 2.f}), (std::vector<float>{0.f, 2.f}));
+
+  WorklistRuleBasedTransformer transformer("WorklistTransformer", "Worklist rule transformer");
+  ASSERT_TRUE(transformer.Register("Identity", std::make_unique<EliminateIdentity>()).IsOK());
+
+  // both Identity nodes before the Relu go in one Apply, the one producing the graph output stays
+  bool modified = false;
+  ASSERT_TRUE(transformer.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  std::vector<std::string> expected{"Relu", "Identity"};
+  EXPECT_EQ(GetOpTypes(graph), expected);
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == "Relu") {
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "X");
+      EXPECT_EQ(node.GetOutputEdgesCount(), 1u);
+    }
+  }
+
+  modified = false;
+  ASSERT_TRUE(transformer.Apply(graph, modified).IsOK());
+  EXPECT_FALSE(modified);
+}
+
+TEST(GraphTransformationTests, CommonSubexpressionElimination) {
+  Model model("CommonSubexpressionElimination", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 9}});
+  Graph& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TypeProto int64_tensor;
+  int64_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& index = AddInitializer(graph, "index", TensorProto_DataType_INT64, {1}, ToRawData(std::vector<int64_t>{0}));
+  std::vector<NodeArg*> int64_values;
+  for (const char* name : {"shape_1", "shape_2", "dim_1", "dim_2", "Z"}) {
+    int64_values.push_back(&graph.GetOrCreateNodeArg(name, &int64_tensor));
+  }
+  std::vector<NodeArg*> float_values;
+  for (const char* name : {"random_1", "random_2", "R"}) {
+    float_values.push_back(&graph.GetOrCreateNodeArg(name, &float_tensor));
+  }
+
+  // Z = Concat(Gather(Shape(X), index), Gather(Shape(X), index)), R = RandomUniformLike(X) + RandomUniformLike(X)
+  graph.AddNode("shape_1", "Shape", "", {&x}, {int64_values[0]});
+  graph.AddNode("shape_2", "Shape", "", {&x}, {int64_values[1]});
+  graph.AddNode("gather_1", "Gather", "", {int64_values[0], &index}, {int64_values[2]});
+  graph.AddNode("gather_2", "Gather", "", {int64_values[1], &index}, {int64_values[3]});
+  graph.AddNode("concat", "Concat", "", {int64_values[2], int64_values[3]}, {int64_values[4]})
+      .AddAttribute("axis", int64_t{0});
+  graph.AddNode("random_1", "RandomUniformLike", "", {&x}, {float_values[0]});
+  graph.AddNode("random_2", "RandomUniformLike", "", {&x}, {float_values[1]});
+  graph.AddNode("add", "Add", "", {float_values[0], float_values[1]}, {float_values[2]});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  // the Gather duplicate is found once the Shape one is merged, the random generators are kept
+  CommonSubexpressionElimination cse;
+  bool modified = false;
+  ASSERT_TRUE(cse.Apply(graph, modified).IsOK());
+  EXPECT_TRUE(modified);
+  std::vector<std::string> expected{"Shape", "Gather", "Concat", "RandomUniformLike", "RandomUniformLike", "Add"};
+  EXPECT_EQ(GetOpTypes(graph), expected);
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == "Concat") {
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "dim_1");
+      EXPECT_EQ(node.InputDefs()[1]->Name(), "dim_1");
+      EXPECT_EQ(node.GetInputEdgesCount(), 2u);
+    }
+  }
+
+  modified = false;
+  ASSERT_TRUE(cse.Apply(graph, modified).IsOK());
+  EXPECT_FALSE(modified);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
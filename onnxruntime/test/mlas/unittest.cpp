@@ -16,8 +16,10 @@ Abstract:
 
 #include <stdio.h>
 #include <memory.h>
+#include <math.h>
 #include <algorithm>
 #include <limits>
+#include <vector>
 #include <mlas.h>
 
 #if defined(_WIN32)
@@ -367,6 +369,200 @@ ExecuteSgemmTests(
     }
 }
 
+void
+ReferenceSgemmPostProcess(
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    size_t M,
+    size_t N,
+    float* C,
+    size_t ldc
+    )
+{
+    for (size_t m = 0; m < M; m++) {
+
+        for (size_t n = 0; n < N; n++) {
+
+            float Value = C[m * ldc + n];
+
+            if (PostProcess->RowBias != nullptr) {
+                Value += PostProcess->RowBias[m];
+            }
+
+            if (PostProcess->ColumnBias != nullptr) {
+                Value += PostProcess->ColumnBias[n];
+            }
+
+            if (PostProcess->Residual != nullptr) {
+                Value += PostProcess->Residual[m * PostProcess->ldr + n];
+            }
+
+            switch (PostProcess->Activation->ActivationKind) {
+
+                case MlasIdentityActivation:
+                    break;
+
+                case MlasReluActivation:
+                    Value = std::max(Value, 0.0f);
+                    break;
+
+                case MlasLeakyReluActivation:
+                    Value = (Value >= 0.0f) ? Value : Value * PostProcess->Activation->alpha;
+                    break;
+
+                case MlasTanhActivation:
+                    Value = tanhf(Value);
+                    break;
+
+                case MlasLogisticActivation:
+                    Value = 1.0f / (1.0f + expf(-Value));
+                    break;
+            }
+
+            C[m * ldc + n] = Value;
+        }
+    }
+}
+
+void
+TrialSgemmPostProcess(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    float* CReference,
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess
+    )
+{
+    for (size_t f = 0; f < M * N; f++) {
+        C[f] = -0.5f;
+        CReference[f] = -0.5f;
+    }
+
+    MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, PostProcess);
+    ReferenceSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, ldc);
+    ReferenceSgemmPostProcess(PostProcess, M, N, CReference, ldc);
+
+    for (size_t f = 0; f < M * N; f++) {
+        // The activations are approximated and the terms may be added in another order.
+        if (fabsf(C[f] - CReference[f]) > 1e-4f * std::max(1.0f, fabsf(CReference[f]))) {
+            printf("mismatch TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f, activation=%d, bias=%d%d%d!\n",
+                TransA, TransB, M, N, K, alpha, beta, int(PostProcess->Activation->ActivationKind),
+                PostProcess->ColumnBias != nullptr, PostProcess->RowBias != nullptr, PostProcess->Residual != nullptr);
+            break;
+        }
+    }
+}
+
+void
+TrialSgemmPostProcess(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    MatrixGuardBuffer& BufferA,
+    MatrixGuardBuffer& BufferB,
+    float beta,
+    MatrixGuardBuffer& BufferC,
+    MatrixGuardBuffer& BufferCReference
+    )
+{
+    const float* A = BufferA.GetBuffer(K * M);
+    const float* B = BufferB.GetBuffer(N * K);
+    float* C = BufferC.GetBuffer(N * M);
+    float* CReference = BufferCReference.GetBuffer(N * M);
+
+    //
+    // The residual matrix has a larger first dimension than matrix C.
+    //
+
+    const size_t ldr = N + 3;
+
+    std::vector<float> ColumnBias(N);
+    std::vector<float> RowBias(M);
+    std::vector<float> Residual(M * ldr);
+
+    for (size_t n = 0; n < N; n++) {
+        ColumnBias[n] = float(int(n % 7) - 3) * 0.125f;
+    }
+    for (size_t m = 0; m < M; m++) {
+        RowBias[m] = float(int(m % 5) - 2) * 0.25f;
+    }
+    for (size_t f = 0; f < M * ldr; f++) {
+        Residual[f] = float(int(f % 11) - 5) * 0.0625f;
+    }
+
+    static const MLAS_ACTIVATION_KIND ActivationKinds[] = {
+        MlasIdentityActivation, MlasReluActivation, MlasLeakyReluActivation, MlasTanhActivation, MlasLogisticActivation
+    };
+
+    for (size_t a = 0; a < _countof(ActivationKinds); a++) {
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = ActivationKinds[a];
+        Activation.alpha = 0.125f;
+
+        for (size_t bias = 0; bias < 4; bias++) {
+
+            MLAS_SGEMM_POSTPROCESS PostProcess;
+            PostProcess.ColumnBias = (bias == 1) ? ColumnBias.data() : nullptr;
+            PostProcess.RowBias = (bias == 2) ? RowBias.data() : nullptr;
+            PostProcess.Residual = (bias == 3) ? Residual.data() : nullptr;
+            PostProcess.ldr = ldr;
+            PostProcess.Activation = &Activation;
+
+            TrialSgemmPostProcess(CblasNoTrans, CblasNoTrans, M, N, K, alpha, A, K, B, N, beta, C, CReference, N, &PostProcess);
+            TrialSgemmPostProcess(CblasNoTrans, CblasTrans, M, N, K, alpha, A, K, B, K, beta, C, CReference, N, &PostProcess);
+            TrialSgemmPostProcess(CblasTrans, CblasNoTrans, M, N, K, alpha, A, M, B, N, beta, C, CReference, N, &PostProcess);
+            TrialSgemmPostProcess(CblasTrans, CblasTrans, M, N, K, alpha, A, M, B, K, beta, C, CReference, N, &PostProcess);
+        }
+    }
+}
+
+void
+ExecuteSgemmPostProcessTests(
+    void
+    )
+{
+    constexpr size_t MaximumDimension = 320;
+
+    MatrixGuardBuffer BufferA(MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferB(MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferC(MaximumDimension * MaximumDimension, false);
+    MatrixGuardBuffer BufferCReference(MaximumDimension * MaximumDimension, false);
+
+    //
+    // An alpha of one and a beta of zero or one select the M=1 kernels, a
+    // small alpha keeps the results in the range where Tanh and Logistic are
+    // not saturated. The larger shapes are split across threads along M or N
+    // when threading is supported, and K=0 only leaves the post-processing.
+    //
+
+    static const float alphas[] = { 1.0f, 1.0f / 1024.0f };
+    static const float betas[] = { 0.0f, 1.0f, 0.5f };
+    static const size_t shapes[][3] = {
+        { 1, 1, 1 }, { 1, 17, 9 }, { 1, 160, 64 }, { 3, 5, 7 }, { 16, 16, 16 }, { 33, 47, 119 },
+        { 160, 24, 160 }, { 24, 320, 160 }, { 320, 320, 64 }, { 7, 9, 0 }, { 1, 16, 0 },
+    };
+
+    for (size_t a = 0; a < _countof(alphas); a++) {
+        for (size_t b = 0; b < _countof(betas); b++) {
+            for (size_t s = 0; s < _countof(shapes); s++) {
+                TrialSgemmPostProcess(shapes[s][0], shapes[s][1], shapes[s][2], alphas[a],
+                    BufferA, BufferB, betas[b], BufferC, BufferCReference);
+            }
+        }
+    }
+}
+
 void
 ReferenceConv2D(
     size_t BatchCount,
@@ -1239,6 +1435,7 @@ main(
     )
 {
 //    ExecuteSgemmTests();
+    ExecuteSgemmPostProcessTests();
     ExecuteConvTests();
 //    ExecutePool2DTests();
 //    ExecutePool3DTests();
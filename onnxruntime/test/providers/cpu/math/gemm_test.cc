@@ -178,5 +178,23 @@ TEST(MathOpTest, GemmEmptyTensor) {
   test.Run();
 }
 
+TEST(MathOpTest, GemmZeroK) {
+  OpTester test("Gemm");
+
+  test.AddAttribute("transA", static_cast<int64_t>(0));
+  test.AddAttribute("transB", static_cast<int64_t>(0));
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 0.5f);
+
+  // the product is empty, Y is beta * C
+  test.AddInput<float>("A", {2, 0}, {});
+  test.AddInput<float>("B", {0, 3}, {});
+  test.AddInput<float>("C", {2, 3}, std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {0.5f, 1.0f, 1.5f,
+                         2.0f, 2.5f, 3.0f});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
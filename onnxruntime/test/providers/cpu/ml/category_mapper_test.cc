@@ -43,5 +43,17 @@ TEST(CategoryMapper, IntToString) {
 
   RunTest(dims, input, output);
 }
+
+TEST(CategoryMapper, LargeBatch) {
+  // More inputs than one lookup block, including repeated and unknown values
+  std::vector<int64_t> input;
+  std::vector<std::string> output;
+  for (int64_t i = 0; i < 1000; ++i) {
+    input.push_back(i % 5);
+    output.push_back(i % 5 == 1 ? "One" : i % 5 == 2 ? "Two" : i % 5 == 3 ? "Three" : "default");
+  }
+
+  RunTest(std::vector<int64_t>{1000}, input, output);
+}
 }  // namespace test
 }  // namespace onnxruntime
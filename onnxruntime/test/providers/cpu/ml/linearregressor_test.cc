@@ -66,5 +66,19 @@ TEST(MLOpTest, LinearRegressorMultiTarget) {
   test.Run();
 }
 
+TEST(MLOpTest, LinearRegressorSoftmax) {
+  OpTester test("LinearRegressor", 1, onnxruntime::kMLDomain);
+  std::vector<float> coefficients = {1.f, 0.f, 0.f, 1.f};
+  std::vector<float> intercepts = {0.f, 0.f};
+  test.AddAttribute("intercepts", intercepts);
+  test.AddAttribute("coefficients", coefficients);
+  test.AddAttribute("targets", int64_t{2});
+  test.AddAttribute("post_transform", std::string("SOFTMAX"));
+
+  test.AddInput<float>("X", {3, 2}, {0.f, 0.f, 1.f, 0.f, 0.f, 2.f});
+  test.AddOutput<float>("Y", {3, 2}, {0.5f, 0.5f, 0.7310586f, 0.2689414f, 0.1192029f, 0.8807971f});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
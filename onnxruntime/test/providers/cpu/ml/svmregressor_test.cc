@@ -1,12 +1,39 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
 namespace onnxruntime {
 namespace test {
 
+// Deterministic values in [-scale, scale)
+static std::vector<float> GenerateSVMValues(size_t count, uint32_t& seed, float scale) {
+  std::vector<float> values(count);
+  for (auto& value : values) {
+    seed = seed * 1103515245u + 12345u;
+    value = (static_cast<float>((seed >> 8) & 0xffff) / 32768.f - 1.f) * scale;
+  }
+  return values;
+}
+
+// Kernel between two rows computed on its own, as the reference of the batched kernels
+static double ReferenceSVMKernel(const std::string& kernel_type, const std::vector<float>& kernel_params,
+                                 const float* a, const float* b, int64_t feature_count) {
+  double dot = 0, distance = 0;
+  for (int64_t i = 0; i < feature_count; i++) {
+    dot += static_cast<double>(a[i]) * b[i];
+    distance += (static_cast<double>(a[i]) - b[i]) * (static_cast<double>(a[i]) - b[i]);
+  }
+  const double gamma = kernel_params[0], coef0 = kernel_params[1], degree = kernel_params[2];
+  if (kernel_type == "POLY") return std::pow(dot * gamma + coef0, degree);
+  if (kernel_type == "SIGMOID") return std::tanh(dot * gamma + coef0);
+  if (kernel_type == "RBF") return std::exp(-gamma * distance);
+  return dot;
+}
+
 TEST(MLOpTest, SVMRegressorSVC) {
   OpTester test("SVMRegressor", 1, onnxruntime::kMLDomain);
 
@@ -104,5 +131,46 @@ TEST(MLOpTest, SVMRegressorLinear) {
   test.Run();
 }
 
+// The kernels of a large batch are computed a chunk of rows at a time. Every row of such a batch must get the
+// prediction computed for it on its own.
+TEST(MLOpTest, SVMRegressorLargeBatchSVC) {
+  const int64_t feature_count = 3;
+  const int64_t vector_count = 4200;
+  // several chunks of rows with that many support vectors
+  const int64_t N = 520;
+
+  uint32_t seed = 11;
+  const std::vector<float> support_vectors = GenerateSVMValues(vector_count * feature_count, seed, 1.f);
+  const std::vector<float> coefficients = GenerateSVMValues(vector_count, seed, 0.01f);
+  const std::vector<float> rho = GenerateSVMValues(1, seed, 0.1f);
+  const std::vector<float> X = GenerateSVMValues(N * feature_count, seed, 1.f);
+  const std::vector<float> kernel_params = {0.5f, 0.5f, 2.f};  //gamma, coef0, degree
+
+  for (const std::string kernel_type : {"LINEAR", "POLY", "RBF", "SIGMOID"}) {
+    std::vector<float> predictions;
+    for (int64_t n = 0; n < N; n++) {
+      double prediction = rho[0];
+      for (int64_t v = 0; v < vector_count; v++) {
+        prediction += coefficients[v] * ReferenceSVMKernel(kernel_type, kernel_params, &X[n * feature_count],
+                                                           &support_vectors[v * feature_count], feature_count);
+      }
+      predictions.push_back(static_cast<float>(prediction));
+    }
+
+    OpTester test("SVMRegressor", 1, onnxruntime::kMLDomain);
+    test.AddAttribute("kernel_type", kernel_type);
+    test.AddAttribute("coefficients", coefficients);
+    test.AddAttribute("support_vectors", support_vectors);
+    test.AddAttribute("rho", rho);
+    test.AddAttribute("kernel_params", kernel_params);
+    test.AddAttribute("n_supports", vector_count);
+
+    test.AddInput<float>("X", {N, feature_count}, X);
+    test.AddOutput<float>("Y", {N, 1}, predictions);
+
+    test.Run();
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
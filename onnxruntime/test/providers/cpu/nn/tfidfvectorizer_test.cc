@@ -4,6 +4,7 @@
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
+#include <algorithm>
 #include <stdint.h>
 
 namespace onnxruntime {
@@ -36,6 +37,128 @@ void InitTestAttr(OpTester& test, const std::string& mode,
     test.AddAttribute("pool_strings", pool_strings);
   }
 }
+
+// Builds a pool of many n-grams over few distinct items so that the index holds n-grams of
+// every length that share prefixes, are permutations of each other and collide in the table.
+// Items 12-19 only appear as 1-grams and items above 19 are not in the pool at all.
+void CreateCollidingPool(std::vector<int64_t>& ngram_counts, std::vector<int64_t>& ngram_indexes,
+                         std::vector<int64_t>& pool) {
+  ngram_counts.clear();
+  pool.clear();
+  size_t ngrams = 0;
+  ngram_counts.push_back(0);
+  for (int64_t a = 0; a < 20; ++a, ++ngrams) {
+    pool.push_back(a);
+  }
+  ngram_counts.push_back(static_cast<int64_t>(pool.size()));
+  for (int64_t a = 0; a < 12; ++a) {
+    for (int64_t b = 0; b < 12; ++b) {
+      if (a != b) {
+        pool.insert(pool.end(), {a, b});
+        ++ngrams;
+      }
+    }
+  }
+  ngram_counts.push_back(static_cast<int64_t>(pool.size()));
+  for (int64_t a = 0; a < 6; ++a) {
+    for (int64_t b = 0; b < 6; ++b) {
+      for (int64_t c = 0; c < 6; ++c) {
+        if ((a + b + c) % 2 == 0) {
+          pool.insert(pool.end(), {a, b, c});
+          ++ngrams;
+        }
+      }
+    }
+  }
+  // Output indexes run backwards so that n-gram ids and output positions differ
+  ngram_indexes.resize(ngrams);
+  for (size_t i = 0; i < ngrams; ++i) {
+    ngram_indexes[i] = static_cast<int64_t>(ngrams - 1 - i);
+  }
+}
+
+// Counts the pool n-grams in each row by comparing every n-gram to every window of the row
+std::vector<float> CountNgrams(const std::vector<int32_t>& input, size_t rows, size_t C,
+                               size_t min_gram_length, size_t max_gram_length, size_t max_skip_count,
+                               const std::vector<int64_t>& ngram_counts,
+                               const std::vector<int64_t>& ngram_indexes,
+                               const std::vector<int64_t>& pool) {
+  const size_t output_size = static_cast<size_t>(*std::max_element(ngram_indexes.cbegin(), ngram_indexes.cend())) + 1;
+  std::vector<float> output(rows * output_size, 0.f);
+  size_t ngram_id = 0;
+  for (size_t ngram_size = 1; ngram_size <= ngram_counts.size(); ++ngram_size) {
+    const size_t start_idx = static_cast<size_t>(ngram_counts[ngram_size - 1]);
+    const size_t end_idx = ngram_size < ngram_counts.size() ? static_cast<size_t>(ngram_counts[ngram_size]) : pool.size();
+    for (size_t idx = start_idx; idx < end_idx; idx += ngram_size, ++ngram_id) {
+      if (ngram_size < min_gram_length || ngram_size > max_gram_length) {
+        continue;
+      }
+      // 1-grams do not depend on skips
+      const size_t max_skip_distance = ngram_size == 1 ? 1 : max_skip_count + 1;
+      for (size_t row = 0; row < rows; ++row) {
+        for (size_t skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
+          for (size_t start = 0; start + skip_distance * (ngram_size - 1) < C; ++start) {
+            size_t k = 0;
+            while (k < ngram_size && input[row * C + start + k * skip_distance] == pool[idx + k]) {
+              ++k;
+            }
+            if (k == ngram_size) {
+              ++output[row * output_size + ngram_indexes[ngram_id]];
+            }
+          }
+        }
+      }
+    }
+  }
+  return output;
+}
+
+// Compares the op with CountNgrams on rows drawn mostly from the few items the n-grams are made of
+void RunCollidingPoolTest(bool strings, int64_t min_gram_length, int64_t max_gram_length, int64_t max_skip_count) {
+  std::vector<int64_t> ngram_counts;
+  std::vector<int64_t> ngram_indexes;
+  std::vector<int64_t> pool;
+  CreateCollidingPool(ngram_counts, ngram_indexes, pool);
+
+  const size_t rows = 3;
+  const size_t C = 64;
+  std::vector<int32_t> input(rows * C);
+  uint32_t seed = 5;
+  for (auto& item : input) {
+    seed = seed * 1103515245 + 12345;
+    const uint32_t r = seed >> 8;
+    item = static_cast<int32_t>((r & 1) ? (r >> 1) % 6 : (r >> 1) % 24);
+  }
+
+  auto expected = CountNgrams(input, rows, C, static_cast<size_t>(min_gram_length),
+                              static_cast<size_t>(max_gram_length), static_cast<size_t>(max_skip_count),
+                              ngram_counts, ngram_indexes, pool);
+  const int64_t output_size = static_cast<int64_t>(expected.size() / rows);
+  // The rows must match plenty of n-grams for the comparison to mean anything
+  ASSERT_GT(std::count_if(expected.cbegin(), expected.cend(), [](float f) { return f > 0; }), 25);
+
+  OpTester test("TfIdfVectorizer", opset_ver, domain);
+  std::vector<int64_t> dims{static_cast<int64_t>(rows), static_cast<int64_t>(C)};
+  if (strings) {
+    std::vector<std::string> pool_strings;
+    for (auto item : pool) {
+      pool_strings.push_back("w" + std::to_string(item));
+    }
+    InitTestAttr(test, "TF", min_gram_length, max_gram_length, max_skip_count,
+                 ngram_counts, ngram_indexes, {}, {}, pool_strings);
+    std::vector<std::string> input_strings;
+    for (auto item : input) {
+      input_strings.push_back("w" + std::to_string(item));
+    }
+    test.AddInput<std::string>("T", dims, input_strings);
+  } else {
+    InitTestAttr(test, "TF", min_gram_length, max_gram_length, max_skip_count,
+                 ngram_counts, ngram_indexes, {}, pool, {});
+    test.AddInput<int32_t>("T", dims, input);
+  }
+  test.AddOutput<float>("Y", {static_cast<int64_t>(rows), output_size}, expected);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
 }  // namespace tfidfvectorizer_test
 
 using namespace tfidfvectorizer_test;
@@ -555,5 +678,90 @@ TEST(TfIdfVectorizerTest, String_TFIDFWeights_onlyBigrams_Skip5) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+// 1-, 2- and 3-grams in one pool. (2, 1, 3) is in the pool while its prefix (2, 1) is not, and
+// item 4 is not in any n-gram so no window may extend past it.
+TEST(TfIdfVectorizerTest, Int32_TF_MixedLengths_Skip0) {
+  OpTester test("TfIdfVectorizer", opset_ver, domain);
+  // s=0, Min=1, Max=3, weights empty, int32
+  InitTestAttr(test, "TF", 1, 3, 0,
+               {0, 2, 6},
+               {0, 1, 2, 3, 4, 5},  //6 output indexes
+               {},
+               {1, 2,               //1-grams
+                1, 3, 3, 1,         //bi-grams
+                1, 2, 1, 2, 1, 3},  //tri-grams
+               {});
+
+  std::vector<int64_t> dims{10};
+  std::vector<int32_t> input = {2, 4, 1, 2, 3, 1, 2, 1, 3, 1};
+  test.AddInput<int32_t>("T", dims, input);
+
+  std::vector<int64_t> out_dims{6};
+  std::vector<float> output = {4, 3, 1, 2, 1, 1};
+  test.AddOutput<float>("Y", out_dims, output);
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(TfIdfVectorizerTest, Int32_TF_MixedLengths_Skip1) {
+  OpTester test("TfIdfVectorizer", opset_ver, domain);
+  // s=1, Min=1, Max=3, weights empty, int32
+  InitTestAttr(test, "TF", 1, 3, 1,
+               {0, 2, 6},
+               {0, 1, 2, 3, 4, 5},  //6 output indexes
+               {},
+               {1, 2,               //1-grams
+                1, 3, 3, 1,         //bi-grams
+                1, 2, 1, 2, 1, 3},  //tri-grams
+               {});
+
+  std::vector<int64_t> dims{10};
+  std::vector<int32_t> input = {2, 4, 1, 2, 3, 1, 2, 1, 3, 1};
+  test.AddInput<int32_t>("T", dims, input);
+
+  std::vector<int64_t> out_dims{6};
+  // (1, 3) once more over a skip, (2, 1, 3) once more over items 0, 2 and 4
+  std::vector<float> output = {4, 3, 2, 2, 1, 2};
+  test.AddOutput<float>("Y", out_dims, output);
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(TfIdfVectorizerTest, String_TF_BatchMixedLengths_Skip2) {
+  OpTester test("TfIdfVectorizer", opset_ver, domain);
+  // s=2, Min=2, Max=3, weights empty, string
+  InitTestAttr(test, "TF", 2, 3, 2,
+               {0, 2, 6},
+               {0, 1, 2, 3, 4, 5},  //6 output indexes
+               {},
+               {},
+               {"one", "two",                                 //1-grams
+                "one", "three", "three", "one",               //bi-grams
+                "one", "two", "one", "two", "one", "three"});  //tri-grams
+
+  std::vector<int64_t> dims{2, 10};
+  std::vector<std::string> input{"two", "four", "one", "two", "three", "one", "two", "one", "three", "one",
+                                 "one", "two", "one", "three", "one", "four", "two", "one", "three", "one"};
+  test.AddInput<std::string>("T", dims, input);
+
+  std::vector<int64_t> out_dims{2, 6};
+  std::vector<float> output = {0, 0, 3, 3, 1, 2,
+                               0, 0, 3, 2, 1, 2};
+  test.AddOutput<float>("Y", out_dims, output);
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(TfIdfVectorizerTest, Int32_TF_BatchCollidingPool) {
+  RunCollidingPoolTest(false, 1, 3, 0);
+  RunCollidingPoolTest(false, 1, 3, 2);
+  RunCollidingPoolTest(false, 2, 3, 3);
+}
+
+TEST(TfIdfVectorizerTest, String_TF_BatchCollidingPool) {
+  RunCollidingPoolTest(true, 1, 3, 2);
+  RunCollidingPoolTest(true, 3, 3, 1);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -117,6 +117,15 @@ void CheckDispatch(MLDataType type, const OpTester::Data& expected_data, MLValue
 }
 
 void Check(const OpTester::Data& expected_data, MLValue& mlvalue, const std::string& provider_type) {
+  // sequences of maps are produced in columnar form, compare the maps they represent
+  if (mlvalue.Type() == DataTypeImpl::GetType<ColumnarMapStringToFloat>()) {
+    Check<VectorMapStringToFloat>(expected_data, mlvalue.Get<ColumnarMapStringToFloat>().ToMaps(), provider_type);
+    return;
+  }
+  if (mlvalue.Type() == DataTypeImpl::GetType<ColumnarMapInt64ToFloat>()) {
+    Check<VectorMapInt64ToFloat>(expected_data, mlvalue.Get<ColumnarMapInt64ToFloat>().ToMaps(), provider_type);
+    return;
+  }
   CheckDispatch<VectorMapStringToFloat, VectorMapInt64ToFloat>(expected_data.data_.Type(), expected_data, mlvalue, provider_type);
 }
 
@@ -2,6 +2,7 @@
 # Licensed under the MIT License.
 
 # -*- coding: UTF-8 -*-
+import asyncio
 import unittest
 import os
 import sys
@@ -40,6 +41,35 @@ class TestInferenceSession(unittest.TestCase):
         output_expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
         np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
 
+    def testRunModelAsync(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.pb"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        loop = asyncio.get_event_loop()
+
+        async def run_all():
+            return await asyncio.gather(*[sess.run_async(["Y"], {"X": x * i}) for i in range(1, 5)])
+
+        results = loop.run_until_complete(run_all())
+        for i, res in enumerate(results, 1):
+            output_expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32) * i * i
+            np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+
+        with self.assertRaises(RuntimeError):
+            loop.run_until_complete(sess.run_async(["Y"], {"Z": x}))
+
+    def testRunModelNonContiguousInput(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.pb"))
+        x = np.array([[1.0, 3.0, 5.0], [2.0, 4.0, 6.0]], dtype=np.float32)
+        output_expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+        # contiguous inputs are used in place, others are copied
+        res = sess.run(["Y"], {"X": np.ascontiguousarray(x.T)})
+        np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+        res = sess.run(["Y"], {"X": x.T})
+        np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+        # the output stays valid once the session is gone
+        del sess
+        np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+
     def testRunModelFromBytes(self):
         with open(self.get_name("mul_1.pb"), "rb") as f:
             content = f.read()
@@ -93,6 +123,20 @@ class TestInferenceSession(unittest.TestCase):
         output_expected = np.array([[5.0], [11.0], [17.0]], dtype=np.float32)
         np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
 
+    def testWarmUp(self):
+        so = onnxrt.SessionOptions()
+        self.assertEqual(so.mem_pattern_cache_max_entries, 64)
+        so.mem_pattern_dim_buckets = [4, 8]
+        self.assertEqual(so.mem_pattern_dim_buckets, [4, 8])
+        sess = onnxrt.InferenceSession(self.get_name("matmul_2.pb"), so)
+        sess.warm_up([{"X": [4, 2]}, {"X": (5, 2)}])
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        res = sess.run(["Y"], {"X": x})
+        output_expected = np.array([[5.0], [11.0], [17.0]], dtype=np.float32)
+        np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+        with self.assertRaises(RuntimeError):
+            sess.warm_up([{"Z": [4, 2]}])
+
     def testBooleanInputs(self):
         sess = onnxrt.InferenceSession(self.get_name("logicaland.pb"))
         a = np.array([[True, True], [False, False]], dtype=np.bool)
@@ -296,6 +340,12 @@ class TestInferenceSession(unittest.TestCase):
         res = sess.run([output_name], {x_name: x})
         self.assertEqual(output_expected, res[0])
 
+        # the maps are a view over the scores
+        self.assertEqual([10, 20, 30], res[0].keys)
+        np.testing.assert_array_equal(x, res[0].values)
+        self.assertEqual(44.0, res[0][1][10])
+        self.assertEqual(output_expected, res[0].to_list())
+
     def testRaiseWrongNumInputs(self):
         with self.assertRaises(ValueError) as context:
             sess = onnxrt.InferenceSession(self.get_name("logicaland.pb"))
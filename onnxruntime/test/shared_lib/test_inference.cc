@@ -3,10 +3,13 @@
 
 #include "core/session/onnxruntime_cxx_api.h"
 #include "providers.h"
+#include <fstream>
+#include <iterator>
 #include <memory>
 #include <vector>
 #include <iostream>
 #include <atomic>
+#include <future>
 #include <gtest/gtest.h>
 #include "test_allocator.h"
 #include "test_fixture.h"
@@ -135,6 +138,79 @@ TEST_F(CApiTest, DISABLED_custom_op) {
 }
 #endif
 
+struct RunAsyncResult {
+  std::promise<void> done;
+  std::vector<float> values_y;
+  std::string error;
+};
+
+static void ORT_API_CALL OnRunAsyncCompleted(void* user_data, OrtValue** output, size_t output_len, OrtStatus* status) {
+  auto* result = reinterpret_cast<RunAsyncResult*>(user_data);
+  if (status != nullptr) {
+    result->error = OrtGetErrorMessage(status);
+    OrtReleaseStatus(status);
+  } else if (output_len == 1) {
+    float* f;
+    ORT_THROW_ON_ERROR(OrtGetTensorMutableData(output[0], (void**)&f));
+    result->values_y.assign(f, f + 6);
+    OrtReleaseValue(output[0]);
+  }
+  result->done.set_value();
+}
+
+TEST_F(CApiTest, run_async) {
+  SessionOptionsWrapper sf(env);
+  std::unique_ptr<OrtSession, decltype(&OrtReleaseSession)> inference_session(sf.OrtCreateSession(MODEL_URI), OrtReleaseSession);
+  std::unique_ptr<MockedOrtAllocator> default_allocator(std::make_unique<MockedOrtAllocator>());
+
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> value_x(
+      OrtCreateTensorAsOrtValue(default_allocator.get(), {3, 2}, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT), OrtReleaseValue);
+  void* raw_data;
+  ORT_THROW_ON_ERROR(OrtGetTensorMutableData(value_x.get(), &raw_data));
+  memcpy(raw_data, values_x.data(), values_x.size() * sizeof(values_x[0]));
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  const OrtValue* inputs[] = {value_x.get()};
+  RunAsyncResult result;
+  auto done = result.done.get_future();
+  ORT_THROW_ON_ERROR(OrtRunAsync(inference_session.get(), NULL, input_names, inputs, 1, output_names, 1,
+                                 OnRunAsyncCompleted, &result));
+  done.wait();
+  ASSERT_EQ(result.error, "");
+  ASSERT_EQ(result.values_y, std::vector<float>({1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f}));
+}
+
+TEST_F(CApiTest, clone_session) {
+  SessionOptionsWrapper sf(env);
+  std::unique_ptr<MockedOrtAllocator> default_allocator(std::make_unique<MockedOrtAllocator>());
+  OrtSession* clone;
+  {
+    std::unique_ptr<OrtSession, decltype(&OrtReleaseSession)> inference_session(sf.OrtCreateSession(MODEL_URI), OrtReleaseSession);
+    ORT_THROW_ON_ERROR(OrtCloneSession(inference_session.get(), nullptr, &clone));
+  }
+  std::unique_ptr<OrtSession, decltype(&OrtReleaseSession)> clone_session(clone, OrtReleaseSession);
+  RunSession(default_allocator.get(), clone_session.get(), {3, 2}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f},
+             {3, 2}, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+}
+
+TEST_F(CApiTest, create_session_from_array) {
+  std::ifstream model_file(MODEL_URI, std::ios::in | std::ios::binary);
+  std::vector<char> model_data((std::istreambuf_iterator<char>(model_file)), std::istreambuf_iterator<char>());
+  ASSERT_FALSE(model_data.empty());
+
+  SessionOptionsWrapper sf(env);
+  std::unique_ptr<MockedOrtAllocator> default_allocator(std::make_unique<MockedOrtAllocator>());
+  std::unique_ptr<OrtSession, decltype(&OrtReleaseSession)> inference_session(
+      sf.OrtCreateSessionFromArray(model_data.data(), model_data.size()), OrtReleaseSession);
+  // the buffer is no longer needed once the session is created
+  model_data.clear();
+  model_data.shrink_to_fit();
+  RunSession(default_allocator.get(), inference_session.get(), {3, 2}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f},
+             {3, 2}, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+}
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 TEST_F(CApiTest, create_session_without_session_option) {
   constexpr PATH_TYPE model_uri = TSTR("../models/opset8/test_squeezenet/model.onnx");
@@ -190,6 +266,55 @@ TEST_F(CApiTest, create_tensor_with_data) {
   OrtReleaseTypeInfo(type_info);
 }
 
+TEST_F(CApiTest, create_packed_string_tensor) {
+  const char* s[] = {"abc", "", "kmp"};
+  size_t expected_len = 3;
+  std::unique_ptr<MockedOrtAllocator> default_allocator(std::make_unique<MockedOrtAllocator>());
+  {
+    std::vector<size_t> dims = {expected_len};
+    OrtValue* tensor_ptr;
+    ORT_THROW_ON_ERROR(OrtCreatePackedStringTensorAsOrtValue(default_allocator.get(), dims.data(), dims.size(),
+                                                             s, expected_len, &tensor_ptr));
+    std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> tensor(tensor_ptr, OrtReleaseValue);
+    ASSERT_EQ(ONNX_TYPE_TENSOR, OrtGetValueType(tensor.get()));
+    std::unique_ptr<OrtTensorTypeAndShapeInfo> shape_info;
+    {
+      OrtTensorTypeAndShapeInfo* shape_info_ptr;
+      ORT_THROW_ON_ERROR(OrtGetTensorShapeAndType(tensor.get(), &shape_info_ptr));
+      shape_info.reset(shape_info_ptr);
+    }
+    ASSERT_EQ(ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING, OrtGetTensorElementType(shape_info.get()));
+    size_t len = static_cast<size_t>(OrtGetTensorShapeElementCount(shape_info.get()));
+    ASSERT_EQ(len, expected_len);
+
+    size_t data_len;
+    ORT_THROW_ON_ERROR(OrtGetStringTensorDataLength(tensor.get(), &data_len));
+    ASSERT_EQ(data_len, 6u);
+    std::string result(data_len, '\0');
+    std::vector<size_t> offsets(len);
+    ORT_THROW_ON_ERROR(OrtGetStringTensorContent(tensor.get(), (void*)result.data(), data_len, offsets.data(), offsets.size()));
+    ASSERT_EQ(result, "abckmp");
+    ASSERT_EQ(offsets, std::vector<size_t>({0, 3, 3}));
+
+    // the packed buffers can be wrapped without a copy
+    OrtValue* wrapped_ptr;
+    ORT_THROW_ON_ERROR(OrtCreatePackedStringTensorWithDataAsOrtValue((void*)result.data(), data_len, offsets.data(),
+                                                                     offsets.size(), dims.data(), dims.size(),
+                                                                     &wrapped_ptr));
+    std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> wrapped(wrapped_ptr, OrtReleaseValue);
+    const void* bytes;
+    size_t bytes_len;
+    const size_t* wrapped_offsets;
+    size_t wrapped_offsets_len;
+    ORT_THROW_ON_ERROR(OrtGetPackedStringTensorContent(wrapped.get(), &bytes, &bytes_len, &wrapped_offsets,
+                                                       &wrapped_offsets_len));
+    ASSERT_EQ(bytes, result.data());
+    ASSERT_EQ(bytes_len, data_len);
+    ASSERT_EQ(wrapped_offsets, offsets.data());
+    ASSERT_EQ(wrapped_offsets_len, expected_len);
+  }
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
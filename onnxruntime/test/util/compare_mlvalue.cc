@@ -336,6 +336,17 @@ std::pair<COMPARE_RESULT, std::string> CompareMLValue(const MLValue& o, const ML
                                                       double per_sample_tolerance,
                                                       double relative_per_sample_tolerance,
                                                       bool post_processing) {
+  // sequences of maps are produced in columnar form, compare the maps they represent
+  if (o.Type() == DataTypeImpl::GetType<ColumnarMapInt64ToFloat>() &&
+      expected_mlvalue.Type() == DataTypeImpl::GetType<VectorMapInt64ToFloat>()) {
+    return CompareSeqOfMapToFloat(o.Get<ColumnarMapInt64ToFloat>().ToMaps(), expected_mlvalue.Get<VectorMapInt64ToFloat>(),
+                                  per_sample_tolerance, relative_per_sample_tolerance, post_processing);
+  }
+  if (o.Type() == DataTypeImpl::GetType<ColumnarMapStringToFloat>() &&
+      expected_mlvalue.Type() == DataTypeImpl::GetType<VectorMapStringToFloat>()) {
+    return CompareSeqOfMapToFloat(o.Get<ColumnarMapStringToFloat>().ToMaps(), expected_mlvalue.Get<VectorMapStringToFloat>(),
+                                  per_sample_tolerance, relative_per_sample_tolerance, post_processing);
+  }
   if (o.IsTensor() != expected_mlvalue.IsTensor() || o.Type() != expected_mlvalue.Type()) {
     return std::make_pair(COMPARE_RESULT::TYPE_MISMATCH, "");
   }